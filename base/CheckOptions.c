@@ -84,6 +84,15 @@ void CheckOptions(INP t_options Options, INP boolean TimingEnabled) {
 	if (Options.Count[OT_EXIT_T] > 0) {
 		Yes = OT_EXIT_T;
 	}
+	if (Options.Count[OT_ANNEAL_ADAPTIVE] > 0) {
+		Yes = OT_ANNEAL_ADAPTIVE;
+	}
+	if (Options.Count[OT_ANNEAL_EXIT_WINDOW] > 0) {
+		Yes = OT_ANNEAL_EXIT_WINDOW;
+	}
+	if (Options.Count[OT_ANNEAL_EXIT_IMPROVEMENT] > 0) {
+		Yes = OT_ANNEAL_EXIT_IMPROVEMENT;
+	}
 	if (Options.Count[OT_FIX_PINS] > 0) {
 		Yes = OT_FIX_PINS;
 	}
@@ -201,4 +210,22 @@ void CheckOptions(INP t_options Options, INP boolean TimingEnabled) {
 			++Cur;
 		}
 	}
+
+	/* Forked placement continuations all start from a checkpoint */
+	if (Options.Count[OT_PLACE_FORK]) {
+		if (Options.Count[OT_PLACE_RESUME] == 0) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Option 'place_fork' needs a checkpoint to continue from; give it with 'place_resume'.\n");
+			exit(1);
+		}
+		if (Options.PlaceNumForks < 1) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Option 'place_fork' must be at least 1, not %d.\n", Options.PlaceNumForks);
+			exit(1);
+		}
+	}
+
+	if (Options.Count[OT_RECOMPUTE_TIMING_AFTER]
+			&& Options.recompute_timing_after < 1) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Option 'recompute_timing_after' must be at least 1, not %d.\n", Options.recompute_timing_after);
+		exit(1);
+	}
 }
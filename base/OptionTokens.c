@@ -14,6 +14,7 @@ struct s_TokenPair OptionBaseTokenList[] = {
 		{ "full_stats", OT_FULL_STATS }, 
 		{ "fast", OT_FAST }, 
 		{ "echo_file", OT_CREATE_ECHO_FILE }, 
+		{ "echo_compression", OT_ECHO_COMPRESSION }, 
 		{ "gen_postsynthesis_netlist", OT_GENERATE_POST_SYNTHESIS_NETLIST }, 
 		{ "timing_analysis", OT_TIMING_ANALYSIS }, 
 		{ "timing_analyze_only_with_net_delay", OT_TIMING_ANALYZE_ONLY_WITH_NET_DELAY },
@@ -21,10 +22,19 @@ struct s_TokenPair OptionBaseTokenList[] = {
 		{ "alpha_t", OT_ALPHA_T }, 
 		{ "exit_t", OT_EXIT_T }, 
 		{ "inner_num", OT_INNER_NUM }, 
+		{ "anneal_adaptive", OT_ANNEAL_ADAPTIVE }, 
+		{ "anneal_exit_window", OT_ANNEAL_EXIT_WINDOW }, 
+		{ "anneal_exit_improvement", OT_ANNEAL_EXIT_IMPROVEMENT }, 
 		{ "seed", OT_SEED },
 		{ "place_cost_exp", OT_PLACE_COST_EXP }, 
 		{ "td_place_exp_first", OT_TD_PLACE_EXP_FIRST }, 
 		{ "td_place_exp_last", OT_TD_PLACE_EXP_LAST },
+		{ "place_delay_cache", OT_PLACE_DELAY_CACHE }, 
+		{ "place_checkpoint", OT_PLACE_CHECKPOINT }, 
+		{ "place_checkpoint_t", OT_PLACE_CHECKPOINT_T }, 
+		{ "place_resume", OT_PLACE_RESUME }, 
+		{ "place_fork", OT_PLACE_FORK }, 
+		{ "place_profile", OT_PLACE_PROFILE }, 
 		{ "place_algorithm", OT_PLACE_ALGORITHM }, 
 		{ "timing_tradeoff", OT_TIMING_TRADEOFF }, 
 		{ "enable_timing_computations", OT_ENABLE_TIMING_COMPUTATIONS },
@@ -53,6 +63,9 @@ struct s_TokenPair OptionBaseTokenList[] = {
 		{ "place_file", OT_PLACE_FILE }, 
 		{ "route_file", OT_ROUTE_FILE }, 
 		{ "sdc_file", OT_SDC_FILE }, 
+		{ "write_snapshot", OT_WRITE_SNAPSHOT }, 
+		{ "read_snapshot", OT_READ_SNAPSHOT }, 
+		{ "import_route", OT_IMPORT_ROUTE }, 
 		{ "global_clocks", OT_GLOBAL_CLOCKS }, 
 		{ "hill_climbing", OT_HILL_CLIMBING_FLAG }, 
 		{ "sweep_hanging_nets_and_inputs", OT_SWEEP_HANGING_NETS_AND_INPUTS }, 
@@ -70,7 +83,11 @@ struct s_TokenPair OptionBaseTokenList[] = {
 		{ "inter_cluster_net_delay", OT_INTER_CLUSTER_NET_DELAY }, 
 		{ "pack", OT_PACK }, 
 		{ "packer_algorithm", OT_PACKER_ALGORITHM }, /**/
+		{ "pack_workers", OT_PACK_WORKERS }, /* Speculative clustering processes */
+		{ "pack_deterministic", OT_PACK_DETERMINISTIC }, 
+		{ "pack_profile", OT_PACK_PROFILE }, /* JSON packing profile next to the .net file */
 		{ "activity_file", OT_ACTIVITY_FILE }, /* Activity file */
+		{ "write_activity_binary", OT_WRITE_ACTIVITY_BINARY }, /* Binary copy of the activity file for later runs */
 		{ "power_output_file", OT_POWER_OUT_FILE }, /* Output file for power results */
 		{ "power", OT_POWER }, /* Run power estimation? */
 		{ "tech_properties", OT_CMOS_TECH_BEHAVIOR_FILE }, /* Technology properties */
@@ -82,6 +99,7 @@ struct s_TokenPair OptionBaseTokenList[] = {
 		{ "delay_increase", OT_DELAY_INCREASE },
 		{ "placer_cost_constant", OT_PLACER_COST_CONSTANT },
 		{ "constant_type", OT_CONSTANT_TYPE },
+		{ "place_die_partition", OT_PLACE_DIE_PARTITION },
 #endif
 
 		{ NULL, OT_BASE_UNKNOWN } /* End of list marker */
@@ -14,6 +14,7 @@ enum e_OptionBaseToken {
 	OT_READ_PLACE_ONLY,
 	OT_FAST,
 	OT_CREATE_ECHO_FILE,
+	OT_ECHO_COMPRESSION,
 	OT_TIMING_ANALYSIS,
 	OT_TIMING_ANALYZE_ONLY_WITH_NET_DELAY,
 	OT_GENERATE_POST_SYNTHESIS_NETLIST,
@@ -21,10 +22,19 @@ enum e_OptionBaseToken {
 	OT_ALPHA_T,
 	OT_EXIT_T,
 	OT_INNER_NUM,
+	OT_ANNEAL_ADAPTIVE,
+	OT_ANNEAL_EXIT_WINDOW,
+	OT_ANNEAL_EXIT_IMPROVEMENT,
 	OT_SEED,
 	OT_PLACE_COST_EXP,
 	OT_TD_PLACE_EXP_FIRST,
 	OT_TD_PLACE_EXP_LAST,
+	OT_PLACE_DELAY_CACHE,
+	OT_PLACE_CHECKPOINT,
+	OT_PLACE_CHECKPOINT_T,
+	OT_PLACE_RESUME,
+	OT_PLACE_FORK,
+	OT_PLACE_PROFILE,
 	OT_PLACE_ALGORITHM,
 	OT_TIMING_TRADEOFF,
 	OT_ENABLE_TIMING_COMPUTATIONS,
@@ -53,6 +63,9 @@ enum e_OptionBaseToken {
 	OT_PLACE_FILE,
 	OT_ROUTE_FILE,
 	OT_SDC_FILE,
+	OT_WRITE_SNAPSHOT,
+	OT_READ_SNAPSHOT,
+	OT_IMPORT_ROUTE,
 	OT_GLOBAL_CLOCKS,
 	OT_HILL_CLIMBING_FLAG,
 	OT_SWEEP_HANGING_NETS_AND_INPUTS,
@@ -70,8 +83,12 @@ enum e_OptionBaseToken {
 	OT_INTER_CLUSTER_NET_DELAY,
 	OT_PACK,
 	OT_PACKER_ALGORITHM,
+	OT_PACK_WORKERS,
+	OT_PACK_DETERMINISTIC,
+	OT_PACK_PROFILE,
 	OT_POWER,
 	OT_ACTIVITY_FILE,
+	OT_WRITE_ACTIVITY_BINARY,
 	OT_POWER_OUT_FILE,
 	OT_CMOS_TECH_BEHAVIOR_FILE,
 
@@ -82,6 +99,7 @@ enum e_OptionBaseToken {
 	OT_DELAY_INCREASE,
 	OT_PLACER_COST_CONSTANT,
 	OT_CONSTANT_TYPE,
+	OT_PLACE_DIE_PARTITION,
 #endif
 
 	OT_BASE_UNKNOWN /* Must be last since used for counting enum items */
@@ -118,6 +118,45 @@ void setEchoFileName(enum e_echo_files echo_option, const char *name) {
 	echoFileNames[(int)echo_option] = my_strdup(name);
 }
 
+void setEchoFileCompression(const char *compression) {
+	/* Adds the suffix that makes open_out_file compress (".gz" or ".zst") to *
+	 * the names of the echo dumps that grow with the netlist.                */
+	const enum e_echo_files large_dumps[] = { E_ECHO_RR_GRAPH,
+			E_ECHO_PRE_PACKING_TIMING_GRAPH, E_ECHO_PRE_PACKING_SLACK,
+			E_ECHO_PRE_PACKING_CRITICALITY,
+			E_ECHO_INITIAL_PLACEMENT_TIMING_GRAPH, E_ECHO_INITIAL_PLACEMENT_SLACK,
+			E_ECHO_INITIAL_PLACEMENT_CRITICALITY,
+			E_ECHO_FINAL_PLACEMENT_TIMING_GRAPH, E_ECHO_FINAL_PLACEMENT_SLACK,
+			E_ECHO_FINAL_PLACEMENT_CRITICALITY, E_ECHO_TIMING_GRAPH,
+			E_ECHO_SLACK, E_ECHO_CRITICALITY, E_ECHO_NET_DELAY };
+	const char *suffix;
+	char *name;
+	int i;
+
+	if (strcmp(compression, "gzip") == 0) {
+		suffix = ".gz";
+	} else if (strcmp(compression, "zstd") == 0) {
+		suffix = ".zst";
+	} else if (strcmp(compression, "off") == 0) {
+		return;
+	} else {
+		vpr_printf(TIO_MESSAGE_ERROR, "Unknown echo compression '%s'; expected off, gzip or zstd.\n",
+				compression);
+		exit(1);
+	}
+
+	if (echoFileEnabled == NULL) {
+		alloc_and_load_echo_file_info();
+	}
+	for (i = 0; i < (int) (sizeof(large_dumps) / sizeof(large_dumps[0])); i++) {
+		name = (char *) my_malloc(strlen(echoFileNames[(int)large_dumps[i]]) + strlen(suffix) + 1);
+		strcpy(name, echoFileNames[(int)large_dumps[i]]);
+		strcat(name, suffix);
+		setEchoFileName(large_dumps[i], name);
+		free(name);
+	}
+}
+
 boolean isEchoFileEnabled(enum e_echo_files echo_option) {
 	if(echoFileEnabled == NULL) {
 		return FALSE;
@@ -341,6 +380,12 @@ ProcessOption(INP char **Args, INOUTP t_options * Options) {
 		return ReadString(Args, &Options->RouteFile);
 	case OT_SDC_FILE:
 		return ReadString(Args, &Options->SDCFile);
+	case OT_WRITE_SNAPSHOT:
+		return ReadString(Args, &Options->WriteSnapshotFile);
+	case OT_READ_SNAPSHOT:
+		return ReadString(Args, &Options->ReadSnapshotFile);
+	case OT_IMPORT_ROUTE:
+		return ReadString(Args, &Options->ImportRouteFile);
 	case OT_SETTINGS_FILE:
 		return ReadString(Args, &Options->SettingsFile);
 		/* General Options */
@@ -363,6 +408,8 @@ ProcessOption(INP char **Args, INOUTP t_options * Options) {
 		return ReadString(Args, &Options->out_file_prefix);
 	case OT_CREATE_ECHO_FILE:
 		return ReadOnOff(Args, &Options->CreateEchoFile);
+	case OT_ECHO_COMPRESSION:
+		return ReadString(Args, &Options->EchoCompression);
 	case OT_GENERATE_POST_SYNTHESIS_NETLIST:
           
 	  return ReadOnOff(Args, &Options->Generate_Post_Synthesis_Netlist);
@@ -399,6 +446,12 @@ ProcessOption(INP char **Args, INOUTP t_options * Options) {
 		return Args;
 	case OT_PACKER_ALGORITHM:
 		return ReadPackerAlgorithm(Args, &Options->packer_algorithm);
+	case OT_PACK_WORKERS:
+		return ReadInt(Args, &Options->pack_workers);
+	case OT_PACK_DETERMINISTIC:
+		return ReadOnOff(Args, &Options->pack_deterministic);
+	case OT_PACK_PROFILE:
+		return ReadOnOff(Args, &Options->pack_profile);
 
 		/* Placer Options */
 	case OT_PLACE_ALGORITHM:
@@ -411,6 +464,12 @@ ProcessOption(INP char **Args, INOUTP t_options * Options) {
 		return ReadFloat(Args, &Options->PlaceAlphaT);
 	case OT_INNER_NUM:
 		return ReadFloat(Args, &Options->PlaceInnerNum);
+	case OT_ANNEAL_ADAPTIVE:
+		return ReadOnOff(Args, &Options->PlaceAdaptiveAnneal);
+	case OT_ANNEAL_EXIT_WINDOW:
+		return ReadInt(Args, &Options->PlaceExitWindow);
+	case OT_ANNEAL_EXIT_IMPROVEMENT:
+		return ReadFloat(Args, &Options->PlaceExitImprovement);
 	case OT_SEED:
 		return ReadInt(Args, &Options->Seed);
 	case OT_PLACE_COST_EXP:
@@ -435,6 +494,18 @@ ProcessOption(INP char **Args, INOUTP t_options * Options) {
 		return ReadFloat(Args, &Options->place_exp_first);
 	case OT_TD_PLACE_EXP_LAST:
 		return ReadFloat(Args, &Options->place_exp_last);
+	case OT_PLACE_CHECKPOINT:
+		return ReadString(Args, &Options->PlaceCheckpointFile);
+	case OT_PLACE_CHECKPOINT_T:
+		return ReadFloat(Args, &Options->PlaceCheckpointT);
+	case OT_PLACE_RESUME:
+		return ReadString(Args, &Options->PlaceResumeFile);
+	case OT_PLACE_FORK:
+		return ReadInt(Args, &Options->PlaceNumForks);
+	case OT_PLACE_PROFILE:
+		return ReadString(Args, &Options->PlaceProfileFile);
+	case OT_PLACE_DELAY_CACHE:
+		return ReadString(Args, &Options->PlaceDelayCacheFile);
 
 		/* Router Options */
 	case OT_MAX_ROUTER_ITERATIONS:
@@ -475,6 +546,8 @@ ProcessOption(INP char **Args, INOUTP t_options * Options) {
 		return ReadInt(Args, &Options->constant_type);
 	case OT_ROUTING_FAILURE_PREDICTOR:
 		return ReadRoutingPredictor(Args, &Options->routing_failure_predictor);
+	case OT_PLACE_DIE_PARTITION:
+		return ReadOnOff(Args, &Options->place_die_partition);
 #endif
 
 		/* Routing options valid only for timing-driven routing */
@@ -490,6 +563,8 @@ ProcessOption(INP char **Args, INOUTP t_options * Options) {
 		return Args;
 	case OT_ACTIVITY_FILE:
 		return ReadString(Args, &Options->ActFile);
+	case OT_WRITE_ACTIVITY_BINARY:
+		return ReadString(Args, &Options->WriteActBinaryFile);
 	case OT_POWER_OUT_FILE:
 		return ReadString(Args, &Options->PowerFile);
 	case OT_CMOS_TECH_BEHAVIOR_FILE:
@@ -542,6 +617,15 @@ static void MergeOptions(INOUTP t_options * dest, INP t_options * src, int id)
 		case OT_SDC_FILE:
 			dest->SDCFile = src->SDCFile;
 			break;
+		case OT_WRITE_SNAPSHOT:
+			dest->WriteSnapshotFile = src->WriteSnapshotFile;
+			break;
+		case OT_READ_SNAPSHOT:
+			dest->ReadSnapshotFile = src->ReadSnapshotFile;
+			break;
+		case OT_IMPORT_ROUTE:
+			dest->ImportRouteFile = src->ImportRouteFile;
+			break;
 			/* General Options */
 		case OT_NODISP:
 			break;
@@ -567,6 +651,9 @@ static void MergeOptions(INOUTP t_options * dest, INP t_options * src, int id)
 		case OT_CREATE_ECHO_FILE:
 			dest->CreateEchoFile = src->CreateEchoFile;
 			break;
+		case OT_ECHO_COMPRESSION:
+			dest->EchoCompression = src->EchoCompression;
+			break;
 
 			/* Clustering Options */
 		case OT_GLOBAL_CLOCKS:
@@ -616,6 +703,15 @@ static void MergeOptions(INOUTP t_options * dest, INP t_options * src, int id)
 		case OT_PACKER_ALGORITHM:
 			dest->packer_algorithm = src->packer_algorithm;
 			break;
+		case OT_PACK_WORKERS:
+			dest->pack_workers = src->pack_workers;
+			break;
+		case OT_PACK_DETERMINISTIC:
+			dest->pack_deterministic = src->pack_deterministic;
+			break;
+		case OT_PACK_PROFILE:
+			dest->pack_profile = src->pack_profile;
+			break;
 
 			/* Placer Options */
 		case OT_PLACE_ALGORITHM:
@@ -633,6 +729,15 @@ static void MergeOptions(INOUTP t_options * dest, INP t_options * src, int id)
 		case OT_INNER_NUM:
 			dest->PlaceInnerNum = src->PlaceInnerNum;
 			break;
+		case OT_ANNEAL_ADAPTIVE:
+			dest->PlaceAdaptiveAnneal = src->PlaceAdaptiveAnneal;
+			break;
+		case OT_ANNEAL_EXIT_WINDOW:
+			dest->PlaceExitWindow = src->PlaceExitWindow;
+			break;
+		case OT_ANNEAL_EXIT_IMPROVEMENT:
+			dest->PlaceExitImprovement = src->PlaceExitImprovement;
+			break;
 		case OT_SEED:
 			dest->Seed = src->Seed;
 			break;
@@ -668,6 +773,29 @@ static void MergeOptions(INOUTP t_options * dest, INP t_options * src, int id)
 		case OT_TD_PLACE_EXP_LAST:
 			dest->place_exp_last = src->place_exp_last;
 			break;
+		case OT_PLACE_DELAY_CACHE:
+			dest->PlaceDelayCacheFile = src->PlaceDelayCacheFile;
+			break;
+		case OT_PLACE_CHECKPOINT:
+			dest->PlaceCheckpointFile = src->PlaceCheckpointFile;
+			break;
+		case OT_PLACE_CHECKPOINT_T:
+			dest->PlaceCheckpointT = src->PlaceCheckpointT;
+			break;
+		case OT_PLACE_RESUME:
+			dest->PlaceResumeFile = src->PlaceResumeFile;
+			break;
+		case OT_PLACE_FORK:
+			dest->PlaceNumForks = src->PlaceNumForks;
+			break;
+		case OT_PLACE_PROFILE:
+			dest->PlaceProfileFile = src->PlaceProfileFile;
+			break;
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+		case OT_PLACE_DIE_PARTITION:
+			dest->place_die_partition = src->place_die_partition;
+			break;
+#endif
 
 			/* Router Options */
 		case OT_MAX_ROUTER_ITERATIONS:
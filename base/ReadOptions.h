@@ -14,16 +14,21 @@ struct s_options {
 	char *RouteFile;
 	char *BlifFile;
 	char *ActFile;
+	char *WriteActBinaryFile;
 	char *PowerFile;
 	char *CmosTechFile;
 	char *out_file_prefix;
 	char *SDCFile;
+	char *WriteSnapshotFile;
+	char *ReadSnapshotFile;
+	char *ImportRouteFile;
 
 	/* General options */
 	int GraphPause;
 	float constant_net_delay;
 	boolean TimingAnalysis;
 	boolean CreateEchoFile;
+	char *EchoCompression;
 	boolean Generate_Post_Synthesis_Netlist;
 	/* Clustering options */
 	boolean global_clocks;
@@ -45,6 +50,9 @@ struct s_options {
 	boolean allow_early_exit;
 	boolean connection_driven;
 	enum e_packer_algorithm packer_algorithm;
+	int pack_workers;
+	boolean pack_deterministic;
+	boolean pack_profile;
 
 	/* Placement options */
 	enum e_place_algorithm PlaceAlgorithm;
@@ -52,12 +60,20 @@ struct s_options {
 	float PlaceExitT;
 	float PlaceAlphaT;
 	float PlaceInnerNum;
+	boolean PlaceAdaptiveAnneal;
+	int PlaceExitWindow;
+	float PlaceExitImprovement;
 	int Seed;
 	float place_cost_exp;
 	int PlaceChanWidth;
 	char *PinFile;
 	boolean ShowPlaceTiming;
 	int block_dist;
+	char *PlaceCheckpointFile;
+	float PlaceCheckpointT;
+	char *PlaceResumeFile;
+	int PlaceNumForks;
+	char *PlaceProfileFile;
 
 	/* Timing-driven placement options only */
 	float PlaceTimingTradeoff;
@@ -65,6 +81,7 @@ struct s_options {
 	int inner_loop_recompute_divider;
 	float place_exp_first;
 	float place_exp_last;
+	char *PlaceDelayCacheFile;
 
 	/* Router Options */
 	int max_router_iterations;
@@ -86,6 +103,7 @@ struct s_options {
 	float placer_cost_constant;
 	int constant_type;
 	enum e_routing_failure_predictor routing_failure_predictor;
+	boolean place_die_partition;
 #endif
 
 	/* Timing-driven router options only */
@@ -161,6 +179,7 @@ void setEchoEnabled(boolean echo_enabled);
 void setAllEchoFileEnabled(boolean value);
 void setEchoFileEnabled(enum e_echo_files echo_option, boolean value);
 void setEchoFileName(enum e_echo_files echo_option, const char *name);
+void setEchoFileCompression(const char *compression);
 
 boolean isEchoFileEnabled(enum e_echo_files echo_option);
 char *getEchoFileName(enum e_echo_files echo_option);
@@ -158,6 +158,26 @@ void SetupVPR(INP t_options *Options, INP boolean TimingEnabled,
 	FileNameOpts->CmosTechFile = Options->CmosTechFile;
 	FileNameOpts->out_file_prefix = Options->out_file_prefix;
 
+	FileNameOpts->WriteSnapshotFile = NULL; /* DEFAULT */
+	if (Options->Count[OT_WRITE_SNAPSHOT]) {
+		FileNameOpts->WriteSnapshotFile = Options->WriteSnapshotFile;
+	}
+
+	FileNameOpts->ReadSnapshotFile = NULL; /* DEFAULT */
+	if (Options->Count[OT_READ_SNAPSHOT]) {
+		FileNameOpts->ReadSnapshotFile = Options->ReadSnapshotFile;
+	}
+
+	FileNameOpts->ImportRouteFile = NULL; /* DEFAULT */
+	if (Options->Count[OT_IMPORT_ROUTE]) {
+		FileNameOpts->ImportRouteFile = Options->ImportRouteFile;
+	}
+
+	FileNameOpts->WriteActBinaryFile = NULL; /* DEFAULT */
+	if (Options->Count[OT_WRITE_ACTIVITY_BINARY]) {
+		FileNameOpts->WriteActBinaryFile = Options->WriteActBinaryFile;
+	}
+
 	SetupOperation(*Options, Operation);
 	SetupPlacerOpts(*Options, TimingEnabled, PlacerOpts);
 	SetupAnnealSched(*Options, AnnealSched);
@@ -614,6 +634,34 @@ static void SetupAnnealSched(INP t_options Options,
 			|| (Options.Count[OT_INIT_T])) {
 		AnnealSched->type = USER_SCHED;
 	}
+	if (Options.Count[OT_ANNEAL_ADAPTIVE] && Options.PlaceAdaptiveAnneal) {
+		if (AnnealSched->type == USER_SCHED) {
+			vpr_printf(TIO_MESSAGE_ERROR,
+					"anneal_adaptive cannot be combined with init_t, alpha_t or exit_t.\n");
+			exit(1);
+		}
+		AnnealSched->type = ADAPTIVE_SCHED;
+	}
+	AnnealSched->exit_window = 5; /* DEFAULT */
+	if (Options.Count[OT_ANNEAL_EXIT_WINDOW]) {
+		AnnealSched->exit_window = Options.PlaceExitWindow;
+	}
+	if (AnnealSched->exit_window < 1
+			|| AnnealSched->exit_window > MAX_ANNEAL_EXIT_WINDOW) {
+		vpr_printf(TIO_MESSAGE_ERROR,
+				"anneal_exit_window must be between 1 and %d.\n",
+				MAX_ANNEAL_EXIT_WINDOW);
+		exit(1);
+	}
+	AnnealSched->exit_improvement = 0.001; /* DEFAULT */
+	if (Options.Count[OT_ANNEAL_EXIT_IMPROVEMENT]) {
+		AnnealSched->exit_improvement = Options.PlaceExitImprovement;
+	}
+	if (AnnealSched->exit_improvement < 0) {
+		vpr_printf(TIO_MESSAGE_ERROR,
+				"anneal_exit_improvement must be at least 0.\n");
+		exit(1);
+	}
 }
 
 /* Sets up the s_packer_opts structure baesd on users inputs and on the architecture specified.  
@@ -693,8 +741,8 @@ void SetupPackerOpts(INP t_options Options, INP boolean TimingEnabled,
 		PackerOpts->beta = Options.beta;
 	}
 
-	/* never recomputer timing */
-	PackerOpts->recompute_timing_after = MAX_SHORT; /* DEFAULT */
+	/* never recompute timing */
+	PackerOpts->recompute_timing_after = OPEN; /* DEFAULT */
 	if (Options.Count[OT_RECOMPUTE_TIMING_AFTER]) {
 		PackerOpts->recompute_timing_after = Options.recompute_timing_after;
 	}
@@ -717,6 +765,19 @@ void SetupPackerOpts(INP t_options Options, INP boolean TimingEnabled,
 	if (Options.Count[OT_PACKER_ALGORITHM]) {
 		PackerOpts->packer_algorithm = Options.packer_algorithm;
 	}
+
+	PackerOpts->num_workers = 1; /* DEFAULT */
+	if (Options.Count[OT_PACK_WORKERS]) {
+		PackerOpts->num_workers = Options.pack_workers;
+	}
+	PackerOpts->deterministic = TRUE; /* DEFAULT */
+	if (Options.Count[OT_PACK_DETERMINISTIC]) {
+		PackerOpts->deterministic = Options.pack_deterministic;
+	}
+	PackerOpts->profile = FALSE; /* DEFAULT */
+	if (Options.Count[OT_PACK_PROFILE]) {
+		PackerOpts->profile = Options.pack_profile;
+	}
 }
 
 /* Sets up the s_placer_opts structure based on users input. Error checking,
@@ -749,6 +810,43 @@ static void SetupPlacerOpts(INP t_options Options, INP boolean TimingEnabled,
 		PlacerOpts->td_place_exp_last = Options.place_exp_last;
 	}
 
+	PlacerOpts->delay_cache_file = NULL; /* DEFAULT */
+	if (Options.Count[OT_PLACE_DELAY_CACHE]) {
+		PlacerOpts->delay_cache_file = my_strdup(Options.PlaceDelayCacheFile);
+	}
+
+	PlacerOpts->checkpoint_file = NULL; /* DEFAULT */
+	if (Options.Count[OT_PLACE_CHECKPOINT]) {
+		PlacerOpts->checkpoint_file = my_strdup(Options.PlaceCheckpointFile);
+	}
+
+	PlacerOpts->checkpoint_t = -1.; /* DEFAULT */
+	if (Options.Count[OT_PLACE_CHECKPOINT_T]) {
+		PlacerOpts->checkpoint_t = Options.PlaceCheckpointT;
+	}
+
+	PlacerOpts->resume_file = NULL; /* DEFAULT */
+	if (Options.Count[OT_PLACE_RESUME]) {
+		PlacerOpts->resume_file = my_strdup(Options.PlaceResumeFile);
+	}
+
+	PlacerOpts->num_forks = 1; /* DEFAULT */
+	if (Options.Count[OT_PLACE_FORK]) {
+		PlacerOpts->num_forks = Options.PlaceNumForks;
+	}
+
+	PlacerOpts->profile_file = NULL; /* DEFAULT */
+	if (Options.Count[OT_PLACE_PROFILE]) {
+		PlacerOpts->profile_file = my_strdup(Options.PlaceProfileFile);
+	}
+
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+	PlacerOpts->die_partition = FALSE; /* DEFAULT */
+	if (Options.Count[OT_PLACE_DIE_PARTITION]) {
+		PlacerOpts->die_partition = Options.place_die_partition;
+	}
+#endif
+
 	PlacerOpts->place_algorithm = BOUNDING_BOX_PLACE; /* DEFAULT */
 	if (TimingEnabled) {
 		PlacerOpts->place_algorithm = PATH_TIMING_DRIVEN_PLACE; /* DEFAULT */
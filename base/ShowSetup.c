@@ -26,6 +26,18 @@ void ShowSetup(INP t_options options, INP t_vpr_setup vpr_setup) {
 	vpr_printf(TIO_MESSAGE_INFO, "Circuit placement file: %s\n", vpr_setup.FileNameOpts.PlaceFile);
 	vpr_printf(TIO_MESSAGE_INFO, "Circuit routing file: %s\n", vpr_setup.FileNameOpts.RouteFile);
 	vpr_printf(TIO_MESSAGE_INFO, "Circuit SDC file: %s\n", vpr_setup.Timing.SDCFile);
+	if (vpr_setup.FileNameOpts.WriteSnapshotFile) {
+		vpr_printf(TIO_MESSAGE_INFO, "Snapshot written to: %s\n", vpr_setup.FileNameOpts.WriteSnapshotFile);
+	}
+	if (vpr_setup.FileNameOpts.ReadSnapshotFile) {
+		vpr_printf(TIO_MESSAGE_INFO, "Snapshot read from: %s\n", vpr_setup.FileNameOpts.ReadSnapshotFile);
+	}
+	if (vpr_setup.FileNameOpts.ImportRouteFile) {
+		vpr_printf(TIO_MESSAGE_INFO, "Routing imported from: %s\n", vpr_setup.FileNameOpts.ImportRouteFile);
+	}
+	if (vpr_setup.FileNameOpts.WriteActBinaryFile) {
+		vpr_printf(TIO_MESSAGE_INFO, "Binary activity file written to: %s\n", vpr_setup.FileNameOpts.WriteActBinaryFile);
+	}
 
 	ShowOperation(vpr_setup.Operation);
 	vpr_printf(TIO_MESSAGE_INFO, "Packer: %s\n", (vpr_setup.PackerOpts.doPacking ? "ENABLED" : "DISABLED"));
@@ -142,6 +154,9 @@ static void ShowAnnealSched(INP struct s_annealing_sched AnnealSched) {
 	case USER_SCHED:
 		vpr_printf(TIO_MESSAGE_INFO, "USER_SCHED\n");
 		break;
+	case ADAPTIVE_SCHED:
+		vpr_printf(TIO_MESSAGE_INFO, "ADAPTIVE_SCHED\n");
+		break;
 	default:
 		vpr_printf(TIO_MESSAGE_ERROR, "Unknown annealing schedule\n");
 	}
@@ -153,6 +168,10 @@ static void ShowAnnealSched(INP struct s_annealing_sched AnnealSched) {
 		vpr_printf(TIO_MESSAGE_INFO, "AnnealSched.alpha_t: %f\n", AnnealSched.alpha_t);
 		vpr_printf(TIO_MESSAGE_INFO, "AnnealSched.exit_t: %f\n", AnnealSched.exit_t);
 	}
+	if (ADAPTIVE_SCHED == AnnealSched.type) {
+		vpr_printf(TIO_MESSAGE_INFO, "AnnealSched.exit_window: %d\n", AnnealSched.exit_window);
+		vpr_printf(TIO_MESSAGE_INFO, "AnnealSched.exit_improvement: %f\n", AnnealSched.exit_improvement);
+	}
 }
 
 static void ShowRouterOpts(INP struct s_router_opts RouterOpts) {
@@ -357,9 +376,26 @@ static void ShowPlacerOpts(INP t_options Options,
 			vpr_printf(TIO_MESSAGE_INFO, "PlacerOpts.timing_tradeoff: %f\n", PlacerOpts.timing_tradeoff);
 			vpr_printf(TIO_MESSAGE_INFO, "PlacerOpts.td_place_exp_first: %f\n", PlacerOpts.td_place_exp_first);
 			vpr_printf(TIO_MESSAGE_INFO, "PlacerOpts.td_place_exp_last: %f\n", PlacerOpts.td_place_exp_last);
+			if (PlacerOpts.delay_cache_file) {
+				vpr_printf(TIO_MESSAGE_INFO, "PlacerOpts.delay_cache_file: %s\n", PlacerOpts.delay_cache_file);
+			}
 		}
 
 		vpr_printf(TIO_MESSAGE_INFO, "PlaceOpts.seed: %d\n", PlacerOpts.seed);
+		if (PlacerOpts.checkpoint_file) {
+			vpr_printf(TIO_MESSAGE_INFO, "PlacerOpts.checkpoint_file: %s\n", PlacerOpts.checkpoint_file);
+			vpr_printf(TIO_MESSAGE_INFO, "PlacerOpts.checkpoint_t: %f\n", PlacerOpts.checkpoint_t);
+		}
+		if (PlacerOpts.resume_file) {
+			vpr_printf(TIO_MESSAGE_INFO, "PlacerOpts.resume_file: %s\n", PlacerOpts.resume_file);
+			vpr_printf(TIO_MESSAGE_INFO, "PlacerOpts.num_forks: %d\n", PlacerOpts.num_forks);
+		}
+		if (PlacerOpts.profile_file) {
+			vpr_printf(TIO_MESSAGE_INFO, "PlacerOpts.profile_file: %s\n", PlacerOpts.profile_file);
+		}
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+		vpr_printf(TIO_MESSAGE_INFO, "PlacerOpts.die_partition: %s\n", (PlacerOpts.die_partition ? "TRUE" : "FALSE"));
+#endif
 
 		ShowAnnealSched(AnnealSched);
 	}
@@ -389,10 +425,13 @@ static void ShowPackerOpts(INP struct s_packer_opts PackerOpts) {
 		exit(1);
 	}
 	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.connection_driven: %s", (PackerOpts.connection_driven ? "TRUE\n" : "FALSE\n"));
+	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.deterministic: %s", (PackerOpts.deterministic ? "TRUE\n" : "FALSE\n"));
 	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.global_clocks: %s", (PackerOpts.global_clocks ? "TRUE\n" : "FALSE\n"));
 	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.hill_climbing_flag: %s", (PackerOpts.hill_climbing_flag ? "TRUE\n" : "FALSE\n"));
 	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.inter_cluster_net_delay: %f\n", PackerOpts.inter_cluster_net_delay);
 	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.intra_cluster_net_delay: %f\n", PackerOpts.intra_cluster_net_delay);
+	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.num_workers: %d\n", PackerOpts.num_workers);
+	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.profile: %s", (PackerOpts.profile ? "TRUE\n" : "FALSE\n"));
 	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.recompute_timing_after: %d\n", PackerOpts.recompute_timing_after);
 	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.sweep_hanging_nets_and_inputs: %s", (PackerOpts.sweep_hanging_nets_and_inputs ? "TRUE\n" : "FALSE\n"));
 	vpr_printf(TIO_MESSAGE_INFO, "PackerOpts.timing_driven: %s", (PackerOpts.timing_driven ? "TRUE\n" : "FALSE\n"));
@@ -36,7 +36,8 @@ static int check_primitives(int iblk, int isub);
 
 void check_netlist() {
 	int i, error, num_conn;
-	struct s_hash **net_hash_table, *h_net_ptr;
+	struct s_hash_table *net_hash_table;
+	struct s_hash *h_net_ptr;
 
 	/* TODO: Remove the following the function calls after these functions have 
 	 been fleshed and are legitimately used in the code!!! They are called here so that 
@@ -251,9 +252,8 @@ static int check_for_duplicated_names(void) {
 #if 0
 	int iblk, isub, iprim, error;
 	int clb_count, sub_count, prim_count;
-	struct s_hash **clb_hash_table, *clb_h_ptr;
-	struct s_hash **sub_hash_table, *sub_h_ptr;
-	struct s_hash **prim_hash_table, *prim_h_ptr;
+	struct s_hash_table *clb_hash_table, *sub_hash_table, *prim_hash_table;
+	struct s_hash *clb_h_ptr, *sub_h_ptr, *prim_h_ptr;
 
 	clb_hash_table = alloc_hash_table();
 	sub_hash_table = alloc_hash_table();
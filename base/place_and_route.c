@@ -23,6 +23,7 @@
 #include "place_macro.h"
 #include "verilog_writer.h"
 #include "power.h"
+#include "snapshot.h"
 
 /******************* Subroutines local to this module ************************/
 
@@ -46,8 +47,8 @@ void free_pb_data(t_pb *pb);
 
 void place_and_route(enum e_operation operation,
 		struct s_placer_opts placer_opts, char *place_file, char *net_file,
-		char *arch_file, char *route_file,
-		struct s_annealing_sched annealing_sched,
+		char *arch_file, char *route_file, char *snapshot_file,
+		char *import_route_file, struct s_annealing_sched annealing_sched,
 		struct s_router_opts router_opts,
 		struct s_det_routing_arch det_routing_arch, t_segment_inf * segment_inf,
 		t_timing_inf timing_inf, t_chan_width_dist chan_width_dist,
@@ -77,8 +78,10 @@ void place_and_route(enum e_operation operation,
 	}
 
 	if (placer_opts.place_freq == PLACE_NEVER) {
-		/* Read the placement from a file */
-		read_place(place_file, net_file, arch_file, nx, ny, num_blocks, block);
+		/* Read the placement from a file, unless a placed snapshot was read */
+		if (!restore_snapshot_placement()) {
+			read_place(place_file, net_file, arch_file, nx, ny, num_blocks, block);
+		}
 		sync_grid_to_blocks(num_blocks, block, nx, ny, grid);
 	} else {
 		assert(
@@ -87,6 +90,9 @@ void place_and_route(enum e_operation operation,
 		try_place(placer_opts, annealing_sched, chan_width_dist, router_opts,
 				det_routing_arch, segment_inf, timing_inf, directs, num_directs);
 		print_place(place_file, net_file, arch_file);
+		if (snapshot_file) {
+			write_snapshot(snapshot_file, SNAPSHOT_PLACED, arch_file);
+		}
 		end = clock();
 #ifdef CLOCKS_PER_SEC
 		vpr_printf(TIO_MESSAGE_INFO, "Placement took %g seconds.\n", (float)(end - begin) / CLOCKS_PER_SEC);
@@ -132,7 +138,8 @@ void place_and_route(enum e_operation operation,
 
 		success = try_route(width_fac, router_opts, det_routing_arch,
 				segment_inf, timing_inf, net_delay, slacks, chan_width_dist,
-				clb_opins_used_locally, &Fc_clipped, directs, num_directs);
+				clb_opins_used_locally, &Fc_clipped, directs, num_directs,
+				import_route_file);
 
 		if (Fc_clipped) {
 			vpr_printf(TIO_MESSAGE_WARNING, "Fc_output was too high and was clipped to full (maximum) connectivity.\n");
@@ -353,7 +360,8 @@ static int binary_search_place_and_route(struct s_placer_opts placer_opts,
 		}
 		success = try_route(current, router_opts, det_routing_arch, segment_inf,
 				timing_inf, net_delay, slacks, chan_width_dist,
-				clb_opins_used_locally, &Fc_clipped, directs, num_directs);
+				clb_opins_used_locally, &Fc_clipped, directs, num_directs,
+				NULL);
 		attempt_count++;
 		fflush(stdout);
 #if 1
@@ -460,7 +468,8 @@ static int binary_search_place_and_route(struct s_placer_opts placer_opts,
 			}
 			success = try_route(current, router_opts, det_routing_arch,
 					segment_inf, timing_inf, net_delay, slacks,
-					chan_width_dist, clb_opins_used_locally, &Fc_clipped, directs, num_directs);
+					chan_width_dist, clb_opins_used_locally, &Fc_clipped, directs, num_directs,
+					NULL);
 
 			if (success && Fc_clipped == FALSE) {
 				final = current;
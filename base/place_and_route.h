@@ -16,8 +16,8 @@ typedef struct s_fmap_cell {
 
 void place_and_route(enum e_operation operation,
 		struct s_placer_opts placer_opts, char *place_file, char *net_file,
-		char *arch_file, char *route_file,
-		struct s_annealing_sched annealing_sched,
+		char *arch_file, char *route_file, char *snapshot_file,
+		char *import_route_file, struct s_annealing_sched annealing_sched,
 		struct s_router_opts router_opts,
 		struct s_det_routing_arch det_routing_arch, t_segment_inf * segment_inf,
 		t_timing_inf timing_inf, t_chan_width_dist chan_width_dist,
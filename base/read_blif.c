@@ -1,6 +1,14 @@
 #include <string.h>
 #include <stdio.h>
 #include <time.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#endif
 #include "assert.h"
 #include "util.h"
 #include "vpr_types.h"
@@ -19,6 +27,42 @@ struct s_model_stats {
 
 #define MAX_ATOM_PARSE 200000000
 
+#define BLIF_MAX_PARSE_THREADS 16 /* Most threads used to tokenize the blif file */
+#define BLIF_MIN_CHUNK_SIZE 1048576 /* Smallest part of the file given its own thread, in bytes */
+
+/* A binary activity file is ACTIVITY_BINARY_MAGIC, the header ints [byte   *
+ * order, number of nets, checksum of the net names], then a [probability, *
+ * density] float pair for every net in net index order.  The checksum ties *
+ * the file to the netlist it was written from.                            */
+#define ACTIVITY_BINARY_MAGIC "VPRACTB1" /* first 8 bytes of a binary activity file */
+#define ACTIVITY_BINARY_BYTE_ORDER 0x01020304 /* read back differently on a machine of the other endianness */
+#define ACTIVITY_BINARY_HEADER_INTS 3
+
+/* A logical line of the blif file: physical lines joined at '\' continuations,  *
+ * with comments removed.  Its tokens are blif_tokens[first_token..first_token + *
+ * num_tokens - 1], and line_number is the physical line it starts on.           */
+typedef struct s_blif_line {
+	int first_token;
+	int num_tokens;
+	int line_number;
+} t_blif_line;
+
+/* A part of the file, [start..end-1], tokenized on its own thread.  Every chunk *
+ * but the first starts on a .names, .latch or .subckt line that does not        *
+ * continue the line before it, so no logical line spans two chunks.  Line      *
+ * numbers are counted from the start of the chunk until the chunks are merged.  */
+typedef struct s_blif_chunk {
+	char *start;
+	char *end;
+	char **tokens;
+	int num_tokens;
+	int max_tokens;
+	t_blif_line *lines;
+	int num_lines;
+	int max_lines;
+	int num_physical_lines;
+} t_blif_chunk;
+
 /* This source file will read in a FLAT blif netlist consisting     *
  * of .inputs, .outputs, .names and .latch commands.  It currently   *
  * does not handle hierarchical blif files.  Hierarchical            *
@@ -41,13 +85,33 @@ static int num_luts = 0, num_latches = 0, num_subckts = 0;
 
 /* # of .input, .output, .model and .end lines */
 static int ilines, olines, model_lines, endlines;
-static struct s_hash **blif_hash;
+static struct s_hash_table *blif_hash;
 static char *model = NULL;
-static FILE *blif;
+
+/* The blif file is read into memory once (memory-mapped where possible) and  *
+ * split into tokens in place; both parsing passes walk the lines below.      *
+ * blif_tok_next and blif_tok_end bound the tokens of the line being parsed.  */
+static char *blif_text = NULL;
+static size_t blif_text_size = 0;
+static boolean blif_text_is_mapped = FALSE;
+static char **blif_tokens = NULL;
+static int num_blif_tokens = 0;
+static t_blif_line *blif_lines = NULL;
+static int num_blif_lines = 0;
+static int blif_tok_next = 0, blif_tok_end = 0;
 
 static int add_vpack_net(char *ptr, int type, int bnum, int bport, int bpin,
 		boolean is_global, int doall);
-static void get_blif_tok(char *buffer, int doall, boolean *done,
+static double get_blif_wall_seconds(void);
+static void load_blif_text(char *file_name, const char *file_kind);
+static void free_blif_text(void);
+static boolean is_blif_continuation(char *p, char *end);
+static char *find_blif_chunk_start(char *from, char *end);
+static void *tokenize_blif_chunk(void *arg);
+static void tokenize_blif_text(char *blif_file);
+static char *get_blif_line_tok(void);
+static void skip_blif_line(void);
+static void get_blif_tok(int iline, int doall, boolean *done,
 		boolean *add_truth_table, INP t_model* inpad_model,
 		INP t_model* outpad_model, INP t_model* logic_model,
 		INP t_model* latch_model, INP t_model* user_models);
@@ -63,10 +127,16 @@ static void check_and_count_models(int doall, const char* model_name,
 static void load_default_models(INP t_model *library_models,
 		OUTP t_model** inpad_model, OUTP t_model** outpad_model,
 		OUTP t_model** logic_model, OUTP t_model** latch_model);
-static void read_activity(char * activity_file);
+static void read_activity(char * activity_file, char * activity_binary_file);
+static int get_activity_words(char **text, char *end, int *line_number,
+		char **words, int max_words);
+static unsigned int get_net_name_checksum(void);
+static boolean load_binary_activity(char * activity_file);
+static void write_binary_activity(char * activity_binary_file);
 static void read_blif(char *blif_file, boolean sweep_hanging_nets_and_inputs,
 		t_model *user_models, t_model *library_models,
-		boolean read_activity_file, char * activity_file);
+		boolean read_activity_file, char * activity_file,
+		char * activity_binary_file);
 
 static void absorb_buffer_luts(void);
 static void compress_netlist(void);
@@ -76,20 +146,17 @@ static bool add_activity_to_net(char * net_name, float probability,
 
 static void read_blif(char *blif_file, boolean sweep_hanging_nets_and_inputs,
 		t_model *user_models, t_model *library_models,
-		boolean read_activity_file, char * activity_file) {
-	char buffer[BUFSIZE];
-	int doall;
+		boolean read_activity_file, char * activity_file,
+		char * activity_binary_file) {
+	int doall, iline;
 	boolean done;
 	boolean add_truth_table;
 	t_model *inpad_model, *outpad_model, *logic_model, *latch_model;
 	clock_t begin, end;
+	double load_begin;
 
-	blif = fopen(blif_file, "r");
-	if (blif == NULL ) {
-		vpr_printf(TIO_MESSAGE_ERROR, "Failed to open blif file '%s'.\n",
-				blif_file);
-		exit(1);
-	}
+	load_begin = get_blif_wall_seconds();
+	tokenize_blif_text(blif_file);
 	load_default_models(library_models, &inpad_model, &outpad_model,
 			&logic_model, &latch_model);
 
@@ -113,11 +180,10 @@ static void read_blif(char *blif_file, boolean sweep_hanging_nets_and_inputs,
 		done = FALSE;
 		add_truth_table = FALSE;
 		model_lines = 0;
-		while (my_fgets(buffer, BUFSIZE, blif) != NULL ) {
-			get_blif_tok(buffer, doall, &done, &add_truth_table, inpad_model,
+		for (iline = 0; iline < num_blif_lines; iline++) {
+			get_blif_tok(iline, doall, &done, &add_truth_table, inpad_model,
 					outpad_model, logic_model, latch_model, user_models);
 		}
-		rewind(blif); /* Start at beginning of file again */
 
 		end = clock();
 #ifdef CLOCKS_PER_SEC
@@ -134,14 +200,379 @@ static void read_blif(char *blif_file, boolean sweep_hanging_nets_and_inputs,
 	get_hash_stats(blif_hash, "blif_hash");
 #endif
 
-	fclose(blif);
+	free_blif_text();
 	check_net(sweep_hanging_nets_and_inputs);
 
 	/* Read activity file */
 	if (read_activity_file) {
-		read_activity(activity_file);
+		read_activity(activity_file, activity_binary_file);
 	}
 	free_parse();
+
+	vpr_printf(TIO_MESSAGE_INFO, "Loading the blif file took %g seconds.\n",
+			get_blif_wall_seconds() - load_begin);
+}
+
+static double get_blif_wall_seconds(void) {
+
+	/* Wall-clock time, so the threaded tokenizer is not charged for every *
+	 * thread's CPU time.                                                  */
+
+#ifndef _WIN32
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return ((double) now.tv_sec + 1.e-6 * (double) now.tv_usec);
+#else
+	return ((double) clock() / CLOCKS_PER_SEC);
+#endif
+}
+
+static void load_blif_text(char *file_name, const char *file_kind) {
+
+	/* Brings the whole blif (or activity) file into memory with one read.   *
+	 * The file is mapped copy-on-write where mmap is available, so tokens   *
+	 * can be ended in place without touching the file.  A file that does    *
+	 * not end in a newline is read into a buffer instead, so that one can   *
+	 * be added.  file_kind names the file in error messages.                */
+
+	FILE *fp;
+	size_t num_read;
+
+#ifndef _WIN32
+	int fd;
+	struct stat file_stat;
+	void *mapped;
+
+	fd = open(file_name, O_RDONLY);
+	if (fd < 0) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Failed to open %s file '%s'.\n",
+				file_kind, file_name);
+		exit(1);
+	}
+	if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+		mapped = mmap(NULL, (size_t) file_stat.st_size, PROT_READ | PROT_WRITE,
+				MAP_PRIVATE, fd, 0);
+		if (mapped != MAP_FAILED) {
+			if (((char *) mapped)[file_stat.st_size - 1] == '\n') {
+				close(fd);
+				blif_text = (char *) mapped;
+				blif_text_size = (size_t) file_stat.st_size;
+				blif_text_is_mapped = TRUE;
+				return;
+			}
+			munmap(mapped, (size_t) file_stat.st_size);
+		}
+	}
+	close(fd);
+#endif
+
+	fp = fopen(file_name, "rb");
+	if (fp == NULL ) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Failed to open %s file '%s'.\n",
+				file_kind, file_name);
+		exit(1);
+	}
+	fseek(fp, 0, SEEK_END);
+	blif_text_size = (size_t) ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	blif_text = (char *) my_malloc(blif_text_size + 2);
+	num_read = fread(blif_text, 1, blif_text_size, fp);
+	fclose(fp);
+	if (num_read != blif_text_size) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Failed to read %s file '%s'.\n",
+				file_kind, file_name);
+		exit(1);
+	}
+	if (blif_text_size == 0 || blif_text[blif_text_size - 1] != '\n')
+		blif_text[blif_text_size++] = '\n';
+	blif_text[blif_text_size] = '\0';
+	blif_text_is_mapped = FALSE;
+}
+
+static void free_blif_text(void) {
+
+	/* Releases the file contents and the token table; the netlist keeps *
+	 * copies of every name it uses.                                      */
+
+#ifndef _WIN32
+	if (blif_text_is_mapped)
+		munmap(blif_text, blif_text_size);
+	else
+#endif
+		free(blif_text);
+	free(blif_tokens);
+	free(blif_lines);
+	blif_text = NULL;
+	blif_text_size = 0;
+	blif_text_is_mapped = FALSE;
+	blif_tokens = NULL;
+	num_blif_tokens = 0;
+	blif_lines = NULL;
+	num_blif_lines = 0;
+}
+
+static boolean is_blif_continuation(char *p, char *end) {
+
+	/* TRUE if the '\' at p ends its physical line, joining the next one. */
+
+	p++;
+	if (p < end && *p == '\r')
+		p++;
+	return ((boolean) (p < end && *p == '\n'));
+}
+
+static char *find_blif_chunk_start(char *from, char *end) {
+
+	/* Returns the first line after from that starts a .names, .latch or     *
+	 * .subckt and does not continue the line before it, or end if none.     *
+	 * Truth-table lines always stay in the chunk of their .names.           */
+
+	char *p, *newline, *last;
+
+	p = from;
+	while (p < end) {
+		newline = (char *) memchr(p, '\n', end - p);
+		if (newline == NULL )
+			return end;
+		last = newline;
+		if (last > blif_text && last[-1] == '\r')
+			last--;
+		p = newline + 1;
+		if (last > blif_text && last[-1] == '\\')
+			continue;
+		if ((end - p > 7 && strncmp(p, ".names", 6) == 0
+				&& (p[6] == ' ' || p[6] == '\t'))
+				|| (end - p > 7 && strncmp(p, ".latch", 6) == 0
+						&& (p[6] == ' ' || p[6] == '\t'))
+				|| (end - p > 8 && strncmp(p, ".subckt", 7) == 0
+						&& (p[7] == ' ' || p[7] == '\t')))
+			return p;
+	}
+	return end;
+}
+
+static void *tokenize_blif_chunk(void *arg) {
+
+	/* Splits one chunk into NUL-terminated tokens in place and groups them *
+	 * into logical lines.  Follows the rules of my_fgets and my_strtok: a  *
+	 * '#' comments out the rest of its physical line, a '\' at the end of  *
+	 * a line continues it, and '\r' is white space.  On .subckt lines '='  *
+	 * separates tokens too, as add_subckt expects.                          */
+
+	t_blif_chunk *chunk;
+	char *p, *tok, sep;
+	boolean in_line, split_on_equals;
+	t_blif_line *line;
+
+	chunk = (t_blif_chunk *) arg;
+	chunk->max_tokens = (int) ((chunk->end - chunk->start) / 8) + 16;
+	chunk->tokens = (char **) my_malloc(chunk->max_tokens * sizeof(char *));
+	chunk->max_lines = (int) ((chunk->end - chunk->start) / 32) + 16;
+	chunk->lines = (t_blif_line *) my_malloc(
+			chunk->max_lines * sizeof(t_blif_line));
+	chunk->num_tokens = 0;
+	chunk->num_lines = 0;
+	chunk->num_physical_lines = 0;
+
+	in_line = FALSE;
+	split_on_equals = FALSE;
+	p = chunk->start;
+	while (p < chunk->end) {
+		sep = *p;
+		if (sep == '\n') {
+			in_line = FALSE;
+			chunk->num_physical_lines++;
+			p++;
+			continue;
+		}
+		if (sep == ' ' || sep == '\t' || sep == '\r'
+				|| (sep == '=' && split_on_equals)) {
+			p++;
+			continue;
+		}
+		if (sep == '#') {
+			p = (char *) memchr(p, '\n', chunk->end - p);
+			continue; /* Every chunk ends in a newline, so p is never NULL */
+		}
+		if (sep == '\\' && is_blif_continuation(p, chunk->end)) {
+			p = (char *) memchr(p, '\n', chunk->end - p) + 1;
+			chunk->num_physical_lines++;
+			continue;
+		}
+
+		/* Start of a token: find its end */
+		tok = p;
+		while (*p != ' ' && *p != '\t' && *p != '\r' && *p != '\n' && *p != '#'
+				&& !(*p == '=' && split_on_equals)
+				&& !(*p == '\\' && is_blif_continuation(p, chunk->end)))
+			p++;
+		sep = *p;
+		*p = '\0';
+
+		if (!in_line) {
+			if (chunk->num_lines == chunk->max_lines) {
+				chunk->max_lines *= 2;
+				chunk->lines = (t_blif_line *) my_realloc(chunk->lines,
+						chunk->max_lines * sizeof(t_blif_line));
+			}
+			line = &chunk->lines[chunk->num_lines++];
+			line->first_token = chunk->num_tokens;
+			line->num_tokens = 0;
+			line->line_number = chunk->num_physical_lines + 1;
+			split_on_equals = (boolean) (strcmp(tok, ".subckt") == 0);
+			in_line = TRUE;
+		}
+		if (chunk->num_tokens == chunk->max_tokens) {
+			chunk->max_tokens *= 2;
+			chunk->tokens = (char **) my_realloc(chunk->tokens,
+					chunk->max_tokens * sizeof(char *));
+		}
+		chunk->tokens[chunk->num_tokens++] = tok;
+		chunk->lines[chunk->num_lines - 1].num_tokens++;
+
+		/* Act on the separator that was overwritten */
+		if (sep == '\n') {
+			in_line = FALSE;
+			chunk->num_physical_lines++;
+			p++;
+		} else if (sep == '#') {
+			p = (char *) memchr(p + 1, '\n', chunk->end - p - 1);
+		} else if (sep == '\\') {
+			p = (char *) memchr(p + 1, '\n', chunk->end - p - 1) + 1;
+			chunk->num_physical_lines++;
+		} else {
+			p++;
+		}
+	}
+	return NULL ;
+}
+
+static void tokenize_blif_text(char *blif_file) {
+
+	/* Loads the blif file and builds the token table both parsing passes  *
+	 * read.  Large files are cut into one chunk per processor at model    *
+	 * element boundaries and the chunks are tokenized in parallel, then   *
+	 * merged in file order so line numbers and parse order are unchanged. */
+
+	t_blif_chunk *chunks;
+	int num_chunks, max_chunks, ichunk, iline, token_offset, line_offset;
+	char *end, *cut;
+	double begin;
+#ifndef _WIN32
+	pthread_t *threads;
+	boolean *is_threaded;
+	long num_cpus;
+#endif
+
+	begin = get_blif_wall_seconds();
+	load_blif_text(blif_file, "blif");
+	end = blif_text + blif_text_size;
+
+	max_chunks = 1;
+#ifndef _WIN32
+	num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (num_cpus > BLIF_MAX_PARSE_THREADS)
+		max_chunks = BLIF_MAX_PARSE_THREADS;
+	else if (num_cpus > 1)
+		max_chunks = (int) num_cpus;
+#endif
+	if ((size_t) max_chunks * BLIF_MIN_CHUNK_SIZE > blif_text_size)
+		max_chunks = (int) (blif_text_size / BLIF_MIN_CHUNK_SIZE);
+	if (max_chunks < 1)
+		max_chunks = 1;
+
+	chunks = (t_blif_chunk *) my_calloc(max_chunks, sizeof(t_blif_chunk));
+	num_chunks = 0;
+	chunks[0].start = blif_text;
+	for (ichunk = 1; ichunk < max_chunks; ichunk++) {
+		cut = blif_text + (blif_text_size / max_chunks) * ichunk;
+		if (cut < chunks[num_chunks].start)
+			cut = chunks[num_chunks].start;
+		cut = find_blif_chunk_start(cut, end);
+		if (cut == end)
+			break;
+		chunks[num_chunks].end = cut;
+		num_chunks++;
+		chunks[num_chunks].start = cut;
+	}
+	chunks[num_chunks].end = end;
+	num_chunks++;
+
+#ifndef _WIN32
+	/* Chunk 0 is tokenized on this thread; any thread that cannot be *
+	 * started just leaves its chunk to be done here too.             */
+	threads = (pthread_t *) my_malloc(num_chunks * sizeof(pthread_t));
+	is_threaded = (boolean *) my_calloc(num_chunks, sizeof(boolean));
+	for (ichunk = 1; ichunk < num_chunks; ichunk++) {
+		is_threaded[ichunk] = (boolean) (pthread_create(&threads[ichunk], NULL,
+				tokenize_blif_chunk, &chunks[ichunk]) == 0);
+	}
+	tokenize_blif_chunk(&chunks[0]);
+	for (ichunk = 1; ichunk < num_chunks; ichunk++) {
+		if (is_threaded[ichunk])
+			pthread_join(threads[ichunk], NULL);
+		else
+			tokenize_blif_chunk(&chunks[ichunk]);
+	}
+	free(threads);
+	free(is_threaded);
+#else
+	for (ichunk = 0; ichunk < num_chunks; ichunk++)
+		tokenize_blif_chunk(&chunks[ichunk]);
+#endif
+
+	/* Merge the chunks in file order */
+	num_blif_tokens = 0;
+	num_blif_lines = 0;
+	for (ichunk = 0; ichunk < num_chunks; ichunk++) {
+		num_blif_tokens += chunks[ichunk].num_tokens;
+		num_blif_lines += chunks[ichunk].num_lines;
+	}
+	blif_tokens = (char **) my_malloc((num_blif_tokens + 1) * sizeof(char *));
+	blif_lines = (t_blif_line *) my_malloc(
+			(num_blif_lines + 1) * sizeof(t_blif_line));
+	token_offset = 0;
+	line_offset = 0;
+	num_blif_lines = 0;
+	for (ichunk = 0; ichunk < num_chunks; ichunk++) {
+		memcpy(blif_tokens + token_offset, chunks[ichunk].tokens,
+				chunks[ichunk].num_tokens * sizeof(char *));
+		for (iline = 0; iline < chunks[ichunk].num_lines; iline++) {
+			blif_lines[num_blif_lines] = chunks[ichunk].lines[iline];
+			blif_lines[num_blif_lines].first_token += token_offset;
+			blif_lines[num_blif_lines].line_number += line_offset;
+			num_blif_lines++;
+		}
+		token_offset += chunks[ichunk].num_tokens;
+		line_offset += chunks[ichunk].num_physical_lines;
+		free(chunks[ichunk].tokens);
+		free(chunks[ichunk].lines);
+	}
+	free(chunks);
+
+	vpr_printf(TIO_MESSAGE_INFO,
+			"Tokenized blif file '%s' (%.1f MB, %d lines, %d tokens) in %d chunk%s, %g seconds.\n",
+			blif_file, (double) blif_text_size / 1048576., line_offset,
+			num_blif_tokens, num_chunks, (num_chunks == 1 ? "" : "s"),
+			get_blif_wall_seconds() - begin);
+}
+
+static char *get_blif_line_tok(void) {
+
+	/* Returns the next token of the line being parsed, or NULL at its end. */
+
+	if (blif_tok_next >= blif_tok_end)
+		return NULL ;
+	return blif_tokens[blif_tok_next++];
+}
+
+static void skip_blif_line(void) {
+
+	/* Skips the rest of the line being parsed. */
+
+	blif_tok_next = blif_tok_end;
 }
 
 static void init_parse(int doall) {
@@ -150,11 +581,11 @@ static void init_parse(int doall) {
 
 	int i;
 	struct s_hash *h_ptr;
+	struct s_hash_iterator hash_iter;
 
 	if (!doall) { /* Initialization before first (counting) pass */
 		num_logical_nets = 0;
-		blif_hash = (struct s_hash **) my_calloc(sizeof(struct s_hash *),
-				HASHSIZE);
+		blif_hash = alloc_hash_table();
 	}
 	/* Allocate memory for second (load) pass */
 	else {
@@ -184,21 +615,18 @@ static void init_parse(int doall) {
 			logical_block[i].index = i;
 		}
 
-		for (i = 0; i < HASHSIZE; i++) {
-			h_ptr = blif_hash[i];
-			while (h_ptr != NULL ) {
-				vpack_net[h_ptr->index].node_block = (int *) my_malloc(
-						h_ptr->count * sizeof(int));
-				vpack_net[h_ptr->index].node_block_port = (int *) my_malloc(
-						h_ptr->count * sizeof(int));
-				vpack_net[h_ptr->index].node_block_pin = (int *) my_malloc(
-						h_ptr->count * sizeof(int));
-
-				/* For avoiding assigning values beyond end of pins array. */
-				temp_num_pins[h_ptr->index] = h_ptr->count;
-				vpack_net[h_ptr->index].name = my_strdup(h_ptr->name);
-				h_ptr = h_ptr->next;
-			}
+		hash_iter = start_hash_table_iterator();
+		while ((h_ptr = get_next_hash(blif_hash, &hash_iter)) != NULL ) {
+			vpack_net[h_ptr->index].node_block = (int *) my_malloc(
+					h_ptr->count * sizeof(int));
+			vpack_net[h_ptr->index].node_block_port = (int *) my_malloc(
+					h_ptr->count * sizeof(int));
+			vpack_net[h_ptr->index].node_block_pin = (int *) my_malloc(
+					h_ptr->count * sizeof(int));
+
+			/* For avoiding assigning values beyond end of pins array. */
+			temp_num_pins[h_ptr->index] = h_ptr->count;
+			vpack_net[h_ptr->index].name = my_strdup(h_ptr->name);
 		}
 #ifdef PRINT_PIN_NETS
 		vpr_printf(TIO_MESSAGE_INFO, "i\ttemp_num_pins\n");
@@ -224,20 +652,23 @@ static void init_parse(int doall) {
 	num_subckts = 0;
 }
 
-static void get_blif_tok(char *buffer, int doall, boolean *done,
+static void get_blif_tok(int iline, int doall, boolean *done,
 		boolean *add_truth_table, INP t_model* inpad_model,
 		INP t_model* outpad_model, INP t_model* logic_model,
 		INP t_model* latch_model, INP t_model* user_models) {
 
-	/* Figures out which, if any token is at the start of this line and *
-	 * takes the appropriate action.                                    */
+	/* Figures out which, if any token is at the start of line iline and *
+	 * takes the appropriate action.                                      */
 
-#define BLIF_TOKENS " \t\n"
 	char *ptr;
 	char *fn;
 	struct s_linked_vptr *data;
 
-	ptr = my_strtok(buffer, TOKENS, blif, buffer);
+	blif_tok_next = blif_lines[iline].first_token;
+	blif_tok_end = blif_tok_next + blif_lines[iline].num_tokens;
+	file_line_number = blif_lines[iline].line_number;
+
+	ptr = get_blif_line_tok();
 	if (ptr == NULL )
 		return;
 
@@ -246,7 +677,7 @@ static void get_blif_tok(char *buffer, int doall, boolean *done,
 			data = (struct s_linked_vptr*) my_malloc(
 					sizeof(struct s_linked_vptr));
 			fn = ptr;
-			ptr = my_strtok(NULL, BLIF_TOKENS, blif, buffer);
+			ptr = get_blif_line_tok();
 			if (!ptr || strlen(ptr) != 1) {
 				if (strlen(fn) == 1) {
 					/* constant generator */
@@ -284,7 +715,7 @@ static void get_blif_tok(char *buffer, int doall, boolean *done,
 
 	if (strcmp(ptr, ".model") == 0) {
 		*add_truth_table = FALSE;
-		ptr = my_strtok(NULL, TOKENS, blif, buffer);
+		ptr = get_blif_line_tok();
 		if (doall) {
 			if (ptr != NULL ) {
 				if(model != NULL) {
@@ -307,7 +738,7 @@ static void get_blif_tok(char *buffer, int doall, boolean *done,
 		if (model_lines > 0) {
 			check_and_count_models(doall, ptr, user_models);
 		} else {
-			dum_parse(buffer);
+			skip_blif_line();
 		}
 		model_lines++;
 		return;
@@ -355,14 +786,6 @@ static void get_blif_tok(char *buffer, int doall, boolean *done,
 
 }
 
-void dum_parse(char *buf) {
-
-	/* Continue parsing to the end of this (possibly continued) line. */
-
-	while (my_strtok(NULL, TOKENS, blif, buf) != NULL )
-		;
-}
-
 static boolean add_lut(int doall, t_model *logic_model) {
 
 	/* Adds a LUT as VPACK_COMB from (.names) currently being parsed to the logical_block array.  Adds *
@@ -370,17 +793,18 @@ static boolean add_lut(int doall, t_model *logic_model) {
 	 * zero this is a counting pass; if it is 1 this is the final (loading) *
 	 * pass.                                                                */
 
-	char *ptr, **saved_names, buf[BUFSIZE];
+	char *ptr, **saved_names;
 	int i, j, output_net_index;
 
-	saved_names = (char**) alloc_matrix(0, logic_model->inputs->size, 0,
-			BUFSIZE - 1, sizeof(char));
+	/* The names point into the token table, which outlives both passes */
+	saved_names = (char **) my_malloc(
+			(logic_model->inputs->size + 1) * sizeof(char *));
 
 	num_logical_blocks++;
 
 	/* Count # nets connecting */
 	i = 0;
-	while ((ptr = my_strtok(NULL, TOKENS, blif, buf)) != NULL ) {
+	while ((ptr = get_blif_line_tok()) != NULL ) {
 		if (i > logic_model->inputs->size) {
 			vpr_printf(TIO_MESSAGE_ERROR,
 					"[LINE %d] .names %s ... %s has a LUT size that exceeds the maximum LUT size (%d) of the architecture.\n",
@@ -388,13 +812,13 @@ static boolean add_lut(int doall, t_model *logic_model) {
 					logic_model->inputs->size);
 			exit(1);
 		}
-		strcpy(saved_names[i], ptr);
+		saved_names[i] = ptr;
 		i++;
 	}
 	output_net_index = i - 1;
 	if (strcmp(saved_names[output_net_index], "unconn") == 0) {
 		/* unconn is a keyword to pad unused pins, ignore this block */
-		free_matrix(saved_names, 0, logic_model->inputs->size, 0, sizeof(char));
+		free(saved_names);
 		num_logical_blocks--;
 		return FALSE;
 	}
@@ -404,7 +828,7 @@ static boolean add_lut(int doall, t_model *logic_model) {
 			/* On this pass it doesn't matter if RECEIVER or DRIVER.  Just checking if in hash.  [0] should be DRIVER */
 			add_vpack_net(saved_names[j], RECEIVER, num_logical_blocks - 1, 0,
 					j, FALSE, doall);
-		free_matrix(saved_names, 0, logic_model->inputs->size, 0, sizeof(char));
+		free(saved_names);
 		return FALSE;
 	}
 
@@ -448,7 +872,7 @@ static boolean add_lut(int doall, t_model *logic_model) {
 	logical_block[num_logical_blocks - 1].truth_table = NULL;
 	num_luts++;
 
-	free_matrix(saved_names, 0, logic_model->inputs->size, 0, sizeof(char));
+	free(saved_names);
 	return (boolean) doall;
 }
 
@@ -461,19 +885,19 @@ static void add_latch(int doall, INP t_model *latch_model) {
 	 * .latch <input> <output> <type (latch on)> <control (clock)> <init_val> *
 	 * The latch pins are in .nets 0 to 2 in the order: Q D CLOCK.            */
 
-	char *ptr, buf[BUFSIZE], saved_names[6][BUFSIZE];
+	char *ptr, *saved_names[6];
 	int i;
 
 	num_logical_blocks++;
 
 	/* Count # parameters, making sure we don't go over 6 (avoids memory corr.) */
-	/* Note that we can't rely on the tokens being around unless we copy them.  */
+	/* The tokens stay in the token table, so pointers to them are enough.   */
 
 	for (i = 0; i < 6; i++) {
-		ptr = my_strtok(NULL, TOKENS, blif, buf);
+		ptr = get_blif_line_tok();
 		if (ptr == NULL )
 			break;
-		strcpy(saved_names[i], ptr);
+		saved_names[i] = ptr;
 	}
 
 	if (i != 5) {
@@ -523,9 +947,7 @@ static void add_latch(int doall, INP t_model *latch_model) {
 static void add_subckt(int doall, t_model *user_models) {
 	char *ptr;
 	char *close_bracket;
-	char subckt_name[BUFSIZE];
-	char buf[BUFSIZE];
-	//fpos_t current_subckt_pos;
+	char *subckt_name;
 	int i, j, iparse;
 	int subckt_index_signals = 0;
 	char **subckt_signal_name = NULL;
@@ -543,20 +965,27 @@ static void add_subckt(int doall, t_model *user_models) {
 
 	/* now we have to find the matching subckt */
 	/* find the name we are looking for */
-	strcpy(subckt_name, my_strtok(NULL, TOKENS, blif, buf));
+	subckt_name = get_blif_line_tok();
+	if (subckt_name == NULL ) {
+		vpr_printf(TIO_MESSAGE_ERROR, "[LINE %d] .subckt has no model name.\n",
+				file_line_number);
+		exit(1);
+	}
 	/* get all the signals in the form z=r */
 	iparse = 0;
 	while (iparse < MAX_ATOM_PARSE) {
 		iparse++;
-		/* Assumption is that it will be "signal1, =, signal1b, spacing, and repeat" */
-		ptr = my_strtok(NULL, " \t\n=", blif, buf);
+		/* Assumption is that it will be "signal1, =, signal1b, spacing, and repeat"; *
+		 * the tokenizer already splits .subckt lines at '='.                         */
+		ptr = get_blif_line_tok();
 
 		if (ptr == NULL && toggle == 0)
 			break;
 		else if (ptr == NULL && toggle == 1) {
 			vpr_printf(TIO_MESSAGE_ERROR,
-					"subckt %s formed incorrectly with signal=signal at %s.\n",
-					subckt_name, buf);
+					"[LINE %d] subckt %s formed incorrectly with signal=signal at %s.\n",
+					file_line_number, subckt_name,
+					subckt_signal_name[subckt_index_signals]);
 			exit(-1);
 		} else if (toggle == 0) {
 			/* ELSE - parse in one or the other */
@@ -584,11 +1013,6 @@ static void add_subckt(int doall, t_model *user_models) {
 		}
 	}
 	assert(iparse < MAX_ATOM_PARSE);
-	/* record the position of the parse so far so when we resume we will move to the next item */
-	//if (fgetpos(blif, &current_subckt_pos) != 0) {
-	//	vpr_printf(TIO_MESSAGE_ERROR, "In file pointer read - read_blif.c\n");
-	//	exit(-1);
-	//}
 	input_net_count = 0;
 	output_net_count = 0;
 
@@ -767,12 +1191,6 @@ static void add_subckt(int doall, t_model *user_models) {
 	}
 	free(subckt_signal_name);
 	free(circuit_signal_name);
-
-	/* now that you've done the analysis, move the file pointer back */
-	//if (fsetpos(blif, &current_subckt_pos) != 0) {
-	//	vpr_printf(TIO_MESSAGE_ERROR, "In moving back file pointer - read_blif.c\n");
-	//	exit(-1);
-	//}
 }
 
 static void io_line(int in_or_out, int doall, t_model *io_model) {
@@ -783,13 +1201,12 @@ static void io_line(int in_or_out, int doall, t_model *io_model) {
 	 * first pass when hash table is built and pins, nets, etc. are counted. */
 
 	char *ptr;
-	char buf2[BUFSIZE];
 	int nindex, len, iparse;
 
 	iparse = 0;
 	while (iparse < MAX_ATOM_PARSE) {
 		iparse++;
-		ptr = my_strtok(NULL, TOKENS, blif, buf2);
+		ptr = get_blif_line_tok();
 		if (ptr == NULL )
 			return;
 		num_logical_blocks++;
@@ -845,18 +1262,10 @@ static void io_line(int in_or_out, int doall, t_model *io_model) {
 
 static void check_and_count_models(int doall, const char* model_name,
 		t_model *user_models) {
-	fpos_t start_pos;
 	t_model *user_model;
 
 	num_blif_models++;
 	if (doall) {
-		/* get start position to do two passes on model */
-		if (fgetpos(blif, &start_pos) != 0) {
-			vpr_printf(TIO_MESSAGE_ERROR,
-					"in file pointer read - read_blif.c\n");
-			exit(-1);
-		}
-
 		/* get corresponding architecture model */
 		user_model = user_models;
 		while (user_model) {
@@ -886,8 +1295,8 @@ static int add_vpack_net(char *ptr, int type, int bnum, int bport, int bpin,
 	 * returns the vpack_net number so the calling routine can update the logical_block  *
 	 * data structure.                                                     */
 
-	struct s_hash *h_ptr, *prev_ptr;
-	int index, j, nindex;
+	struct s_hash *h_ptr;
+	int j, nindex;
 
 	if (strcmp(ptr, "open") == 0) {
 		vpr_printf(TIO_MESSAGE_ERROR,
@@ -898,83 +1307,59 @@ static int add_vpack_net(char *ptr, int type, int bnum, int bport, int bpin,
 	if (strcmp(ptr, "unconn") == 0) {
 		return OPEN;
 	}
-	index = hash_value(ptr);
 
-	if (doall) {
-		if (type == RECEIVER && !is_global) {
-			logical_block_input_count[bnum]++;
-		} else if (type == DRIVER) {
-			logical_block_output_count[bnum]++;
-		}
+	if (!doall) {
+		/* Counting pass only: a new vpack_net is added with one pin, a known *
+		 * one gets one more pin.                                              */
+		h_ptr = insert_in_hash_table(blif_hash, ptr, num_logical_nets);
+		if (h_ptr->count == 1)
+			num_logical_nets++;
+		return (h_ptr->index);
 	}
 
-	h_ptr = blif_hash[index];
-	prev_ptr = h_ptr;
-
-	while (h_ptr != NULL ) {
-		if (strcmp(h_ptr->name, ptr) == 0) { /* Net already in hash table */
-			nindex = h_ptr->index;
-
-			if (!doall) { /* Counting pass only */
-				(h_ptr->count)++;
-				return (nindex);
-			}
-
-			if (type == DRIVER) {
-				num_driver[nindex]++;
-				j = 0; /* Driver always in position 0 of pinlist */
-			} else {
-				vpack_net[nindex].num_sinks++;
-				if ((num_driver[nindex] < 0) || (num_driver[nindex] > 1)) {
-					vpr_printf(TIO_MESSAGE_ERROR,
-							"Number of drivers for net #%d (%s) has %d drivers.\n",
-							nindex, ptr, num_driver[index]);
-				}
-				j = vpack_net[nindex].num_sinks;
-
-				/* num_driver is the number of signal drivers of this vpack_net. *
-				 * should always be zero or 1 unless the netlist is bad.   */
-				if ((vpack_net[nindex].num_sinks - num_driver[nindex])
-						>= temp_num_pins[nindex]) {
-					vpr_printf(TIO_MESSAGE_ERROR,
-							"Net #%d (%s) has no driver and will cause memory corruption.\n",
-							nindex, ptr);
-					exit(1);
-				}
-			}
-			vpack_net[nindex].node_block[j] = bnum;
-			vpack_net[nindex].node_block_port[j] = bport;
-			vpack_net[nindex].node_block_pin[j] = bpin;
-			vpack_net[nindex].is_global = is_global;
-			return (nindex);
-		}
-		prev_ptr = h_ptr;
-		h_ptr = h_ptr->next;
+	if (type == RECEIVER && !is_global) {
+		logical_block_input_count[bnum]++;
+	} else if (type == DRIVER) {
+		logical_block_output_count[bnum]++;
 	}
 
-	/* Net was not in the hash table. */
-
-	if (doall == 1) {
+	h_ptr = get_hash_entry(blif_hash, ptr);
+	if (h_ptr == NULL ) {
+		/* Only the counting pass adds nets to the symbol table. */
 		vpr_printf(TIO_MESSAGE_ERROR,
 				"in add_vpack_net: The second (load) pass could not find vpack_net %s in the symbol table.\n",
 				ptr);
 		exit(1);
 	}
+	nindex = h_ptr->index;
 
-	/* Add the vpack_net (only counting pass will add nets to symbol table). */
-
-	num_logical_nets++;
-	h_ptr = (struct s_hash *) my_malloc(sizeof(struct s_hash));
-	if (prev_ptr == NULL ) {
-		blif_hash[index] = h_ptr;
+	if (type == DRIVER) {
+		num_driver[nindex]++;
+		j = 0; /* Driver always in position 0 of pinlist */
 	} else {
-		prev_ptr->next = h_ptr;
+		vpack_net[nindex].num_sinks++;
+		if ((num_driver[nindex] < 0) || (num_driver[nindex] > 1)) {
+			vpr_printf(TIO_MESSAGE_ERROR,
+					"Number of drivers for net #%d (%s) has %d drivers.\n",
+					nindex, ptr, num_driver[nindex]);
+		}
+		j = vpack_net[nindex].num_sinks;
+
+		/* num_driver is the number of signal drivers of this vpack_net. *
+		 * should always be zero or 1 unless the netlist is bad.   */
+		if ((vpack_net[nindex].num_sinks - num_driver[nindex])
+				>= temp_num_pins[nindex]) {
+			vpr_printf(TIO_MESSAGE_ERROR,
+					"Net #%d (%s) has no driver and will cause memory corruption.\n",
+					nindex, ptr);
+			exit(1);
+		}
 	}
-	h_ptr->next = NULL;
-	h_ptr->index = num_logical_nets - 1;
-	h_ptr->count = 1;
-	h_ptr->name = my_strdup(ptr);
-	return (h_ptr->index);
+	vpack_net[nindex].node_block[j] = bnum;
+	vpack_net[nindex].node_block_port[j] = bport;
+	vpack_net[nindex].node_block_pin[j] = bpin;
+	vpack_net[nindex].is_global = is_global;
+	return (nindex);
 }
 
 void echo_input(char *blif_file, char *echo_file, t_model *library_models) {
@@ -1483,20 +1868,8 @@ static void free_parse(void) {
 
 	/* Release memory needed only during blif network parsing. */
 
-	int i;
-	struct s_hash *h_ptr, *temp_ptr;
-
-	for (i = 0; i < HASHSIZE; i++) {
-		h_ptr = blif_hash[i];
-		while (h_ptr != NULL ) {
-			free((void *) h_ptr->name);
-			temp_ptr = h_ptr->next;
-			free((void *) h_ptr);
-			h_ptr = temp_ptr;
-		}
-	}
+	free_hash_table(blif_hash);
 	free((void *) num_driver);
-	free((void *) blif_hash);
 	free((void *) temp_num_pins);
 }
 
@@ -1764,11 +2137,13 @@ static void compress_netlist(void) {
  */
 void read_and_process_blif(char *blif_file,
 		boolean sweep_hanging_nets_and_inputs, t_model *user_models,
-		t_model *library_models, boolean read_activity_file, char * activity_file) {
+		t_model *library_models, boolean read_activity_file, char * activity_file,
+		char * activity_binary_file) {
 
 	/* begin parsing blif input file */
 	read_blif(blif_file, sweep_hanging_nets_and_inputs, user_models,
-			library_models, read_activity_file, activity_file);
+			library_models, read_activity_file, activity_file,
+			activity_binary_file);
 
 	/* TODO: Do check blif here 
 	 eg. 
@@ -1898,22 +2273,27 @@ static void show_blif_stats(t_model *user_models, t_model *library_models) {
 	free(num_lut_of_size);
 }
 
-static void read_activity(char * activity_file) {
-	int net_idx;
-	bool fail;
-	char buf[BUFSIZE];
-	char * ptr;
-	char * word1;
-	char * word2;
-	char * word3;
+static void read_activity(char * activity_file, char * activity_binary_file) {
+
+	/* Reads the switching activity of every net, either from a text file  *
+	 * of "net probability density" lines or from a binary activity file   *
+	 * written by an earlier run for the same netlist.  The file is loaded *
+	 * like the blif file and split into words in place; net names are     *
+	 * found through blif_hash, so nothing is copied per line.             */
 
-	FILE * act_file_hdl;
+	int net_idx, line_number, word_line, num_words;
+	bool fail;
+	boolean is_binary;
+	char *words[3];
+	char *text, *end;
+	double begin;
 
 	if (num_logical_nets == 0) {
 		printf("Error reading activity file.  Must read netlist first\n");
 		exit(-1);
 	}
 
+	begin = get_blif_wall_seconds();
 	for (net_idx = 0; net_idx < num_logical_nets; net_idx++) {
 		if (!vpack_net[net_idx].net_power) {
 			vpack_net[net_idx].net_power = new t_net_power;
@@ -1922,24 +2302,35 @@ static void read_activity(char * activity_file) {
 		vpack_net[net_idx].net_power->density = -1.0;
 	}
 
-	act_file_hdl = my_fopen(activity_file, "r", FALSE);
-	if (act_file_hdl == NULL ) {
-		printf("Error: could not open activity file: %s\n", activity_file);
-		exit(-1);
-	}
-
-	fail = FALSE;
-	ptr = my_fgets(buf, BUFSIZE, act_file_hdl);
-	while (ptr != NULL ) {
-		word1 = strtok(buf, TOKENS);
-		word2 = strtok(NULL, TOKENS);
-		word3 = strtok(NULL, TOKENS);
-		//printf("word1:%s|word2:%s|word3:%s\n", word1, word2, word3);
-		fail |= add_activity_to_net(word1, atof(word2), atof(word3));
+	load_blif_text(activity_file, "activity");
+	end = blif_text + blif_text_size;
 
-		ptr = my_fgets(buf, BUFSIZE, act_file_hdl);
+	is_binary = (boolean) (blif_text_size >= strlen(ACTIVITY_BINARY_MAGIC)
+			&& strncmp(blif_text, ACTIVITY_BINARY_MAGIC,
+					strlen(ACTIVITY_BINARY_MAGIC)) == 0);
+	if (is_binary) {
+		fail = (bool) load_binary_activity(activity_file);
+	} else {
+		fail = FALSE;
+		text = blif_text;
+		line_number = 1;
+		while (text < end) {
+			word_line = line_number;
+			num_words = get_activity_words(&text, end, &line_number, words, 3);
+			if (num_words == 0)
+				continue;
+			if (num_words < 3) {
+				printf("Error: line %d of activity file %s needs a net name, "
+						"a probability and a density.\n", word_line,
+						activity_file);
+				fail = TRUE;
+				continue;
+			}
+			fail |= add_activity_to_net(words[0], atof(words[1]),
+					atof(words[2]));
+		}
 	}
-	fclose(act_file_hdl);
+	free_blif_text();
 
 	/* Make sure all nets have an activity value */
 	for (net_idx = 0; net_idx < num_logical_nets; net_idx++) {
@@ -1955,23 +2346,184 @@ static void read_activity(char * activity_file) {
 	if (fail) {
 		exit(-1);
 	}
+
+	if (activity_binary_file != NULL && !is_binary) {
+		write_binary_activity(activity_binary_file);
+	}
+
+	vpr_printf(TIO_MESSAGE_INFO, "Loading the activity file took %g seconds.\n",
+			get_blif_wall_seconds() - begin);
 }
 
-bool add_activity_to_net(char * net_name, float probability, float density) {
-	int hash_idx, net_idx;
-	struct s_hash * h_ptr;
+static int get_activity_words(char **text, char *end, int *line_number,
+		char **words, int max_words) {
 
-	hash_idx = hash_value(net_name);
-	h_ptr = blif_hash[hash_idx];
+	/* Splits the logical line at *text into words, ending each one in      *
+	 * place, and advances *text past it.  '#' starts a comment and a '\'   *
+	 * at the end of a physical line joins the next one, as in my_fgets.    *
+	 * Words beyond max_words are skipped.  Returns the number of words.    *
+	 * The text always ends in '\n', so a word can always be ended.         */
 
-	while (h_ptr != NULL ) {
-		if (strcmp(h_ptr->name, net_name) == 0) {
-			net_idx = h_ptr->index;
-			vpack_net[net_idx].net_power->probability = probability;
-			vpack_net[net_idx].net_power->density = density;
-			return false;
+	char *p;
+	int num_words;
+
+	p = *text;
+	num_words = 0;
+	while (p < end) {
+		if (*p == '\n') {
+			(*line_number)++;
+			p++;
+			break;
 		}
-		h_ptr = h_ptr->next;
+		if (*p == ' ' || *p == '\t' || *p == '\r') {
+			p++;
+		} else if (*p == '#') {
+			p = (char *) memchr(p, '\n', end - p);
+		} else if (*p == '\\' && is_blif_continuation(p, end)) {
+			p = (char *) memchr(p, '\n', end - p) + 1;
+			(*line_number)++;
+		} else {
+			if (num_words < max_words)
+				words[num_words] = p;
+			num_words++;
+			while (*p != ' ' && *p != '\t' && *p != '\r' && *p != '\n'
+					&& *p != '#'
+					&& !(*p == '\\' && is_blif_continuation(p, end)))
+				p++;
+
+			/* Whatever ends the word is acted on before it is overwritten. */
+			if (*p == '\n') {
+				*p = '\0';
+				(*line_number)++;
+				p++;
+				break;
+			} else if (*p == '#') {
+				*p = '\0';
+				p = (char *) memchr(p + 1, '\n', end - p - 1);
+			} else if (*p == '\\') {
+				*p = '\0';
+				p = (char *) memchr(p + 1, '\n', end - p - 1) + 1;
+				(*line_number)++;
+			} else {
+				*p++ = '\0';
+			}
+		}
+	}
+	*text = p;
+	return (num_words < max_words ? num_words : max_words);
+}
+
+static unsigned int get_net_name_checksum(void) {
+
+	/* FNV-1a over every net name, '\0' included, in net index order. */
+
+	unsigned int checksum;
+	int net_idx;
+	char *name;
+
+	checksum = 2166136261u;
+	for (net_idx = 0; net_idx < num_logical_nets; net_idx++) {
+		name = vpack_net[net_idx].name;
+		do {
+			checksum = (checksum ^ (unsigned char) *name) * 16777619u;
+		} while (*name++ != '\0');
+	}
+	return checksum;
+}
+
+static boolean load_binary_activity(char * activity_file) {
+
+	/* Copies a binary activity file, already in blif_text, straight onto  *
+	 * the nets.  Returns TRUE if the file does not fit this netlist.       */
+
+	int header[ACTIVITY_BINARY_HEADER_INTS];
+	int net_idx;
+	float activity[2];
+	size_t offset, size_needed;
+
+	offset = strlen(ACTIVITY_BINARY_MAGIC);
+	size_needed = offset + sizeof(header)
+			+ (size_t) num_logical_nets * sizeof(activity);
+	if (blif_text_size < offset + sizeof(header)) {
+		printf("Error: binary activity file %s is truncated.\n",
+				activity_file);
+		return TRUE;
+	}
+	memcpy(header, blif_text + offset, sizeof(header));
+	offset += sizeof(header);
+
+	if (header[0] != ACTIVITY_BINARY_BYTE_ORDER) {
+		printf("Error: binary activity file %s was written on a machine "
+				"of the other byte order.\n", activity_file);
+		return TRUE;
+	}
+	if (header[1] != num_logical_nets
+			|| (unsigned int) header[2] != get_net_name_checksum()) {
+		printf("Error: binary activity file %s was written for a different "
+				"netlist.\n", activity_file);
+		return TRUE;
+	}
+	if (blif_text_size < size_needed) {
+		printf("Error: binary activity file %s is truncated.\n",
+				activity_file);
+		return TRUE;
+	}
+
+	/* blif_text need not be float-aligned, so each pair is copied out. */
+	for (net_idx = 0; net_idx < num_logical_nets; net_idx++) {
+		memcpy(activity, blif_text + offset, sizeof(activity));
+		offset += sizeof(activity);
+		vpack_net[net_idx].net_power->probability = activity[0];
+		vpack_net[net_idx].net_power->density = activity[1];
+	}
+	return FALSE;
+}
+
+static void write_binary_activity(char * activity_binary_file) {
+
+	/* Saves the activity just read in the binary form load_binary_activity *
+	 * reads, so later runs on the same netlist skip the text parse.        */
+
+	FILE *fp;
+	int header[ACTIVITY_BINARY_HEADER_INTS];
+	int net_idx;
+	float activity[2];
+
+	fp = my_fopen(activity_binary_file, "wb", 0);
+	header[0] = ACTIVITY_BINARY_BYTE_ORDER;
+	header[1] = num_logical_nets;
+	header[2] = (int) get_net_name_checksum();
+
+	fwrite(ACTIVITY_BINARY_MAGIC, sizeof(char), strlen(ACTIVITY_BINARY_MAGIC),
+			fp);
+	fwrite(header, sizeof(int), ACTIVITY_BINARY_HEADER_INTS, fp);
+	for (net_idx = 0; net_idx < num_logical_nets; net_idx++) {
+		activity[0] = vpack_net[net_idx].net_power->probability;
+		activity[1] = vpack_net[net_idx].net_power->density;
+		fwrite(activity, sizeof(float), 2, fp);
+	}
+	if (ferror(fp)) {
+		vpr_printf(TIO_MESSAGE_ERROR,
+				"Failed to write binary activity file '%s'.\n",
+				activity_binary_file);
+		exit(1);
+	}
+	fclose(fp);
+
+	vpr_printf(TIO_MESSAGE_INFO, "Wrote binary activity file '%s'.\n",
+			activity_binary_file);
+}
+
+bool add_activity_to_net(char * net_name, float probability, float density) {
+	int net_idx;
+	struct s_hash * h_ptr;
+
+	h_ptr = get_hash_entry(blif_hash, net_name);
+	if (h_ptr != NULL ) {
+		net_idx = h_ptr->index;
+		vpack_net[net_idx].net_power->probability = probability;
+		vpack_net[net_idx].net_power->density = density;
+		return false;
 	}
 
 	printf(
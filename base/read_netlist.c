@@ -8,6 +8,10 @@
 #include <stdio.h>
 #include <string.h>
 #include <assert.h>
+#include <time.h>
+#ifndef _WIN32
+#include <sys/resource.h>
+#endif
 #include "util.h"
 #include "hash.h"
 #include "vpr_types.h"
@@ -22,19 +26,45 @@
 #include "token.h"
 #include "rr_graph.h"
 
+#define NET_FILE_BUFFER_SIZE 1048576 /* Bytes read from the .net file at a time */
+
+/* Streaming reader for the .net file.  Only one top-level element (the    *
+ * circuit I/O lists or one complex block) is in memory at a time: its     *
+ * text is collected in elem and parsed on its own, so memory is bounded   *
+ * by the largest complex block rather than by the whole file.             *
+ * buf:  [0..len-1] bytes read from the file; pos is the next one to use.  *
+ * elem: [0..elem_len-1] text of the element being collected, which        *
+ *       started on line elem_line.                                        */
+typedef struct s_net_file_reader {
+	FILE *fp;
+	char *buf;
+	int len;
+	int pos;
+	int line;
+	boolean is_collecting;
+	char *elem;
+	int elem_len;
+	int max_elem_len;
+	int elem_line;
+} t_net_file_reader;
+
+enum e_net_file_tag {
+	NET_FILE_START_TAG, NET_FILE_EMPTY_TAG, NET_FILE_END_TAG, NET_FILE_OTHER_TAG
+};
+
 static void processPorts(INOUTP ezxml_t Parent, INOUTP t_pb* pb,
-		INOUTP t_rr_node *rr_graph, INOUTP t_pb** rr_node_to_pb_mapping, INP struct s_hash **vpack_net_hash);
+		INOUTP t_rr_node *rr_graph, INOUTP t_pb** rr_node_to_pb_mapping, INP struct s_hash_table *vpack_net_hash);
 
 static void processPb(INOUTP ezxml_t Parent, INOUTP t_pb* pb,
 		INOUTP t_rr_node *rr_graph, INOUTP t_pb **rr_node_to_pb_mapping, INOUTP int *num_primitives, 
-		INP struct s_hash **vpack_net_hash, INP struct s_hash **logical_block_hash, INP int cb_index);
+		INP struct s_hash_table *vpack_net_hash, INP struct s_hash_table *logical_block_hash, INP int cb_index);
 
 static void processComplexBlock(INOUTP ezxml_t Parent, INOUTP t_block *cb,
-		INP int index, INOUTP int *num_primitives, INP const t_arch *arch, INP struct s_hash **vpack_net_hash, INP struct s_hash **logical_block_hash);
+		INP int index, INOUTP int *num_primitives, INP const t_arch *arch, INP struct s_hash_table *vpack_net_hash, INP struct s_hash_table *logical_block_hash);
 static struct s_net *alloc_and_init_netlist_from_hash(INP int ncount,
-		INOUTP struct s_hash **nhash);
+		INOUTP struct s_hash_table *nhash);
 
-static int add_net_to_hash(INOUTP struct s_hash **nhash, INP char *net_name,
+static int add_net_to_hash(INOUTP struct s_hash_table *nhash, INP char *net_name,
 		INOUTP int *ncount);
 
 static void load_external_nets_and_cb(INP int L_num_blocks,
@@ -61,6 +91,25 @@ static void mark_constant_generators(INP int L_num_blocks,
 static void mark_constant_generators_rec(INP t_pb *pb, INP t_rr_node *rr_graph,
 		INOUTP struct s_net nlist[]);
 
+static void add_net_file_char(INOUTP t_net_file_reader *reader, INP int c);
+
+static int get_net_file_char(INOUTP t_net_file_reader *reader);
+
+static void skip_net_file_markup(INOUTP t_net_file_reader *reader,
+		INP const char *terminator);
+
+static enum e_net_file_tag read_net_file_tag(INOUTP t_net_file_reader *reader);
+
+static void shift_node_lines(INOUTP ezxml_t node, INP int offset);
+
+static ezxml_t parse_net_file_element(INOUTP t_net_file_reader *reader);
+
+static ezxml_t read_net_file_root(INOUTP t_net_file_reader *reader);
+
+static ezxml_t read_net_file_element(INOUTP t_net_file_reader *reader);
+
+static long get_peak_memory_kb(void);
+
 /**
  * Initializes the block_list with info from a netlist 
  * net_file - Name of the netlist file to read
@@ -72,27 +121,36 @@ static void mark_constant_generators_rec(INP t_pb *pb, INP t_rr_node *rr_graph,
 void read_netlist(INP const char *net_file, INP const t_arch *arch,
 		OUTP int *L_num_blocks, OUTP struct s_block *block_list[],
 		OUTP int *L_num_nets, OUTP struct s_net *net_list[]) {
-	ezxml_t Cur, Prev, Top;
+	ezxml_t Cur, Top;
 	int i;
 	const char *Prop;
-	int bcount;
+	int bcount, max_blocks;
 	struct s_block *blist;
 	int ext_ncount;
 	struct s_net *ext_nlist;
-	struct s_hash **vpack_net_hash, **logical_block_hash, *temp_hash;
+	struct s_hash_table *vpack_net_hash, *logical_block_hash;
+	struct s_hash *temp_hash;
 	char **circuit_inputs, **circuit_outputs, **circuit_clocks;
+	boolean found_clocks;
 	int Count, Len;
+	t_net_file_reader reader;
+	clock_t begin, end;
+	long peak_memory_kb;
 
 	int num_primitives = 0;
 
 	/* Parse the file */
 	vpr_printf(TIO_MESSAGE_INFO, "Begin parsing packed FPGA netlist file.\n");
-	Top = ezxml_parse_file(net_file);
-	if (NULL == Top) {
+	begin = clock();
+	memset(&reader, 0, sizeof(t_net_file_reader));
+	reader.fp = fopen(net_file, "rb");
+	if (NULL == reader.fp) {
 		vpr_printf(TIO_MESSAGE_ERROR, "Unable to load netlist file '%s'.\n", net_file);
 		exit(1);
 	}
-	vpr_printf(TIO_MESSAGE_INFO, "Finished parsing packed FPGA netlist file.\n");
+	reader.buf = (char *) my_malloc(NET_FILE_BUFFER_SIZE * sizeof(char));
+	reader.line = 1;
+	Top = read_net_file_root(&reader);
 
 	/* Root node should be block */
 	CheckElement(Top, "block");
@@ -110,27 +168,6 @@ void read_netlist(INP const char *net_file, INP const t_arch *arch,
 	}
 	ezxml_set_attr(Top, "instance", NULL);
 
-	/* Parse top-level netlist I/Os */
-	Cur = FindElement(Top, "inputs", TRUE);
-	circuit_inputs = GetNodeTokens(Cur);
-	FreeNode(Cur);
-	Cur = FindElement(Top, "outputs", TRUE);
-	circuit_outputs = GetNodeTokens(Cur);
-	FreeNode(Cur);
-
-	Cur = FindElement(Top, "clocks", TRUE);
-	CountTokensInString(Cur->txt, &Count, &Len);
-	if (Count > 0) {
-		circuit_clocks = GetNodeTokens(Cur);
-	} else {
-		circuit_clocks = NULL;
-	}
-	FreeNode(Cur);
-
-	/* Parse all CLB blocks and all nets*/
-	bcount = CountChildren(Top, "block", 1);
-	blist = (struct s_block *) my_calloc(bcount, sizeof(t_block));
-
 	/* create quick hash look up for vpack_net and logical_block 
 		Also reset logical block data structure for pb
 	*/
@@ -145,24 +182,53 @@ void read_netlist(INP const char *net_file, INP const t_arch *arch,
 		logical_block[i].pb = NULL;
 		assert(temp_hash->count == 1);
 	}
-	
-	/* Prcoess netlist */
 
-	Cur = Top->child;
-	i = 0;
-	while (Cur) {
+	/* Process the netlist one top-level element at a time: the netlist *
+	 * I/Os, and all CLB blocks with their nets.  The block count is not *
+	 * known up front, so blist grows as blocks arrive.                  */
+	circuit_inputs = circuit_outputs = circuit_clocks = NULL;
+	found_clocks = FALSE;
+	bcount = 0;
+	max_blocks = 0;
+	blist = NULL;
+	while ((Cur = read_net_file_element(&reader)) != NULL) {
 		if (0 == strcmp(Cur->name, "block")) {
 			CheckElement(Cur, "block");
-			processComplexBlock(Cur, blist, i, &num_primitives,	arch, vpack_net_hash, logical_block_hash);
-			Prev = Cur;
-			Cur = Cur->next;
-			FreeNode(Prev);
-			i++;
+			if (bcount == max_blocks) {
+				max_blocks = (max_blocks == 0 ? 64 : 2 * max_blocks);
+				blist = (struct s_block *) my_realloc(blist,
+						max_blocks * sizeof(t_block));
+			}
+			memset(&blist[bcount], 0, sizeof(t_block));
+			processComplexBlock(Cur, blist, bcount, &num_primitives, arch, vpack_net_hash, logical_block_hash);
+			bcount++;
+		} else if (0 == strcmp(Cur->name, "inputs") && circuit_inputs == NULL) {
+			circuit_inputs = GetNodeTokens(Cur);
+		} else if (0 == strcmp(Cur->name, "outputs") && circuit_outputs == NULL) {
+			circuit_outputs = GetNodeTokens(Cur);
+		} else if (0 == strcmp(Cur->name, "clocks") && !found_clocks) {
+			found_clocks = TRUE;
+			CountTokensInString(Cur->txt, &Count, &Len);
+			if (Count > 0) {
+				circuit_clocks = GetNodeTokens(Cur);
+			}
 		} else {
-			Cur = Cur->next;
+			vpr_printf(TIO_MESSAGE_ERROR, "[Line %d] Unexpected element '%s' in netlist '%s'.\n",
+					Cur->line, Cur->name, net_file);
+			exit(1);
 		}
+		FreeNode(Cur);
+	}
+	fclose(reader.fp);
+	free(reader.buf);
+	free(reader.elem);
+
+	if (circuit_inputs == NULL || circuit_outputs == NULL || !found_clocks) {
+		vpr_printf(TIO_MESSAGE_ERROR, "[Line %d] Netlist '%s' is missing its <%s> element.\n",
+				Top->line, net_file,
+				(circuit_inputs == NULL ? "inputs" : (circuit_outputs == NULL ? "outputs" : "clocks")));
+		exit(1);
 	}
-	assert(i == bcount);
 	assert(num_primitives == num_logical_blocks);
 
 	/* Error check */
@@ -213,6 +279,268 @@ void read_netlist(INP const char *net_file, INP const t_arch *arch,
 
 	free_hash_table(logical_block_hash);
 	free_hash_table(vpack_net_hash);
+
+	end = clock();
+	peak_memory_kb = get_peak_memory_kb();
+#ifdef CLOCKS_PER_SEC
+	vpr_printf(TIO_MESSAGE_INFO, "Finished loading packed FPGA netlist file: %d blocks, %d nets in %g seconds.\n",
+			bcount, ext_ncount, (float) (end - begin) / CLOCKS_PER_SEC);
+#else
+	vpr_printf(TIO_MESSAGE_INFO, "Finished loading packed FPGA netlist file: %d blocks, %d nets in %g seconds.\n",
+			bcount, ext_ncount, (float) (end - begin) / CLK_PER_SEC);
+#endif
+	if (peak_memory_kb >= 0) {
+		vpr_printf(TIO_MESSAGE_INFO, "Peak memory use so far: %.1f MB.\n",
+				peak_memory_kb / 1024.);
+	}
+}
+
+static void add_net_file_char(INOUTP t_net_file_reader *reader, INP int c) {
+	if (reader->elem_len + 1 >= reader->max_elem_len) {
+		reader->max_elem_len = (reader->max_elem_len == 0 ? 4096 : 2 * reader->max_elem_len);
+		reader->elem = (char *) my_realloc(reader->elem,
+				reader->max_elem_len * sizeof(char));
+	}
+	reader->elem[reader->elem_len++] = (char) c;
+}
+
+/**
+ * Returns the next character of the .net file, or EOF.  While an element is
+ * being collected, the character is also appended to its text.
+ */
+static int get_net_file_char(INOUTP t_net_file_reader *reader) {
+	int c;
+
+	if (reader->pos == reader->len) {
+		reader->len = (int) fread(reader->buf, sizeof(char), NET_FILE_BUFFER_SIZE, reader->fp);
+		reader->pos = 0;
+		if (reader->len == 0) {
+			return EOF;
+		}
+	}
+	c = (unsigned char) reader->buf[reader->pos++];
+	if (c == '\n') {
+		reader->line++;
+	}
+	if (reader->is_collecting) {
+		add_net_file_char(reader, c);
+	}
+	return c;
+}
+
+/**
+ * Reads up to and including terminator, e.g. the "-->" ending a comment.
+ */
+static void skip_net_file_markup(INOUTP t_net_file_reader *reader,
+		INP const char *terminator) {
+	int c, matched, len;
+
+	len = strlen(terminator);
+	matched = 0;
+	while (matched < len) {
+		c = get_net_file_char(reader);
+		if (c == EOF) {
+			vpr_printf(TIO_MESSAGE_ERROR, "[Line %d] Netlist file ends inside markup, expected '%s'.\n",
+					reader->line, terminator);
+			exit(1);
+		}
+		if (c == terminator[matched]) {
+			matched++;
+		} else {
+			matched = (c == terminator[0] ? 1 : 0);
+		}
+	}
+}
+
+/**
+ * Reads one tag; the '<' has already been read.  Tells start tags, empty
+ * element tags and end tags apart, and skips comments, processing
+ * instructions, CDATA sections and declarations as NET_FILE_OTHER_TAG.
+ */
+static enum e_net_file_tag read_net_file_tag(INOUTP t_net_file_reader *reader) {
+	int c, prev, quote;
+
+	c = get_net_file_char(reader);
+	if (c == '/') {
+		skip_net_file_markup(reader, ">");
+		return NET_FILE_END_TAG;
+	}
+	if (c == '?') {
+		skip_net_file_markup(reader, "?>");
+		return NET_FILE_OTHER_TAG;
+	}
+	if (c == '!') {
+		c = get_net_file_char(reader);
+		if (c == '-') {
+			skip_net_file_markup(reader, "-->");
+		} else if (c == '[') {
+			skip_net_file_markup(reader, "]]>");
+		} else if (c != '>') {
+			skip_net_file_markup(reader, ">");
+		}
+		return NET_FILE_OTHER_TAG;
+	}
+
+	/* Start tag: '>' may appear inside quoted attribute values */
+	quote = 0;
+	prev = c;
+	while (c != EOF) {
+		c = get_net_file_char(reader);
+		if (quote) {
+			if (c == quote) {
+				quote = 0;
+			}
+		} else if (c == '"' || c == '\'') {
+			quote = c;
+		} else if (c == '>') {
+			return (prev == '/' ? NET_FILE_EMPTY_TAG : NET_FILE_START_TAG);
+		}
+		prev = c;
+	}
+	vpr_printf(TIO_MESSAGE_ERROR, "[Line %d] Netlist file ends inside a tag.\n",
+			reader->line);
+	exit(1);
+}
+
+/**
+ * Line numbers of a node parsed on its own count from its first line;
+ * shift them to lines of the .net file.
+ */
+static void shift_node_lines(INOUTP ezxml_t node, INP int offset) {
+	ezxml_t child;
+
+	node->line += offset;
+	for (child = node->child; child != NULL; child = child->ordered) {
+		shift_node_lines(child, offset);
+	}
+}
+
+/**
+ * Parses the collected element text into a tree of its own.  The text buffer
+ * is reused for the next element, so the tree must be freed before then.
+ */
+static ezxml_t parse_net_file_element(INOUTP t_net_file_reader *reader) {
+	ezxml_t node;
+
+	add_net_file_char(reader, '\0');
+	node = ezxml_parse_str(reader->elem, reader->elem_len - 1);
+	if (node == NULL || ezxml_error(node)[0] != '\0') {
+		vpr_printf(TIO_MESSAGE_ERROR, "[Line %d] Unable to parse netlist element: %s.\n",
+				reader->elem_line, (node ? ezxml_error(node) : "out of memory"));
+		exit(1);
+	}
+	shift_node_lines(node, reader->elem_line - 1);
+	return node;
+}
+
+/**
+ * Reads past the XML declaration to the root start tag and returns the root
+ * as an element with its attributes but no children.
+ */
+static ezxml_t read_net_file_root(INOUTP t_net_file_reader *reader) {
+	int c;
+	enum e_net_file_tag tag;
+
+	for (;;) {
+		c = get_net_file_char(reader);
+		if (c == EOF) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Netlist file has no root element.\n");
+			exit(1);
+		}
+		if (c != '<') {
+			continue;
+		}
+		reader->elem_len = 0;
+		reader->elem_line = reader->line;
+		add_net_file_char(reader, '<');
+		reader->is_collecting = TRUE;
+		tag = read_net_file_tag(reader);
+		reader->is_collecting = FALSE;
+		if (tag == NET_FILE_START_TAG) {
+			/* <block ...> becomes <block .../> so it parses on its own */
+			reader->elem[reader->elem_len - 1] = '/';
+			add_net_file_char(reader, '>');
+			return parse_net_file_element(reader);
+		}
+		if (tag != NET_FILE_OTHER_TAG) {
+			vpr_printf(TIO_MESSAGE_ERROR, "[Line %d] Netlist root element is empty or malformed.\n",
+					reader->line);
+			exit(1);
+		}
+	}
+}
+
+/**
+ * Returns the next child of the root as a tree of its own, or NULL once the
+ * root end tag is read.
+ */
+static ezxml_t read_net_file_element(INOUTP t_net_file_reader *reader) {
+	int c, depth;
+	enum e_net_file_tag tag;
+
+	for (;;) {
+		/* Text directly inside the root is ignored */
+		do {
+			c = get_net_file_char(reader);
+		} while (c != '<' && c != EOF);
+		if (c == EOF) {
+			vpr_printf(TIO_MESSAGE_ERROR, "[Line %d] Netlist file ends before the root element is closed.\n",
+					reader->line);
+			exit(1);
+		}
+
+		reader->elem_len = 0;
+		reader->elem_line = reader->line;
+		add_net_file_char(reader, '<');
+		reader->is_collecting = TRUE;
+		tag = read_net_file_tag(reader);
+		if (tag == NET_FILE_END_TAG) {
+			reader->is_collecting = FALSE;
+			return NULL;
+		}
+		if (tag == NET_FILE_OTHER_TAG) {
+			reader->is_collecting = FALSE;
+			continue;
+		}
+
+		depth = (tag == NET_FILE_START_TAG ? 1 : 0);
+		while (depth > 0) {
+			do {
+				c = get_net_file_char(reader);
+			} while (c != '<' && c != EOF);
+			if (c == EOF) {
+				vpr_printf(TIO_MESSAGE_ERROR, "[Line %d] Netlist file ends inside the element starting on line %d.\n",
+						reader->line, reader->elem_line);
+				exit(1);
+			}
+			tag = read_net_file_tag(reader);
+			if (tag == NET_FILE_START_TAG) {
+				depth++;
+			} else if (tag == NET_FILE_END_TAG) {
+				depth--;
+			}
+		}
+		reader->is_collecting = FALSE;
+		return parse_net_file_element(reader);
+	}
+}
+
+/**
+ * Peak resident memory of this process in kB, or -1 where it is not known.
+ */
+static long get_peak_memory_kb(void) {
+#ifndef _WIN32
+	struct rusage usage;
+
+	if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+		return usage.ru_maxrss / 1024; /* bytes */
+#else
+		return usage.ru_maxrss;
+#endif
+	}
+#endif
+	return -1;
 }
 
 /**
@@ -224,7 +552,7 @@ void read_netlist(INP const char *net_file, INP const t_arch *arch,
  * logical_block_hash - hashtable of all atoms in blif netlist
  */
 static void processComplexBlock(INOUTP ezxml_t Parent, INOUTP t_block *cb,
-		INP int index, INOUTP int *num_primitives, INP const t_arch *arch, INP struct s_hash **vpack_net_hash, INP struct s_hash **logical_block_hash)
+		INP int index, INOUTP int *num_primitives, INP const t_arch *arch, INP struct s_hash_table *vpack_net_hash, INP struct s_hash_table *logical_block_hash)
  {
 
 	const char *Prop;
@@ -271,15 +599,7 @@ static void processComplexBlock(INOUTP ezxml_t Parent, INOUTP t_block *cb,
 
 	/* Parse all pbs and CB internal nets*/
 	cb[index].pb->logical_block = OPEN;
-	cb[index].pb->pb_graph_node = cb[index].type->pb_graph_head;
-	num_rr_nodes = cb[index].pb->pb_graph_node->total_pb_pins;
-	rr_node = (t_rr_node*)my_calloc((num_rr_nodes * 2) + cb[index].type->pb_type->num_input_pins
-			+ cb[index].type->pb_type->num_output_pins + cb[index].type->pb_type->num_clock_pins,
-			sizeof(t_rr_node));
-	alloc_and_load_rr_graph_for_pb_graph_node(cb[index].pb->pb_graph_node, arch,
-			0);
-	cb[index].pb->rr_node_to_pb_mapping = (t_pb **)my_calloc(cb[index].type->pb_graph_head->total_pb_pins, sizeof(t_pb *));
-	cb[index].pb->rr_graph = rr_node;
+	alloc_cb_rr_graph(&cb[index], arch);
 	
 	Prop = FindProperty(Parent, "mode", TRUE);
 	ezxml_set_attr(Parent, "mode", NULL);
@@ -303,13 +623,7 @@ static void processComplexBlock(INOUTP ezxml_t Parent, INOUTP t_block *cb,
 	for (i = 0; i < cb[index].type->num_pins; i++) {
 		cb[index].nets[i] = OPEN;
 	}
-	alloc_internal_cb_nets(cb[index].pb, cb[index].pb->pb_graph_node,
-			cb[index].pb->rr_graph, 1);
-	alloc_internal_cb_nets(cb[index].pb, cb[index].pb->pb_graph_node,
-			cb[index].pb->rr_graph, 2);
-	i = 0;
-	load_internal_cb_nets(cb[index].pb, cb[index].pb->pb_graph_node,
-			cb[index].pb->rr_graph, &i);
+	load_cb_internal_nets(&cb[index]);
 	freeTokens(tokens, num_tokens);
 #if 0
 	/* print local nets */
@@ -323,6 +637,39 @@ static void processComplexBlock(INOUTP ezxml_t Parent, INOUTP t_block *cb,
 #endif
 }
 
+/**
+ * Allocates the rr_graph of the pbs inside complex block cb, with every net and
+ * route still open, and the look-up from its rr_nodes to pbs
+ * cb - complex block whose type is set and whose top-level pb is allocated
+ */
+void alloc_cb_rr_graph(INOUTP t_block *cb, INP const t_arch *arch) {
+	cb->pb->pb_graph_node = cb->type->pb_graph_head;
+	num_rr_nodes = cb->pb->pb_graph_node->total_pb_pins;
+	rr_node = (t_rr_node*)my_calloc((num_rr_nodes * 2) + cb->type->pb_type->num_input_pins
+			+ cb->type->pb_type->num_output_pins + cb->type->pb_type->num_clock_pins,
+			sizeof(t_rr_node));
+	alloc_and_load_rr_graph_for_pb_graph_node(cb->pb->pb_graph_node, arch,
+			0);
+	cb->pb->rr_node_to_pb_mapping = (t_pb **)my_calloc(cb->type->pb_graph_head->total_pb_pins, sizeof(t_pb *));
+	cb->pb->rr_graph = rr_node;
+}
+
+/**
+ * Builds the nets internal to complex block cb from the net numbers and routes
+ * (prev_node) already loaded into its rr_graph
+ */
+void load_cb_internal_nets(INOUTP t_block *cb) {
+	int inet;
+
+	alloc_internal_cb_nets(cb->pb, cb->pb->pb_graph_node,
+			cb->pb->rr_graph, 1);
+	alloc_internal_cb_nets(cb->pb, cb->pb->pb_graph_node,
+			cb->pb->rr_graph, 2);
+	inet = 0;
+	load_internal_cb_nets(cb->pb, cb->pb->pb_graph_node,
+			cb->pb->rr_graph, &inet);
+}
+
 /**
  * XML parser to populate pb info and to update internal nets of the parent CLB
  * Parent - XML tag for this pb_type
@@ -332,7 +679,7 @@ static void processComplexBlock(INOUTP ezxml_t Parent, INOUTP t_block *cb,
  */
 static void processPb(INOUTP ezxml_t Parent, INOUTP t_pb* pb,
 		INOUTP t_rr_node *rr_graph, INOUTP t_pb** rr_node_to_pb_mapping, INOUTP int *num_primitives, 
-		INP struct s_hash **vpack_net_hash, INP struct s_hash **logical_block_hash, INP int cb_index) {
+		INP struct s_hash_table *vpack_net_hash, INP struct s_hash_table *logical_block_hash, INP int cb_index) {
 	ezxml_t Cur, Prev, lookahead;
 	const char *Prop;
 	const char *instance_type;
@@ -529,7 +876,7 @@ static void processPb(INOUTP ezxml_t Parent, INOUTP t_pb* pb,
  * returns array of nets stored in hashtable
  */
 static struct s_net *alloc_and_init_netlist_from_hash(INP int ncount,
-		INOUTP struct s_hash **nhash) {
+		INOUTP struct s_hash_table *nhash) {
 	struct s_net *nlist;
 	struct s_hash_iterator hash_iter;
 	struct s_hash *curr_net;
@@ -562,7 +909,7 @@ static struct s_net *alloc_and_init_netlist_from_hash(INP int ncount,
  * Adds net to hashtable of nets.  If the net is "open", then this is a keyword so do not add it.  
  * If the net already exists, increase the count on that net 
  */
-static int add_net_to_hash(INOUTP struct s_hash **nhash, INP char *net_name,
+static int add_net_to_hash(INOUTP struct s_hash_table *nhash, INP char *net_name,
 		INOUTP int *ncount) {
 	struct s_hash *hash_value;
 
@@ -579,7 +926,7 @@ static int add_net_to_hash(INOUTP struct s_hash **nhash, INP char *net_name,
 }
 
 static void processPorts(INOUTP ezxml_t Parent, INOUTP t_pb* pb,
-		t_rr_node *rr_graph, INOUTP t_pb** rr_node_to_pb_mapping, INP struct s_hash **vpack_net_hash) {
+		t_rr_node *rr_graph, INOUTP t_pb** rr_node_to_pb_mapping, INP struct s_hash_table *vpack_net_hash) {
 
 	int i, j, in_port, out_port, clock_port, num_tokens;
 	ezxml_t Cur, Prev;
@@ -809,7 +1156,7 @@ static void load_external_nets_and_cb(INP int L_num_blocks,
 		INP struct s_net nlist[], OUTP int *ext_ncount,
 		OUTP struct s_net **ext_nets, INP char **circuit_clocks) {
 	int i, j, k, ipin;
-	struct s_hash **ext_nhash;
+	struct s_hash_table *ext_nhash;
 	t_rr_node *rr_graph;
 	t_pb_graph_pin *pb_graph_pin;
 	int *count;
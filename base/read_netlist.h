@@ -15,6 +15,10 @@ void read_netlist(INP const char *net_file,
 		OUTP int *L_num_nets, 
 		OUTP struct s_net *net_list[]);
 
+void alloc_cb_rr_graph(INOUTP t_block *cb, INP const t_arch *arch);
+
+void load_cb_internal_nets(INOUTP t_block *cb);
+
 void free_logical_blocks(void);
 void free_logical_nets(void);
 
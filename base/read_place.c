@@ -8,6 +8,7 @@
 #include "read_place.h"
 #include "read_xml_arch_file.h"
 #include "ReadLine.h"
+#include "out_buf.h"
 
 /* extern, should be a header */
 char **ReadLineTokens(INOUTP FILE * InFile, INOUTP int *LineNum);
@@ -135,7 +136,8 @@ void read_user_pad_loc(char *pad_loc_file) {
 
 	/* Reads in the locations of the IO pads from a file. */
 
-	struct s_hash **hash_table, *h_ptr;
+	struct s_hash_table *hash_table;
+	struct s_hash *h_ptr;
 	int iblk, i, j, xtmp, ytmp, bnum, k;
 	FILE *fp;
 	char buf[BUFSIZE], bname[BUFSIZE], *ptr;
@@ -266,24 +268,31 @@ void print_place(char *place_file, char *net_file, char *arch_file) {
 	 * file to avoid loading a placement with the wrong support files    *
 	 * later.                                                            */
 
-	FILE *fp;
+	t_out_buf *out;
 	int i;
 
-	fp = fopen(place_file, "w");
+	out = open_out_file(place_file);
 
-	fprintf(fp, "Netlist file: %s   Architecture file: %s\n", net_file,
+	out_printf(out, "Netlist file: %s   Architecture file: %s\n", net_file,
 			arch_file);
-	fprintf(fp, "Array size: %d x %d logic blocks\n\n", nx, ny);
-	fprintf(fp, "#block name\tx\ty\tsubblk\tblock number\n");
-	fprintf(fp, "#----------\t--\t--\t------\t------------\n");
+	out_printf(out, "Array size: %d x %d logic blocks\n\n", nx, ny);
+	out_str(out, "#block name\tx\ty\tsubblk\tblock number\n");
+	out_str(out, "#----------\t--\t--\t------\t------------\n");
 
 	for (i = 0; i < num_blocks; i++) {
-		fprintf(fp, "%s\t", block[i].name);
+		out_str(out, block[i].name);
+		out_char(out, '\t');
 		if (strlen(block[i].name) < 8)
-			fprintf(fp, "\t");
-
-		fprintf(fp, "%d\t%d\t%d", block[i].x, block[i].y, block[i].z);
-		fprintf(fp, "\t#%d\n", i);
+			out_char(out, '\t');
+
+		out_int(out, block[i].x);
+		out_char(out, '\t');
+		out_int(out, block[i].y);
+		out_char(out, '\t');
+		out_int(out, block[i].z);
+		out_str(out, "\t#");
+		out_int(out, i);
+		out_char(out, '\n');
 	}
-	fclose(fp);
+	close_out_file(out);
 }
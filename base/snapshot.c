@@ -0,0 +1,982 @@
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include <time.h>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#include "util.h"
+#include "vpr_types.h"
+#include "globals.h"
+#include "read_netlist.h"
+#include "snapshot.h"
+
+#define SNAPSHOT_MAGIC "VPRSNAP1" /* first 8 bytes of a snapshot file */
+#define SNAPSHOT_VERSION 1 /* bump whenever the layout below changes */
+#define SNAPSHOT_BYTE_ORDER 0x01020304 /* read back differently on a machine of the other endianness */
+
+/* A snapshot is the magic string, then the header ints [version, byte    *
+ * order, stage, checksum], then the payload.  The checksum is FNV-1a over *
+ * the payload.  Every field of the payload is a native int, an int array  *
+ * or a string (length, or -1 for NULL, then the characters), written in   *
+ * this order:                                                             *
+ *   architecture: arch file name; num_types; per type: name, num_pins,    *
+ *                 total_pb_pins.                                          *
+ *   circuit:      blif_circuit_name, num_p_inputs, num_p_outputs, the     *
+ *                 removed primary inputs.                                 *
+ *   vpack nets, logical blocks, complex blocks (pb tree and per-pin rr    *
+ *   state), clb nets, the clb <-> vpack net mappings.                     *
+ *   placed only:  nx, ny; per block: x, y, z, isFixed.                    *
+ * Pointers are never written; everything that points into the            *
+ * architecture is rebuilt from indices when the snapshot is read.        */
+
+enum e_snapshot_pb_state {
+	SNAPSHOT_PB_ABSENT, /* no pb_graph_node: not mentioned in the .net file */
+	SNAPSHOT_PB_UNUSED, /* mentioned as open, with no routing inside */
+	SNAPSHOT_PB_USED /* expanded; its own fields follow */
+};
+
+typedef struct s_snapshot_writer {
+	FILE *fp;
+	unsigned int checksum;
+} t_snapshot_writer;
+
+/* data: [0..size-1] the whole file, mapped read-only where mmap is      *
+ *       available.  pos is the next byte to read from the payload.      */
+typedef struct s_snapshot_reader {
+	const char *fname;
+	char *data;
+	size_t size;
+	boolean is_mapped;
+	const char *pos;
+	const char *end;
+} t_snapshot_reader;
+
+static const char *stage_names[NUM_SNAPSHOT_STAGES] = { "packed", "placed" };
+
+/* Placement of a placed snapshot, kept until restore_snapshot_placement */
+static char *placement_file = NULL;
+static int placement_nx = 0;
+static int placement_ny = 0;
+static int *placement_locs = NULL; /* [0..num_blocks-1][x, y, z, isFixed] */
+
+/******** prototypes ******************/
+
+static unsigned int update_snapshot_checksum(unsigned int checksum,
+		const void *data, size_t size);
+
+static void put_snapshot_bytes(t_snapshot_writer *writer, const void *data,
+		size_t size);
+
+static void put_snapshot_int(t_snapshot_writer *writer, int value);
+
+static void put_snapshot_ints(t_snapshot_writer *writer, const int *values,
+		int count);
+
+static void put_snapshot_string(t_snapshot_writer *writer, const char *s);
+
+static void put_snapshot_pb(t_snapshot_writer *writer, t_pb *pb);
+
+static void put_snapshot_net(t_snapshot_writer *writer, struct s_net *net);
+
+static void load_snapshot_file(t_snapshot_reader *reader, const char *fname);
+
+static void free_snapshot_file(t_snapshot_reader *reader);
+
+static void bad_snapshot(t_snapshot_reader *reader, const char *what);
+
+static void get_snapshot_bytes(t_snapshot_reader *reader, void *data,
+		size_t size);
+
+static int get_snapshot_int(t_snapshot_reader *reader);
+
+static int *get_snapshot_ints(t_snapshot_reader *reader, int count);
+
+static char *get_snapshot_string(t_snapshot_reader *reader);
+
+static void check_snapshot_indices(t_snapshot_reader *reader,
+		const int *values, int count, int limit, const char *what);
+
+static void get_snapshot_net(t_snapshot_reader *reader, struct s_net *net);
+
+static int get_snapshot_model_port_size(t_model_ports *ports, int index);
+
+static void check_snapshot_vpack_net(t_snapshot_reader *reader,
+		struct s_net *net);
+
+static void check_snapshot_clb_net(t_snapshot_reader *reader,
+		struct s_net *net);
+
+static t_model *find_snapshot_model(const char *name, t_model *user_models,
+		t_model *library_models);
+
+static void get_snapshot_logical_block(t_snapshot_reader *reader, int iblk,
+		t_model *user_models, t_model *library_models);
+
+static void get_snapshot_pb(t_snapshot_reader *reader, t_pb *pb,
+		t_pb **rr_node_to_pb_mapping, int cb_index);
+
+static void get_snapshot_block(t_snapshot_reader *reader, int iblk,
+		const t_arch *arch);
+
+/**************************************/
+
+static unsigned int update_snapshot_checksum(unsigned int checksum,
+		const void *data, size_t size) {
+
+	const unsigned char *p;
+	size_t i;
+
+	p = (const unsigned char *) data;
+	for (i = 0; i < size; i++) {
+		checksum ^= p[i];
+		checksum *= 16777619u;
+	}
+	return (checksum);
+}
+
+static void put_snapshot_bytes(t_snapshot_writer *writer, const void *data,
+		size_t size) {
+
+	if (size == 0)
+		return;
+	fwrite(data, 1, size, writer->fp);
+	writer->checksum = update_snapshot_checksum(writer->checksum, data, size);
+}
+
+static void put_snapshot_int(t_snapshot_writer *writer, int value) {
+
+	put_snapshot_bytes(writer, &value, sizeof(int));
+}
+
+static void put_snapshot_ints(t_snapshot_writer *writer, const int *values,
+		int count) {
+
+	put_snapshot_bytes(writer, values, count * sizeof(int));
+}
+
+static void put_snapshot_string(t_snapshot_writer *writer, const char *s) {
+
+	if (s == NULL) {
+		put_snapshot_int(writer, -1);
+	} else {
+		put_snapshot_int(writer, strlen(s));
+		put_snapshot_bytes(writer, s, strlen(s));
+	}
+}
+
+static void put_snapshot_pb(t_snapshot_writer *writer, t_pb *pb) {
+
+	/* Writes pb and, depth first, the state of every child slot of its *
+	 * mode, in the order of child_pbs.                                 */
+
+	int i, j;
+	const t_pb_type *pb_type;
+	t_pb *child;
+
+	pb_type = pb->pb_graph_node->pb_type;
+	put_snapshot_string(writer, pb->name);
+	put_snapshot_int(writer, pb->mode);
+	if (pb_type->num_modes == 0) {
+		put_snapshot_int(writer, pb->logical_block);
+		return;
+	}
+
+	for (i = 0; i < pb_type->modes[pb->mode].num_pb_type_children; i++) {
+		for (j = 0; j < pb_type->modes[pb->mode].pb_type_children[i].num_pb; j++) {
+			child = &pb->child_pbs[i][j];
+			if (child->pb_graph_node == NULL) {
+				put_snapshot_int(writer, SNAPSHOT_PB_ABSENT);
+			} else if (child->parent_pb == NULL) {
+				put_snapshot_int(writer, SNAPSHOT_PB_UNUSED);
+			} else {
+				put_snapshot_int(writer, SNAPSHOT_PB_USED);
+				put_snapshot_pb(writer, child);
+			}
+		}
+	}
+}
+
+static void put_snapshot_net(t_snapshot_writer *writer, struct s_net *net) {
+
+	put_snapshot_string(writer, net->name);
+	put_snapshot_int(writer, net->num_sinks);
+	put_snapshot_ints(writer, net->node_block, net->num_sinks + 1);
+	put_snapshot_int(writer, (net->node_block_port != NULL));
+	if (net->node_block_port != NULL)
+		put_snapshot_ints(writer, net->node_block_port, net->num_sinks + 1);
+	put_snapshot_ints(writer, net->node_block_pin, net->num_sinks + 1);
+	put_snapshot_int(writer, net->is_global);
+	put_snapshot_int(writer, net->is_const_gen);
+}
+
+void write_snapshot(INP const char *snapshot_file,
+		INP enum e_snapshot_stage stage, INP const char *arch_file) {
+
+	/* Writes the current netlist, and for SNAPSHOT_PLACED the current   *
+	 * placement, to snapshot_file.  Must be called once the .net file   *
+	 * has been read (the pb trees come from read_netlist) and, for a    *
+	 * placed snapshot, before post_place_sync.                          */
+
+	t_snapshot_writer writer;
+	int header[4];
+	int i, iblk, ipin, iport, num_removed;
+	struct s_linked_vptr *tvptr;
+	t_model_ports *port;
+	t_pb *top;
+
+	writer.fp = my_fopen(snapshot_file, "wb", 0);
+	writer.checksum = 2166136261u;
+
+	header[0] = SNAPSHOT_VERSION;
+	header[1] = SNAPSHOT_BYTE_ORDER;
+	header[2] = stage;
+	header[3] = 0; /* checksum, filled in at the end */
+	fwrite(SNAPSHOT_MAGIC, sizeof(char), strlen(SNAPSHOT_MAGIC), writer.fp);
+	fwrite(header, sizeof(int), 4, writer.fp);
+
+	/* Architecture */
+	put_snapshot_string(&writer, arch_file);
+	put_snapshot_int(&writer, num_types);
+	for (i = 0; i < num_types; i++) {
+		put_snapshot_string(&writer, type_descriptors[i].name);
+		put_snapshot_int(&writer, type_descriptors[i].num_pins);
+		put_snapshot_int(&writer, (type_descriptors[i].pb_graph_head == NULL ?
+				0 : type_descriptors[i].pb_graph_head->total_pb_pins));
+	}
+
+	/* Circuit */
+	put_snapshot_string(&writer, blif_circuit_name);
+	put_snapshot_int(&writer, num_p_inputs);
+	put_snapshot_int(&writer, num_p_outputs);
+	num_removed = 0;
+	for (tvptr = circuit_p_io_removed; tvptr != NULL; tvptr = tvptr->next)
+		num_removed++;
+	put_snapshot_int(&writer, num_removed);
+	for (tvptr = circuit_p_io_removed; tvptr != NULL; tvptr = tvptr->next)
+		put_snapshot_string(&writer, (char *) tvptr->data_vptr);
+
+	/* Vpack nets */
+	put_snapshot_int(&writer, num_logical_nets);
+	for (i = 0; i < num_logical_nets; i++)
+		put_snapshot_net(&writer, &vpack_net[i]);
+
+	/* Logical blocks.  The net arrays are shaped by the model's ports, *
+	 * in the same order free_logical_blocks walks them.                */
+	put_snapshot_int(&writer, num_logical_blocks);
+	for (iblk = 0; iblk < num_logical_blocks; iblk++) {
+		put_snapshot_string(&writer, logical_block[iblk].name);
+		put_snapshot_int(&writer, logical_block[iblk].type);
+		put_snapshot_string(&writer, logical_block[iblk].model->name);
+		iport = 0;
+		for (port = logical_block[iblk].model->inputs; port != NULL; port = port->next) {
+			if (!port->is_clock) {
+				put_snapshot_int(&writer, port->size);
+				put_snapshot_ints(&writer, logical_block[iblk].input_nets[iport], port->size);
+				iport++;
+			}
+		}
+		iport = 0;
+		for (port = logical_block[iblk].model->outputs; port != NULL; port = port->next) {
+			put_snapshot_int(&writer, port->size);
+			put_snapshot_ints(&writer, logical_block[iblk].output_nets[iport], port->size);
+			iport++;
+		}
+		put_snapshot_int(&writer, logical_block[iblk].clock_net);
+		put_snapshot_int(&writer, logical_block[iblk].used_input_pins);
+		i = 0;
+		for (tvptr = logical_block[iblk].truth_table; tvptr != NULL; tvptr = tvptr->next)
+			i++;
+		put_snapshot_int(&writer, i);
+		for (tvptr = logical_block[iblk].truth_table; tvptr != NULL; tvptr = tvptr->next)
+			put_snapshot_string(&writer, (char *) tvptr->data_vptr);
+	}
+
+	/* Complex blocks.  Local nets and prev_edge are not written: they   *
+	 * are recomputed from net_num and prev_node by load_cb_internal_nets. */
+	put_snapshot_int(&writer, num_blocks);
+	for (iblk = 0; iblk < num_blocks; iblk++) {
+		top = block[iblk].pb;
+		put_snapshot_string(&writer, block[iblk].name);
+		put_snapshot_int(&writer, block[iblk].type->index);
+		put_snapshot_ints(&writer, block[iblk].nets, block[iblk].type->num_pins);
+		put_snapshot_pb(&writer, top);
+		for (ipin = 0; ipin < top->pb_graph_node->total_pb_pins; ipin++) {
+			put_snapshot_int(&writer, top->rr_graph[ipin].net_num);
+			put_snapshot_int(&writer, top->rr_graph[ipin].prev_node);
+			put_snapshot_int(&writer, (top->rr_node_to_pb_mapping[ipin] != NULL));
+		}
+	}
+
+	/* Clb nets */
+	put_snapshot_int(&writer, num_nets);
+	for (i = 0; i < num_nets; i++)
+		put_snapshot_net(&writer, &clb_net[i]);
+	put_snapshot_ints(&writer, clb_to_vpack_net_mapping, num_nets);
+	put_snapshot_ints(&writer, vpack_to_clb_net_mapping, num_logical_nets);
+
+	if (stage == SNAPSHOT_PLACED) {
+		put_snapshot_int(&writer, nx);
+		put_snapshot_int(&writer, ny);
+		for (iblk = 0; iblk < num_blocks; iblk++) {
+			put_snapshot_int(&writer, block[iblk].x);
+			put_snapshot_int(&writer, block[iblk].y);
+			put_snapshot_int(&writer, block[iblk].z);
+			put_snapshot_int(&writer, block[iblk].isFixed);
+		}
+	}
+
+	header[3] = (int) writer.checksum;
+	fseek(writer.fp, strlen(SNAPSHOT_MAGIC) + 3 * sizeof(int), SEEK_SET);
+	fwrite(&header[3], sizeof(int), 1, writer.fp);
+	if (ferror(writer.fp)) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Failed to write snapshot '%s'.\n", snapshot_file);
+		exit(1);
+	}
+	fclose(writer.fp);
+
+	vpr_printf(TIO_MESSAGE_INFO, "Saved %s snapshot '%s'.\n", stage_names[stage],
+			snapshot_file);
+}
+
+static void load_snapshot_file(t_snapshot_reader *reader, const char *fname) {
+
+	/* Brings the whole snapshot into memory with one read, mapping it   *
+	 * where mmap is available.                                          */
+
+	FILE *fp;
+	size_t num_read;
+#ifndef _WIN32
+	int fd;
+	struct stat file_stat;
+	void *mapped;
+#endif
+
+	reader->fname = fname;
+	reader->data = NULL;
+	reader->size = 0;
+	reader->is_mapped = FALSE;
+
+#ifndef _WIN32
+	fd = open(fname, O_RDONLY);
+	if (fd < 0) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Failed to open snapshot '%s'.\n", fname);
+		exit(1);
+	}
+	if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+		mapped = mmap(NULL, (size_t) file_stat.st_size, PROT_READ, MAP_PRIVATE,
+				fd, 0);
+		if (mapped != MAP_FAILED) {
+			close(fd);
+			reader->data = (char *) mapped;
+			reader->size = (size_t) file_stat.st_size;
+			reader->is_mapped = TRUE;
+			return;
+		}
+	}
+	close(fd);
+#endif
+
+	fp = fopen(fname, "rb");
+	if (fp == NULL) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Failed to open snapshot '%s'.\n", fname);
+		exit(1);
+	}
+	fseek(fp, 0, SEEK_END);
+	reader->size = (size_t) ftell(fp);
+	fseek(fp, 0, SEEK_SET);
+
+	reader->data = (char *) my_malloc(reader->size + 1);
+	num_read = fread(reader->data, 1, reader->size, fp);
+	fclose(fp);
+	if (num_read != reader->size) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Failed to read snapshot '%s'.\n", fname);
+		exit(1);
+	}
+}
+
+static void free_snapshot_file(t_snapshot_reader *reader) {
+
+#ifndef _WIN32
+	if (reader->is_mapped)
+		munmap(reader->data, reader->size);
+	else
+#endif
+		free(reader->data);
+	reader->data = NULL;
+	reader->size = 0;
+}
+
+static void bad_snapshot(t_snapshot_reader *reader, const char *what) {
+
+	vpr_printf(TIO_MESSAGE_ERROR, "Snapshot '%s' is corrupt: %s.\n",
+			reader->fname, what);
+	exit(1);
+}
+
+static void get_snapshot_bytes(t_snapshot_reader *reader, void *data,
+		size_t size) {
+
+	if ((size_t) (reader->end - reader->pos) < size)
+		bad_snapshot(reader, "truncated");
+	memcpy(data, reader->pos, size);
+	reader->pos += size;
+}
+
+static int get_snapshot_int(t_snapshot_reader *reader) {
+
+	int value;
+
+	get_snapshot_bytes(reader, &value, sizeof(int));
+	return (value);
+}
+
+static int *get_snapshot_ints(t_snapshot_reader *reader, int count) {
+
+	/* Returns a new copy of the next count ints, NULL if count is 0. */
+
+	int *values;
+
+	if (count < 0)
+		bad_snapshot(reader, "negative array size");
+	if (count == 0)
+		return (NULL);
+	values = (int *) my_malloc(count * sizeof(int));
+	get_snapshot_bytes(reader, values, count * sizeof(int));
+	return (values);
+}
+
+static char *get_snapshot_string(t_snapshot_reader *reader) {
+
+	/* Returns a new copy of the next string, NULL if it was written as NULL. */
+
+	int len;
+	char *s;
+
+	len = get_snapshot_int(reader);
+	if (len < 0)
+		return (NULL);
+	s = (char *) my_malloc((len + 1) * sizeof(char));
+	get_snapshot_bytes(reader, s, len);
+	s[len] = '\0';
+	return (s);
+}
+
+static void check_snapshot_indices(t_snapshot_reader *reader,
+		const int *values, int count, int limit, const char *what) {
+
+	/* Exits unless each of the count values is OPEN or in [0..limit-1]. */
+
+	int i;
+
+	for (i = 0; i < count; i++) {
+		if (values[i] < OPEN || values[i] >= limit)
+			bad_snapshot(reader, what);
+	}
+}
+
+static void get_snapshot_net(t_snapshot_reader *reader, struct s_net *net) {
+
+	/* The terminals are range-checked by check_snapshot_vpack_net or     *
+	 * check_snapshot_clb_net once the blocks they refer to are loaded.   */
+
+	memset(net, 0, sizeof(struct s_net));
+	net->name = get_snapshot_string(reader);
+	net->num_sinks = get_snapshot_int(reader);
+	if (net->num_sinks < 0)
+		bad_snapshot(reader, "negative net sink count");
+	net->node_block = get_snapshot_ints(reader, net->num_sinks + 1);
+	if (get_snapshot_int(reader))
+		net->node_block_port = get_snapshot_ints(reader, net->num_sinks + 1);
+	net->node_block_pin = get_snapshot_ints(reader, net->num_sinks + 1);
+	net->is_global = (boolean) get_snapshot_int(reader);
+	net->is_const_gen = (boolean) get_snapshot_int(reader);
+}
+
+static int get_snapshot_model_port_size(t_model_ports *ports, int index) {
+
+	/* Returns the size of the port of that index, OPEN if there is none. *
+	 * Clock and data ports are numbered apart, so two ports may share an *
+	 * index; the larger size is returned.                                */
+
+	int size;
+	t_model_ports *port;
+
+	size = OPEN;
+	for (port = ports; port != NULL; port = port->next) {
+		if (port->index == index && port->size > size)
+			size = port->size;
+	}
+	return (size);
+}
+
+static void check_snapshot_vpack_net(t_snapshot_reader *reader,
+		struct s_net *net) {
+
+	/* Exits unless every terminal of the vpack net is a pin of a logical *
+	 * block: the driver an output pin, the sinks input or clock pins.    */
+
+	int ipin, port_size;
+	t_model *model;
+
+	check_snapshot_indices(reader, net->node_block, net->num_sinks + 1,
+			num_logical_blocks, "vpack net terminal on an unknown logical block");
+	for (ipin = 0; ipin <= net->num_sinks; ipin++) {
+		if (net->node_block[ipin] == OPEN || net->node_block_port == NULL
+				|| net->node_block_port[ipin] == OPEN) {
+			if (net->node_block_pin[ipin] < OPEN)
+				bad_snapshot(reader, "vpack net terminal pin out of range");
+			continue;
+		}
+		model = logical_block[net->node_block[ipin]].model;
+		port_size = get_snapshot_model_port_size(
+				(ipin == 0 ? model->outputs : model->inputs),
+				net->node_block_port[ipin]);
+		if (port_size == OPEN)
+			bad_snapshot(reader, "vpack net terminal port out of range");
+		if (net->node_block_pin[ipin] < OPEN
+				|| net->node_block_pin[ipin] >= port_size)
+			bad_snapshot(reader, "vpack net terminal pin out of range");
+	}
+}
+
+static void check_snapshot_clb_net(t_snapshot_reader *reader,
+		struct s_net *net) {
+
+	/* Exits unless every terminal of the clb net is a pin of a complex   *
+	 * block.                                                             */
+
+	int ipin, num_pins;
+
+	check_snapshot_indices(reader, net->node_block, net->num_sinks + 1,
+			num_blocks, "clb net terminal on an unknown complex block");
+	for (ipin = 0; ipin <= net->num_sinks; ipin++) {
+		num_pins = (net->node_block[ipin] == OPEN ?
+				0 : block[net->node_block[ipin]].type->num_pins);
+		if (net->node_block_pin[ipin] < OPEN
+				|| net->node_block_pin[ipin] >= num_pins)
+			bad_snapshot(reader, "clb net terminal pin out of range");
+		if (net->node_block_port != NULL
+				&& (net->node_block_port[ipin] < OPEN
+						|| net->node_block_port[ipin] >= num_pins))
+			bad_snapshot(reader, "clb net terminal port out of range");
+	}
+}
+
+static t_model *find_snapshot_model(const char *name, t_model *user_models,
+		t_model *library_models) {
+
+	t_model *cur;
+
+	for (cur = user_models; cur != NULL; cur = cur->next) {
+		if (strcmp(cur->name, name) == 0)
+			return (cur);
+	}
+	for (cur = library_models; cur != NULL; cur = cur->next) {
+		if (strcmp(cur->name, name) == 0)
+			return (cur);
+	}
+	return (NULL);
+}
+
+static void get_snapshot_logical_block(t_snapshot_reader *reader, int iblk,
+		t_model *user_models, t_model *library_models) {
+
+	/* Loads logical_block[iblk], allocated the way read_blif does. */
+
+	int i, num_ports, num_lines;
+	char *model_name;
+	t_model_ports *port;
+	t_logical_block *blk;
+	struct s_linked_vptr *line, *tail;
+
+	blk = &logical_block[iblk];
+	blk->name = get_snapshot_string(reader);
+	blk->type = (enum logical_block_types) get_snapshot_int(reader);
+	blk->index = iblk;
+	blk->clb_index = OPEN;
+	blk->pb = NULL;
+
+	model_name = get_snapshot_string(reader);
+	blk->model = find_snapshot_model(model_name, user_models, library_models);
+	if (blk->model == NULL) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Snapshot '%s' uses model %s, which is not in the architecture.\n",
+				reader->fname, model_name);
+		exit(1);
+	}
+	free(model_name);
+
+	num_ports = 0;
+	for (port = blk->model->inputs; port != NULL; port = port->next) {
+		if (!port->is_clock)
+			num_ports++;
+	}
+	blk->input_nets = (num_ports == 0 ? NULL : (int **) my_malloc(num_ports * sizeof(int *)));
+	i = 0;
+	for (port = blk->model->inputs; port != NULL; port = port->next) {
+		if (!port->is_clock) {
+			if (get_snapshot_int(reader) != port->size)
+				bad_snapshot(reader, "logical block port does not match its model");
+			blk->input_nets[i] = get_snapshot_ints(reader, port->size);
+			check_snapshot_indices(reader, blk->input_nets[i], port->size,
+					num_logical_nets, "logical block input net out of range");
+			i++;
+		}
+	}
+
+	num_ports = 0;
+	for (port = blk->model->outputs; port != NULL; port = port->next)
+		num_ports++;
+	blk->output_nets = (num_ports == 0 ? NULL : (int **) my_malloc(num_ports * sizeof(int *)));
+	i = 0;
+	for (port = blk->model->outputs; port != NULL; port = port->next) {
+		if (get_snapshot_int(reader) != port->size)
+			bad_snapshot(reader, "logical block port does not match its model");
+		blk->output_nets[i] = get_snapshot_ints(reader, port->size);
+		check_snapshot_indices(reader, blk->output_nets[i], port->size,
+				num_logical_nets, "logical block output net out of range");
+		i++;
+	}
+
+	blk->clock_net = get_snapshot_int(reader);
+	check_snapshot_indices(reader, &blk->clock_net, 1, num_logical_nets,
+			"logical block clock net out of range");
+	blk->used_input_pins = get_snapshot_int(reader);
+
+	num_lines = get_snapshot_int(reader);
+	tail = NULL;
+	for (i = 0; i < num_lines; i++) {
+		line = (struct s_linked_vptr *) my_malloc(sizeof(struct s_linked_vptr));
+		line->data_vptr = get_snapshot_string(reader);
+		line->next = NULL;
+		if (tail == NULL)
+			blk->truth_table = line;
+		else
+			tail->next = line;
+		tail = line;
+	}
+}
+
+static void get_snapshot_pb(t_snapshot_reader *reader, t_pb *pb,
+		t_pb **rr_node_to_pb_mapping, int cb_index) {
+
+	/* Loads pb, whose pb_graph_node, parent_pb and rr_graph are already  *
+	 * set, and its subtree; allocates what processPb would.  Every pin   *
+	 * of pb is provisionally mapped to pb; the rr state clears the pins  *
+	 * the .net file did not mention.                                    */
+
+	int i, j, k, state;
+	const t_pb_type *pb_type;
+	t_pb_graph_node *pb_graph_node;
+	t_pb *child;
+
+	pb_graph_node = pb->pb_graph_node;
+	pb_type = pb_graph_node->pb_type;
+	pb->name = get_snapshot_string(reader);
+	pb->mode = get_snapshot_int(reader);
+	pb->logical_block = OPEN;
+	if (pb->mode < 0 || (pb_type->num_modes > 0 && pb->mode >= pb_type->num_modes))
+		bad_snapshot(reader, "pb mode out of range");
+
+	for (i = 0; i < pb_graph_node->num_input_ports; i++) {
+		for (j = 0; j < pb_graph_node->num_input_pins[i]; j++)
+			rr_node_to_pb_mapping[pb_graph_node->input_pins[i][j].pin_count_in_cluster] = pb;
+	}
+	for (i = 0; i < pb_graph_node->num_output_ports; i++) {
+		for (j = 0; j < pb_graph_node->num_output_pins[i]; j++)
+			rr_node_to_pb_mapping[pb_graph_node->output_pins[i][j].pin_count_in_cluster] = pb;
+	}
+	for (i = 0; i < pb_graph_node->num_clock_ports; i++) {
+		for (j = 0; j < pb_graph_node->num_clock_pins[i]; j++)
+			rr_node_to_pb_mapping[pb_graph_node->clock_pins[i][j].pin_count_in_cluster] = pb;
+	}
+
+	if (pb_type->num_modes == 0) {
+		if (strcmp(pb_type->blif_model, ".names") == 0) {
+			pb->lut_pin_remap = (int *) my_malloc(pb_type->num_input_pins * sizeof(int));
+			for (i = 0; i < pb_type->num_input_pins; i++)
+				pb->lut_pin_remap[i] = OPEN;
+		} else {
+			pb->lut_pin_remap = NULL;
+		}
+		pb->logical_block = get_snapshot_int(reader);
+		if (pb->logical_block != OPEN) {
+			if (pb->logical_block < 0 || pb->logical_block >= num_logical_blocks
+					|| logical_block[pb->logical_block].pb != NULL)
+				bad_snapshot(reader, "primitive holds an unknown or already placed logical block");
+			logical_block[pb->logical_block].pb = pb;
+			logical_block[pb->logical_block].clb_index = cb_index;
+		}
+		return;
+	}
+
+	pb->child_pbs = (t_pb **) my_calloc(pb_type->modes[pb->mode].num_pb_type_children,
+			sizeof(t_pb *));
+	for (i = 0; i < pb_type->modes[pb->mode].num_pb_type_children; i++) {
+		pb->child_pbs[i] = (t_pb *) my_calloc(
+				pb_type->modes[pb->mode].pb_type_children[i].num_pb, sizeof(t_pb));
+		for (k = 0; k < pb_type->modes[pb->mode].pb_type_children[i].num_pb; k++)
+			pb->child_pbs[i][k].logical_block = OPEN;
+	}
+	for (i = 0; i < pb_type->modes[pb->mode].num_pb_type_children; i++) {
+		for (j = 0; j < pb_type->modes[pb->mode].pb_type_children[i].num_pb; j++) {
+			child = &pb->child_pbs[i][j];
+			state = get_snapshot_int(reader);
+			if (state == SNAPSHOT_PB_ABSENT)
+				continue;
+			if (state != SNAPSHOT_PB_UNUSED && state != SNAPSHOT_PB_USED)
+				bad_snapshot(reader, "unknown pb state");
+			child->pb_graph_node = &pb_graph_node->child_pb_graph_nodes[pb->mode][i][j];
+			if (state == SNAPSHOT_PB_USED) {
+				child->parent_pb = pb;
+				child->rr_graph = pb->rr_graph;
+				get_snapshot_pb(reader, child, rr_node_to_pb_mapping, cb_index);
+			}
+		}
+	}
+}
+
+static void get_snapshot_block(t_snapshot_reader *reader, int iblk,
+		const t_arch *arch) {
+
+	/* Loads block[iblk] with its pb tree, rr graph and local nets. */
+
+	int itype, ipin, mapped;
+	t_pb *top;
+
+	block[iblk].name = get_snapshot_string(reader);
+	itype = get_snapshot_int(reader);
+	if (itype < 0 || itype >= num_types || type_descriptors[itype].pb_graph_head == NULL)
+		bad_snapshot(reader, "block type out of range");
+	block[iblk].type = &type_descriptors[itype];
+	block[iblk].nets = get_snapshot_ints(reader, block[iblk].type->num_pins);
+
+	block[iblk].pb = (t_pb *) my_calloc(1, sizeof(t_pb));
+	top = block[iblk].pb;
+	alloc_cb_rr_graph(&block[iblk], arch);
+	get_snapshot_pb(reader, top, top->rr_node_to_pb_mapping, iblk);
+	if (top->name == NULL || strcmp(top->name, block[iblk].name) != 0)
+		bad_snapshot(reader, "complex block and its top pb have different names");
+
+	for (ipin = 0; ipin < top->pb_graph_node->total_pb_pins; ipin++) {
+		top->rr_graph[ipin].net_num = get_snapshot_int(reader);
+		top->rr_graph[ipin].prev_node = get_snapshot_int(reader);
+		mapped = get_snapshot_int(reader);
+		if (top->rr_graph[ipin].net_num < OPEN
+				|| top->rr_graph[ipin].net_num >= num_logical_nets
+				|| top->rr_graph[ipin].prev_node < OPEN
+				|| top->rr_graph[ipin].prev_node >= top->pb_graph_node->total_pb_pins
+				|| (mapped && top->rr_node_to_pb_mapping[ipin] == NULL))
+			bad_snapshot(reader, "bad pb routing");
+		if (!mapped)
+			top->rr_node_to_pb_mapping[ipin] = NULL;
+	}
+	load_cb_internal_nets(&block[iblk]);
+}
+
+void read_snapshot(INP const char *snapshot_file, INP const char *arch_file,
+		INP const t_arch *arch, INP t_model *user_models,
+		INP t_model *library_models) {
+
+	/* Loads a snapshot written by write_snapshot in place of read_blif   *
+	 * and read_netlist.  The placement of a placed snapshot is kept for  *
+	 * restore_snapshot_placement.  Exits if the file is corrupt, from    *
+	 * another version, or was made for another architecture.            */
+
+	t_snapshot_reader reader;
+	int header[4];
+	int i, iblk, num_removed, stage, checksum;
+	char *name;
+	boolean ok;
+	struct s_linked_vptr *tvptr, *tail;
+	clock_t begin, end;
+
+	begin = clock();
+	load_snapshot_file(&reader, snapshot_file);
+	ok = (boolean) (reader.size >= strlen(SNAPSHOT_MAGIC) + sizeof(header)
+			&& strncmp(reader.data, SNAPSHOT_MAGIC, strlen(SNAPSHOT_MAGIC)) == 0);
+	if (!ok) {
+		vpr_printf(TIO_MESSAGE_ERROR, "'%s' is not a snapshot.\n", snapshot_file);
+		exit(1);
+	}
+	memcpy(header, reader.data + strlen(SNAPSHOT_MAGIC), sizeof(header));
+	if (header[1] != SNAPSHOT_BYTE_ORDER || header[0] != SNAPSHOT_VERSION) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Snapshot '%s' was written by another version of VPR or on another kind of machine.\n",
+				snapshot_file);
+		exit(1);
+	}
+	stage = header[2];
+	checksum = header[3];
+	reader.pos = reader.data + strlen(SNAPSHOT_MAGIC) + sizeof(header);
+	reader.end = reader.data + reader.size;
+	if (stage < 0 || stage >= NUM_SNAPSHOT_STAGES)
+		bad_snapshot(&reader, "unknown stage");
+	if ((int) update_snapshot_checksum(2166136261u, reader.pos, reader.end - reader.pos)
+			!= checksum)
+		bad_snapshot(&reader, "checksum mismatch");
+
+	/* Architecture */
+	name = get_snapshot_string(&reader);
+	if (name == NULL || strcmp(name, arch_file) != 0) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Architecture file that generated snapshot '%s' (%s) does not match current architecture file (%s).\n",
+				snapshot_file, (name ? name : ""), arch_file);
+		exit(1);
+	}
+	free(name);
+	ok = (boolean) (get_snapshot_int(&reader) == num_types);
+	for (i = 0; ok && i < num_types; i++) {
+		name = get_snapshot_string(&reader);
+		ok = (boolean) (name != NULL && strcmp(name, type_descriptors[i].name) == 0
+				&& get_snapshot_int(&reader) == type_descriptors[i].num_pins
+				&& get_snapshot_int(&reader) == (type_descriptors[i].pb_graph_head == NULL ?
+						0 : type_descriptors[i].pb_graph_head->total_pb_pins));
+		free(name);
+	}
+	if (!ok) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Snapshot '%s' was made with different block types than architecture file %s now describes.\n",
+				snapshot_file, arch_file);
+		exit(1);
+	}
+
+	/* Circuit */
+	blif_circuit_name = get_snapshot_string(&reader);
+	num_p_inputs = get_snapshot_int(&reader);
+	num_p_outputs = get_snapshot_int(&reader);
+	num_removed = get_snapshot_int(&reader);
+	tail = NULL;
+	for (i = 0; i < num_removed; i++) {
+		tvptr = (struct s_linked_vptr *) my_malloc(sizeof(struct s_linked_vptr));
+		tvptr->data_vptr = get_snapshot_string(&reader);
+		tvptr->next = NULL;
+		if (tail == NULL)
+			circuit_p_io_removed = tvptr;
+		else
+			tail->next = tvptr;
+		tail = tvptr;
+	}
+
+	/* Vpack nets and logical blocks */
+	num_logical_nets = get_snapshot_int(&reader);
+	if (num_logical_nets < 0)
+		bad_snapshot(&reader, "negative net count");
+	vpack_net = (struct s_net *) my_calloc(num_logical_nets, sizeof(struct s_net));
+	for (i = 0; i < num_logical_nets; i++)
+		get_snapshot_net(&reader, &vpack_net[i]);
+
+	num_logical_blocks = get_snapshot_int(&reader);
+	if (num_logical_blocks < 0)
+		bad_snapshot(&reader, "negative block count");
+	logical_block = (struct s_logical_block *) my_calloc(num_logical_blocks,
+			sizeof(struct s_logical_block));
+	for (iblk = 0; iblk < num_logical_blocks; iblk++)
+		get_snapshot_logical_block(&reader, iblk, user_models, library_models);
+	for (i = 0; i < num_logical_nets; i++)
+		check_snapshot_vpack_net(&reader, &vpack_net[i]);
+
+	/* Complex blocks */
+	num_blocks = get_snapshot_int(&reader);
+	if (num_blocks < 0)
+		bad_snapshot(&reader, "negative complex block count");
+	block = (struct s_block *) my_calloc(num_blocks, sizeof(struct s_block));
+	for (iblk = 0; iblk < num_blocks; iblk++)
+		get_snapshot_block(&reader, iblk, arch);
+	for (iblk = 0; iblk < num_logical_blocks; iblk++) {
+		if (logical_block[iblk].pb == NULL) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Snapshot '%s' does not pack logical block %s.\n",
+					snapshot_file, logical_block[iblk].name);
+			exit(1);
+		}
+	}
+
+	/* Clb nets */
+	num_nets = get_snapshot_int(&reader);
+	if (num_nets < 0)
+		bad_snapshot(&reader, "negative clb net count");
+	clb_net = (struct s_net *) my_calloc(num_nets, sizeof(struct s_net));
+	for (i = 0; i < num_nets; i++) {
+		get_snapshot_net(&reader, &clb_net[i]);
+		check_snapshot_clb_net(&reader, &clb_net[i]);
+	}
+	for (iblk = 0; iblk < num_blocks; iblk++)
+		check_snapshot_indices(&reader, block[iblk].nets,
+				block[iblk].type->num_pins, num_nets,
+				"complex block pin on an unknown clb net");
+	clb_to_vpack_net_mapping = get_snapshot_ints(&reader, num_nets);
+	check_snapshot_indices(&reader, clb_to_vpack_net_mapping, num_nets,
+			num_logical_nets, "clb net mapped to an unknown vpack net");
+	vpack_to_clb_net_mapping = get_snapshot_ints(&reader, num_logical_nets);
+	check_snapshot_indices(&reader, vpack_to_clb_net_mapping, num_logical_nets,
+			num_nets, "vpack net mapped to an unknown clb net");
+
+	if (stage == SNAPSHOT_PLACED) {
+		placement_file = my_strdup(snapshot_file);
+		placement_nx = get_snapshot_int(&reader);
+		placement_ny = get_snapshot_int(&reader);
+		placement_locs = get_snapshot_ints(&reader, 4 * num_blocks);
+	}
+	if (reader.pos != reader.end)
+		bad_snapshot(&reader, "trailing data");
+	free_snapshot_file(&reader);
+
+	end = clock();
+#ifdef CLOCKS_PER_SEC
+	vpr_printf(TIO_MESSAGE_INFO, "Loaded %s snapshot '%s': %d atoms, %d blocks, %d nets in %g seconds.\n",
+			stage_names[stage], snapshot_file, num_logical_blocks, num_blocks, num_nets,
+			(float) (end - begin) / CLOCKS_PER_SEC);
+#else
+	vpr_printf(TIO_MESSAGE_INFO, "Loaded %s snapshot '%s': %d atoms, %d blocks, %d nets in %g seconds.\n",
+			stage_names[stage], snapshot_file, num_logical_blocks, num_blocks, num_nets,
+			(float) (end - begin) / CLK_PER_SEC);
+#endif
+}
+
+boolean restore_snapshot_placement(void) {
+
+	/* Puts every block at the location saved in a placed snapshot, in    *
+	 * place of read_place.  Returns FALSE if no placed snapshot was      *
+	 * read.  The caller syncs the grid to the blocks.  Exits if a block  *
+	 * is saved off the grid or at a slot its type cannot fill.           */
+
+	int iblk, x, y, z;
+
+	if (placement_file == NULL)
+		return (FALSE);
+
+	if (placement_nx != nx || placement_ny != ny) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Snapshot '%s' was placed on a %d x %d grid, but this run has a %d x %d grid.\n",
+				placement_file, placement_nx, placement_ny, nx, ny);
+		exit(1);
+	}
+	for (iblk = 0; iblk < num_blocks; iblk++) {
+		x = placement_locs[4 * iblk];
+		y = placement_locs[4 * iblk + 1];
+		z = placement_locs[4 * iblk + 2];
+		if (x < 0 || x > nx + 1 || y < 0 || y > ny + 1) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Snapshot '%s' places block %s at (%d,%d), off the %d x %d grid.\n",
+					placement_file, block[iblk].name, x, y, nx, ny);
+			exit(1);
+		}
+		if (grid[x][y].type != block[iblk].type || grid[x][y].offset != 0
+				|| z < 0 || z >= grid[x][y].type->capacity) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Snapshot '%s' places block %s of type %s at (%d,%d,%d), which cannot hold it.\n",
+					placement_file, block[iblk].name, block[iblk].type->name,
+					x, y, z);
+			exit(1);
+		}
+		block[iblk].x = x;
+		block[iblk].y = y;
+		block[iblk].z = z;
+		block[iblk].isFixed = (boolean) placement_locs[4 * iblk + 3];
+	}
+	vpr_printf(TIO_MESSAGE_INFO, "Placement restored from snapshot '%s'.\n",
+			placement_file);
+
+	free(placement_file);
+	free(placement_locs);
+	placement_file = NULL;
+	placement_locs = NULL;
+	return (TRUE);
+}
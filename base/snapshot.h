@@ -0,0 +1,24 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+/* Binary snapshot of the flow state (--write_snapshot, --read_snapshot).   *
+ * A packed snapshot holds the logical blocks and vpack nets, the complex   *
+ * blocks with their pb trees, and the clb nets, as they are once the .net  *
+ * file has been read.  A placed snapshot also holds the grid size and the  *
+ * block locations.  Loading a snapshot replaces reading the blif and .net  *
+ * files and, for a placed snapshot, the .place file.                       */
+
+enum e_snapshot_stage {
+	SNAPSHOT_PACKED, SNAPSHOT_PLACED, NUM_SNAPSHOT_STAGES
+};
+
+void write_snapshot(INP const char *snapshot_file,
+		INP enum e_snapshot_stage stage, INP const char *arch_file);
+
+void read_snapshot(INP const char *snapshot_file, INP const char *arch_file,
+		INP const t_arch *arch, INP t_model *user_models,
+		INP t_model *library_models);
+
+boolean restore_snapshot_placement(void);
+
+#endif
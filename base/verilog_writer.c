@@ -1,6 +1,8 @@
 
 #include "verilog_writer.h"
 
+#define VERILOG_BLOCKS_PER_RANGE 64 /* blocks one thread writes per round */
+
 /***********************************************************************************************************
 
 Author: Miad Nasr;  August 30, 2012
@@ -58,13 +60,17 @@ Sixth - Instantiate_primitive_modules() will instantiate all the primitives in t
                                                                 to other primitives
                                                                -Instantiate the SDF block corersponding to this primitive
 
- 
+The wires, input interconnects and primitives of each complex block are written by a separate function
+(instantiate_block_wires() and friends) that is handed a range of blocks. write_out_bufs_parallel() runs
+these on several threads, each into its own Verilog and SDF buffers, and appends the buffers to the files
+in block order, so the files are the same as when written serially and only a few blocks of text are held
+in memory at a time.
 */
 
 void verilog_writer(void)
 {
-  FILE *verilog;
-  FILE *SDF;
+  t_out_buf *verilog;
+  t_out_buf *SDF;
   char * verilog_file_name = (char *)malloc((strlen(blif_circuit_name) + strlen("_post_synthesis.v") + 1) *sizeof(char));/*creating the Verilog file name*/
   char * sdf_file_name = (char *)malloc((strlen(blif_circuit_name) + strlen("_post_synthesis.sdf") + 1) *sizeof(char));/*creating the SDF file name*/
   char *clock_name;/*Will need to store the clock name of the design if any exist*/ 
@@ -76,8 +82,8 @@ void verilog_writer(void)
   sprintf(sdf_file_name, "%s%s", blif_circuit_name, "_post_synthesis.sdf");
 
   /*Openning the post synthesized netlist files*/
-  verilog = fopen(verilog_file_name , "w");
-  SDF = fopen(sdf_file_name , "w");
+  verilog = open_out_file(verilog_file_name);
+  SDF = open_out_file(sdf_file_name);
 
   clock_name = find_clock_name();
   instantiate_top_level_module(verilog);
@@ -86,15 +92,15 @@ void verilog_writer(void)
   instantiate_input_interconnect(verilog , SDF , clock_name);
   instantiate_primitive_modules(verilog,clock_name,SDF);
 
-  fprintf(verilog , "\nendmodule\n");
-  fprintf(SDF , ")\n");
-  fclose(verilog);
-  fclose(SDF);
+  out_printf(verilog , "\nendmodule\n");
+  out_printf(SDF , ")\n");
+  close_out_file(verilog);
+  close_out_file(SDF);
   printf("Done\n\n");
 }
 
 /*The function instantiate_top_level_module instantiates the top level verilog module of the post-synthesized circuit and the list of inputs and outputs to that module*/
-void instantiate_top_level_module(FILE *verilog)
+void instantiate_top_level_module(t_out_buf *verilog)
 {
   int i,place_comma;
   pb_list *temp=NULL;
@@ -102,7 +108,7 @@ void instantiate_top_level_module(FILE *verilog)
   char *fixed_name = NULL;
  
 
-  fprintf(verilog , "module %s(\n" , blif_circuit_name);
+  out_printf(verilog , "module %s(\n" , blif_circuit_name);
   place_comma=0;
   for(i=0 ; i<num_blocks ; i++)/*go through all the blocks in the design*/
     {
@@ -112,46 +118,53 @@ void instantiate_top_level_module(FILE *verilog)
           for(current=temp ; current!=NULL ; current=current->next)/*traverse through all the primitives in this block*/
             {
               if(place_comma){       /*need this for correct placement of commas and verilog syntax correctness*/
-                fprintf(verilog ,"\t,");
+                out_printf(verilog ,"\t,");
               }
               else{
-                fprintf(verilog ,"\t");
+                out_printf(verilog ,"\t");
                 place_comma=1;
               }
               fixed_name = fix_name(current->pb->name);/*need to do this, because some names contain characters that cause syntax errors in verilog (e.g. '~' , '^',)*/
               if(!strcmp(logical_block[current->pb->logical_block].model->name,"input")){/*if this primitive is an input pin, declare as input*/
 
-                fprintf(verilog , "input %s\n",fixed_name);/*declaring the inputs*/
+                out_printf(verilog , "input %s\n",fixed_name);/*declaring the inputs*/
 	
 	     
               }
               else if(!strcmp(logical_block[current->pb->logical_block].model->name,"output")){
 
-                fprintf(verilog , "output %s\n",fixed_name);/*declaring the outputs*/
+                out_printf(verilog , "output %s\n",fixed_name);/*declaring the outputs*/
 	      }
               free(fixed_name);
             }
         }
       temp = free_linked_list(temp);
     }
-  fprintf(verilog , ");\n\n");
+  out_printf(verilog , ");\n\n");
 
 }
 
-void instantiate_SDF_header(FILE *SDF)
+void instantiate_SDF_header(t_out_buf *SDF)
 {
-  fprintf(SDF , "(DELAYFILE\n\t(SDFVERSION \"2.1\")\n\t(DIVIDER /)\n\t(TIMESCALE 1 ps)\n\n ");
+  out_printf(SDF , "(DELAYFILE\n\t(SDFVERSION \"2.1\")\n\t(DIVIDER /)\n\t(TIMESCALE 1 ps)\n\n ");
 }
 
 /*The instantiate_wires function instantiates all the wire in the post-synthesized design*/
-void instantiate_wires(FILE *verilog)
+void instantiate_wires(t_out_buf *verilog)
+{
+  write_out_bufs_parallel(&verilog , 1 , num_blocks , VERILOG_BLOCKS_PER_RANGE , instantiate_block_wires , NULL);
+}
+
+/*Instantiates the wires of blocks first_block to last_block-1 into outs[0] (the Verilog file)*/
+void instantiate_block_wires(t_out_buf **outs , int first_block , int last_block , void *context)
 {
   int i,j,k;
   pb_list *primitive_list=NULL;
   pb_list *current;
   char *fixed_name = NULL;
+  t_out_buf *verilog = outs[0];
 
-  for(i=0; i<num_blocks ; i++)/*go through all the blocks in the design*/
+  for(i=first_block; i<last_block ; i++)/*go through all the blocks in the range*/
     {
       primitive_list = traverse_clb(block[i].pb , primitive_list);/*find all the primitives in this block*/
 
@@ -164,12 +177,12 @@ void instantiate_wires(FILE *verilog)
                 {
                  
                     
-                      fprintf(verilog , "wire %s_output_%d_%d;\n" , fixed_name , j , k);
+                      out_printf(verilog , "wire %s_output_%d_%d;\n" , fixed_name , j , k);
 
                       if(!strcmp(logical_block[current->pb->logical_block].model->name,"input"))/*if that pin is an inpad pin then have to connect the                                        
                                                                                                   inputs to the module to this wire*/
 			{
-                          fprintf(verilog , "assign %s_output_%d_%d = %s;\n\n",fixed_name , j , k , fixed_name);
+                          out_printf(verilog , "assign %s_output_%d_%d = %s;\n\n",fixed_name , j , k , fixed_name);
                         }
 
                     
@@ -179,11 +192,11 @@ void instantiate_wires(FILE *verilog)
             {
               for(k=0 ; k<current->pb->pb_graph_node->num_input_pins[j] ; k++)
                 {          
-		  fprintf(verilog , "wire %s_input_%d_%d;\n" , fixed_name , j , k);
+		  out_printf(verilog , "wire %s_input_%d_%d;\n" , fixed_name , j , k);
 		  if(!strcmp(logical_block[current->pb->logical_block].model->name,"output"))/*if that pin is an outpad then have to connect the input to the outputs 
 											       of the top level module*/
 		    {
-		      fprintf(verilog , "assign %s = %s_input_%d_%d;\n\n",fixed_name , fixed_name , j , k);
+		      out_printf(verilog , "assign %s = %s_input_%d_%d;\n\n",fixed_name , fixed_name , j , k);
 		    }     
                 }
             }
@@ -197,14 +210,28 @@ void instantiate_wires(FILE *verilog)
   The function instantiate_input_interconnect will instantiate the interconnect segments from input pins to the rest of the design.
   This function is necessary because the inputs to the design are not instantiated as a module in verilog.
 */
-void instantiate_input_interconnect(FILE *verilog , FILE *SDF , char *clock_name)
+void instantiate_input_interconnect(t_out_buf *verilog , t_out_buf *SDF , char *clock_name)
+{
+  t_out_buf *outs[2];
+
+  outs[0] = verilog;
+  outs[1] = SDF;
+  write_out_bufs_parallel(outs , 2 , num_blocks , VERILOG_BLOCKS_PER_RANGE , instantiate_block_input_interconnect , clock_name);
+}
+
+/*Instantiates the input interconnects of blocks first_block to last_block-1 into outs[0] (Verilog) and outs[1] (SDF).
+  context is the clock name.*/
+void instantiate_block_input_interconnect(t_out_buf **outs , int first_block , int last_block , void *context)
 {
   int blocks;
   pb_list *current;
   pb_list *primitive_list = NULL;
   conn_list *downhill = NULL;
+  t_out_buf *verilog = outs[0];
+  t_out_buf *SDF = outs[1];
+  char *clock_name = (char *)context;
 
-  for(blocks=0 ; blocks<num_blocks ; blocks++)
+  for(blocks=first_block ; blocks<last_block ; blocks++)
     {
       if(strcmp(block[blocks].pb->pb_graph_node->pb_type->name,"io"))/*if this is an io block*/
         {
@@ -234,7 +261,18 @@ void instantiate_input_interconnect(FILE *verilog , FILE *SDF , char *clock_name
 }
 
 /*This function instantiates the primitive verilog modules e.g. LUTs ,Flip Flops, etc.*/
-void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
+void instantiate_primitive_modules(t_out_buf *fp, char *clock_name , t_out_buf *SDF)
+{
+  t_out_buf *outs[2];
+
+  outs[0] = fp;
+  outs[1] = SDF;
+  write_out_bufs_parallel(outs , 2 , num_blocks , VERILOG_BLOCKS_PER_RANGE , instantiate_block_primitive_modules , clock_name);
+}
+
+/*Instantiates the primitives of blocks first_block to last_block-1, with the interconnects they drive, into outs[0] (Verilog)
+  and outs[1] (SDF). context is the clock name.*/
+void instantiate_block_primitive_modules(t_out_buf **outs , int first_block , int last_block , void *context)
 {
   int i,j,k,h;
   pb_list *primitives = NULL;
@@ -245,7 +283,11 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
   int inputs_to_lut;
   char *fixed_name = NULL;
   int power;
-  for(i=0 ; i<num_blocks ; i++)
+  t_out_buf *fp = outs[0];
+  t_out_buf *SDF = outs[1];
+  char *clock_name = (char *)context;
+
+  for(i=first_block ; i<last_block ; i++)
     {
       primitives = traverse_clb(block[i].pb , primitives);/*find all the primitives inside block i*/
       for(current=primitives ; current!=NULL ; current=current->next)/*traverse through all the found primitives*/
@@ -262,7 +304,7 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 	      /*instantiating the 6 input lut module and passing the truth table as parameter*/
 
 	      power = 1 <<  inputs_to_lut;
-	      fprintf(fp , "\nLUT_%d #(%d'b%s) lut_%s(", inputs_to_lut , power , truth_table , fixed_name);
+	      out_printf(fp , "\nLUT_%d #(%d'b%s) lut_%s(", inputs_to_lut , power , truth_table , fixed_name);
 
 	      free(truth_table);
 
@@ -275,11 +317,11 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 			{
 			  if(place_comma)/*need this flag check to properly place the commas*/
 			    {
-			      fprintf(fp , " , %s_input_%d_%d" , fixed_name , k , j); // j was h
+			      out_printf(fp , " , %s_input_%d_%d" , fixed_name , k , j); // j was h
 			    }
 			  else
 			    {
-			      fprintf(fp , "%s_input_%d_%d" , fixed_name , k , j); // j was h
+			      out_printf(fp , "%s_input_%d_%d" , fixed_name , k , j); // j was h
 			      place_comma=1;
 			    }
 			  j++;
@@ -292,18 +334,18 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 		  if(place_comma && j)
 		    {
 		      j++;
-		      fprintf(fp , " , 1'b0");
+		      out_printf(fp , " , 1'b0");
 		    }
 		  else
 		    {
 		      j++;
-		      fprintf(fp , "1'b0");
+		      out_printf(fp , "1'b0");
 		      place_comma=1;
 		    }
 		}
 
 	      place_comma=0;
-	      fprintf(fp , " , %s_output_0_0 );\n\n",fixed_name);/*finaly write the output of the module*/
+	      out_printf(fp , " , %s_output_0_0 );\n\n",fixed_name);/*finaly write the output of the module*/
 
 	      instantiate_interconnect(fp,i,current->pb,SDF);/*this function will instantiate the routing                                                                                    
                                                                           interconnect from the output of this lut to                                                                         
@@ -314,7 +356,7 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 	    {
 	      char *fixed_clock_name;
 	      fixed_clock_name = fix_name(clock_name);
-	      fprintf(fp , "\nD_Flip_Flop DFF_%s(%s_output_0_0 , %s_input_0_0 , 1'b1 , 1'b1 , %s_output_0_0 );\n",fixed_name,fixed_clock_name,fixed_name,fixed_name);
+	      out_printf(fp , "\nD_Flip_Flop DFF_%s(%s_output_0_0 , %s_input_0_0 , 1'b1 , 1'b1 , %s_output_0_0 );\n",fixed_name,fixed_clock_name,fixed_name,fixed_name);
 	      instantiate_interconnect(fp , i , current->pb , SDF);
 	      sdf_DFF_delay_printing(SDF , current->pb);
 	      free(fixed_clock_name);
@@ -329,19 +371,19 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 	      int i_port , i_pin ;	      
 	      place_comma = 0;
 	      if (mult)
-		fprintf(fp , "\nmult #(%d)%s(" , num_inputs , fixed_name); 
+		out_printf(fp , "\nmult #(%d)%s(" , num_inputs , fixed_name); 
 	      else
-		fprintf(fp , "\nripple_adder #(%d)%s(" , num_inputs , fixed_name); 
+		out_printf(fp , "\nripple_adder #(%d)%s(" , num_inputs , fixed_name); 
 	
 	      /*Traversing through all the input ports of this multiplier*/
 	      for(i_port=0 ; i_port<logical_block[current->pb->logical_block].pb->pb_graph_node->num_input_ports ; i_port++)
 		{
 		  if(i_port == 0)/*This if-else statement will make sure that the signals are concatinated in verilog*/
 		    {
-		      fprintf(fp , "{");
+		      out_printf(fp , "{");
 		    }
 		  else{
-		    fprintf(fp , ",{");
+		    out_printf(fp , ",{");
 		  }
 		  place_comma = 0;
 		  /*Traversing through all the input pins of this input port*/
@@ -352,11 +394,11 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 			{
 			  if(place_comma)/*need this flag check to properly place the commas*/
 			    {
-			      fprintf(fp , " , %s_input_%d_%d" , fixed_name , i_port , i_pin);
+			      out_printf(fp , " , %s_input_%d_%d" , fixed_name , i_port , i_pin);
 			    }
 			  else
 			    {
-			      fprintf(fp , "%s_input_%d_%d" , fixed_name , i_port , i_pin);
+			      out_printf(fp , "%s_input_%d_%d" , fixed_name , i_port , i_pin);
 			      place_comma=1;
 			    }
 			
@@ -364,36 +406,36 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 		      else{/*If this pin was not used, then instantiate logic zero*/
 			if(place_comma)
 			  {
-			    fprintf(fp , ", 1'b0");
+			    out_printf(fp , ", 1'b0");
 			  }
 			else{
-			  fprintf(fp , " 1'b0");
+			  out_printf(fp , " 1'b0");
 			  place_comma = 1;
 			}
 		      }
 		    }
-		  fprintf(fp , "}");/*End concatination*/
+		  out_printf(fp , "}");/*End concatination*/
 		}
 	      /*Traversing through all the output ports of this multiplier*/
 	      for(i_port=0 ; i_port<logical_block[current->pb->logical_block].pb->pb_graph_node->num_output_ports ; i_port++)
 		{
-		  fprintf(fp , ",{");/*Since there is only a single output port for multipliers we only need to concatinate once*/
+		  out_printf(fp , ",{");/*Since there is only a single output port for multipliers we only need to concatinate once*/
 		  place_comma = 0;
 		  /*Traversing through all the output pins of this output port*/
 		  for(i_pin=logical_block[current->pb->logical_block].pb->pb_graph_node->num_output_pins[i_port]-1 ; i_pin>=0 ; i_pin--)
 		    {
 		      if(place_comma)
 			{
-			  fprintf(fp , ", %s_output_%d_%d" , fixed_name , i_port , i_pin);
+			  out_printf(fp , ", %s_output_%d_%d" , fixed_name , i_port , i_pin);
 			}
 		      else{
-			fprintf(fp , " %s_output_%d_%d" , fixed_name , i_port , i_pin);
+			out_printf(fp , " %s_output_%d_%d" , fixed_name , i_port , i_pin);
 			place_comma = 1;
 		      }
 		    }
-		  fprintf(fp , "}");/*End concatination*/
+		  out_printf(fp , "}");/*End concatination*/
 		}
-	      fprintf(fp , ");\n\n");
+	      out_printf(fp , ");\n\n");
 	      instantiate_interconnect(fp , i , current->pb , SDF);
 	      if (mult)
 		SDF_Mult_delay_printing(SDF, current->pb);
@@ -409,16 +451,16 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 	    data_width = logical_block[current->pb->logical_block].pb->pb_graph_node->num_input_pins[1];/*the data_width (word width) is the number of inputs in the data port*/
 	    addr_width = logical_block[current->pb->logical_block].pb->pb_graph_node->num_input_pins[0];/*the addr_width (address width) is the number of inputs in the addr port*/
 
-	    fprintf(fp , "\nsingle_port_ram #(%d,%d)%s(" , addr_width , data_width , fixed_name);/*Passing the address width and data width as a verilog parameter*/
+	    out_printf(fp , "\nsingle_port_ram #(%d,%d)%s(" , addr_width , data_width , fixed_name);/*Passing the address width and data width as a verilog parameter*/
 	    /*Traversign through all the input ports of this single_port_ram*/
 	    for(i_port=0 ; i_port<logical_block[current->pb->logical_block].pb->pb_graph_node->num_input_ports ; i_port++)
 	      {
 		if(i_port == 0)/*This if-else statement will make sure that the signals are concatinated in verilog*/
 		  {
-		    fprintf(fp , "{");
+		    out_printf(fp , "{");
 		  }
 		else{
-		  fprintf(fp , ",{");
+		  out_printf(fp , ",{");
 		}
 		place_comma = 0;
 		/*Traversing through all the input pins of this input port*/
@@ -429,49 +471,49 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 		      {
 			if(place_comma)/*need this flag check to properly place the commas*/
 			  {
-			    fprintf(fp , " , %s_input_%d_%d" , fixed_name , i_port , i_pin);
+			    out_printf(fp , " , %s_input_%d_%d" , fixed_name , i_port , i_pin);
 			  }
 			else
 			  {
-			    fprintf(fp , "%s_input_%d_%d" , fixed_name , i_port , i_pin);
+			    out_printf(fp , "%s_input_%d_%d" , fixed_name , i_port , i_pin);
 			    place_comma=1;
 			  }
 		      }
 		    else{/*If this input pin is not used then instantiate a logic zero*/
 		      if(place_comma)
 			{
-			  fprintf(fp , ", 1'b0");
+			  out_printf(fp , ", 1'b0");
 			}
 		      else{
-			fprintf(fp , " 1'b0");
+			out_printf(fp , " 1'b0");
 			place_comma = 1;
 		      }
 		    }
 		  }
-		fprintf(fp , "}");/*End concatination*/
+		out_printf(fp , "}");/*End concatination*/
 	      }
 	    /*Traversign through all the output ports of this single_port_ram*/
 	    for(i_port=0 ; i_port<logical_block[current->pb->logical_block].pb->pb_graph_node->num_output_ports ; i_port++)
 	      {
-		fprintf(fp , ",{");/*Since there is only a single output port for single_port_rams we only need to concatinate once*/
+		out_printf(fp , ",{");/*Since there is only a single output port for single_port_rams we only need to concatinate once*/
 		place_comma = 0;
 		/*Traverse through all the output pins of this output port*/
 		for(i_pin=logical_block[current->pb->logical_block].pb->pb_graph_node->num_output_pins[i_port]-1 ; i_pin>=0 ; i_pin--)
 		  {
 		    if(place_comma)
 		      {
-			fprintf(fp , ", %s_output_%d_%d" , fixed_name , i_port , i_pin);
+			out_printf(fp , ", %s_output_%d_%d" , fixed_name , i_port , i_pin);
 		      }
 		    else{
-		      fprintf(fp , " %s_output_%d_%d" , fixed_name , i_port , i_pin);
+		      out_printf(fp , " %s_output_%d_%d" , fixed_name , i_port , i_pin);
 		      place_comma = 1;
 		    }
 		  }
-		fprintf(fp , "}");/*End concatination*/
+		out_printf(fp , "}");/*End concatination*/
 	      }
 	    fixed_clock_name = fix_name(clock_name);/*Must also instantiate the clock signal to the RAM block*/
-	    fprintf(fp , ", %s_output_0_0" , fixed_clock_name);
-	    fprintf(fp , ");\n\n");
+	    out_printf(fp , ", %s_output_0_0" , fixed_clock_name);
+	    out_printf(fp , ");\n\n");
 	    free(fixed_clock_name);
 	    instantiate_interconnect(fp , i , current->pb , SDF);
 	    SDF_ram_single_port_delay_printing(SDF , current->pb);
@@ -496,16 +538,16 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 	    data2_width = current->pb->pb_graph_node->num_input_pins[3];/*the data_width (word width) for the second port, is the number of inputs in the second data port*/
 	    addr2_width = current->pb->pb_graph_node->num_input_pins[1];/*the addr_width (address width) for the second port is the number of inputs in the second addr port*/
 	    
-	    fprintf(fp , "\ndual_port_ram #(%d,%d,%d,%d)%s(" , addr1_width , data1_width , addr2_width , data2_width , fixed_name);/*passing the addr_wdith and data_wdith for both ports as verilog parameter*/
+	    out_printf(fp , "\ndual_port_ram #(%d,%d,%d,%d)%s(" , addr1_width , data1_width , addr2_width , data2_width , fixed_name);/*passing the addr_wdith and data_wdith for both ports as verilog parameter*/
 	   
 	    for(i_port=0 ; i_port<logical_block[current->pb->logical_block].pb->pb_graph_node->num_input_ports ; i_port++)
               {
                 if(i_port == 0)
                   {
-                    fprintf(fp , "{");
+                    out_printf(fp , "{");
                   }
                 else{
-                  fprintf(fp , ",{");
+                  out_printf(fp , ",{");
                 }
                 place_comma = 0;
 		/*Traversign through all the input pins of this input port*/
@@ -516,49 +558,49 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
                       {
                         if(place_comma)/*need this flag check to properly place the commas*/
                           {
-                            fprintf(fp , " , %s_input_%d_%d" , fixed_name , i_port , i_pin);
+                            out_printf(fp , " , %s_input_%d_%d" , fixed_name , i_port , i_pin);
                           }
                         else
                           {
-                            fprintf(fp , "%s_input_%d_%d" , fixed_name , i_port , i_pin);
+                            out_printf(fp , "%s_input_%d_%d" , fixed_name , i_port , i_pin);
                             place_comma=1;
                           }
                       }
                     else{/*If this pin is not used, then instantiate logic zero instead*/
                       if(place_comma)
                         {
-                          fprintf(fp , ", 1'b0");
+                          out_printf(fp , ", 1'b0");
                         }
                       else{
-                        fprintf(fp , " 1'b0");
+                        out_printf(fp , " 1'b0");
                         place_comma = 1;
                       }
                     }
                   }
-                fprintf(fp , "}");/*End concatination*/
+                out_printf(fp , "}");/*End concatination*/
               }
 	    /*Traversign through all the output ports of this dual_port_ram*/
 	    for(i_port=0 ; i_port<logical_block[current->pb->logical_block].pb->pb_graph_node->num_output_ports ; i_port++)
               {
-                fprintf(fp , ",{");
+                out_printf(fp , ",{");
                 place_comma = 0;
 		/*Traverse through all the output pins of this output port*/
                 for(i_pin=logical_block[current->pb->logical_block].pb->pb_graph_node->num_output_pins[i_port]-1 ; i_pin>=0 ; i_pin--)
                   {
                     if(place_comma)
                       {
-                        fprintf(fp , ", %s_output_%d_%d" , fixed_name , i_port , i_pin);
+                        out_printf(fp , ", %s_output_%d_%d" , fixed_name , i_port , i_pin);
                       }
                     else{
-                      fprintf(fp , " %s_output_%d_%d" , fixed_name , i_port , i_pin);
+                      out_printf(fp , " %s_output_%d_%d" , fixed_name , i_port , i_pin);
                       place_comma = 1;
                     }
                   }
-                fprintf(fp , "}");
+                out_printf(fp , "}");
               }
             fixed_clock_name = fix_name(clock_name);/*Must also instantiate the clock */
-            fprintf(fp , ", %s_output_0_0" , fixed_clock_name);
-            fprintf(fp , ");\n\n");
+            out_printf(fp , ", %s_output_0_0" , fixed_clock_name);
+            out_printf(fp , ");\n\n");
             free(fixed_clock_name);
             instantiate_interconnect(fp , i , current->pb , SDF);
             SDF_ram_dual_port_delay_printing(SDF , current->pb);
@@ -577,7 +619,7 @@ void instantiate_primitive_modules(FILE *fp, char *clock_name , FILE *SDF)
 }
 
 /*This function instantiates the interconnect modules that connect from the output pins of the primitive "pb" to whatever it connects to block_num is the block number that the pb resides in*/
-void instantiate_interconnect(FILE *verilog , int block_num , t_pb *pb , FILE *SDF)
+void instantiate_interconnect(t_out_buf *verilog , int block_num , t_pb *pb , t_out_buf *SDF)
 {
   conn_list *downhill_connections = NULL;
 
@@ -754,35 +796,23 @@ int find_number_of_inputs(t_pb *pb)
 }
 
 /*This function is a utility function called by intantiate_interconnect*/
-void interconnect_printing(FILE *fp , conn_list *downhill)
+void interconnect_printing(t_out_buf *fp , conn_list *downhill)
 {
   char *fixed_name1;
   char *fixed_name2;
   conn_list *connections;
-  int port_number_out=-1,port_number_in=-1,i;  
+  int port_number_out,port_number_in;  
 
     for(connections=downhill ; connections!=NULL ; connections=connections->next)/*traverse through all the connected primitives and instantiate a routing interconect module*/
     {
       fixed_name1 = fix_name(connections->driver_pb->name);
       fixed_name2 = fix_name(connections->load_pb->name);
 
-      for(i=0 ; i<connections->load_pin->parent_node->num_input_ports ; i++)
-	{
-	  if(!strcmp(connections->load_pin->parent_node->input_pins[i][0].port->name,connections->load_pin->port->name))
-	    {
-	      port_number_out = i;
-	    }
-	}
-      for(i=0 ; i<connections->driver_pin->parent_node->num_output_ports ; i++)
-        {
-          if(!strcmp(connections->driver_pin->parent_node->output_pins[i][0].port->name,connections->driver_pin->port->name))
-            {
-              port_number_in = i;
-            }
-        }     
+      port_number_out = connections->load_port_number;
+      port_number_in = connections->driver_port_number;
       assert(port_number_out >= 0 && port_number_in >= 0);
 
-      fprintf(fp , "interconnect routing_segment_%s_output_%d_%d_to_%s_input_%d_%d( %s_output_%d_%d , %s_input_%d_%d );\n",
+      out_printf(fp , "interconnect routing_segment_%s_output_%d_%d_to_%s_input_%d_%d( %s_output_%d_%d , %s_input_%d_%d );\n",
               fixed_name1 , port_number_in/*connections->driver_pin->port->port_index_by_type*/ , connections->driver_pin->pin_number,
               fixed_name2 , port_number_out , connections->load_pin->pin_number,
               fixed_name1 , port_number_in/*connections->driver_pin->port->port_index_by_type*/ , connections->driver_pin->pin_number,
@@ -794,43 +824,31 @@ void interconnect_printing(FILE *fp , conn_list *downhill)
 }
 
 /*This funciton will instantiate the SDF cell that contains the delay information of the Verilog interconnect modules*/
-void SDF_interconnect_delay_printing(FILE *SDF , conn_list *downhill)
+void SDF_interconnect_delay_printing(t_out_buf *SDF , conn_list *downhill)
 {
   conn_list *connections;
   char *fixed_name1;
   char *fixed_name2;
   float internal_delay;
   int del;
-  int port_number_out=-1,port_number_in=-1,i;  
+  int port_number_out,port_number_in;  
 
    for(connections=downhill ; connections!=NULL ; connections=connections->next)/*traverse through all the connected primitives and instantiate a routing interconect module*/
     {
       fixed_name1 = fix_name(connections->driver_pb->name);
       fixed_name2 = fix_name(connections->load_pb->name);
 
-      for(i=0 ; i<connections->load_pin->parent_node->num_input_ports ; i++)
-	{
-	  if(!strcmp(connections->load_pin->parent_node->input_pins[i][0].port->name,connections->load_pin->port->name))
-	    {
-	      port_number_out = i;
-	    }
-	}
-      for(i=0 ; i<connections->driver_pin->parent_node->num_output_ports ; i++)
-        {
-          if(!strcmp(connections->driver_pin->parent_node->output_pins[i][0].port->name,connections->driver_pin->port->name))
-            {
-              port_number_in = i;
-            }
-        }     
+      port_number_out = connections->load_port_number;
+      port_number_in = connections->driver_port_number;
       internal_delay = connections->driver_to_load_delay;
       internal_delay = internal_delay * 1000000000000.00; /*converting the delay from seconds to picoseconds*/
       internal_delay = internal_delay + 0.5;              /*Rounding the delay to the nearset picosecond*/
       del = (int)internal_delay;
 
-      fprintf(SDF , "\t(CELL\n\t(CELLTYPE \"interconnect\")\n\t(INSTANCE inst/routing_segment_%s_output_%d_%d_to_%s_input_%d_%d)\n" ,
+      out_printf(SDF , "\t(CELL\n\t(CELLTYPE \"interconnect\")\n\t(INSTANCE inst/routing_segment_%s_output_%d_%d_to_%s_input_%d_%d)\n" ,
 	      fixed_name1 , port_number_in/*connections->driver_pin->port->port_index_by_type*/ , connections->driver_pin->pin_number,
               fixed_name2 , port_number_out , connections->load_pin->pin_number);
-      fprintf(SDF , "\t\t(DELAY\n\t\t(ABSOLUTE\n\t\t\t(IOPATH datain dataout (%d:%d:%d)(%d:%d:%d))\n\t\t)\n\t\t)\n\t)\n" ,
+      out_printf(SDF , "\t\t(DELAY\n\t\t(ABSOLUTE\n\t\t\t(IOPATH datain dataout (%d:%d:%d)(%d:%d:%d))\n\t\t)\n\t\t)\n\t)\n" ,
               del , del , del , del , del , del);
 
       free(fixed_name1);
@@ -840,7 +858,7 @@ void SDF_interconnect_delay_printing(FILE *SDF , conn_list *downhill)
 }
 
 /*This function instantiates the SDF cell that contains the delay information of a LUT*/
-void sdf_LUT_delay_printing(FILE *SDF , t_pb *pb)
+void sdf_LUT_delay_printing(t_out_buf *SDF , t_pb *pb)
 {
   char *fixed_name;
   int j,pin_count;
@@ -873,39 +891,39 @@ void sdf_LUT_delay_printing(FILE *SDF , t_pb *pb)
           del = (int)internal_delay;
 
 	  if (!record) { // print the SDF record header
-	    fprintf(SDF , "\t(CELL\n\t(CELLTYPE \"LUT_%d\")\n\t(INSTANCE inst/lut_%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" , find_number_of_inputs(pb) , fixed_name);
+	    out_printf(SDF , "\t(CELL\n\t(CELLTYPE \"LUT_%d\")\n\t(INSTANCE inst/lut_%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" , find_number_of_inputs(pb) , fixed_name);
 	    record = 1;
 	  }
 
-          fprintf(SDF , "\t\t\t(IOPATH inter%d/datain inter%d/dataout (%d:%d:%d)(%d:%d:%d))\n" , j , j , del , del , del , del , del , del);
+          out_printf(SDF , "\t\t\t(IOPATH inter%d/datain inter%d/dataout (%d:%d:%d)(%d:%d:%d))\n" , j , j , del , del , del , del , del , del);
         }
     }
   if (record) 
-    fprintf(SDF , "\t\t)\n\t\t)\n\t)\n");
+    out_printf(SDF , "\t\t)\n\t\t)\n\t)\n");
   free(fixed_name);
 }
 
 /*This function instantiates the SdF cell that contains the delay information of a Flip Flop*/
-void sdf_DFF_delay_printing(FILE *SDF , t_pb *pb)
+void sdf_DFF_delay_printing(t_out_buf *SDF , t_pb *pb)
 {
   char *fixed_name;
   float internal_delay;
   int del,pin_count;
 
   fixed_name = fix_name(pb->name);
-  fprintf(SDF , "\t(CELL\n\t(CELLTYPE \"D_Flip_Flop\")\n\t(INSTANCE inst/DFF_%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" , fixed_name);
+  out_printf(SDF , "\t(CELL\n\t(CELLTYPE \"D_Flip_Flop\")\n\t(INSTANCE inst/DFF_%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" , fixed_name);
 
   pin_count = pb->pb_graph_node->output_pins[0][0].pin_count_in_cluster; // the Q output of the FF (which has only a single output port and pin)
   assert(pb->rr_graph[pin_count].tnode);
   internal_delay = pb->rr_graph[pin_count].tnode->T_arr * 1.0E12 + 0.5;
   del = (int)internal_delay;
 
-  fprintf(SDF , "\t\t\t(IOPATH (posedge clock) Q (%d:%d:%d)(%d:%d:%d))\n" , del , del , del , del , del , del);
-  fprintf(SDF , "\t\t)\n\t\t)\n\t)\n");
+  out_printf(SDF , "\t\t\t(IOPATH (posedge clock) Q (%d:%d:%d)(%d:%d:%d))\n" , del , del , del , del , del , del);
+  out_printf(SDF , "\t\t)\n\t\t)\n\t)\n");
   free(fixed_name);
 }
 
-void SDF_Mult_delay_printing(FILE *SDF , t_pb *pb)
+void SDF_Mult_delay_printing(t_out_buf *SDF , t_pb *pb)
 {
   char *fixed_name;
   int pin_count;
@@ -913,7 +931,7 @@ void SDF_Mult_delay_printing(FILE *SDF , t_pb *pb)
   int del;
 
   fixed_name = fix_name(pb->name);
-  fprintf(SDF , "\t(CELL\n\t(CELLTYPE \"mult\")\n\t(INSTANCE inst/%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" ,  fixed_name);
+  out_printf(SDF , "\t(CELL\n\t(CELLTYPE \"mult\")\n\t(INSTANCE inst/%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" ,  fixed_name);
 
 
   pin_count = pb->pb_graph_node->input_pins[0][0].pin_count_in_cluster;
@@ -922,7 +940,7 @@ void SDF_Mult_delay_printing(FILE *SDF , t_pb *pb)
   internal_delay = internal_delay * 1000000000000.00;/*converting the delay from seconds to picoseconds*/
   internal_delay = internal_delay + 0.5;             /*Rounding the delay to the nearset picosecond*/
   del = (int)internal_delay;
-  fprintf(SDF , "\t\t\t(IOPATH delay/A delay/B (%d:%d:%d)(%d:%d:%d))\n" , del , del , del , del , del , del);
+  out_printf(SDF , "\t\t\t(IOPATH delay/A delay/B (%d:%d:%d)(%d:%d:%d))\n" , del , del , del , del , del , del);
   
   pin_count = pb->pb_graph_node->input_pins[1][0].pin_count_in_cluster;
   assert(pb->rr_graph[pin_count].tnode);
@@ -930,14 +948,14 @@ void SDF_Mult_delay_printing(FILE *SDF , t_pb *pb)
   internal_delay = internal_delay * 1.0E12;/*converting the delay from seconds to picoseconds*/
   internal_delay = internal_delay + 0.5;             /*Rounding the delay to the nearset picosecond*/
   del = (int)internal_delay;
-  fprintf(SDF , "\t\t\t(IOPATH delay2/A delay2/B (%d:%d:%d)(%d:%d:%d))\n" , del , del , del , del , del , del);
+  out_printf(SDF , "\t\t\t(IOPATH delay2/A delay2/B (%d:%d:%d)(%d:%d:%d))\n" , del , del , del , del , del , del);
   
-  fprintf(SDF , "\t\t)\n\t\t)\n\t)\n");
+  out_printf(SDF , "\t\t)\n\t\t)\n\t)\n");
   free(fixed_name);
   
 }
 
-void SDF_Adder_delay_printing(FILE *SDF , t_pb *pb)
+void SDF_Adder_delay_printing(t_out_buf *SDF , t_pb *pb)
 {
   int i, j, k;
   int total_input_ports = pb->pb_graph_node->num_input_ports;
@@ -964,11 +982,11 @@ void SDF_Adder_delay_printing(FILE *SDF , t_pb *pb)
 	int del = tNodeInput->out_edges[k].Tdel * 1.0E12 + 0.5;
 
 	if (!record) { // print the SDF record header
-	  fprintf(SDF , "\t(CELL\n\t(CELLTYPE \"ripple_adder\")\n\t(INSTANCE inst/%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" ,  fixed_name);
+	  out_printf(SDF , "\t(CELL\n\t(CELLTYPE \"ripple_adder\")\n\t(INSTANCE inst/%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" ,  fixed_name);
 	  record = 1;
 	}
 
-	fprintf(SDF , "\t\t\t(IOPATH %s %s (%d:%d:%d)(%d:%d:%d))\n" , tNodeInput->pb_graph_pin->port->name, 
+	out_printf(SDF , "\t\t\t(IOPATH %s %s (%d:%d:%d)(%d:%d:%d))\n" , tNodeInput->pb_graph_pin->port->name, 
 		tNodeOutput.pb_graph_pin->port->name,
 		del , del , del , del , del , del);
 
@@ -979,12 +997,12 @@ void SDF_Adder_delay_printing(FILE *SDF , t_pb *pb)
   }
 
   if (record)
-    fprintf(SDF , "\t\t)\n\t\t)\n\t)\n");
+    out_printf(SDF , "\t\t)\n\t\t)\n\t)\n");
   free(fixed_name);
 }
 
 
-void SDF_ram_single_port_delay_printing(FILE *SDF , t_pb *pb)
+void SDF_ram_single_port_delay_printing(t_out_buf *SDF , t_pb *pb)
 {
   //  int num_inputs;
   char *fixed_name;
@@ -994,21 +1012,21 @@ void SDF_ram_single_port_delay_printing(FILE *SDF , t_pb *pb)
 
   //  num_inputs = pb->pb_graph_node->num_input_pins[0];
   fixed_name = fix_name(pb->name);
-  fprintf(SDF , "\t(CELL\n\t(CELLTYPE \"single_port_ram\")\n\t(INSTANCE inst/%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" ,  fixed_name);
+  out_printf(SDF , "\t(CELL\n\t(CELLTYPE \"single_port_ram\")\n\t(INSTANCE inst/%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" ,  fixed_name);
 
   pin_count = pb->pb_graph_node->output_pins[0][0].pin_count_in_cluster; // an output pin of the RAM
   assert(pb->rr_graph[pin_count].tnode);
   internal_delay = pb->rr_graph[pin_count].tnode->T_arr * 1.0E12 + 0.5;
   del = (int)internal_delay;
 
-  fprintf(SDF , "\t\t\t(IOPATH (posedge clock) out (%d:%d:%d)(%d:%d:%d))" , del , del , del , del , del , del);
+  out_printf(SDF , "\t\t\t(IOPATH (posedge clock) out (%d:%d:%d)(%d:%d:%d))" , del , del , del , del , del , del);
 
-  fprintf(SDF , "\t\t)\n\t\t)\n\t)\n");
+  out_printf(SDF , "\t\t)\n\t\t)\n\t)\n");
   free(fixed_name);
 
 }
 
-void SDF_ram_dual_port_delay_printing(FILE *SDF , t_pb *pb)
+void SDF_ram_dual_port_delay_printing(t_out_buf *SDF , t_pb *pb)
 {
   //  int num_inputs;
   char *fixed_name;
@@ -1018,17 +1036,17 @@ void SDF_ram_dual_port_delay_printing(FILE *SDF , t_pb *pb)
 
   //  num_inputs = pb->pb_graph_node->num_input_pins[0];
   fixed_name = fix_name(pb->name);
-  fprintf(SDF , "\t(CELL\n\t(CELLTYPE \"dual_port_ram\")\n\t(INSTANCE inst/%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" ,  fixed_name);
+  out_printf(SDF , "\t(CELL\n\t(CELLTYPE \"dual_port_ram\")\n\t(INSTANCE inst/%s)\n\t\t(DELAY\n\t\t(ABSOLUTE\n" ,  fixed_name);
 
   pin_count = pb->pb_graph_node->output_pins[0][0].pin_count_in_cluster; // an output pin of the RAM
   assert(pb->rr_graph[pin_count].tnode);
   internal_delay = pb->rr_graph[pin_count].tnode->T_arr * 1.0E12 + 0.5;
   del = (int)internal_delay;
 
-  fprintf(SDF , "\t\t\t(IOPATH (posedge clock) out1 (%d:%d:%d)(%d:%d:%d))" , del , del , del , del , del , del);
-  fprintf(SDF , "\t\t\t(IOPATH (posedge clock) out2 (%d:%d:%d)(%d:%d:%d))" , del , del , del , del , del , del);
+  out_printf(SDF , "\t\t\t(IOPATH (posedge clock) out1 (%d:%d:%d)(%d:%d:%d))" , del , del , del , del , del , del);
+  out_printf(SDF , "\t\t\t(IOPATH (posedge clock) out2 (%d:%d:%d)(%d:%d:%d))" , del , del , del , del , del , del);
 
-  fprintf(SDF , "\t\t)\n\t\t)\n\t)\n");
+  out_printf(SDF , "\t\t)\n\t\t)\n\t)\n");
   free(fixed_name);
 }
 
@@ -1100,12 +1118,9 @@ conn_list *find_connected_primitives_downhill(int block_num , t_pb *pb , conn_li
   int pin_number , port_number_out=-1 ,  pin_number_out , starting_block , next_block , vpck_net , pin_count;
   float delay , start_delay , end_delay;
  
-  char *temp_port_name = (char *)malloc(1000 * sizeof(char));
   int total_output_ports = pb->pb_graph_node->num_output_ports; 
   int model_port_index;
 
-  assert(temp_port_name);
-
   /*iterates through all output pins of the primitive "pb", and finds the other primitive and pin they connect to*/
   for(i=0 ; i < total_output_ports ; i++)
   {
@@ -1124,6 +1139,7 @@ conn_list *find_connected_primitives_downhill(int block_num , t_pb *pb , conn_li
 	  { /*Then we will use the logical_block netlist method for finding the connectivity and timing information*/
 	      if(vpck_net != OPEN)
 	      {
+		  start_delay = pb->rr_graph[pin_number].tnode->T_arr; /*The arrival time of the source pin, shared by all the sinks of the net*/
 
 		  for(k=1 ; k<vpack_net[vpck_net].num_sinks+1 ; k++)/*traversing through all the sink primitives that the source primitive connects to*/
 		  {
@@ -1171,20 +1187,18 @@ conn_list *find_connected_primitives_downhill(int block_num , t_pb *pb , conn_li
 		      pin_count = logical_block[next_block].pb->pb_graph_node->input_pins[port_number_out][pin_number_out].pin_count_in_cluster;/*pin count for the sink pin*/
 		      assert(logical_block[next_block].pb->rr_graph[pin_count].tnode);
 		      
-		      start_delay = pb->rr_graph[pin_number].tnode->T_arr; /*The arrival time of the source pin*/		
 		      end_delay = logical_block[next_block].pb->rr_graph[pin_count].tnode->T_arr;/*The arrival time of the sink pin*/
 		      delay = end_delay - start_delay;   /*The difference of start and end arrival times is the delay for going from the source to sink pin*/		
 		      list=insert_to_linked_list_conn(pb , logical_block[next_block].pb , 
 						      &pb->pb_graph_node->output_pins[i][j] , 
 						      &logical_block[next_block].pb->pb_graph_node->input_pins[port_number_out][unswapped_pin_number] ,
-						      delay , list);/*Insert this sink primitive in the linked list pointer to by "list"*/
+						      i , port_number_out , delay , list);/*Insert this sink primitive in the linked list pointer to by "list"*/
 		      
 		    }
 		}
 	    }
 	}
     }
-  free(temp_port_name);
   return(list);  
 }
 
@@ -1198,7 +1212,7 @@ pb_list *insert_to_linked_list(t_pb *pb_new , pb_list *list)
   return(list);
 }
 
-conn_list *insert_to_linked_list_conn(t_pb *driver_new , t_pb *load_new , t_pb_graph_pin *driver_pin_ , t_pb_graph_pin *load_pin_ , float path_delay , conn_list *list)
+conn_list *insert_to_linked_list_conn(t_pb *driver_new , t_pb *load_new , t_pb_graph_pin *driver_pin_ , t_pb_graph_pin *load_pin_ , int driver_port_number_ , int load_port_number_ , float path_delay , conn_list *list)
 {
   conn_list *new_list = (conn_list *)malloc(1 * sizeof(conn_list));
   assert(new_list);
@@ -1206,6 +1220,8 @@ conn_list *insert_to_linked_list_conn(t_pb *driver_new , t_pb *load_new , t_pb_g
   new_list->load_pb = load_new;
   new_list->driver_pin = driver_pin_;
   new_list->load_pin = load_pin_;
+  new_list->driver_port_number = driver_port_number_;
+  new_list->load_port_number = load_port_number_;
   new_list->driver_to_load_delay = path_delay;
   new_list->next = list;
   list = new_list;
@@ -21,6 +21,7 @@
 #include "string.h"
 #include "stdlib.h"
 #include "math.h"
+#include "out_buf.h"
 
 /* 
 verilog_writer.c defines the main functions used to: 
@@ -67,6 +68,8 @@ typedef struct found_pins{
 	       The port index and pin number for the pin is accessible through this data structure.
    load_pin: A pointer to the t_pb_graph_pin data structure corresponding to the input pin that receives the signal from the driver_pin.
              The port index and pin number for the pin is accessible through this data structure.
+   driver_port_number: The index of the driver pin's port among the output ports of the driver primitive.
+   load_port_number: The index of the load pin's port among the input ports of the load primitive.
    driver_to_load_delay: The delay, in seconds, for a signal to propagate from the driver pin to the load pin.
    next: pointer to the next driver-load pair found.
 */
@@ -77,6 +80,8 @@ typedef struct found_connectivity{
 
   t_pb_graph_pin *driver_pin;
   t_pb_graph_pin *load_pin;
+  int driver_port_number;
+  int load_port_number;
   
   float driver_to_load_delay;
 
@@ -109,7 +114,7 @@ conn_list *find_connected_primitives_downhill(int block_num , t_pb *pb , conn_li
 pb_list *insert_to_linked_list(t_pb *pb_new , pb_list *list);
 
 /*The function insert_to_linked_list_conn inserts a new primitive to the conn_list type linked list pointed by "list".*/
-conn_list *insert_to_linked_list_conn(t_pb *driver_new , t_pb *load_new , t_pb_graph_pin *driver_pin_ , t_pb_graph_pin *load_pin_ , float path_delay , conn_list *list);
+conn_list *insert_to_linked_list_conn(t_pb *driver_new , t_pb *load_new , t_pb_graph_pin *driver_pin_ , t_pb_graph_pin *load_pin_ , int driver_port_number_ , int load_port_number_ , float path_delay , conn_list *list);
 
 /*The traverse_linked_list function prints the entire pb_list type linked list pointed to by "list"*/
 void traverse_linked_list(pb_list *list);
@@ -124,19 +129,31 @@ pb_list *free_linked_list(pb_list *list);
 conn_list *free_linked_list_conn(conn_list *list);
 
 /*The function instantiate_top_level_module instantiates the top level verilog module of the post-synthesized circuit and the list of inputs and outputs to that module*/
-void instantiate_top_level_module(FILE *Verilog);
+void instantiate_top_level_module(t_out_buf *Verilog);
 
 /*The instantiate_wires function instantiates all the wire in the post-synthesized design*/
-void instantiate_wires(FILE *Verilog);
+void instantiate_wires(t_out_buf *Verilog);
+
+/*The instantiate_block_wires function instantiates the wires of blocks first_block to last_block-1 into outs[0] (the Verilog file).
+  It is run on several threads at once by instantiate_wires.*/
+void instantiate_block_wires(t_out_buf **outs , int first_block , int last_block , void *context);
 
 /*The function instantiate_input_interconnect will instantiate the interconnect segments from input pins to the rest of the design*/
-void instantiate_input_interconnect(FILE *Verilog , FILE *SDF , char *clock_name);
+void instantiate_input_interconnect(t_out_buf *Verilog , t_out_buf *SDF , char *clock_name);
+
+/*The instantiate_block_input_interconnect function does the same for blocks first_block to last_block-1, writing to outs[0] (Verilog) and outs[1] (SDF).
+  context is the clock name. It is run on several threads at once by instantiate_input_interconnect.*/
+void instantiate_block_input_interconnect(t_out_buf **outs , int first_block , int last_block , void *context);
 
 /*This function instantiates the interconnect modules that connect from the output pins of the primitive "pb" to whatever it connects to*/
-void instantiate_interconnect(FILE *Verilog , int block_num , t_pb *pb , FILE *SDF);
+void instantiate_interconnect(t_out_buf *Verilog , int block_num , t_pb *pb , t_out_buf *SDF);
 
 /*This function instantiates the primitive verilog modules e.g. LUTs ,Flip Flops, etc.*/
-void instantiate_primitive_modules(FILE *Verilog , char *clock_name , FILE *SDF);
+void instantiate_primitive_modules(t_out_buf *Verilog , char *clock_name , t_out_buf *SDF);
+
+/*This function instantiates the primitives of blocks first_block to last_block-1, writing to outs[0] (Verilog) and outs[1] (SDF).
+  context is the clock name. It is run on several threads at once by instantiate_primitive_modules.*/
+void instantiate_block_primitive_modules(t_out_buf **outs , int first_block , int last_block , void *context);
 
 /*This function returns the truth table corresponding to the LUT primitive represented by "pb"*/
 char *load_truth_table(int inputs , t_pb *pb);
@@ -152,31 +169,31 @@ int find_number_of_inputs(t_pb *pb);
 int find_index(char *row,int inputs);
 
 /*This function is a utility function called by intantiate_interconnect*/
-void interconnect_printing(FILE *fp , conn_list *downhill);
+void interconnect_printing(t_out_buf *fp , conn_list *downhill);
 
 /*This function will instantiate the header of te Standar Delay Format (SDF) file.*/
-void instantiate_SDF_header(FILE *SDF);
+void instantiate_SDF_header(t_out_buf *SDF);
 
 /*This funciton will instantiate the SDF cell that contains the delay information of the Verilog interconnect modules*/
-void SDF_interconnect_delay_printing(FILE *SDF , conn_list *downhill);
+void SDF_interconnect_delay_printing(t_out_buf *SDF , conn_list *downhill);
 
 /*This function instantiates the SDF cell that contains the delay information of a LUT*/
-void sdf_LUT_delay_printing(FILE *SDF , t_pb *pb);
+void sdf_LUT_delay_printing(t_out_buf *SDF , t_pb *pb);
 
 /*This function instantiates the SdF cell that contains the delay information of a Flip Flop*/
-void sdf_DFF_delay_printing(FILE *SDF , t_pb *pb);
+void sdf_DFF_delay_printing(t_out_buf *SDF , t_pb *pb);
 
 /*This function instantiates the SdF cell that contains the delay information of a Multiplier*/
-void SDF_Mult_delay_printing(FILE *SDF , t_pb *pb);
+void SDF_Mult_delay_printing(t_out_buf *SDF , t_pb *pb);
 
 /*This function instantiates the SdF cell that contains the delay information of a Adder*/
-void SDF_Adder_delay_printing(FILE *SDF , t_pb *pb);
+void SDF_Adder_delay_printing(t_out_buf *SDF , t_pb *pb);
 
 /*Finds and returns the name of the clock signal int he circuit*/
 char *find_clock_name(void);
 
 /*This function instantiates the SdF cell that contains the delay information of a Single_port_RAM*/
-void SDF_ram_single_port_delay_printing(FILE *SDF , t_pb *pb);
+void SDF_ram_single_port_delay_printing(t_out_buf *SDF , t_pb *pb);
 
 /*This function instantiates the SdF cell that contains the delay information of a Dual_port_RAM*/
-void SDF_ram_dual_port_delay_printing(FILE *SDF , t_pb *pb);
+void SDF_ram_dual_port_delay_printing(t_out_buf *SDF , t_pb *pb);
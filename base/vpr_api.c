@@ -38,6 +38,7 @@
 #include "timing_place_lookup.h"
 #include "cluster_legality.h"
 #include "route_export.h"
+#include "snapshot.h"
 #include "vpr_api.h"
 #include "read_sdc.h"
 #include "power.h"
@@ -93,6 +94,10 @@ void vpr_print_usage(void) {
 			"\t[--blif_file <string>][--net_file <string>][--place_file <string>]\n");
 	vpr_printf(TIO_MESSAGE_INFO,
 			"\t[--route_file <string>][--sdc_file <string>][--echo_file on | off]\n");
+	vpr_printf(TIO_MESSAGE_INFO,
+			"\t[--echo_compression off | gzip | zstd]\n");
+	vpr_printf(TIO_MESSAGE_INFO,
+			"\t[--write_snapshot <string>][--read_snapshot <string>][--import_route <string>]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\n");
 	vpr_printf(TIO_MESSAGE_INFO, "Packer Options:\n");
 	/*    vpr_printf(TIO_MESSAGE_INFO, "\t[-global_clocks on|off]\n");
@@ -101,13 +106,16 @@ void vpr_print_usage(void) {
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--timing_driven_clustering on|off]\n");
 	vpr_printf(TIO_MESSAGE_INFO,
 			"\t[--cluster_seed_type timing|max_inputs] [--alpha_clustering <float>] [--beta_clustering <float>]\n");
-	/*    vpr_printf(TIO_MESSAGE_INFO, "\t[-recompute_timing_after <int>] [-cluster_block_delay <float>]\n"); */
+	vpr_printf(TIO_MESSAGE_INFO, "\t[--recompute_timing_after <int>] (off by default; each re-timing is a full timing analysis)\n");
+	/*    vpr_printf(TIO_MESSAGE_INFO, "\t[-cluster_block_delay <float>]\n"); */
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--allow_unrelated_clustering on|off]\n");
 	/*    vpr_printf(TIO_MESSAGE_INFO, "\t[-allow_early_exit on|off]\n"); 
 	 vpr_printf(TIO_MESSAGE_INFO, "\t[-intra_cluster_net_delay <float>] \n");
 	 vpr_printf(TIO_MESSAGE_INFO, "\t[-inter_cluster_net_delay <float>] \n"); */
 	vpr_printf(TIO_MESSAGE_INFO,
 			"\t[--connection_driven_clustering on|off] \n");
+	vpr_printf(TIO_MESSAGE_INFO, "\t[--pack_workers <int>] [--pack_deterministic on|off]\n");
+	vpr_printf(TIO_MESSAGE_INFO, "\t[--pack_profile on|off]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\n");
 	vpr_printf(TIO_MESSAGE_INFO, "Placer Options:\n");
 	vpr_printf(TIO_MESSAGE_INFO,
@@ -115,11 +123,16 @@ void vpr_print_usage(void) {
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--init_t <float>] [--exit_t <float>]\n");
 	vpr_printf(TIO_MESSAGE_INFO,
 			"\t[--alpha_t <float>] [--inner_num <float>] [--seed <int>]\n");
+	vpr_printf(TIO_MESSAGE_INFO, "\t[--anneal_adaptive on | off] [--anneal_exit_window <int>]\n");
+	vpr_printf(TIO_MESSAGE_INFO, "\t[--anneal_exit_improvement <float>]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--place_cost_exp <float>]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--place_chan_width <int>] \n");
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--fix_pins random | <file.pads>]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--enable_timing_computations on | off]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--block_dist <int>]\n");
+	vpr_printf(TIO_MESSAGE_INFO, "\t[--place_checkpoint <file>] [--place_checkpoint_t <float>]\n");
+	vpr_printf(TIO_MESSAGE_INFO, "\t[--place_resume <file>] [--place_fork <int>]\n");
+	vpr_printf(TIO_MESSAGE_INFO, "\t[--place_profile <file>]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\n");
 	vpr_printf(TIO_MESSAGE_INFO,
 			"Placement Options Valid Only for Timing-Driven Placement:\n");
@@ -128,6 +141,7 @@ void vpr_print_usage(void) {
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--inner_loop_recompute_divider <int>]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--td_place_exp_first <float>]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--td_place_exp_last <float>]\n");
+	vpr_printf(TIO_MESSAGE_INFO, "\t[--place_delay_cache <file>]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\n");
 
 #ifdef INTERPOSER_BASED_ARCHITECTURE
@@ -135,6 +149,7 @@ void vpr_print_usage(void) {
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--num_cuts <int>]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--delay_increase <int>]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\t[--placer_cost_constant <float>]\n");
+	vpr_printf(TIO_MESSAGE_INFO, "\t[--place_die_partition on | off]\n");
 	vpr_printf(TIO_MESSAGE_INFO, "\n");
 #endif
 
@@ -209,6 +224,9 @@ void vpr_init(INP int argc, INP char **argv, OUTP t_options *options,
 	vpr_setup->TimingEnabled = IsTimingEnabled(options);
 	/* Determine whether echo is on or off */
 	setEchoEnabled(IsEchoEnabled(options));
+	if (options->Count[OT_ECHO_COMPRESSION]) {
+		setEchoFileCompression(options->EchoCompression);
+	}
 	SetPostSynthesisOption(IsPostSynthesisEnabled(options));
 	vpr_setup->constant_net_delay = options->constant_net_delay;
 
@@ -234,11 +252,34 @@ void vpr_init(INP int argc, INP char **argv, OUTP t_options *options,
 	/* flush any messages to user still in stdout that hasn't gotten displayed */
 	fflush(stdout);
 
-	/* Read blif file and sweep unused components */
-	read_and_process_blif(vpr_setup->PackerOpts.blif_file_name,
-			vpr_setup->PackerOpts.sweep_hanging_nets_and_inputs,
-			vpr_setup->user_models, vpr_setup->library_models,
-			vpr_setup->PowerOpts.do_power, vpr_setup->FileNameOpts.ActFile);
+	if (vpr_setup->FileNameOpts.ImportRouteFile
+			&& vpr_setup->RouterOpts.fixed_channel_width == NO_FIXED_CHANNEL_WIDTH) {
+		/* An imported routing is only legal in the rr graph it was made in */
+		vpr_printf(TIO_MESSAGE_ERROR, "--import_route needs the channel width the routing was made at; give it with --route_chan_width.\n");
+		exit(1);
+	}
+
+	if (vpr_setup->FileNameOpts.ReadSnapshotFile) {
+		/* The snapshot holds the packed netlist; the blif file is not read */
+		if (vpr_setup->PackerOpts.doPacking) {
+			vpr_printf(TIO_MESSAGE_ERROR, "A snapshot is already packed; use --place or --route with --read_snapshot.\n");
+			exit(1);
+		}
+		if (vpr_setup->PowerOpts.do_power) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Power estimation needs the activity file, which is read with the blif file; it cannot be used with --read_snapshot.\n");
+			exit(1);
+		}
+		read_snapshot(vpr_setup->FileNameOpts.ReadSnapshotFile,
+				vpr_setup->FileNameOpts.ArchFile, arch,
+				vpr_setup->user_models, vpr_setup->library_models);
+	} else {
+		/* Read blif file and sweep unused components */
+		read_and_process_blif(vpr_setup->PackerOpts.blif_file_name,
+				vpr_setup->PackerOpts.sweep_hanging_nets_and_inputs,
+				vpr_setup->user_models, vpr_setup->library_models,
+				vpr_setup->PowerOpts.do_power, vpr_setup->FileNameOpts.ActFile,
+				vpr_setup->FileNameOpts.WriteActBinaryFile);
+	}
 	fflush(stdout);
 
 	ShowSetup(*options, *vpr_setup);
@@ -254,12 +295,17 @@ void vpr_init_pre_place_and_route(INP t_vpr_setup vpr_setup, INP t_arch Arch) {
 	int current, high, low;
 	boolean fit;
 
-	/* Read in netlist file for placement and routing */
-	if (vpr_setup.FileNameOpts.NetFile) {
+	/* Read in netlist file for placement and routing, unless a snapshot *
+	 * already loaded it                                                 */
+	if (vpr_setup.FileNameOpts.NetFile && !vpr_setup.FileNameOpts.ReadSnapshotFile) {
 		read_netlist(vpr_setup.FileNameOpts.NetFile, &Arch, &num_blocks, &block,
 				&num_nets, &clb_net);
 		/* This is done so that all blocks have subblocks and can be treated the same */
 		check_netlist();
+		if (vpr_setup.FileNameOpts.WriteSnapshotFile) {
+			write_snapshot(vpr_setup.FileNameOpts.WriteSnapshotFile,
+					SNAPSHOT_PACKED, vpr_setup.FileNameOpts.ArchFile);
+		}
 	}
 
 	/* Output the current settings to console. */
@@ -451,7 +497,8 @@ void vpr_place_and_route(INP t_vpr_setup vpr_setup, INP t_arch arch) {
 	place_and_route(vpr_setup.Operation, vpr_setup.PlacerOpts,
 			vpr_setup.FileNameOpts.PlaceFile, vpr_setup.FileNameOpts.NetFile,
 			vpr_setup.FileNameOpts.ArchFile, vpr_setup.FileNameOpts.RouteFile,
-			vpr_setup.AnnealSched, vpr_setup.RouterOpts, vpr_setup.RoutingArch,
+			vpr_setup.FileNameOpts.WriteSnapshotFile,
+			vpr_setup.FileNameOpts.ImportRouteFile, vpr_setup.AnnealSched, vpr_setup.RouterOpts, vpr_setup.RoutingArch,
 			vpr_setup.Segments, vpr_setup.Timing, arch.Chans, arch.models,
 			arch.Directs, arch.num_directs);
 
@@ -587,6 +634,24 @@ void free_options(t_options *options) {
 		free(options->out_file_prefix);
 	if (options->PinFile)
 		free(options->PinFile);
+	if (options->PlaceDelayCacheFile)
+		free(options->PlaceDelayCacheFile);
+	if (options->WriteSnapshotFile)
+		free(options->WriteSnapshotFile);
+	if (options->ReadSnapshotFile)
+		free(options->ReadSnapshotFile);
+	if (options->ImportRouteFile)
+		free(options->ImportRouteFile);
+	if (options->WriteActBinaryFile)
+		free(options->WriteActBinaryFile);
+	if (options->EchoCompression)
+		free(options->EchoCompression);
+	if (options->PlaceCheckpointFile)
+		free(options->PlaceCheckpointFile);
+	if (options->PlaceResumeFile)
+		free(options->PlaceResumeFile);
+	if (options->PlaceProfileFile)
+		free(options->PlaceProfileFile);
 }
 
 static void free_complex_block_types(void) {
@@ -854,9 +919,10 @@ void vpr_check_setup(INP enum e_operation Operation,
 void vpr_read_and_process_blif(INP char *blif_file,
 		INP boolean sweep_hanging_nets_and_inputs, INP t_model *user_models,
 		INP t_model *library_models, boolean read_activity_file,
-		char * activity_file) {
+		char * activity_file, char * activity_binary_file) {
 	read_and_process_blif(blif_file, sweep_hanging_nets_and_inputs, user_models,
-			library_models, read_activity_file, activity_file);
+			library_models, read_activity_file, activity_file,
+			activity_binary_file);
 }
 /* Show current setup */
 void vpr_show_setup(INP t_options options, INP t_vpr_setup vpr_setup) {
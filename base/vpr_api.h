@@ -84,7 +84,7 @@ void vpr_check_setup(INP enum e_operation Operation,
 void vpr_read_and_process_blif(INP char *blif_file,
 		INP boolean sweep_hanging_nets_and_inputs, INP t_model *user_models,
 		INP t_model *library_models, boolean read_activity_file,
-		char * activity_file);
+		char * activity_file, char * activity_binary_file);
 /* Show current setup */
 void vpr_show_setup(INP t_options options, INP t_vpr_setup vpr_setup);
 
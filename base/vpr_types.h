@@ -137,16 +137,29 @@ struct s_rr_node;
 struct s_pack_molecule;
 /* defined later, but need to declare here because it is used */
 
+/* A molecule queued as a candidate for an open cluster, with its gain at the *
+ * time it was queued.                                                         */
+typedef struct s_molecule_gain_entry {
+	float gain;
+	struct s_pack_molecule *molecule;
+} t_molecule_gain_entry;
+
 /* Stores statistical information for pb such as cost information */
 typedef struct s_pb_stats {
-	/* Packing statistics */
-	std::map<int, float> gain; /* Attraction (inverse of cost) function */
-
-	std::map<int, float> timinggain; /* [0..num_logical_blocks-1]. The timing criticality score of this logical_block. 
+	/* Packing statistics.  The gain arrays below are dense, indexed by logical *
+	 * block or vpack_net, and come from a small pool (see                      *
+	 * alloc_pb_stats_gains).  Only the top-level pb of a cluster has them;     *
+	 * they and the marked lists are NULL in the pbs below it.  An entry that   *
+	 * was never touched is 0; the ones that were are found again through       *
+	 * marked_blocks and marked_nets, which is how the arrays are cleared       *
+	 * before they go back to the pool.                                         */
+	float *gain; /* [0..num_logical_blocks-1] Attraction (inverse of cost) function */
+
+	float *timinggain; /* [0..num_logical_blocks-1]. The timing criticality score of this logical_block. 
 	 Determined by the most critical vpack_net between this logical_block and any logical_block in the current pb */
-	std::map<int, float> connectiongain; /* [0..num_logical_blocks-1] Weighted sum of connections to attraction function */
-	std::map<int, float> prevconnectiongainincr; /* [0..num_logical_blocks-1] Prev sum to weighted sum of connections to attraction function */
-	std::map<int, float> sharinggain; /* [0..num_logical_blocks-1]. How many nets on this logical_block are already in the pb under consideration */
+	float *connectiongain; /* [0..num_logical_blocks-1] Weighted sum of connections to attraction function */
+	float *prevconnectiongainincr; /* [0..num_logical_blocks-1] Prev sum to weighted sum of connections to attraction function */
+	float *sharinggain; /* [0..num_logical_blocks-1]. How many nets on this logical_block are already in the pb under consideration, 0 if the logical_block is not marked */
 
 	/* [0..num_logical_blocks-1]. This is the gain used for hill-climbing. It stores*
 	 * the reduction in the number of pins that adding this logical_block to the the*
@@ -154,7 +167,7 @@ typedef struct s_pb_stats {
 	 * addition of a logical_block to a pb may reduce the number of inputs     *
 	 * required if it shares inputs with all other BLEs and it's output is  *
 	 * used by all other child pbs in this parent pb.                               */
-	std::map<int, float> hillgain;
+	float *hillgain;
 
 	/* [0..num_marked_nets] and [0..num_marked_blocks] respectively.  List  *
 	 * the indices of the nets and blocks that have had their num_pins_of_  *
@@ -166,8 +179,8 @@ typedef struct s_pb_stats {
 	int tie_break_high_fanout_net; /* If no marked candidate atoms, use this high fanout net to determine the next candidate atom */
 
 	/* [0..num_logical_nets-1].  How many pins of each vpack_net are contained in the *
-	 * currently open pb?                                          */
-	std::map<int, int> num_pins_of_net_in_pb;
+	 * currently open pb?  0 if the vpack_net is not marked.      */
+	int *num_pins_of_net_in_pb;
 
 	/* Record of pins of class used TODO: Jason Luu: Should really be using hash table for this for speed, too lazy to write one now, performance isn't too bad since I'm at most iterating over the number of pins of a pb which is effectively a constant for reasonable architectures */
 	int **input_pins_used; /* [0..pb_graph_node->num_pin_classes-1][0..pin_class_size] number of input pins of this class that are used */
@@ -175,12 +188,43 @@ typedef struct s_pb_stats {
 
 	int **lookahead_input_pins_used; /* [0..pb_graph_node->num_pin_classes-1][0..pin_class_size] number of input pins of this class that are speculatively used */
 	int **lookahead_output_pins_used; /* [0..pb_graph_node->num_pin_classes-1][0..pin_class_size] number of output pins of this class that are speculatively used */
+	int *lookahead_input_pins_count; /* [0..num_input_pin_class-1] number of entries filled in lookahead_input_pins_used */
+	int *lookahead_output_pins_count; /* [0..num_output_pin_class-1] number of entries filled in lookahead_output_pins_used */
+
+	/* Pins of each class that reach the children of each mode, see load_mode_pin_class_capacities.  NULL for primitives. *
+	 * [0..num_modes-1][0..num_input_pin_class-1] and [0..num_modes-1][0..num_output_pin_class-1], flattened by mode.    */
+	int *input_pin_class_capacity;
+	int *output_pin_class_capacity;
+
+	/* Bitset of the pin classes whose lookahead count exceeds their capacity in the current mode of the pb,           *
+	 * input classes first, then output classes at bit num_input_pin_class + class [0..num_overused_words-1]         */
+	unsigned int *lookahead_overused_classes;
+	int num_overused_words;
 
 	/* Array of feasible blocks to select from [0..max_array_size-1] 
 	 Sorted in ascending gain order so that the last block is the most desirable (this makes it easy to pop blocks off the list
 	 */
 	struct s_pack_molecule **feasible_blocks;
 	int num_feasible_blocks; /* [0..num_marked_models-1] */
+
+	/* Top-level pb only.  Max-heap of candidate molecules keyed on gain       *
+	 * [1..num_candidates].  A molecule is queued again whenever the gain of   *
+	 * one of its blocks changes, so entries whose gain is out of date are    *
+	 * dropped when they reach the top rather than searched for and removed.   *
+	 * num_queued_marked_blocks: marked_blocks whose molecules have been       *
+	 * queued at least once.                                                   */
+	t_molecule_gain_entry *candidates;
+	int num_candidates, max_candidates;
+	int num_queued_marked_blocks;
+
+	/* Top-level pb only.  Molecules popped from candidates since the last    *
+	 * molecule was added to the pb, either returned to the packer or found    *
+	 * to have no free primitive [0..num_parked_candidates-1].  They are       *
+	 * queued again when the pb changes.  num_tried_candidates counts the      *
+	 * ones returned to the packer.                                            */
+	struct s_pack_molecule **parked_candidates;
+	int num_parked_candidates, max_parked_candidates;
+	int num_tried_candidates;
 } t_pb_stats;
 
 /* An FPGA complex block is represented by a hierarchy of physical blocks.  
@@ -269,6 +313,7 @@ typedef struct s_pack_molecule {
 	float base_gain; /* Intrinsic "goodness" score for molecule independant of rest of netlist */
 
 	int num_ext_inputs; /* number of input pins used by molecule that are not self-contained by pattern molecule matches */
+	int candidate_round; /* Last candidate round (see get_highest_gain_molecule) in which this molecule was popped as a candidate */
 	struct s_pack_molecule *next;
 } t_pack_molecule;
 
@@ -470,7 +515,7 @@ typedef struct s_timing_constraints { /* Container structure for all SDC timing
 
 /* Timing data structures end */
 enum sched_type {
-	AUTO_SCHED, USER_SCHED
+	AUTO_SCHED, USER_SCHED, ADAPTIVE_SCHED
 };
 /* Annealing schedule */
 
@@ -598,10 +643,29 @@ struct s_file_name_opts {
 	char *PowerFile;
 	char *CmosTechFile;
 	char *out_file_prefix;
+	char *WriteSnapshotFile; /* snapshot saved after packing and again after placement, NULL for none */
+	char *ReadSnapshotFile; /* snapshot loaded in place of the blif, .net and .place files, NULL for none */
+	char *ImportRouteFile; /* .route file whose routing is repaired instead of routing from scratch, NULL for none */
+	char *WriteActBinaryFile; /* binary copy of the activity file written after it is read, NULL for none */
 };
 
 /* Options for packing
- * TODO: document each packing parameter         */
+ * TODO: document each packing parameter
+ * recompute_timing_after: after at least this many blocks have been packed,
+ *                         the pre-packing timing analysis is rerun between
+ *                         clusters with the absorbed connections at
+ *                         intra_cluster_net_delay.  Each rerun is a full
+ *                         timing analysis.  OPEN (the default) never reruns
+ *                         it.
+ * num_workers: number of clusters grown at once.  Above 1, each round forks
+ *              num_workers-1 worker processes that grow clusters from seeds
+ *              far from the packer's own seed; their clusters are replayed
+ *              into the packer's netlist when the round ends.
+ * deterministic: commit worker clusters in seed order rather than in the
+ *                order the workers finish, so the result depends only on
+ *                num_workers.                                            *
+ * profile: time the phases of clustering and count candidates per cluster *
+ *          type, and write them to <output_file>.profile.json.             */
 enum e_packer_algorithm {
 	PACK_GREEDY, PACK_BRUTE_FORCE
 };
@@ -629,19 +693,33 @@ struct s_packer_opts {
 	boolean doPacking;
 	enum e_packer_algorithm packer_algorithm;
 	float aspect;
+	int num_workers;
+	boolean deterministic;
+	boolean profile;
 };
 
 /* Annealing schedule information for the placer.  The schedule type      *
- * is either USER_SCHED or AUTO_SCHED.  Inner_num is multiplied by        *
- * num_blocks^4/3 to find the number of moves per temperature.  The       *
- * remaining information is used only for USER_SCHED, and have the        *
- * obvious meanings.                                                      */
+ * is USER_SCHED, AUTO_SCHED or ADAPTIVE_SCHED.  Inner_num is multiplied  *
+ * by num_blocks^4/3 to find the number of moves per temperature.  The    *
+ * init_t, alpha_t and exit_t are used only for USER_SCHED, and have the  *
+ * obvious meanings.                                                      *
+ * ADAPTIVE_SCHED cools like AUTO_SCHED, but scales the moves per         *
+ * temperature with the acceptance rate and stops early once the costs    *
+ * have converged:                                                        *
+ * exit_window: number of temperatures the cost improvement is measured  *
+ *              over [1..MAX_ANNEAL_EXIT_WINDOW].                         *
+ * exit_improvement: the anneal stops when neither the bb cost nor the    *
+ *                   delay cost improved by more than this fraction over  *
+ *                   the last exit_window temperatures.                   */
+#define MAX_ANNEAL_EXIT_WINDOW 32
 struct s_annealing_sched {
 	enum sched_type type;
 	float inner_num;
 	float init_t;
 	float alpha_t;
 	float exit_t;
+	int exit_window;
+	float exit_improvement;
 };
 
 enum e_place_algorithm {
@@ -663,7 +741,16 @@ struct s_placer_opts {
 	float td_place_exp_first;
 	int seed;
 	float td_place_exp_last;
+	char *delay_cache_file;
+	char *checkpoint_file;
+	float checkpoint_t;
+	char *resume_file;
+	int num_forks;
+	char *profile_file;
 	boolean doPlacement;
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+	boolean die_partition;
+#endif
 };
 
 /* Various options for the placer.                                           *
@@ -692,7 +779,26 @@ struct s_placer_opts {
  * td_place_exp_first: exponent that is used on the timing_driven criticlity *
  *               it is the value that the exponent starts at.                *
  * td_place_exp_last: value that the criticality exponent will be at the end *
- * doPlacement: TRUE if placement is supposed to be done in the CAD flow, FALSE otherwise */
+ * delay_cache_file: file the placement delay lookup tables are loaded from  *
+ *               if it matches the current architecture, grid and channel    *
+ *               width, and saved to otherwise.  NULL disables the cache.    *
+ * checkpoint_file: file the annealing state is saved to the first time the  *
+ *               temperature drops to checkpoint_t or below, or at every     *
+ *               temperature if checkpoint_t < 0.  NULL for none.  Forked    *
+ *               continuation i writes <checkpoint_file>.fork<i> instead,    *
+ *               and saves its final state there too (or to                  *
+ *               <resume_file>.fork<i> if there is no checkpoint_file).      *
+ * resume_file: checkpoint to restart the anneal from instead of a random    *
+ *               initial placement.  NULL to start from scratch.             *
+ * num_forks: when resuming, number of continuations to run from the         *
+ *               checkpoint, each in its own process with its own seed.      *
+ * profile_file: file a per-temperature trace of move statistics and of the  *
+ *               time spent in each phase of a move is written to.  NULL     *
+ *               disables placement profiling.                               *
+ * doPlacement: TRUE if placement is supposed to be done in the CAD flow, FALSE otherwise *
+ * die_partition: (interposer only) first assign every block to a die, the   *
+ *               region between two cuts, then anneal with each block kept   *
+ *               inside its die.                                             */
 
 enum e_route_type {
 	GLOBAL, DETAILED
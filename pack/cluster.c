@@ -8,7 +8,15 @@
 #include <assert.h>
 #include <string.h>
 #include <stdlib.h>
+#include <time.h>
 #include <map>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/time.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
 
 #include "util.h"
 #include "vpr_types.h"
@@ -20,21 +28,28 @@
 #include "SetupGrid.h"
 #include "read_xml_arch_file.h"
 #include "cluster_legality.h"
+#include "cluster_feasibility_filter.h"
 #include "path_delay2.h"
 #include "path_delay.h"
 #include "vpr_utils.h"
 #include "cluster_placement.h"
 #include "ReadOptions.h"
+#include "pack_profile.h"
 
 /*#define DEBUG_FAILED_PACKING_CANDIDATES*/
 
 #define AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC 2 /* Maximum relative number of pins that can exceed input pins before giving up */
 #define AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST 5 /* Maximum constant number of pins that can exceed input pins before giving up */
+#define AAPACK_PIN_CLASS_WORD_BITS 32 /* Pin classes per word of the lookahead_overused_classes bitset */
 
 #define AAPACK_MAX_FEASIBLE_BLOCK_ARRAY_SIZE 30      /* This value is used to determine the max size of the priority queue for candidates that pass the early filter legality test but not the more detailed routing test */
 #define AAPACK_MAX_NET_SINKS_IGNORE 256				/* The packer looks at all sinks of a net when deciding what next candidate block to pack, for high-fanout nets, this is too runtime costly for marginal benefit, thus ignore those high fanout nets */
 #define AAPACK_MAX_HIGH_FANOUT_EXPLORE 10			/* For high-fanout nets that are ignored, consider a maximum of this many nets */
 
+#define PACK_WORKER_SEED_HOPS 2 /* Seeds grown in parallel are more than this many nets apart */
+#define PACK_WORKER_MAX_NET_SINKS 64 /* Nets with more sinks are ignored when measuring how far apart seeds are */
+#define PACK_WORKER_SEED_SCAN 32 /* Candidate seeds examined per worker before a round starts with fewer workers */
+
 #define SCALE_NUM_PATHS 1e-2     /*this value is used as a multiplier to assign a    *
 				  *slightly higher criticality value to nets that    *
 				  *affect a large number of critical paths versus    *
@@ -78,13 +93,6 @@ struct s_molecule_link {
 	struct s_molecule_link *next;
 };
 
-/* 1/MARKED_FRAC is the fraction of nets or blocks that must be *
- * marked in order for the brute force (go through the whole    *
- * data structure linearly) gain update etc. code to be used.   *
- * This is done for speed only; make MARKED_FRAC whatever       *
- * number speeds the code up most.                              */
-#define MARKED_FRAC 2   
-
 /* Keeps a linked list of the unclustered blocks to speed up looking for *
  * unclustered blocks with a certain number of *external* inputs.        *
  * [0..lut_size].  Unclustered_list_head[i] points to the head of the    *
@@ -107,6 +115,66 @@ static int *net_output_feeds_driving_block_input;
 static float *block_criticality = NULL;
 static int *critindexarray = NULL;
 
+/* Incremented each time the top-level pb of the open cluster changes.  A   *
+ * molecule whose candidate_round equals this has already been popped as a  *
+ * candidate since the last change, so further heap entries for it are      *
+ * skipped.                                                                  */
+static int candidate_round = 0;
+
+/* Speculative clustering (--pack_workers).  Each round the packer forks a *
+ * worker per extra seed; the worker grows one cluster with its own copy   *
+ * of the pb_stats and legalizer state and reports the molecules it packed *
+ * (seed first, in packing order) and the routing stage the cluster was    *
+ * legal at, along with the intra-cluster routings it found.  The packer    *
+ * adds those routings to its route cache and then replays the worker      *
+ * clusters into its own netlist, skipping molecules that an earlier        *
+ * cluster of the round took; the replay's routing checks are cache hits,   *
+ * so a worker cluster is not routed a second time.                         */
+typedef struct s_speculative_cluster {
+	int pid;
+	int fd; /* read end of the worker's pipe */
+	t_pack_molecule *seed;
+	int detailed_routing_stage;
+	int num_molecules;
+	t_pack_molecule **molecules; /* [0..num_molecules-1] */
+	double grow_seconds; /* wall time the worker took to grow the cluster */
+	int num_route_ints;
+	int *route_entries; /* [0..num_route_ints-1], see get_route_cache_additions */
+	boolean reported;
+} t_speculative_cluster;
+
+static int pack_worker_index = 0; /* 0 in the packer, 1.. in a worker */
+static int pack_worker_fd = -1; /* write end of this worker's pipe */
+static t_speculative_cluster *speculative_clusters = NULL; /* [1..num_pack_workers-1] */
+
+/* Molecules packed into the open cluster, kept by a worker for its report */
+static t_pack_molecule **speculative_record = NULL;
+static int num_speculative_record = 0;
+
+/* seed_region_round[iblk] == seed_round if iblk is near a seed picked this *
+ * round; seed_region_hops[iblk] is how many nets further the region went   *
+ * from it.  seed_speculated[iblk] is TRUE once a molecule rooted at iblk    *
+ * has seeded a worker, so each seed is tried speculatively at most once.    *
+ * [0..num_logical_blocks-1]                                                 */
+static int *seed_region_round = NULL;
+static int *seed_region_hops = NULL;
+static boolean *seed_speculated = NULL;
+static int seed_round = 0;
+
+static int num_speculative_committed, num_speculative_discarded,
+		num_speculative_regrown, num_speculative_conflicts;
+
+/* Wall-clock accounting of speculative clustering.  The packer spends     *
+ * fork, wait and replay seconds to save the grow seconds of the worker     *
+ * clusters it commits; after SPECULATIVE_TRIAL_ROUNDS rounds with workers, *
+ * speculation is turned off if it has cost more than it saved.            */
+#define SPECULATIVE_TRIAL_ROUNDS 20
+static double speculative_fork_seconds, speculative_wait_seconds,
+		speculative_replay_seconds, speculative_committed_seconds;
+static int num_speculative_rounds;
+static boolean speculation_throttled;
+static double worker_grow_begin; /* in a worker, when it was forked */
+
 /*****************************************/
 /*local functions*/
 /*****************************************/
@@ -120,7 +188,7 @@ static void check_for_duplicate_inputs ();
 static boolean is_logical_blk_in_pb(int iblk, t_pb *pb);
 
 static void add_molecule_to_pb_stats_candidates(t_pack_molecule *molecule,
-		std::map<int, float> &gain, t_pb *pb);
+		t_pb *pb);
 
 static void alloc_and_init_clustering(boolean global_clocks, float alpha,
 		float beta, int max_cluster_size, int max_molecule_inputs,
@@ -136,6 +204,8 @@ static void compute_and_mark_lookahead_pins_used_for_pin(
 		t_pb_graph_pin *pb_graph_pin, t_pb *primitive_pb, int inet);
 static void commit_lookahead_pins_used(t_pb *cur_pb);
 static boolean check_lookahead_pins_used(t_pb *cur_pb);
+static void mark_lookahead_pin_class_overuse(t_pb *cur_pb, int overuse_bit,
+		int count, int *capacity, int num_pin_class, int pin_class);
 static boolean primitive_feasible(int iblk, t_pb *cur_pb);
 static boolean primitive_type_and_memory_feasible(int iblk,
 		const t_pb_type *cur_pb_type, t_pb *memory_class_pb,
@@ -201,6 +271,22 @@ static void start_new_cluster(
 		INP int num_models, INP int max_cluster_size,
 		INP int max_nets_in_pb_type, INP int detailed_routing_stage);
 
+static void queue_candidate_molecule(INOUTP t_pb_stats *pb_stats,
+		INP t_pack_molecule *molecule);
+
+static void queue_block_candidates(INOUTP t_pb_stats *pb_stats, INP int iblk);
+
+static t_molecule_gain_entry pop_candidate_molecule(INOUTP t_pb_stats *pb_stats);
+
+static void park_candidate_molecule(INOUTP t_pb_stats *pb_stats,
+		INOUTP t_pack_molecule *molecule);
+
+static void requeue_parked_candidates(INOUTP t_pb_stats *pb_stats);
+
+static t_pack_molecule *get_queued_candidate_molecule(
+		INOUTP t_pb_stats *pb_stats,
+		INP t_cluster_placement_stats *cluster_placement_stats_ptr);
+
 static t_pack_molecule* get_highest_gain_molecule(
 		INP enum e_packer_algorithm packer_algorithm, INOUTP t_pb *cur_pb,
 		INP enum e_gain_type gain_mode,
@@ -220,7 +306,55 @@ static void check_cluster_logical_blocks(t_pb *pb, boolean *blocks_checked);
 
 static t_pack_molecule* get_most_critical_seed_molecule(int * indexofcrit);
 
-static float get_molecule_gain(t_pack_molecule *molecule, std::map<int, float> &blk_gain);
+static void load_block_criticalities(INP t_slack * slacks);
+
+static int load_cluster_intra_net_delays(INP t_pb *pb,
+		INP float intra_cluster_net_delay);
+
+static t_pack_molecule *get_best_valid_molecule_of_block(int iblk);
+
+static void alloc_speculative_packing(INP int num_pack_workers,
+		INP int max_cluster_size);
+
+static void free_speculative_packing(INP int num_pack_workers);
+
+static double get_pack_wall_seconds(void);
+
+static void check_speculation_pays_off(void);
+
+static void mark_seed_region_net(INP int inet, INP int hops);
+
+static void mark_seed_region(INP int iblk, INP int hops);
+
+static boolean try_claim_speculative_seed(INP t_pack_molecule *molecule);
+
+static int pick_speculative_seeds(INP t_pack_molecule *istart,
+		INP int max_seeds, INP boolean critical_seeds, INP int indexofcrit,
+		INP int max_molecule_inputs);
+
+static int fork_pack_workers(INP int num_pack_workers,
+		INP boolean critical_seeds, INP int indexofcrit,
+		INP int max_molecule_inputs, INOUTP t_pack_molecule **istart);
+
+static void report_speculative_cluster(INP int detailed_routing_stage);
+
+static int get_finished_pack_worker(INP int num_workers);
+
+static void read_speculative_cluster(INOUTP t_speculative_cluster *spec,
+		INP int max_cluster_size);
+
+static void commit_speculative_cluster(INP t_speculative_cluster *spec,
+		INP t_cluster_placement_stats *cluster_placement_stats,
+		INP t_pb_graph_node **primitives_list, INP const t_arch * arch,
+		INOUTP t_block *clb, INOUTP int *num_clb, INP float aspect,
+		INOUTP int *num_used_instances_type, INOUTP int *num_instances_type,
+		INP int num_models, INP int max_cluster_size,
+		INP int max_nets_in_pb_type, INP boolean *is_clock,
+		INP boolean global_clocks, INP float alpha, INP float beta,
+		INP boolean timing_driven, INP boolean connection_driven,
+		INP t_slack * slacks);
+
+static float get_molecule_gain(t_pack_molecule *molecule, t_pb_stats *pb_stats);
 static int compare_molecule_gain(const void *a, const void *b);
 static int get_net_corresponding_to_pb_graph_pin(t_pb *cur_pb,
 		t_pb_graph_pin *pb_graph_pin);
@@ -237,7 +371,8 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 		float intra_cluster_net_delay, float inter_cluster_net_delay,
 		float aspect, boolean allow_unrelated_clustering,
 		boolean allow_early_exit, boolean connection_driven,
-		enum e_packer_algorithm packer_algorithm, t_timing_inf timing_inf) {
+		enum e_packer_algorithm packer_algorithm, t_timing_inf timing_inf,
+		int num_pack_workers, boolean pack_deterministic) {
 
 	/* Does the actual work of clustering multiple netlist blocks *
 	 * into clusters.                                                  */
@@ -249,31 +384,27 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 	 
 	 */
 
-	int i, iblk, num_molecules, blocks_since_last_analysis, num_clb, max_nets_in_pb_type,  
+	int i, num_molecules, blocks_since_last_analysis, num_clb, max_nets_in_pb_type,  
 		cur_nets_in_pb_type, num_blocks_hill_added, max_cluster_size, cur_cluster_size, 
 		max_molecule_inputs, max_pb_depth, cur_pb_depth, num_unrelated_clustering_attempts,
 		indexofcrit, savedindexofcrit /* index of next most timing critical block */,
-		detailed_routing_stage, *hill_climbing_inputs_avail;
+		detailed_routing_stage, *hill_climbing_inputs_avail, iworker,
+		num_workers_started, first_clb_of_round, num_pending_delay_changes,
+		num_timing_reanalyses, num_intra_cluster_edges;
 
 	int *num_used_instances_type, *num_instances_type; 
 	/* [0..num_types] Holds array for total number of each cluster_type available */
 
 	boolean early_exit, is_cluster_legal;
 	enum e_block_pack_status block_pack_status;
-	float crit;
+	double profile_ticks, wall_begin, wall_end;
 
 	t_cluster_placement_stats *cluster_placement_stats, *cur_cluster_placement_stats_ptr;
 	t_pb_graph_node **primitives_list;
 	t_block *clb;
 	t_slack * slacks = NULL;
 	t_pack_molecule *istart, *next_molecule, *prev_molecule, *cur_molecule;
-	
-#ifdef PATH_COUNTING
-	int inet, ipin;
-#else
-	int inode;
-	float num_paths_scaling, distance_scaling;
-#endif
+	t_speculative_cluster *spec;
 
 	/* TODO: This is memory inefficient, fix if causes problems */
 	clb = (t_block*)my_calloc(num_logical_blocks, sizeof(t_block));
@@ -338,14 +469,33 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 			num_molecules);
 
 	blocks_since_last_analysis = 0;
+	num_pending_delay_changes = 0;
+	num_timing_reanalyses = 0;
+	num_intra_cluster_edges = 0;
 	early_exit = FALSE;
 	num_blocks_hill_added = 0;
 	num_used_instances_type = (int*) my_calloc(num_types, sizeof(int));
 	num_instances_type = (int*) my_calloc(num_types, sizeof(int));
 
+#ifdef _WIN32
+	if (num_pack_workers > 1) {
+		vpr_printf(TIO_MESSAGE_WARNING, "--pack_workers is not supported on this platform; clustering serially.\n");
+		num_pack_workers = 1;
+	}
+#endif
+	if (num_pack_workers > 1) {
+		alloc_speculative_packing(num_pack_workers, max_cluster_size);
+	}
+
 	assert(max_cluster_size < MAX_SHORT);
 	/* Limit maximum number of elements for each cluster */
 
+	/* With --pack_profile, each phase is charged as it completes to the *
+	 * type of the open cluster; try_pack_molecule charges its own.      */
+	profile_ticks = 0.;
+	if (pack_profiling)
+		profile_ticks = get_pack_profile_ticks();
+
 	if (timing_driven) {
 		slacks = alloc_and_load_pre_packing_timing_graph(block_delay,
 				inter_cluster_net_delay, arch->models, timing_inf);
@@ -373,48 +523,9 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 			critindexarray[i] = i;
 		}
 
-#ifdef PATH_COUNTING
-		/* Calculate block criticality from a weighted sum of timing and path criticalities. */
-		for (inet = 0; inet < num_logical_nets; inet++) { 
-			for (ipin = 1; ipin <= vpack_net[inet].num_sinks; ipin++) { 
-			
-				/* Find the logical block iblk which this pin is a sink on. */
-				iblk = vpack_net[inet].node_block[ipin];
-					
-				/* The criticality of this pin is a sum of its timing and path criticalities. */
-				crit =		PACK_PATH_WEIGHT  * slacks->path_criticality[inet][ipin] 
-					 + (1 - PACK_PATH_WEIGHT) * slacks->timing_criticality[inet][ipin]; 
-
-				/* The criticality of each block is the maximum of the criticalities of all its pins. */
-				if (block_criticality[iblk] < crit) {
-					block_criticality[iblk] = crit;
-				}
-			}
-		}
-
-#else
-		/* Calculate criticality based on slacks and tie breakers (# paths, distance from source) */
-		for (inode = 0; inode < num_tnodes; inode++) {
-			/* Only calculate for tnodes which have valid normalized values.
-			Either all values will be accurate or none will, so we only have
-			to check whether one particular value (normalized_T_arr) is valid 
-			Tnodes that do not have both times valid were not part of the analysis. 
-			Because we calloc-ed the array criticality, such nodes will have criticality 0, the lowest possible value. */
-			if (has_valid_normalized_T_arr(inode)) {
-				iblk = tnode[inode].block;
-				num_paths_scaling = SCALE_NUM_PATHS
-						* (float) tnode[inode].prepacked_data->normalized_total_critical_paths;
-				distance_scaling = SCALE_DISTANCE_VAL
-						* (float) tnode[inode].prepacked_data->normalized_T_arr;
-				crit = (1 - tnode[inode].prepacked_data->normalized_slack) + num_paths_scaling
-						+ distance_scaling;
-				if (block_criticality[iblk] < crit) {
-					block_criticality[iblk] = crit;
-				}
-			}
-		}
-#endif
-		heapsort(critindexarray, block_criticality, num_logical_blocks, 1);
+		load_block_criticalities(slacks);
+		if (pack_profiling)
+			profile_ticks = add_pack_profile_phase(PACK_PHASE_TIMING, profile_ticks);
 		
 		if (getEchoEnabled() && isEchoFileEnabled(E_ECHO_CLUSTERING_BLOCK_CRITICALITIES)) {
 			print_block_criticalities(getEchoFileName(E_ECHO_CLUSTERING_BLOCK_CRITICALITIES));
@@ -432,12 +543,33 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 		istart = get_seed_logical_molecule_with_most_ext_inputs(
 				max_molecule_inputs);
 	}
+	if (pack_profiling)
+		add_pack_profile_phase(PACK_PHASE_SEED, profile_ticks);
 
 
 	while (istart != NULL) {
 		is_cluster_legal = FALSE;
 		savedindexofcrit = indexofcrit;
+
+		/* Grow clusters from distant seeds in forked workers while this    *
+		 * process grows the cluster of istart; a worker returns here with   *
+		 * istart set to its own seed.                                       */
+		num_workers_started = 0;
+		if (num_pack_workers > 1 && pack_worker_index == 0
+				&& !speculation_throttled) {
+			if (pack_profiling)
+				profile_ticks = get_pack_profile_ticks();
+			wall_begin = get_pack_wall_seconds();
+			num_workers_started = fork_pack_workers(num_pack_workers,
+					(boolean) (timing_driven && cluster_seed_type == VPACK_TIMING),
+					indexofcrit, max_molecule_inputs, &istart);
+			speculative_fork_seconds += get_pack_wall_seconds() - wall_begin;
+			if (pack_profiling)
+				add_pack_profile_phase(PACK_PHASE_SEED, profile_ticks);
+		}
 		for (detailed_routing_stage = (int)E_DETAILED_ROUTE_AT_END_ONLY; !is_cluster_legal && detailed_routing_stage != (int)E_DETAILED_ROUTE_END; detailed_routing_stage++) {
+			if (pack_profiling)
+				profile_ticks = get_pack_profile_ticks();
 			reset_legalizer_for_cluster(&clb[num_clb]);
 
 			/* start a new cluster and reset all stats */
@@ -445,13 +577,23 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 					&clb[num_clb], num_clb, istart, aspect, num_used_instances_type,
 					num_instances_type, num_models, max_cluster_size,
 					max_nets_in_pb_type, detailed_routing_stage);
+			if (pack_profiling) {
+				start_pack_profile_cluster(clb[num_clb].type);
+				profile_ticks = add_pack_profile_phase(PACK_PHASE_START_CLUSTER, profile_ticks);
+			}
 			vpr_printf(TIO_MESSAGE_INFO, "Complex block %d: %s, type: %s\n", 
 					num_clb, clb[num_clb].name, clb[num_clb].type->name);
 			vpr_printf(TIO_MESSAGE_INFO, "\t");
 			fflush(stdout);
 			update_cluster_stats(istart, num_clb, is_clock, global_clocks, alpha,
 					beta, timing_driven, connection_driven, slacks);
+			if (pack_profiling)
+				profile_ticks = add_pack_profile_phase(PACK_PHASE_UPDATE_STATS, profile_ticks);
 			num_clb++;
+			if (pack_worker_index > 0) {
+				num_speculative_record = 0;
+				speculative_record[num_speculative_record++] = istart;
+			}
 
 			if (timing_driven && !early_exit) {
 				blocks_since_last_analysis++;
@@ -461,16 +603,22 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 			cur_cluster_placement_stats_ptr = &cluster_placement_stats[clb[num_clb
 					- 1].type->index];
 			num_unrelated_clustering_attempts = 0;
+			if (pack_profiling)
+				profile_ticks = get_pack_profile_ticks();
 			next_molecule = get_molecule_for_cluster(PACK_BRUTE_FORCE,
 					clb[num_clb - 1].pb, allow_unrelated_clustering,
 					&num_unrelated_clustering_attempts,
 					cur_cluster_placement_stats_ptr);
+			if (pack_profiling)
+				add_pack_profile_phase(PACK_PHASE_GET_MOLECULE, profile_ticks);
 			prev_molecule = istart;
 			while (next_molecule != NULL && prev_molecule != next_molecule) {
 				block_pack_status = try_pack_molecule(
 						cur_cluster_placement_stats_ptr, next_molecule,
 						primitives_list, clb[num_clb - 1].pb, num_models,
 						max_cluster_size, num_clb - 1, max_nets_in_pb_type, detailed_routing_stage);
+				if (pack_profiling)
+					profile_ticks = get_pack_profile_ticks();
 				prev_molecule = next_molecule;
 				if (block_pack_status != BLK_PASSED) {
 					if (next_molecule != NULL) {
@@ -500,6 +648,8 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 							clb[num_clb - 1].pb, allow_unrelated_clustering,
 							&num_unrelated_clustering_attempts,
 							cur_cluster_placement_stats_ptr);
+					if (pack_profiling)
+						add_pack_profile_phase(PACK_PHASE_GET_MOLECULE, profile_ticks);
 					continue;
 				} else {
 					/* Continue packing by filling smallest cluster */
@@ -512,20 +662,31 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 					vpr_printf(TIO_MESSAGE_DIRECT, ".");
 	#endif
 				}
+				if (pack_profiling)
+					profile_ticks = get_pack_profile_ticks();
 				update_cluster_stats(next_molecule, num_clb - 1, is_clock,
 						global_clocks, alpha, beta, timing_driven,
 						connection_driven, slacks);
+				if (pack_profiling)
+					profile_ticks = add_pack_profile_phase(PACK_PHASE_UPDATE_STATS, profile_ticks);
 				num_unrelated_clustering_attempts = 0;
+				if (pack_worker_index > 0) {
+					speculative_record[num_speculative_record++] = next_molecule;
+				}
 
 				if (timing_driven && !early_exit) {
-					blocks_since_last_analysis++; /* historically, timing slacks were recomputed after X number of blocks were packed, but this doesn't significantly alter results so I (jluu) did not port the code */
+					blocks_since_last_analysis++; /* slacks are recomputed between clusters once recompute_timing_after blocks have been packed */
 				}
 				next_molecule = get_molecule_for_cluster(PACK_BRUTE_FORCE,
 						clb[num_clb - 1].pb, allow_unrelated_clustering,
 						&num_unrelated_clustering_attempts,
 						cur_cluster_placement_stats_ptr);
+				if (pack_profiling)
+					add_pack_profile_phase(PACK_PHASE_GET_MOLECULE, profile_ticks);
 			}
 			vpr_printf(TIO_MESSAGE_DIRECT, "\n");
+			if (pack_profiling)
+				profile_ticks = get_pack_profile_ticks();
 			if (detailed_routing_stage == (int)E_DETAILED_ROUTE_AT_END_ONLY) {
 				is_cluster_legal = try_breadth_first_route_cluster();
 				if (is_cluster_legal == TRUE) {
@@ -536,12 +697,82 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 			} else {
 				is_cluster_legal = TRUE;
 			}
+			if (pack_profiling)
+				profile_ticks = add_pack_profile_phase(PACK_PHASE_ROUTE, profile_ticks);
 			if (is_cluster_legal == TRUE) {
 				save_cluster_solution();
+				if (pack_worker_index > 0) {
+					report_speculative_cluster(detailed_routing_stage);
+				}
+				free_pb_stats_recursive(clb[num_clb - 1].pb);
+				first_clb_of_round = num_clb - 1;
+				if (pack_profiling) {
+					add_pack_profile_phase(PACK_PHASE_COMMIT, profile_ticks);
+					end_pack_profile_cluster(clb[num_clb - 1].name,
+							detailed_routing_stage, TRUE);
+				}
+
+				/* Commit the worker clusters of this round: in seed order for *
+				 * deterministic output, otherwise as the workers finish.      */
+				for (iworker = 1; iworker <= num_workers_started; iworker++) {
+					if (pack_profiling)
+						profile_ticks = get_pack_profile_ticks();
+					wall_begin = get_pack_wall_seconds();
+					spec = &speculative_clusters[pack_deterministic ?
+							iworker : get_finished_pack_worker(num_workers_started)];
+					read_speculative_cluster(spec, max_cluster_size);
+					if (pack_profiling)
+						add_pack_profile_phase(PACK_PHASE_WORKER_WAIT, profile_ticks);
+					wall_end = get_pack_wall_seconds();
+					speculative_wait_seconds += wall_end - wall_begin;
+					commit_speculative_cluster(spec,
+							cluster_placement_stats, primitives_list, arch, clb,
+							&num_clb, aspect, num_used_instances_type,
+							num_instances_type, num_models, max_cluster_size,
+							max_nets_in_pb_type, is_clock, global_clocks, alpha,
+							beta, timing_driven, connection_driven, slacks);
+					speculative_replay_seconds += get_pack_wall_seconds() - wall_end;
+				}
+				if (num_workers_started > 0) {
+					check_speculation_pays_off();
+				}
+
+				if (pack_profiling)
+					profile_ticks = get_pack_profile_ticks();
 				if (timing_driven) {
 					if (num_blocks_hill_added > 0 && !early_exit) {
 						blocks_since_last_analysis += num_blocks_hill_added;
 					}
+
+					/* Optional periodic re-timing (recompute_timing_after is OPEN *
+					 * by default).  The connections absorbed by the clusters of   *
+					 * this round get the intra-cluster delay, and every           *
+					 * recompute_timing_after blocks a full timing analysis is     *
+					 * rerun if any delay changed.  Arrival and required times are *
+					 * not propagated incrementally.  The analysis runs between    *
+					 * clusters, when no pb_stats are live, so the next cluster    *
+					 * takes its timing gains from the new slacks.                 */
+					if (recompute_timing_after != OPEN) {
+						for (i = first_clb_of_round; i < num_clb; i++) {
+							num_pending_delay_changes += load_cluster_intra_net_delays(
+									clb[i].pb, intra_cluster_net_delay);
+						}
+					}
+					if (recompute_timing_after != OPEN
+							&& blocks_since_last_analysis >= recompute_timing_after
+							&& !early_exit) {
+						if (num_pending_delay_changes > 0) {
+							do_timing_analysis(slacks, TRUE, FALSE, FALSE);
+							load_block_criticalities(slacks);
+							indexofcrit = 0; /* critindexarray was re-sorted */
+							num_timing_reanalyses++;
+						}
+						num_intra_cluster_edges += num_pending_delay_changes;
+						num_pending_delay_changes = 0;
+						blocks_since_last_analysis = 0;
+					}
+					if (pack_profiling)
+						profile_ticks = add_pack_profile_phase(PACK_PHASE_TIMING, profile_ticks);
 					if (cluster_seed_type == VPACK_TIMING) {
 						istart = get_most_critical_seed_molecule(&indexofcrit);
 					} else { /*max input seed*/
@@ -552,11 +783,15 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 					/*cluster seed is max input (since there is no timing information)*/
 					istart = get_seed_logical_molecule_with_most_ext_inputs(
 							max_molecule_inputs);
-				
-				free_pb_stats_recursive(clb[num_clb - 1].pb);
+				if (pack_profiling)
+					add_pack_profile_phase(PACK_PHASE_SEED, profile_ticks);
 			} else {
 				/* Free up data structures and requeue used molecules */
+				if (pack_profiling)
+					end_pack_profile_cluster(clb[num_clb - 1].name,
+							detailed_routing_stage, FALSE);
 				num_used_instances_type[clb[num_clb - 1].type->index]--;
+				free_cluster_rr_graph(clb[num_clb - 1].pb);
 				free_cb(clb[num_clb - 1].pb);
 				free(clb[num_clb - 1].pb);
 				free(clb[num_clb - 1].name);
@@ -568,7 +803,13 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 		}
 	}
 
+	if (timing_driven && num_timing_reanalyses > 0) {
+		vpr_printf(TIO_MESSAGE_INFO, "Periodic pre-packing re-timing: %d full timing analyses after %d connections became intra-cluster.\n",
+				num_timing_reanalyses, num_intra_cluster_edges);
+	}
+
 	free_cluster_legality_checker();
+	free_pb_stats_gain_pool();
 
 	alloc_and_load_cluster_info(num_clb, clb);
 
@@ -586,12 +827,17 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 	free_cluster_placement_stats(cluster_placement_stats);
 
 	for (i = 0; i < num_clb; i++) {
+		free_cluster_rr_graph(clb[i].pb);
 		free_cb(clb[i].pb);
 		free(clb[i].name);
 		free(clb[i].nets);
 		free(clb[i].pb);
 	}
 	free(clb);
+	free_cluster_legalizer_arena();
+	if (num_pack_workers > 1) {
+		free_speculative_packing(num_pack_workers);
+	}
 
 	free(num_used_instances_type);
 	free(num_instances_type);
@@ -615,6 +861,104 @@ void do_clustering(const t_arch *arch, t_pack_molecule *molecule_head,
 
 }
 
+/*****************************************/
+static void load_block_criticalities(INP t_slack * slacks) {
+
+	/* Loads block_criticality from the latest pre-packing timing analysis and *
+	 * sorts critindexarray from the most to the least critical block.         */
+
+	int iblk;
+	float crit;
+#ifdef PATH_COUNTING
+	int inet, ipin;
+#else
+	int inode;
+	float num_paths_scaling, distance_scaling;
+#endif
+
+	for (iblk = 0; iblk < num_logical_blocks; iblk++) {
+		block_criticality[iblk] = 0.;
+	}
+
+#ifdef PATH_COUNTING
+	/* Calculate block criticality from a weighted sum of timing and path criticalities. */
+	for (inet = 0; inet < num_logical_nets; inet++) { 
+		for (ipin = 1; ipin <= vpack_net[inet].num_sinks; ipin++) { 
+		
+			/* Find the logical block iblk which this pin is a sink on. */
+			iblk = vpack_net[inet].node_block[ipin];
+				
+			/* The criticality of this pin is a sum of its timing and path criticalities. */
+			crit =		PACK_PATH_WEIGHT  * slacks->path_criticality[inet][ipin] 
+				 + (1 - PACK_PATH_WEIGHT) * slacks->timing_criticality[inet][ipin]; 
+
+			/* The criticality of each block is the maximum of the criticalities of all its pins. */
+			if (block_criticality[iblk] < crit) {
+				block_criticality[iblk] = crit;
+			}
+		}
+	}
+
+#else
+	/* Calculate criticality based on slacks and tie breakers (# paths, distance from source) */
+	for (inode = 0; inode < num_tnodes; inode++) {
+		/* Only calculate for tnodes which have valid normalized values.
+		Either all values will be accurate or none will, so we only have
+		to check whether one particular value (normalized_T_arr) is valid 
+		Tnodes that do not have both times valid were not part of the analysis. 
+		Because block_criticality was reset above, such nodes will have criticality 0, the lowest possible value. */
+		if (has_valid_normalized_T_arr(inode)) {
+			iblk = tnode[inode].block;
+			num_paths_scaling = SCALE_NUM_PATHS
+					* (float) tnode[inode].prepacked_data->normalized_total_critical_paths;
+			distance_scaling = SCALE_DISTANCE_VAL
+					* (float) tnode[inode].prepacked_data->normalized_T_arr;
+			crit = (1 - tnode[inode].prepacked_data->normalized_slack) + num_paths_scaling
+					+ distance_scaling;
+			if (block_criticality[iblk] < crit) {
+				block_criticality[iblk] = crit;
+			}
+		}
+	}
+#endif
+	heapsort(critindexarray, block_criticality, num_logical_blocks, 1);
+}
+
+/*****************************************/
+static int load_cluster_intra_net_delays(INP t_pb *pb,
+		INP float intra_cluster_net_delay) {
+
+	/* Gives the connections between the logical blocks of a committed cluster *
+	 * the intra-cluster net delay in the pre-packing timing graph.  Returns   *
+	 * the number of timing edges whose delay changed.                         */
+
+	int i, j, num_changed;
+	const t_pb_type *pb_type;
+
+	num_changed = 0;
+	pb_type = pb->pb_graph_node->pb_type;
+	if (pb_type->num_modes == 0) {
+		if (pb->logical_block != OPEN) {
+			num_changed = load_pre_packing_intra_cluster_net_delays(
+					pb->logical_block, intra_cluster_net_delay);
+		}
+	} else if (pb->child_pbs != NULL) {
+		for (i = 0; i < pb_type->modes[pb->mode].num_pb_type_children; i++) {
+			if (pb->child_pbs[i] == NULL) {
+				continue;
+			}
+			for (j = 0; j < pb_type->modes[pb->mode].pb_type_children[i].num_pb;
+					j++) {
+				if (pb->child_pbs[i][j].name != NULL) {
+					num_changed += load_cluster_intra_net_delays(
+							&pb->child_pbs[i][j], intra_cluster_net_delay);
+				}
+			}
+		}
+	}
+	return num_changed;
+}
+
 /*****************************************/
 static void check_clocks(boolean *is_clock) {
 
@@ -662,7 +1006,7 @@ static boolean is_logical_blk_in_pb(int iblk, t_pb *pb) {
 
 /* Add blk to list of feasible blocks sorted according to gain */
 static void add_molecule_to_pb_stats_candidates(t_pack_molecule *molecule,
-		std::map<int, float> &gain, t_pb *pb) {
+		t_pb *pb) {
 	int i, j;
 
 	for (i = 0; i < pb->pb_stats->num_feasible_blocks; i++) {
@@ -674,13 +1018,13 @@ static void add_molecule_to_pb_stats_candidates(t_pack_molecule *molecule,
 	if (pb->pb_stats->num_feasible_blocks
 			>= AAPACK_MAX_FEASIBLE_BLOCK_ARRAY_SIZE - 1) {
 		/* maximum size for array, remove smallest gain element and sort */
-		if (get_molecule_gain(molecule, gain)
-				> get_molecule_gain(pb->pb_stats->feasible_blocks[0], gain)) {
+		if (get_molecule_gain(molecule, pb->pb_stats)
+				> get_molecule_gain(pb->pb_stats->feasible_blocks[0], pb->pb_stats)) {
 			/* single loop insertion sort */
 			for (j = 0; j < pb->pb_stats->num_feasible_blocks - 1; j++) {
-				if (get_molecule_gain(molecule, gain)
+				if (get_molecule_gain(molecule, pb->pb_stats)
 						<= get_molecule_gain(
-								pb->pb_stats->feasible_blocks[j + 1], gain)) {
+								pb->pb_stats->feasible_blocks[j + 1], pb->pb_stats)) {
 					pb->pb_stats->feasible_blocks[j] = molecule;
 					break;
 				} else {
@@ -695,8 +1039,8 @@ static void add_molecule_to_pb_stats_candidates(t_pack_molecule *molecule,
 	} else {
 		/* Expand array and single loop insertion sort */
 		for (j = pb->pb_stats->num_feasible_blocks - 1; j >= 0; j--) {
-			if (get_molecule_gain(pb->pb_stats->feasible_blocks[j], gain)
-					> get_molecule_gain(molecule, gain)) {
+			if (get_molecule_gain(pb->pb_stats->feasible_blocks[j], pb->pb_stats)
+					> get_molecule_gain(molecule, pb->pb_stats)) {
 				pb->pb_stats->feasible_blocks[j + 1] =
 						pb->pb_stats->feasible_blocks[j];
 			} else {
@@ -729,6 +1073,8 @@ static void alloc_and_init_clustering(boolean global_clocks, float alpha,
 	int max_molecule_size;
 
 	alloc_and_load_cluster_legality_checker();
+	alloc_cluster_route_cache();
+	alloc_cluster_legalizer_arena();
 	/**cluster_placement_stats = alloc_and_load_cluster_placement_stats();*/
 
 	for (i = 0; i < num_logical_blocks; i++) {
@@ -1106,6 +1452,15 @@ static void alloc_and_load_pb_stats(t_pb *pb, int max_models,
 	pb->pb_stats->feasible_blocks = (t_pack_molecule**) my_calloc(
 			AAPACK_MAX_FEASIBLE_BLOCK_ARRAY_SIZE, sizeof(t_pack_molecule *));
 
+	pb->pb_stats->candidates = NULL;
+	pb->pb_stats->num_candidates = 0;
+	pb->pb_stats->max_candidates = 0;
+	pb->pb_stats->num_queued_marked_blocks = 0;
+	pb->pb_stats->parked_candidates = NULL;
+	pb->pb_stats->num_parked_candidates = 0;
+	pb->pb_stats->max_parked_candidates = 0;
+	pb->pb_stats->num_tried_candidates = 0;
+
 	pb->pb_stats->tie_break_high_fanout_net = OPEN;
 	for (i = 0; i < pb->pb_graph_node->num_input_pin_class; i++) {
 		pb->pb_stats->input_pins_used[i] = (int*) my_malloc(
@@ -1123,16 +1478,11 @@ static void alloc_and_load_pb_stats(t_pb *pb, int max_models,
 		}
 	}
 
+	/* Lookahead nets are kept packed at the front of each array, lookahead_*_pins_count says how many there are */
 	for (i = 0; i < pb->pb_graph_node->num_input_pin_class; i++) {
 		pb->pb_stats->lookahead_input_pins_used[i] = (int*) my_malloc(
 			(AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST + pb->pb_graph_node->input_pin_class_size[i]
 						* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC) * sizeof(int));
-		for (j = 0;
-				j
-						< pb->pb_graph_node->input_pin_class_size[i]
-								* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST; j++) {
-			pb->pb_stats->lookahead_input_pins_used[i][j] = OPEN;
-		}
 	}
 
 	for (i = 0; i < pb->pb_graph_node->num_output_pin_class; i++) {
@@ -1140,26 +1490,45 @@ static void alloc_and_load_pb_stats(t_pb *pb, int max_models,
 			(AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST + 
 				pb->pb_graph_node->output_pin_class_size[i]
 						* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC) * sizeof(int));
-		for (j = 0;
-				j
-						< pb->pb_graph_node->output_pin_class_size[i]
-								* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST; j++) {
-			pb->pb_stats->lookahead_output_pins_used[i][j] = OPEN;
-		}
 	}
 
-	pb->pb_stats->gain.clear();
-	pb->pb_stats->timinggain.clear();
-	pb->pb_stats->connectiongain.clear();
-	pb->pb_stats->sharinggain.clear();
-	pb->pb_stats->hillgain.clear();
-
-	pb->pb_stats->num_pins_of_net_in_pb.clear();
-
-	pb->pb_stats->marked_nets = (int *) my_malloc(
-			max_nets_in_pb_type * sizeof(int));
-	pb->pb_stats->marked_blocks = (int *) my_malloc(
-			num_logical_blocks * sizeof(int));
+	pb->pb_stats->lookahead_input_pins_count = (int*) my_calloc(
+			pb->pb_graph_node->num_input_pin_class, sizeof(int));
+	pb->pb_stats->lookahead_output_pins_count = (int*) my_calloc(
+			pb->pb_graph_node->num_output_pin_class, sizeof(int));
+	pb->pb_stats->num_overused_words = (pb->pb_graph_node->num_input_pin_class
+			+ pb->pb_graph_node->num_output_pin_class + AAPACK_PIN_CLASS_WORD_BITS
+			- 1) / AAPACK_PIN_CLASS_WORD_BITS;
+	pb->pb_stats->lookahead_overused_classes = (unsigned int*) my_calloc(
+			pb->pb_stats->num_overused_words, sizeof(unsigned int));
+
+	pb->pb_stats->input_pin_class_capacity = NULL;
+	pb->pb_stats->output_pin_class_capacity = NULL;
+	if (pb->pb_graph_node->pb_type->num_modes > 0) {
+		pb->pb_stats->input_pin_class_capacity = (int*) my_malloc(
+				pb->pb_graph_node->pb_type->num_modes
+						* pb->pb_graph_node->num_input_pin_class * sizeof(int));
+		pb->pb_stats->output_pin_class_capacity = (int*) my_malloc(
+				pb->pb_graph_node->pb_type->num_modes
+						* pb->pb_graph_node->num_output_pin_class * sizeof(int));
+		load_mode_pin_class_capacities(pb->pb_graph_node,
+				pb->pb_stats->input_pin_class_capacity,
+				pb->pb_stats->output_pin_class_capacity);
+	}
+
+	/* Only the top-level pb of a cluster gets gain arrays and marked lists *
+	 * (see mark_and_update_partial_gain).                                  */
+	pb->pb_stats->marked_nets = NULL;
+	pb->pb_stats->marked_blocks = NULL;
+	pb->pb_stats->gain = NULL;
+	pb->pb_stats->num_pins_of_net_in_pb = NULL;
+	if (pb->pb_graph_node->parent_pb_graph_node == NULL) {
+		alloc_pb_stats_gains(pb->pb_stats);
+		pb->pb_stats->marked_nets = (int *) my_malloc(
+				max_nets_in_pb_type * sizeof(int));
+		pb->pb_stats->marked_blocks = (int *) my_malloc(
+				num_logical_blocks * sizeof(int));
+	}
 
 	pb->pb_stats->num_marked_nets = 0;
 	pb->pb_stats->num_marked_blocks = 0;
@@ -1185,6 +1554,7 @@ static enum e_block_pack_status try_pack_molecule(
 	t_logical_block *chain_root_block;
 	boolean is_root_of_chain;
 	t_pb_graph_pin *chain_root_pin;
+	double profile_ticks;
 
 	
 	parent = NULL;
@@ -1194,8 +1564,14 @@ static enum e_block_pack_status try_pack_molecule(
 	molecule_size = get_array_size_of_molecule(molecule);
 	failed_location = 0;
 
+	profile_ticks = 0.;
+	if (pack_profiling)
+		profile_ticks = get_pack_profile_ticks();
+
 	while (block_pack_status != BLK_PASSED) {
 		save_and_reset_routing_cluster(); /* save current routing information because speculative packing will change routing*/
+		if (pack_profiling)
+			profile_ticks = add_pack_profile_phase(PACK_PHASE_ROUTE, profile_ticks);
 		if (get_next_primitive_list(cluster_placement_stats_ptr, molecule,
 				primitives_list, clb_index)) {
 			block_pack_status = BLK_PASSED;
@@ -1220,6 +1596,8 @@ static enum e_block_pack_status try_pack_molecule(
 							max_nets_in_pb_type, cluster_placement_stats_ptr, is_root_of_chain, chain_root_pin);
 				}
 			}
+			if (pack_profiling)
+				profile_ticks = add_pack_profile_phase(PACK_PHASE_PRIMITIVE_PLACEMENT, profile_ticks);
 			if (block_pack_status == BLK_PASSED) {
 				/* Check if pin usage is feasible for the current packing assigment */
 				reset_lookahead_pins_used(pb);
@@ -1227,6 +1605,8 @@ static enum e_block_pack_status try_pack_molecule(
 				if (!check_lookahead_pins_used(pb)) {
 					block_pack_status = BLK_FAILED_FEASIBLE;
 				}
+				if (pack_profiling)
+					profile_ticks = add_pack_profile_phase(PACK_PHASE_FEASIBILITY, profile_ticks);
 			}
 			if (block_pack_status == BLK_PASSED) {
 				/* Try to route if heuristic is to route for every atom
@@ -1236,7 +1616,10 @@ static enum e_block_pack_status try_pack_molecule(
 				if (detailed_routing_stage == (int)E_DETAILED_ROUTE_FOR_EACH_ATOM && try_breadth_first_route_cluster() == FALSE) {
 					/* Cannot pack */
 					block_pack_status = BLK_FAILED_ROUTE;
-				} else {
+				}
+				if (pack_profiling)
+					profile_ticks = add_pack_profile_phase(PACK_PHASE_ROUTE, profile_ticks);
+				if (block_pack_status == BLK_PASSED) {
 					/* Pack successful, commit 
 					 TODO: SW Engineering note - may want to update cluster stats here too instead of doing it outside
 					 */
@@ -1265,6 +1648,8 @@ static enum e_block_pack_status try_pack_molecule(
 									primitives_list[i]);
 						}
 					}
+					if (pack_profiling)
+						profile_ticks = add_pack_profile_phase(PACK_PHASE_PRIMITIVE_PLACEMENT, profile_ticks);
 				}
 			}
 			if (block_pack_status != BLK_PASSED) {
@@ -1275,14 +1660,24 @@ static enum e_block_pack_status try_pack_molecule(
 								max_models);
 					}
 				}
+				if (pack_profiling)
+					profile_ticks = add_pack_profile_phase(PACK_PHASE_PRIMITIVE_PLACEMENT, profile_ticks);
 				restore_routing_cluster();
+				if (pack_profiling)
+					profile_ticks = add_pack_profile_phase(PACK_PHASE_ROUTE, profile_ticks);
 			}
 		} else {
 			block_pack_status = BLK_FAILED_FEASIBLE;
+			if (pack_profiling)
+				profile_ticks = add_pack_profile_phase(PACK_PHASE_PRIMITIVE_PLACEMENT, profile_ticks);
 			restore_routing_cluster();
+			if (pack_profiling)
+				add_pack_profile_phase(PACK_PHASE_ROUTE, profile_ticks);
 			break; /* no more candidate primitives available, this molecule will not pack, return fail */
 		}
 	}
+	if (pack_profiling)
+		add_pack_profile_candidate(block_pack_status);
 	return block_pack_status;
 }
 
@@ -1479,10 +1874,6 @@ static void update_connection_gain_values(int inet, int clustered_block,
 			iblk = vpack_net[inet].node_block[ipin];
 			if (logical_block[iblk].clb_index == NO_CLUSTER) {
 				/* TODO: Gain function accurate only if net has one connection to block, TODO: Should we handle case where net has multi-connection to block? Gain computation is only off by a bit in this case */
-				if(cur_pb->pb_stats->connectiongain.count(iblk) == 0) {
-					cur_pb->pb_stats->connectiongain[iblk] = 0;
-				}
-				
 				if (num_internal_connections > 1) {
 					cur_pb->pb_stats->connectiongain[iblk] -= 1
 							/ (float) (vpack_net[inet].num_sinks
@@ -1503,9 +1894,6 @@ static void update_connection_gain_values(int inet, int clustered_block,
 
 		iblk = vpack_net[inet].node_block[0];
 		if (logical_block[iblk].clb_index == NO_CLUSTER) {
-			if(cur_pb->pb_stats->connectiongain.count(iblk) == 0) {
-				cur_pb->pb_stats->connectiongain[iblk] = 0;
-			}
 			if (num_internal_connections > 1) {
 				cur_pb->pb_stats->connectiongain[iblk] -= 1
 						/ (float) (vpack_net[inet].num_sinks
@@ -1550,9 +1938,6 @@ static void update_timing_gain_values(int inet, int clustered_block,
 				/* Timing gain is the timing criticality. */
 				timinggain = slacks->timing_criticality[inet][ipin]; 
 #endif
-				if(cur_pb->pb_stats->timinggain.count(iblk) == 0) {
-					cur_pb->pb_stats->timinggain[iblk] = 0;
-				}
 				if (timinggain > cur_pb->pb_stats->timinggain[iblk])
 					cur_pb->pb_stats->timinggain[iblk] = timinggain;
 			}
@@ -1574,9 +1959,6 @@ static void update_timing_gain_values(int inet, int clustered_block,
 				/* Timing gain is the timing criticality. */
 				timinggain = slacks->timing_criticality[inet][ipin]; 
 #endif
-				if(cur_pb->pb_stats->timinggain.count(newblk) == 0) {
-					cur_pb->pb_stats->timinggain[newblk] = 0;
-				}
 				if (timinggain > cur_pb->pb_stats->timinggain[newblk])
 					cur_pb->pb_stats->timinggain[newblk] = timinggain;
 
@@ -1603,16 +1985,20 @@ static void mark_and_update_partial_gain(int inet, enum e_gain_update gain_flag,
 	int iblk, ipin, ifirst, stored_net;
 	t_pb *cur_pb;
 
+	/* Only the top-level pb keeps gains: candidates are picked from its   *
+	 * gains alone, so the levels below it would keep figures nobody reads. */
 	cur_pb = logical_block[clustered_block].pb->parent_pb;
+	if (cur_pb == NULL) {
+		return; /* the block is a cluster of its own */
+	}
+	while (cur_pb->parent_pb != NULL) {
+		cur_pb = cur_pb->parent_pb;
+	}
 
-	
 	if (vpack_net[inet].num_sinks > AAPACK_MAX_NET_SINKS_IGNORE) {
 		/* Optimization: It can be too runtime costly for marking all sinks for a high fanout-net that probably has no hope of ever getting packed, thus ignore those high fanout nets */
 		if(vpack_net[inet].is_global != TRUE) {
 			/* If no low/medium fanout nets, we may need to consider high fan-out nets for packing, so select one and store it */ 
-			while(cur_pb->parent_pb != NULL) {
-				cur_pb = cur_pb->parent_pb;
-			}
 			stored_net = cur_pb->pb_stats->tie_break_high_fanout_net;
 			if(stored_net == OPEN || vpack_net[inet].num_sinks < vpack_net[stored_net].num_sinks) {
 				cur_pb->pb_stats->tie_break_high_fanout_net = inet;
@@ -1621,63 +2007,57 @@ static void mark_and_update_partial_gain(int inet, enum e_gain_update gain_flag,
 		return;
 	}
 
-	while (cur_pb) {
-		/* Mark vpack_net as being visited, if necessary. */
+	/* Mark vpack_net as being visited, if necessary. */
 
-		if (cur_pb->pb_stats->num_pins_of_net_in_pb.count(inet) == 0) {
-			cur_pb->pb_stats->marked_nets[cur_pb->pb_stats->num_marked_nets] =
-					inet;
-			cur_pb->pb_stats->num_marked_nets++;
-		}
+	if (cur_pb->pb_stats->num_pins_of_net_in_pb[inet] == 0) {
+		cur_pb->pb_stats->marked_nets[cur_pb->pb_stats->num_marked_nets] =
+				inet;
+		cur_pb->pb_stats->num_marked_nets++;
+	}
 
-		/* Update gains of affected blocks. */
+	/* Update gains of affected blocks. */
 
-		if (gain_flag == GAIN) {
+	if (gain_flag == GAIN) {
 
-			/* Check if this vpack_net lists its driving logical_block twice.  If so, avoid  *
-			 * double counting this logical_block by skipping the first (driving) pin. */
+		/* Check if this vpack_net lists its driving logical_block twice.  If so, avoid  *
+		 * double counting this logical_block by skipping the first (driving) pin. */
 
-			if (net_output_feeds_driving_block_input[inet] == 0)
-				ifirst = 0;
-			else
-				ifirst = 1;
-
-			if (cur_pb->pb_stats->num_pins_of_net_in_pb.count(inet) == 0) {
-				for (ipin = ifirst; ipin <= vpack_net[inet].num_sinks; ipin++) {
-					iblk = vpack_net[inet].node_block[ipin];
-					if (logical_block[iblk].clb_index == NO_CLUSTER) {
-
-						if (cur_pb->pb_stats->sharinggain.count(iblk) == 0) {
-							cur_pb->pb_stats->marked_blocks[cur_pb->pb_stats->num_marked_blocks] =
-									iblk;
-							cur_pb->pb_stats->num_marked_blocks++;
-							cur_pb->pb_stats->sharinggain[iblk] = 1;
-							cur_pb->pb_stats->hillgain[iblk] = 1
-									- num_ext_inputs_logical_block(iblk);
-						} else {
-							cur_pb->pb_stats->sharinggain[iblk]++;
-							cur_pb->pb_stats->hillgain[iblk]++;
-						}
+		if (net_output_feeds_driving_block_input[inet] == 0)
+			ifirst = 0;
+		else
+			ifirst = 1;
+
+		if (cur_pb->pb_stats->num_pins_of_net_in_pb[inet] == 0) {
+			for (ipin = ifirst; ipin <= vpack_net[inet].num_sinks; ipin++) {
+				iblk = vpack_net[inet].node_block[ipin];
+				if (logical_block[iblk].clb_index == NO_CLUSTER) {
+
+					if (cur_pb->pb_stats->sharinggain[iblk] == 0) {
+						cur_pb->pb_stats->marked_blocks[cur_pb->pb_stats->num_marked_blocks] =
+								iblk;
+						cur_pb->pb_stats->num_marked_blocks++;
+						cur_pb->pb_stats->sharinggain[iblk] = 1;
+						cur_pb->pb_stats->hillgain[iblk] = 1
+								- num_ext_inputs_logical_block(iblk);
+					} else {
+						cur_pb->pb_stats->sharinggain[iblk]++;
+						cur_pb->pb_stats->hillgain[iblk]++;
 					}
 				}
 			}
+		}
 
-			if (connection_driven) {
-				update_connection_gain_values(inet, clustered_block, cur_pb,
-						net_relation_to_clustered_block);
-			}
-
-			if (timing_driven) {
-				update_timing_gain_values(inet, clustered_block, cur_pb,
-						net_relation_to_clustered_block, slacks);
-			}
+		if (connection_driven) {
+			update_connection_gain_values(inet, clustered_block, cur_pb,
+					net_relation_to_clustered_block);
 		}
-		if(cur_pb->pb_stats->num_pins_of_net_in_pb.count(inet) == 0) {
-			cur_pb->pb_stats->num_pins_of_net_in_pb[inet] = 0;
+
+		if (timing_driven) {
+			update_timing_gain_values(inet, clustered_block, cur_pb,
+					net_relation_to_clustered_block, slacks);
 		}
-		cur_pb->pb_stats->num_pins_of_net_in_pb[inet]++;
-		cur_pb = cur_pb->parent_pb;
 	}
+	cur_pb->pb_stats->num_pins_of_net_in_pb[inet]++;
 }
 
 /*****************************************/
@@ -1685,89 +2065,94 @@ static void update_total_gain(float alpha, float beta, boolean timing_driven,
 		boolean connection_driven, boolean global_clocks, t_pb *pb) {
 
 	/*Updates the total  gain array to reflect the desired tradeoff between*
-	 *input sharing (sharinggain) and path_length minimization (timinggain)*/
+	 *input sharing (sharinggain) and path_length minimization (timinggain)*
+	 *of pb, the top-level pb of the open cluster.                         */
 
 	int i, iblk, j, k;
 	t_pb * cur_pb;
 	int num_input_pins, num_output_pins;
 	int num_used_input_pins, num_used_output_pins;
+	float old_gain;
 	t_model_ports *port;
 
+	if (pb == NULL) {
+		return;
+	}
 	cur_pb = pb;
-	while (cur_pb) {
-
-		for (i = 0; i < cur_pb->pb_stats->num_marked_blocks; i++) {
-			iblk = cur_pb->pb_stats->marked_blocks[i];
-
-			if(cur_pb->pb_stats->connectiongain.count(iblk) == 0) {
-				cur_pb->pb_stats->connectiongain[iblk] = 0;
-			}
-			if(cur_pb->pb_stats->sharinggain.count(iblk) == 0) {
-				cur_pb->pb_stats->connectiongain[iblk] = 0;
-			}
-
-			/* Todo: This was used to explore different normalization options, can be made more efficient once we decide on which one to use*/
-			num_input_pins = 0;
-			port = logical_block[iblk].model->inputs;
-			j = 0;
-			num_used_input_pins = 0;
-			while (port) {
-				num_input_pins += port->size;
-				if (!port->is_clock) {
-					for (k = 0; k < port->size; k++) {
-						if (logical_block[iblk].input_nets[j][k] != OPEN) {
-							num_used_input_pins++;
-						}
+	for (i = 0; i < cur_pb->pb_stats->num_marked_blocks; i++) {
+		iblk = cur_pb->pb_stats->marked_blocks[i];
+		old_gain = cur_pb->pb_stats->gain[iblk];
+
+		/* Todo: This was used to explore different normalization options, can be made more efficient once we decide on which one to use*/
+		num_input_pins = 0;
+		port = logical_block[iblk].model->inputs;
+		j = 0;
+		num_used_input_pins = 0;
+		while (port) {
+			num_input_pins += port->size;
+			if (!port->is_clock) {
+				for (k = 0; k < port->size; k++) {
+					if (logical_block[iblk].input_nets[j][k] != OPEN) {
+						num_used_input_pins++;
 					}
-					j++;
 				}
-				port = port->next;
-			}
-			if (num_input_pins == 0) {
-				num_input_pins = 1;
+				j++;
 			}
+			port = port->next;
+		}
+		if (num_input_pins == 0) {
+			num_input_pins = 1;
+		}
 
-			num_used_output_pins = 0;
-			j = 0;
-			num_output_pins = 0;
-			port = logical_block[iblk].model->outputs;
-			while (port) {
-				num_output_pins += port->size;
-				for (k = 0; k < port->size; k++) {
-					if (logical_block[iblk].output_nets[j][k] != OPEN) {
-						num_used_output_pins++;
-					}
+		num_used_output_pins = 0;
+		j = 0;
+		num_output_pins = 0;
+		port = logical_block[iblk].model->outputs;
+		while (port) {
+			num_output_pins += port->size;
+			for (k = 0; k < port->size; k++) {
+				if (logical_block[iblk].output_nets[j][k] != OPEN) {
+					num_used_output_pins++;
 				}
-				port = port->next;
-				j++;
 			}
-			/* end todo */
+			port = port->next;
+			j++;
+		}
+		/* end todo */
+
+		/* Calculate area-only cost function */
+		if (connection_driven) {
+			/*try to absorb as many connections as possible*/
+			/*cur_pb->pb_stats->gain[iblk] = ((1-beta)*(float)cur_pb->pb_stats->sharinggain[iblk] + beta*(float)cur_pb->pb_stats->connectiongain[iblk])/(num_input_pins + num_output_pins);*/
+			cur_pb->pb_stats->gain[iblk] = ((1 - beta)
+					* (float) cur_pb->pb_stats->sharinggain[iblk]
+					+ beta * (float) cur_pb->pb_stats->connectiongain[iblk])
+					/ (num_used_input_pins + num_used_output_pins);
+		} else {
+			/*cur_pb->pb_stats->gain[iblk] = ((float)cur_pb->pb_stats->sharinggain[iblk])/(num_input_pins + num_output_pins); */
+			cur_pb->pb_stats->gain[iblk] =
+					((float) cur_pb->pb_stats->sharinggain[iblk])
+							/ (num_used_input_pins + num_used_output_pins);
 
-			/* Calculate area-only cost function */
-			if (connection_driven) {
-				/*try to absorb as many connections as possible*/
-				/*cur_pb->pb_stats->gain[iblk] = ((1-beta)*(float)cur_pb->pb_stats->sharinggain[iblk] + beta*(float)cur_pb->pb_stats->connectiongain[iblk])/(num_input_pins + num_output_pins);*/
-				cur_pb->pb_stats->gain[iblk] = ((1 - beta)
-						* (float) cur_pb->pb_stats->sharinggain[iblk]
-						+ beta * (float) cur_pb->pb_stats->connectiongain[iblk])
-						/ (num_used_input_pins + num_used_output_pins);
-			} else {
-				/*cur_pb->pb_stats->gain[iblk] = ((float)cur_pb->pb_stats->sharinggain[iblk])/(num_input_pins + num_output_pins); */
-				cur_pb->pb_stats->gain[iblk] =
-						((float) cur_pb->pb_stats->sharinggain[iblk])
-								/ (num_used_input_pins + num_used_output_pins);
+		}
 
-			}
+		/* Add in timing driven cost into cost function */
+		if (timing_driven) {
+			cur_pb->pb_stats->gain[iblk] = alpha
+					* cur_pb->pb_stats->timinggain[iblk]
+					+ (1.0 - alpha) * (float) cur_pb->pb_stats->gain[iblk];
+		}
 
-			/* Add in timing driven cost into cost function */
-			if (timing_driven) {
-				cur_pb->pb_stats->gain[iblk] = alpha
-						* cur_pb->pb_stats->timinggain[iblk]
-						+ (1.0 - alpha) * (float) cur_pb->pb_stats->gain[iblk];
-			}
+		/* Queue the molecules of newly marked blocks, and queue again  *
+		 * those whose gain has changed; the old heap entries become    *
+		 * stale.                                                       */
+		if (i >= cur_pb->pb_stats->num_queued_marked_blocks
+				|| cur_pb->pb_stats->gain[iblk] != old_gain) {
+			queue_block_candidates(cur_pb->pb_stats, iblk);
 		}
-		cur_pb = cur_pb->parent_pb;
 	}
+	cur_pb->pb_stats->num_queued_marked_blocks =
+			cur_pb->pb_stats->num_marked_blocks;
 }
 
 /*****************************************/
@@ -1868,7 +2253,7 @@ static void update_cluster_stats( INP t_pack_molecule *molecule,
 		}
 
 		update_total_gain(alpha, beta, timing_driven, connection_driven,
-				global_clocks, logical_block[new_blk].pb->parent_pb);
+				global_clocks, cb);
 
 		commit_lookahead_pins_used(cb);
 	}
@@ -1985,107 +2370,228 @@ static void start_new_cluster(
 }
 
 /*****************************************/
-static t_pack_molecule *get_highest_gain_molecule(
-		INP enum e_packer_algorithm packer_algorithm, INOUTP t_pb *cur_pb,
-		INP enum e_gain_type gain_mode,
-		INP t_cluster_placement_stats *cluster_placement_stats_ptr) {
+static void queue_candidate_molecule(INOUTP t_pb_stats *pb_stats,
+		INP t_pack_molecule *molecule) {
 
-	/* This routine populates a list of feasible blocks outside the cluster then returns the best one for the list    *
-	 * not currently in a cluster and satisfies the feasibility     *
-	 * function passed in as is_feasible.  If there are no feasible *
-	 * blocks it returns NO_CLUSTER.                                */
+	/* Pushes molecule onto the candidate heap of pb_stats with its current gain. */
 
-	int i, j, iblk, index, inet, count;
-	boolean success;
-	struct s_linked_vptr *cur;
+	int i;
+	t_molecule_gain_entry entry;
+
+	if (pb_stats->num_candidates + 1 >= pb_stats->max_candidates) {
+		pb_stats->max_candidates = 2 * pb_stats->max_candidates
+				+ AAPACK_MAX_FEASIBLE_BLOCK_ARRAY_SIZE;
+		pb_stats->candidates = (t_molecule_gain_entry *) my_realloc(
+				pb_stats->candidates,
+				pb_stats->max_candidates * sizeof(t_molecule_gain_entry));
+	}
 
+	entry.gain = get_molecule_gain(molecule, pb_stats);
+	entry.molecule = molecule;
+
+	pb_stats->num_candidates++;
+	i = pb_stats->num_candidates;
+	while (i > 1 && pb_stats->candidates[i / 2].gain < entry.gain) {
+		pb_stats->candidates[i] = pb_stats->candidates[i / 2];
+		i /= 2;
+	}
+	pb_stats->candidates[i] = entry;
+}
+
+static void queue_block_candidates(INOUTP t_pb_stats *pb_stats, INP int iblk) {
+
+	/* Queues every valid molecule containing unclustered logical block iblk. */
+
+	struct s_linked_vptr *cur;
 	t_pack_molecule *molecule;
-	molecule = NULL;
 
-	if (gain_mode == HILL_CLIMBING) {
-		vpr_printf(TIO_MESSAGE_ERROR, "Hill climbing not supported yet, error out.\n");
-		exit(1);
+	if (logical_block[iblk].clb_index != NO_CLUSTER) {
+		return;
 	}
+	cur = logical_block[iblk].packed_molecules;
+	while (cur != NULL) {
+		molecule = (t_pack_molecule *) cur->data_vptr;
+		if (molecule->valid) {
+			queue_candidate_molecule(pb_stats, molecule);
+		}
+		cur = cur->next;
+	}
+}
 
-	if (cur_pb->pb_stats->num_feasible_blocks == NOT_VALID) {
-		/* Divide into two cases for speed only. */
-		/* Typical case:  not too many blocks have been marked. */
+static t_molecule_gain_entry pop_candidate_molecule(INOUTP t_pb_stats *pb_stats) {
 
-		cur_pb->pb_stats->num_feasible_blocks = 0;
+	/* Removes and returns the highest gain entry of the candidate heap. */
 
-		if (cur_pb->pb_stats->num_marked_blocks
-				< num_logical_blocks / MARKED_FRAC) {
-			for (i = 0; i < cur_pb->pb_stats->num_marked_blocks; i++) {
-				iblk = cur_pb->pb_stats->marked_blocks[i];
-				if (logical_block[iblk].clb_index == NO_CLUSTER) {
-					cur = logical_block[iblk].packed_molecules;
-					while (cur != NULL) {
-						molecule = (t_pack_molecule *) cur->data_vptr;
-						if (molecule->valid) {
-							success = TRUE;
-							for (j = 0;
-									j < get_array_size_of_molecule(molecule);
-									j++) {
-								if (molecule->logical_block_ptrs[j] != NULL) {
-									assert(
-											molecule->logical_block_ptrs[j]->clb_index == NO_CLUSTER);
-									if (!exists_free_primitive_for_logical_block(
-											cluster_placement_stats_ptr,
-											iblk)) { /* TODO: debating whether to check if placement exists for molecule (more robust) or individual logical blocks (faster) */
-										success = FALSE;
-										break;
-									}
-								}
-							}
-							if (success) {
-								add_molecule_to_pb_stats_candidates(molecule,
-										cur_pb->pb_stats->gain, cur_pb);
-							}
-						}
-						cur = cur->next;
-					}
-				}
-			}
-		} else { /* Some high fanout nets marked lots of blocks. */
-			for (iblk = 0; iblk < num_logical_blocks; iblk++) {
-				if (logical_block[iblk].clb_index == NO_CLUSTER) {
-					cur = logical_block[iblk].packed_molecules;
-					while (cur != NULL) {
-						molecule = (t_pack_molecule *) cur->data_vptr;
-						if (molecule->valid) {
-							success = TRUE;
-							for (j = 0;
-									j < get_array_size_of_molecule(molecule);
-									j++) {
-								if (molecule->logical_block_ptrs[j] != NULL) {
-									assert(
-											molecule->logical_block_ptrs[j]->clb_index == NO_CLUSTER);
-									if (!exists_free_primitive_for_logical_block(
-											cluster_placement_stats_ptr,
-											iblk)) {
-										success = FALSE;
-										break;
-									}
-								}
-							}
-							if (success) {
-								add_molecule_to_pb_stats_candidates(molecule,
-										cur_pb->pb_stats->gain, cur_pb);
-							}
-						}
-						cur = cur->next;
-					}
-				}
-			}
+	int i, child;
+	t_molecule_gain_entry top, last;
+
+	assert(pb_stats->num_candidates > 0);
+	top = pb_stats->candidates[1];
+	last = pb_stats->candidates[pb_stats->num_candidates];
+	pb_stats->num_candidates--;
+
+	i = 1;
+	child = 2;
+	while (child <= pb_stats->num_candidates) {
+		if (child < pb_stats->num_candidates
+				&& pb_stats->candidates[child + 1].gain
+						> pb_stats->candidates[child].gain) {
+			child++;
+		}
+		if (pb_stats->candidates[child].gain <= last.gain) {
+			break;
 		}
+		pb_stats->candidates[i] = pb_stats->candidates[child];
+		i = child;
+		child = 2 * i;
 	}
-	if(cur_pb->pb_stats->num_feasible_blocks == 0 && cur_pb->pb_stats->tie_break_high_fanout_net != OPEN) {
-		/* Because the packer ignores high fanout nets when marking what blocks to consider, use one of the ignored high fanout net to fill up lightly related blocks */
-		reset_tried_but_unused_cluster_placements(cluster_placement_stats_ptr);
-		inet = cur_pb->pb_stats->tie_break_high_fanout_net;
-		count = 0;
-		for (i = 0; i <= vpack_net[inet].num_sinks && count < AAPACK_MAX_HIGH_FANOUT_EXPLORE; i++) {
-			iblk = vpack_net[inet].node_block[i];
+	pb_stats->candidates[i] = last;
+
+	return top;
+}
+
+static void park_candidate_molecule(INOUTP t_pb_stats *pb_stats,
+		INOUTP t_pack_molecule *molecule) {
+
+	/* Sets molecule aside until the pb changes; see requeue_parked_candidates. */
+
+	if (pb_stats->num_parked_candidates >= pb_stats->max_parked_candidates) {
+		pb_stats->max_parked_candidates = 2 * pb_stats->max_parked_candidates
+				+ AAPACK_MAX_FEASIBLE_BLOCK_ARRAY_SIZE;
+		pb_stats->parked_candidates = (t_pack_molecule **) my_realloc(
+				pb_stats->parked_candidates,
+				pb_stats->max_parked_candidates * sizeof(t_pack_molecule *));
+	}
+	pb_stats->parked_candidates[pb_stats->num_parked_candidates] = molecule;
+	pb_stats->num_parked_candidates++;
+	molecule->candidate_round = candidate_round;
+}
+
+static void requeue_parked_candidates(INOUTP t_pb_stats *pb_stats) {
+
+	/* Starts a new candidate round: every parked molecule that is still *
+	 * valid is queued again with its current gain.                       */
+
+	int i;
+
+	candidate_round++;
+	for (i = 0; i < pb_stats->num_parked_candidates; i++) {
+		if (pb_stats->parked_candidates[i]->valid) {
+			queue_candidate_molecule(pb_stats, pb_stats->parked_candidates[i]);
+		}
+	}
+	pb_stats->num_parked_candidates = 0;
+	pb_stats->num_tried_candidates = 0;
+}
+
+static t_pack_molecule *get_queued_candidate_molecule(
+		INOUTP t_pb_stats *pb_stats,
+		INP t_cluster_placement_stats *cluster_placement_stats_ptr) {
+
+	/* Pops candidates until one is found that is still valid, whose entry  *
+	 * is not stale, and whose logical blocks all have a free primitive in  *
+	 * the cluster.  As with the old sorted candidate array, at most        *
+	 * AAPACK_MAX_FEASIBLE_BLOCK_ARRAY_SIZE - 1 molecules are returned per  *
+	 * candidate round.  Returns NULL if there is no such molecule.         */
+
+	int i;
+	boolean success;
+	t_molecule_gain_entry entry;
+	t_pack_molecule *molecule;
+
+	while (pb_stats->num_candidates > 0
+			&& pb_stats->num_tried_candidates
+					< AAPACK_MAX_FEASIBLE_BLOCK_ARRAY_SIZE - 1) {
+		entry = pop_candidate_molecule(pb_stats);
+		molecule = entry.molecule;
+
+		/* Already popped this round, or absorbed by another molecule */
+		if (molecule->candidate_round == candidate_round || !molecule->valid) {
+			continue;
+		}
+		success = TRUE;
+		for (i = 0; i < get_array_size_of_molecule(molecule); i++) {
+			if (molecule->logical_block_ptrs[i] != NULL
+					&& molecule->logical_block_ptrs[i]->clb_index != NO_CLUSTER) {
+				success = FALSE;
+				break;
+			}
+		}
+		if (!success) {
+			continue;
+		}
+
+		/* A later entry holds the molecule's current gain */
+		if (entry.gain != get_molecule_gain(molecule, pb_stats)) {
+			continue;
+		}
+
+		park_candidate_molecule(pb_stats, molecule);
+		for (i = 0; i < get_array_size_of_molecule(molecule); i++) {
+			if (molecule->logical_block_ptrs[i] != NULL
+					&& !exists_free_primitive_for_logical_block(
+							cluster_placement_stats_ptr,
+							molecule->logical_block_ptrs[i]->index)) {
+				success = FALSE;
+				break;
+			}
+		}
+		if (success) {
+			pb_stats->num_tried_candidates++;
+			return molecule;
+		}
+	}
+
+	return NULL;
+}
+
+/*****************************************/
+static t_pack_molecule *get_highest_gain_molecule(
+		INP enum e_packer_algorithm packer_algorithm, INOUTP t_pb *cur_pb,
+		INP enum e_gain_type gain_mode,
+		INP t_cluster_placement_stats *cluster_placement_stats_ptr) {
+
+	/* Returns the highest gain molecule outside the cluster that is not    *
+	 * currently in a cluster and has a free primitive for each of its      *
+	 * logical blocks.  Candidates come from the heap kept up to date by    *
+	 * update_total_gain; if it has none, a few blocks on an ignored high   *
+	 * fanout net are tried.  If there are no feasible blocks it returns    *
+	 * NULL.                                                                */
+
+	int i, j, iblk, index, inet, count;
+	boolean success;
+	struct s_linked_vptr *cur;
+
+	t_pack_molecule *molecule;
+	molecule = NULL;
+
+	if (gain_mode == HILL_CLIMBING) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Hill climbing not supported yet, error out.\n");
+		exit(1);
+	}
+
+	if (cur_pb->pb_stats->num_feasible_blocks == NOT_VALID) {
+		/* A molecule was added since the last call, so the molecules tried *
+		 * or blocked since then get another chance.                        */
+		cur_pb->pb_stats->num_feasible_blocks = 0;
+		requeue_parked_candidates(cur_pb->pb_stats);
+	}
+
+	if (cur_pb->pb_stats->num_feasible_blocks == 0) {
+		molecule = get_queued_candidate_molecule(cur_pb->pb_stats,
+				cluster_placement_stats_ptr);
+		if (molecule != NULL) {
+			return molecule;
+		}
+	}
+
+	if(cur_pb->pb_stats->num_feasible_blocks == 0 && cur_pb->pb_stats->tie_break_high_fanout_net != OPEN) {
+		/* Because the packer ignores high fanout nets when marking what blocks to consider, use one of the ignored high fanout net to fill up lightly related blocks */
+		reset_tried_but_unused_cluster_placements(cluster_placement_stats_ptr);
+		inet = cur_pb->pb_stats->tie_break_high_fanout_net;
+		count = 0;
+		for (i = 0; i <= vpack_net[inet].num_sinks && count < AAPACK_MAX_HIGH_FANOUT_EXPLORE; i++) {
+			iblk = vpack_net[inet].node_block[i];
 			if (logical_block[iblk].clb_index == NO_CLUSTER) {
 				cur = logical_block[iblk].packed_molecules;
 				while (cur != NULL) {
@@ -2108,7 +2614,7 @@ static t_pack_molecule *get_highest_gain_molecule(
 						}
 						if (success) {
 							add_molecule_to_pb_stats_candidates(molecule,
-									cur_pb->pb_stats->gain, cur_pb);
+									cur_pb);
 							count++;
 						}
 					}
@@ -2330,26 +2836,14 @@ static t_pack_molecule* get_most_critical_seed_molecule(int * indexofcrit) {
 	 * if block belongs to multiple molecules, return the biggest molecule. */
 
 	int blkidx;
-	t_pack_molecule *molecule, *best;
-	struct s_linked_vptr *cur;
+	t_pack_molecule *best;
 
 	while (*indexofcrit < num_logical_blocks) {
 
 		blkidx = critindexarray[(*indexofcrit)++];
 
 		if (logical_block[blkidx].clb_index == NO_CLUSTER) {
-			cur = logical_block[blkidx].packed_molecules;
-			best = NULL;
-			while (cur != NULL) {
-				molecule = (t_pack_molecule *) cur->data_vptr;
-				if (molecule->valid) {
-					if (best == NULL
-							|| (best->base_gain) < (molecule->base_gain)) {
-						best = molecule;
-					}
-				}
-				cur = cur->next;
-			}
+			best = get_best_valid_molecule_of_block(blkidx);
 			assert(best != NULL);
 			return best;
 		}
@@ -2359,11 +2853,595 @@ static t_pack_molecule* get_most_critical_seed_molecule(int * indexofcrit) {
 	return NULL;
 }
 
+static t_pack_molecule *get_best_valid_molecule_of_block(int iblk) {
+
+	/* Returns the valid molecule with the highest base gain that iblk belongs *
+	 * to, or NULL if it is in none.                                           */
+
+	t_pack_molecule *molecule, *best;
+	struct s_linked_vptr *cur;
+
+	cur = logical_block[iblk].packed_molecules;
+	best = NULL;
+	while (cur != NULL) {
+		molecule = (t_pack_molecule *) cur->data_vptr;
+		if (molecule->valid) {
+			if (best == NULL || (best->base_gain) < (molecule->base_gain)) {
+				best = molecule;
+			}
+		}
+		cur = cur->next;
+	}
+	return best;
+}
+
+/*****************************************/
+static void alloc_speculative_packing(INP int num_pack_workers,
+		INP int max_cluster_size) {
+
+	int iworker, iblk;
+
+	speculative_clusters = (t_speculative_cluster *) my_calloc(num_pack_workers,
+			sizeof(t_speculative_cluster));
+	for (iworker = 1; iworker < num_pack_workers; iworker++) {
+		speculative_clusters[iworker].molecules = (t_pack_molecule **) my_malloc(
+				(max_cluster_size + 1) * sizeof(t_pack_molecule *));
+		speculative_clusters[iworker].fd = -1;
+		speculative_clusters[iworker].route_entries = NULL;
+	}
+	speculative_record = (t_pack_molecule **) my_malloc(
+			(max_cluster_size + 1) * sizeof(t_pack_molecule *));
+	num_speculative_record = 0;
+
+	seed_region_round = (int *) my_malloc(num_logical_blocks * sizeof(int));
+	seed_region_hops = (int *) my_malloc(num_logical_blocks * sizeof(int));
+	seed_speculated = (boolean *) my_malloc(num_logical_blocks * sizeof(boolean));
+	for (iblk = 0; iblk < num_logical_blocks; iblk++) {
+		seed_region_round[iblk] = 0;
+		seed_region_hops[iblk] = 0;
+		seed_speculated[iblk] = FALSE;
+	}
+	seed_round = 0;
+
+	num_speculative_committed = 0;
+	num_speculative_discarded = 0;
+	num_speculative_regrown = 0;
+	num_speculative_conflicts = 0;
+
+	speculative_fork_seconds = 0.;
+	speculative_wait_seconds = 0.;
+	speculative_replay_seconds = 0.;
+	speculative_committed_seconds = 0.;
+	num_speculative_rounds = 0;
+	speculation_throttled = FALSE;
+}
+
+static void free_speculative_packing(INP int num_pack_workers) {
+
+	int iworker;
+
+	vpr_printf(TIO_MESSAGE_INFO, "Speculative clustering: %d worker clusters committed, %d discarded, %d regrown serially; %d molecules lost to conflicts.\n",
+			num_speculative_committed, num_speculative_discarded,
+			num_speculative_regrown, num_speculative_conflicts);
+	vpr_printf(TIO_MESSAGE_INFO, "Speculative clustering: %g s forking, %g s waiting for workers, %g s replaying, for %g s of committed worker clustering (%g s saved).\n",
+			speculative_fork_seconds, speculative_wait_seconds,
+			speculative_replay_seconds, speculative_committed_seconds,
+			speculative_committed_seconds - speculative_fork_seconds
+					- speculative_wait_seconds - speculative_replay_seconds);
+
+	for (iworker = 1; iworker < num_pack_workers; iworker++) {
+		free(speculative_clusters[iworker].molecules);
+		free(speculative_clusters[iworker].route_entries);
+	}
+	free(speculative_clusters);
+	free(speculative_record);
+	free(seed_region_round);
+	free(seed_region_hops);
+	free(seed_speculated);
+	speculative_clusters = NULL;
+	speculative_record = NULL;
+	seed_region_round = NULL;
+	seed_region_hops = NULL;
+	seed_speculated = NULL;
+}
+
+static double get_pack_wall_seconds(void) {
+
+	/* Wall-clock time, so the packer is charged for waiting on workers. */
+
+#ifndef _WIN32
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return ((double) now.tv_sec + 1.e-6 * (double) now.tv_usec);
+#else
+	return ((double) clock() / CLOCKS_PER_SEC);
+#endif
+}
+
+static void check_speculation_pays_off(void) {
+
+	/* Called after each round that had workers.  Once the trial rounds are *
+	 * done, stops speculating if forking, waiting for and replaying the    *
+	 * worker clusters took longer than growing them serially would have.   */
+
+	double overhead;
+
+	num_speculative_rounds++;
+	if (num_speculative_rounds != SPECULATIVE_TRIAL_ROUNDS) {
+		return;
+	}
+	overhead = speculative_fork_seconds + speculative_wait_seconds
+			+ speculative_replay_seconds;
+	if (overhead >= speculative_committed_seconds) {
+		vpr_printf(TIO_MESSAGE_INFO, "Speculative clustering cost %g s to save %g s of clustering over %d rounds; clustering serially from here.\n",
+				overhead, speculative_committed_seconds, num_speculative_rounds);
+		speculation_throttled = TRUE;
+	}
+}
+
+static void mark_seed_region_net(INP int inet, INP int hops) {
+
+	int ipin;
+
+	if (inet == OPEN || vpack_net[inet].num_sinks > PACK_WORKER_MAX_NET_SINKS) {
+		return;
+	}
+	for (ipin = 0; ipin <= vpack_net[inet].num_sinks; ipin++) {
+		mark_seed_region(vpack_net[inet].node_block[ipin], hops);
+	}
+}
+
+static void mark_seed_region(INP int iblk, INP int hops) {
+
+	/* Marks every block within hops nets of iblk as too close to a seed of *
+	 * this round.  Blocks already reached with as many hops left are not   *
+	 * expanded again.                                                      */
+
+	int ipin;
+	t_model_ports *port;
+
+	if (seed_region_round[iblk] == seed_round && seed_region_hops[iblk] >= hops) {
+		return;
+	}
+	seed_region_round[iblk] = seed_round;
+	seed_region_hops[iblk] = hops;
+	if (hops == 0) {
+		return;
+	}
+
+	port = logical_block[iblk].model->outputs;
+	while (port) {
+		for (ipin = 0; ipin < port->size; ipin++) {
+			mark_seed_region_net(logical_block[iblk].output_nets[port->index][ipin],
+					hops - 1);
+		}
+		port = port->next;
+	}
+	port = logical_block[iblk].model->inputs;
+	while (port) {
+		if (!port->is_clock) {
+			for (ipin = 0; ipin < port->size; ipin++) {
+				mark_seed_region_net(
+						logical_block[iblk].input_nets[port->index][ipin],
+						hops - 1);
+			}
+		}
+		port = port->next;
+	}
+	mark_seed_region_net(logical_block[iblk].clock_net, hops - 1);
+}
+
+static boolean try_claim_speculative_seed(INP t_pack_molecule *molecule) {
+
+	/* Accepts molecule as a worker seed if it has not been tried as one     *
+	 * before and none of its blocks is near a seed already picked this     *
+	 * round.  An accepted seed's neighbourhood is marked.                   */
+
+	int i;
+
+	if (seed_speculated[molecule->logical_block_ptrs[molecule->root]->index]) {
+		return FALSE;
+	}
+	for (i = 0; i < get_array_size_of_molecule(molecule); i++) {
+		if (molecule->logical_block_ptrs[i] != NULL
+				&& seed_region_round[molecule->logical_block_ptrs[i]->index]
+						== seed_round) {
+			return FALSE;
+		}
+	}
+	for (i = 0; i < get_array_size_of_molecule(molecule); i++) {
+		if (molecule->logical_block_ptrs[i] != NULL) {
+			mark_seed_region(molecule->logical_block_ptrs[i]->index,
+					PACK_WORKER_SEED_HOPS);
+		}
+	}
+	return TRUE;
+}
+
+static int pick_speculative_seeds(INP t_pack_molecule *istart,
+		INP int max_seeds, INP boolean critical_seeds, INP int indexofcrit,
+		INP int max_molecule_inputs) {
+
+	/* Loads speculative_clusters[1..] with up to max_seeds seeds, taken in   *
+	 * the order the packer would pick them itself, that are more than       *
+	 * PACK_WORKER_SEED_HOPS nets from istart and from each other.  Nothing is *
+	 * consumed; returns the number of seeds found.                           */
+
+	int i, num_seeds, num_scanned, ext_inps;
+	t_pack_molecule *molecule;
+	struct s_molecule_link *ptr;
+
+	seed_round++;
+	for (i = 0; i < get_array_size_of_molecule(istart); i++) {
+		if (istart->logical_block_ptrs[i] != NULL) {
+			mark_seed_region(istart->logical_block_ptrs[i]->index,
+					PACK_WORKER_SEED_HOPS);
+		}
+	}
+
+	num_seeds = 0;
+	num_scanned = 0;
+	if (critical_seeds) {
+		for (i = indexofcrit;
+				i < num_logical_blocks && num_seeds < max_seeds
+						&& num_scanned < max_seeds * PACK_WORKER_SEED_SCAN; i++) {
+			if (logical_block[critindexarray[i]].clb_index != NO_CLUSTER) {
+				continue;
+			}
+			num_scanned++;
+			molecule = get_best_valid_molecule_of_block(critindexarray[i]);
+			if (molecule != NULL && try_claim_speculative_seed(molecule)) {
+				speculative_clusters[++num_seeds].seed = molecule;
+			}
+		}
+	} else {
+		for (ext_inps = max_molecule_inputs;
+				ext_inps >= 0 && num_seeds < max_seeds
+						&& num_scanned < max_seeds * PACK_WORKER_SEED_SCAN; ext_inps--) {
+			ptr = unclustered_list_head[ext_inps].next;
+			while (ptr != NULL && num_seeds < max_seeds
+					&& num_scanned < max_seeds * PACK_WORKER_SEED_SCAN) {
+				if (ptr->moleculeptr->valid) {
+					num_scanned++;
+					if (try_claim_speculative_seed(ptr->moleculeptr)) {
+						speculative_clusters[++num_seeds].seed = ptr->moleculeptr;
+					}
+				}
+				ptr = ptr->next;
+			}
+		}
+	}
+	return num_seeds;
+}
+
+static int fork_pack_workers(INP int num_pack_workers,
+		INP boolean critical_seeds, INP int indexofcrit,
+		INP int max_molecule_inputs, INOUTP t_pack_molecule **istart) {
+
+	/* Picks up to num_pack_workers-1 seeds far from *istart and forks one    *
+	 * worker per seed.  Returns the number of workers started in the packer. *
+	 * In a worker, returns 0 with *istart set to the worker's seed.          */
+
+	int num_seeds, iworker, jworker;
+#ifndef _WIN32
+	int fds[2];
+	t_pack_molecule *seed;
+
+	num_seeds = pick_speculative_seeds(*istart, num_pack_workers - 1,
+			critical_seeds, indexofcrit, max_molecule_inputs);
+	if (num_seeds == 0) {
+		return 0;
+	}
+
+	fflush(NULL); /* so the workers do not repeat buffered output */
+	for (iworker = 1; iworker <= num_seeds; iworker++) {
+		if (pipe(fds) != 0) {
+			break;
+		}
+		speculative_clusters[iworker].pid = (int) fork();
+		if (speculative_clusters[iworker].pid == 0) {
+			close(fds[0]);
+			for (jworker = 1; jworker < iworker; jworker++) {
+				close(speculative_clusters[jworker].fd);
+			}
+			pack_worker_index = iworker;
+			pack_worker_fd = fds[1];
+			*istart = speculative_clusters[iworker].seed;
+			worker_grow_begin = get_pack_wall_seconds();
+			record_route_cache_additions();
+			/* Only the packer reports progress */
+			if (freopen("/dev/null", "w", stdout) == NULL) {
+				_exit(1);
+			}
+			return 0;
+		}
+		close(fds[1]);
+		if (speculative_clusters[iworker].pid < 0) {
+			close(fds[0]);
+			break;
+		}
+		speculative_clusters[iworker].fd = fds[0];
+		speculative_clusters[iworker].reported = FALSE;
+		seed = speculative_clusters[iworker].seed;
+		seed_speculated[seed->logical_block_ptrs[seed->root]->index] = TRUE;
+	}
+	return iworker - 1;
+#else
+	(void) num_seeds;
+	(void) iworker;
+	(void) jworker;
+	return 0;
+#endif
+}
+
+#ifndef _WIN32
+static boolean write_fully(INP int fd, INP const void *buf, INP size_t size) {
+
+	ssize_t written;
+
+	while (size > 0) {
+		written = write(fd, buf, size);
+		if (written <= 0) {
+			return FALSE;
+		}
+		buf = (const char *) buf + written;
+		size -= (size_t) written;
+	}
+	return TRUE;
+}
+
+static boolean read_fully(INP int fd, OUTP void *buf, INP size_t size) {
+
+	ssize_t num_read;
+
+	while (size > 0) {
+		num_read = read(fd, buf, size);
+		if (num_read <= 0) {
+			return FALSE;
+		}
+		buf = (char *) buf + num_read;
+		size -= (size_t) num_read;
+	}
+	return TRUE;
+}
+#endif
+
+static void report_speculative_cluster(INP int detailed_routing_stage) {
+
+	/* Sends the molecules of the cluster this worker grew, in the order they *
+	 * were packed, the time it took and the intra-cluster routings it found  *
+	 * to the packer, and ends the worker.  The molecule pointers are valid   *
+	 * in the packer since the worker is a fork of it.                        */
+
+#ifndef _WIN32
+	int header[3];
+	int *route_entries;
+	double grow_seconds;
+
+	grow_seconds = get_pack_wall_seconds() - worker_grow_begin;
+	route_entries = get_route_cache_additions(&header[2]);
+	header[0] = detailed_routing_stage;
+	header[1] = num_speculative_record;
+	if (write_fully(pack_worker_fd, header, sizeof(header))
+			&& write_fully(pack_worker_fd, &grow_seconds, sizeof(double))
+			&& write_fully(pack_worker_fd, speculative_record,
+					num_speculative_record * sizeof(t_pack_molecule *))) {
+		write_fully(pack_worker_fd, route_entries, header[2] * sizeof(int));
+	}
+	close(pack_worker_fd);
+	_exit(0);
+#else
+	(void) detailed_routing_stage;
+#endif
+}
+
+static int get_finished_pack_worker(INP int num_workers) {
+
+	/* Returns the index of an unread worker whose result is ready, waiting  *
+	 * for one if need be.                                                    */
+
+	int iworker;
+#ifndef _WIN32
+	int num_fds, ifd;
+	struct pollfd *fds;
+
+	fds = (struct pollfd *) my_malloc(num_workers * sizeof(struct pollfd));
+	num_fds = 0;
+	for (iworker = 1; iworker <= num_workers; iworker++) {
+		if (!speculative_clusters[iworker].reported) {
+			fds[num_fds].fd = speculative_clusters[iworker].fd;
+			fds[num_fds].events = POLLIN;
+			fds[num_fds].revents = 0;
+			num_fds++;
+		}
+	}
+	while (poll(fds, num_fds, -1) < 0) {
+		/* interrupted; wait again */
+	}
+	ifd = 0;
+	for (iworker = 1; iworker <= num_workers; iworker++) {
+		if (!speculative_clusters[iworker].reported) {
+			if (fds[ifd].revents != 0) {
+				break;
+			}
+			ifd++;
+		}
+	}
+	free(fds);
+	return iworker;
+#else
+	for (iworker = 1; iworker <= num_workers; iworker++) {
+		if (!speculative_clusters[iworker].reported) {
+			break;
+		}
+	}
+	return iworker;
+#endif
+}
+
+static void read_speculative_cluster(INOUTP t_speculative_cluster *spec,
+		INP int max_cluster_size) {
+
+	/* Reads a worker's cluster and reaps the worker.  A worker that died    *
+	 * without reporting leaves num_molecules at 0.                           */
+
+#ifndef _WIN32
+	int header[3];
+
+	spec->num_molecules = 0;
+	spec->num_route_ints = 0;
+	spec->grow_seconds = 0.;
+	if (read_fully(spec->fd, header, sizeof(header)) && header[1] > 0
+			&& header[1] <= max_cluster_size + 1 && header[2] >= 0
+			&& read_fully(spec->fd, &spec->grow_seconds, sizeof(double))
+			&& read_fully(spec->fd, spec->molecules,
+					header[1] * sizeof(t_pack_molecule *))) {
+		spec->detailed_routing_stage = header[0];
+		spec->num_molecules = header[1];
+		if (header[2] > 0) {
+			spec->route_entries = (int *) my_realloc(spec->route_entries,
+					header[2] * sizeof(int));
+			if (read_fully(spec->fd, spec->route_entries,
+					header[2] * sizeof(int))) {
+				spec->num_route_ints = header[2];
+			}
+		}
+	}
+	close(spec->fd);
+	waitpid((pid_t) spec->pid, NULL, 0);
+#else
+	spec->num_molecules = 0;
+	spec->num_route_ints = 0;
+	(void) max_cluster_size;
+#endif
+	spec->fd = -1;
+	spec->reported = TRUE;
+}
+
+static void commit_speculative_cluster(INP t_speculative_cluster *spec,
+		INP t_cluster_placement_stats *cluster_placement_stats,
+		INP t_pb_graph_node **primitives_list, INP const t_arch * arch,
+		INOUTP t_block *clb, INOUTP int *num_clb, INP float aspect,
+		INOUTP int *num_used_instances_type, INOUTP int *num_instances_type,
+		INP int num_models, INP int max_cluster_size,
+		INP int max_nets_in_pb_type, INP boolean *is_clock,
+		INP boolean global_clocks, INP float alpha, INP float beta,
+		INP boolean timing_driven, INP boolean connection_driven,
+		INP t_slack * slacks) {
+
+	/* Replays a worker's cluster into the packer's netlist: the seed starts *
+	 * a new cluster and the other molecules are packed in the worker's     *
+	 * order.  The worker's routings are added to the route cache first, so *
+	 * the replay reuses them rather than routing the cluster again; only   *
+	 * a cluster changed by conflicts is routed anew.  Molecules claimed by *
+	 * a cluster committed earlier in the round are skipped.  If the seed   *
+	 * was claimed there is nothing to commit; if most of the cluster was   *
+	 * claimed, or the rest no longer routes, the cluster is undone and its *
+	 * seed is left to the serial packer.                                   */
+
+	int i, num_packed, num_skipped;
+	boolean is_cluster_legal;
+	t_pack_molecule *molecule;
+	t_cluster_placement_stats *cur_cluster_placement_stats_ptr;
+	t_block *new_cluster;
+	double profile_ticks;
+
+	add_route_cache_entries(spec->route_entries, spec->num_route_ints);
+
+	if (spec->num_molecules == 0 || !spec->molecules[0]->valid) {
+		num_speculative_discarded++;
+		return;
+	}
+
+	profile_ticks = 0.;
+	if (pack_profiling)
+		profile_ticks = get_pack_profile_ticks();
+	new_cluster = &clb[*num_clb];
+	reset_legalizer_for_cluster(new_cluster);
+	start_new_cluster(cluster_placement_stats, primitives_list, arch,
+			new_cluster, *num_clb, spec->molecules[0], aspect,
+			num_used_instances_type, num_instances_type, num_models,
+			max_cluster_size, max_nets_in_pb_type,
+			spec->detailed_routing_stage);
+	if (pack_profiling) {
+		start_pack_profile_cluster(new_cluster->type);
+		profile_ticks = add_pack_profile_phase(PACK_PHASE_START_CLUSTER, profile_ticks);
+	}
+	update_cluster_stats(spec->molecules[0], *num_clb, is_clock, global_clocks,
+			alpha, beta, timing_driven, connection_driven, slacks);
+	if (pack_profiling)
+		add_pack_profile_phase(PACK_PHASE_UPDATE_STATS, profile_ticks);
+	cur_cluster_placement_stats_ptr =
+			&cluster_placement_stats[new_cluster->type->index];
+
+	num_packed = 1;
+	num_skipped = 0;
+	for (i = 1; i < spec->num_molecules; i++) {
+		molecule = spec->molecules[i];
+		if (!molecule->valid) {
+			num_skipped++;
+			continue;
+		}
+		if (try_pack_molecule(cur_cluster_placement_stats_ptr, molecule,
+				primitives_list, new_cluster->pb, num_models,
+				max_cluster_size, *num_clb, max_nets_in_pb_type,
+				spec->detailed_routing_stage) == BLK_PASSED) {
+			if (pack_profiling)
+				profile_ticks = get_pack_profile_ticks();
+			update_cluster_stats(molecule, *num_clb, is_clock, global_clocks,
+					alpha, beta, timing_driven, connection_driven, slacks);
+			if (pack_profiling)
+				add_pack_profile_phase(PACK_PHASE_UPDATE_STATS, profile_ticks);
+			num_packed++;
+		}
+	}
+	num_speculative_conflicts += num_skipped;
+
+	if (pack_profiling)
+		profile_ticks = get_pack_profile_ticks();
+	is_cluster_legal = (boolean) (2 * num_packed >= spec->num_molecules);
+	if (is_cluster_legal
+			&& spec->detailed_routing_stage == (int) E_DETAILED_ROUTE_AT_END_ONLY) {
+		is_cluster_legal = try_breadth_first_route_cluster();
+	}
+	if (pack_profiling)
+		profile_ticks = add_pack_profile_phase(PACK_PHASE_ROUTE, profile_ticks);
+
+	if (is_cluster_legal) {
+		vpr_printf(TIO_MESSAGE_INFO, "Complex block %d: %s, type: %s (speculative, %d of %d molecules)\n",
+				*num_clb, new_cluster->name, new_cluster->type->name,
+				num_packed, spec->num_molecules);
+		save_cluster_solution();
+		free_pb_stats_recursive(new_cluster->pb);
+		if (pack_profiling) {
+			add_pack_profile_phase(PACK_PHASE_COMMIT, profile_ticks);
+			end_pack_profile_cluster(new_cluster->name,
+					spec->detailed_routing_stage, TRUE);
+		}
+		(*num_clb)++;
+		num_speculative_committed++;
+		speculative_committed_seconds += spec->grow_seconds;
+	} else {
+		if (pack_profiling)
+			end_pack_profile_cluster(new_cluster->name,
+					spec->detailed_routing_stage, FALSE);
+		num_used_instances_type[new_cluster->type->index]--;
+		free_cluster_rr_graph(new_cluster->pb);
+		free_cb(new_cluster->pb);
+		free(new_cluster->pb);
+		free(new_cluster->name);
+		new_cluster->name = NULL;
+		new_cluster->pb = NULL;
+		num_speculative_regrown++;
+	}
+}
+
 /* get gain of packing molecule into current cluster 
  gain is equal to total_block_gain + molecule_base_gain*some_factor - introduced_input_nets_of_unrelated_blocks_pulled_in_by_molecule*some_other_factor
 
  */
-static float get_molecule_gain(t_pack_molecule *molecule, std::map<int, float> &blk_gain) {
+static float get_molecule_gain(t_pack_molecule *molecule, t_pb_stats *pb_stats) {
 	float gain;
 	int i, ipin, iport, inet, iblk;
 	int num_introduced_inputs_of_indirectly_related_block;
@@ -2373,8 +3451,9 @@ static float get_molecule_gain(t_pack_molecule *molecule, std::map<int, float> &
 	num_introduced_inputs_of_indirectly_related_block = 0;
 	for (i = 0; i < get_array_size_of_molecule(molecule); i++) {
 		if (molecule->logical_block_ptrs[i] != NULL) {
-			if(blk_gain.count(molecule->logical_block_ptrs[i]->index) > 0) {
-				gain += blk_gain[molecule->logical_block_ptrs[i]->index];
+			/* Gains exist for the marked blocks, which are the ones with a sharinggain */
+			if(pb_stats->sharinggain[molecule->logical_block_ptrs[i]->index] != 0) {
+				gain += pb_stats->gain[molecule->logical_block_ptrs[i]->index];
 			} else {
 				/* This block has no connection with current cluster, penalize molecule for having this block 
 				 */
@@ -2472,23 +3551,13 @@ static void reset_lookahead_pins_used(t_pb *cur_pb) {
 
 	if (pb_type->num_modes > 0 && cur_pb->name != NULL) {
 		for (i = 0; i < cur_pb->pb_graph_node->num_input_pin_class; i++) {
-			for (j = 0;
-					j
-							< cur_pb->pb_graph_node->input_pin_class_size[i]
-									* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST;
-					j++) {
-				cur_pb->pb_stats->lookahead_input_pins_used[i][j] = OPEN;
-			}
+			cur_pb->pb_stats->lookahead_input_pins_count[i] = 0;
 		}
-
 		for (i = 0; i < cur_pb->pb_graph_node->num_output_pin_class; i++) {
-			for (j = 0;
-					j
-							< cur_pb->pb_graph_node->output_pin_class_size[i]
-									* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST;
-					j++) {
-				cur_pb->pb_stats->lookahead_output_pins_used[i][j] = OPEN;
-			}
+			cur_pb->pb_stats->lookahead_output_pins_count[i] = 0;
+		}
+		for (i = 0; i < cur_pb->pb_stats->num_overused_words; i++) {
+			cur_pb->pb_stats->lookahead_overused_classes[i] = 0;
 		}
 
 		if (cur_pb->child_pbs != NULL) {
@@ -2637,31 +3706,27 @@ static void compute_and_mark_lookahead_pins_used_for_pin(
 			/* Must use input pin */
 			if (!skip) {
 				/* Check if already in pin class, if yes, skip */
-				skip = FALSE;
-				for (i = 0;
-						i
-								< cur_pb->pb_graph_node->input_pin_class_size[pin_class]
-										* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST;
-						i++) {
+				count = cur_pb->pb_stats->lookahead_input_pins_count[pin_class];
+				for (i = 0; i < count; i++) {
 					if (cur_pb->pb_stats->lookahead_input_pins_used[pin_class][i]
 							== inet) {
 						skip = TRUE;
+						break;
 					}
 				}
-				if (!skip) {
-					/* Net must take up a slot */
-					for (i = 0;
-							i
-									< cur_pb->pb_graph_node->input_pin_class_size[pin_class]
-											* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST;
-							i++) {
-						if (cur_pb->pb_stats->lookahead_input_pins_used[pin_class][i]
-								== OPEN) {
-							cur_pb->pb_stats->lookahead_input_pins_used[pin_class][i] =
-									inet;
-							break;
-						}
-					}
+				/* Net must take up a slot.  Once the array is full the class is already overused, further nets need not be recorded */
+				if (!skip
+						&& count
+								< cur_pb->pb_graph_node->input_pin_class_size[pin_class]
+										* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST) {
+					cur_pb->pb_stats->lookahead_input_pins_used[pin_class][count] =
+							inet;
+					cur_pb->pb_stats->lookahead_input_pins_count[pin_class]++;
+					mark_lookahead_pin_class_overuse(cur_pb, pin_class,
+							count + 1,
+							cur_pb->pb_stats->input_pin_class_capacity,
+							cur_pb->pb_graph_node->num_input_pin_class,
+							pin_class);
 				}
 			}
 		} else {
@@ -2706,19 +3771,23 @@ static void compute_and_mark_lookahead_pins_used_for_pin(
 
 			if (!skip) {
 				/* This output must exit this cluster */
-				for (i = 0;
-						i
-								< cur_pb->pb_graph_node->output_pin_class_size[pin_class]
-										* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST;
-						i++) {
+				count = cur_pb->pb_stats->lookahead_output_pins_count[pin_class];
+				for (i = 0; i < count; i++) {
 					assert(
 							cur_pb->pb_stats->lookahead_output_pins_used[pin_class][i] != inet);
-					if (cur_pb->pb_stats->lookahead_output_pins_used[pin_class][i]
-							== OPEN) {
-						cur_pb->pb_stats->lookahead_output_pins_used[pin_class][i] =
-								inet;
-						break;
-					}
+				}
+				if (count
+						< cur_pb->pb_graph_node->output_pin_class_size[pin_class]
+								* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST) {
+					cur_pb->pb_stats->lookahead_output_pins_used[pin_class][count] =
+							inet;
+					cur_pb->pb_stats->lookahead_output_pins_count[pin_class]++;
+					mark_lookahead_pin_class_overuse(cur_pb,
+							cur_pb->pb_graph_node->num_input_pin_class + pin_class,
+							count + 1,
+							cur_pb->pb_stats->output_pin_class_capacity,
+							cur_pb->pb_graph_node->num_output_pin_class,
+							pin_class);
 				}
 			}
 		}
@@ -2730,43 +3799,15 @@ static void compute_and_mark_lookahead_pins_used_for_pin(
 /* Check if the number of available inputs/outputs for a pin class is sufficient for speculatively packed blocks */
 static boolean check_lookahead_pins_used(t_pb *cur_pb) {
 	int i, j;
-	int ipin;
 	const t_pb_type *pb_type = cur_pb->pb_graph_node->pb_type;
 	boolean success;
 
 	success = TRUE;
 
 	if (pb_type->num_modes > 0 && cur_pb->name != NULL) {
-		for (i = 0; i < cur_pb->pb_graph_node->num_input_pin_class && success;
-				i++) {
-			ipin = 0;
-			for (j = 0;
-					j
-							< cur_pb->pb_graph_node->input_pin_class_size[i]
-									* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST;
-					j++) {
-				if (cur_pb->pb_stats->lookahead_input_pins_used[i][j] != OPEN) {
-					ipin++;
-				}
-			}
-			if (ipin > cur_pb->pb_graph_node->input_pin_class_size[i]) {
-				success = FALSE;
-			}
-		}
-
-		for (i = 0; i < cur_pb->pb_graph_node->num_output_pin_class && success;
-				i++) {
-			ipin = 0;
-			for (j = 0;
-					j
-							< cur_pb->pb_graph_node->output_pin_class_size[i]
-									* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST;
-					j++) {
-				if (cur_pb->pb_stats->lookahead_output_pins_used[i][j] != OPEN) {
-					ipin++;
-				}
-			}
-			if (ipin > cur_pb->pb_graph_node->output_pin_class_size[i]) {
+		/* Overuse was flagged as the pins were marked, so only the bitset needs to be looked at */
+		for (i = 0; i < cur_pb->pb_stats->num_overused_words && success; i++) {
+			if (cur_pb->pb_stats->lookahead_overused_classes[i] != 0) {
 				success = FALSE;
 			}
 		}
@@ -2796,39 +3837,22 @@ static boolean check_lookahead_pins_used(t_pb *cur_pb) {
 /* Speculation successful, commit input/output pins used */
 static void commit_lookahead_pins_used(t_pb *cur_pb) {
 	int i, j;
-	int ipin;
 	const t_pb_type *pb_type = cur_pb->pb_graph_node->pb_type;
 
 	if (pb_type->num_modes > 0 && cur_pb->name != NULL) {
 		for (i = 0; i < cur_pb->pb_graph_node->num_input_pin_class; i++) {
-			ipin = 0;
-			for (j = 0;
-					j
-							< cur_pb->pb_graph_node->input_pin_class_size[i]
-									* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST;
-					j++) {
-				if (cur_pb->pb_stats->lookahead_input_pins_used[i][j] != OPEN) {
-					cur_pb->pb_stats->input_pins_used[i][ipin] =
-							cur_pb->pb_stats->lookahead_input_pins_used[i][j];
-					ipin++;
-				}
-				assert(ipin <= cur_pb->pb_graph_node->input_pin_class_size[i]);
+			assert(cur_pb->pb_stats->lookahead_input_pins_count[i] <= cur_pb->pb_graph_node->input_pin_class_size[i]);
+			for (j = 0; j < cur_pb->pb_stats->lookahead_input_pins_count[i]; j++) {
+				cur_pb->pb_stats->input_pins_used[i][j] =
+						cur_pb->pb_stats->lookahead_input_pins_used[i][j];
 			}
 		}
 
 		for (i = 0; i < cur_pb->pb_graph_node->num_output_pin_class; i++) {
-			ipin = 0;
-			for (j = 0;
-					j
-							< cur_pb->pb_graph_node->output_pin_class_size[i]
-									* AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_FAC + AAPACK_MAX_OVERUSE_LOOKAHEAD_PINS_CONST;
-					j++) {
-				if (cur_pb->pb_stats->lookahead_output_pins_used[i][j] != OPEN) {
-					cur_pb->pb_stats->output_pins_used[i][ipin] =
-							cur_pb->pb_stats->lookahead_output_pins_used[i][j];
-					ipin++;
-				}
-				assert(ipin <= cur_pb->pb_graph_node->output_pin_class_size[i]);
+			assert(cur_pb->pb_stats->lookahead_output_pins_count[i] <= cur_pb->pb_graph_node->output_pin_class_size[i]);
+			for (j = 0; j < cur_pb->pb_stats->lookahead_output_pins_count[i]; j++) {
+				cur_pb->pb_stats->output_pins_used[i][j] =
+						cur_pb->pb_stats->lookahead_output_pins_used[i][j];
 			}
 		}
 
@@ -2848,6 +3872,18 @@ static void commit_lookahead_pins_used(t_pb *cur_pb) {
 	}
 }
 
+/* Flag pin class overuse_bit of cur_pb if count nets need more pins of the class than reach the current mode of cur_pb.
+ * capacity is [0..num_modes-1][0..num_pin_class-1] flattened by mode, see load_mode_pin_class_capacities */
+static void mark_lookahead_pin_class_overuse(t_pb *cur_pb, int overuse_bit,
+		int count, int *capacity, int num_pin_class, int pin_class) {
+	assert(cur_pb->mode >= 0 && cur_pb->mode < cur_pb->pb_graph_node->pb_type->num_modes);
+	if (count > capacity[cur_pb->mode * num_pin_class + pin_class]) {
+		cur_pb->pb_stats->lookahead_overused_classes[overuse_bit
+				/ AAPACK_PIN_CLASS_WORD_BITS] |= 1u
+				<< (overuse_bit % AAPACK_PIN_CLASS_WORD_BITS);
+	}
+}
+
 /* determine net at given pin location for cluster, return OPEN if none exists */
 static int get_net_corresponding_to_pb_graph_pin(t_pb *cur_pb,
 		t_pb_graph_pin *pb_graph_pin) {
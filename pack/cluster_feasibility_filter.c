@@ -14,7 +14,8 @@
  a) Definition of a pin class - If there exists a path (ignoring directionality of connections) from pin A to pin B and pin A and pin B are of the same type (input, output, or clock), then pin A and pin B are in the same pin class.  Otherwise, pin A and pin B are in different pin classes.
  b) Code Identifies pin classes.  Given a candidate solution  
 
- TODO: May 30, 2012 Jason Luu - Must take into consideration modes when doing pin counting.  For fracturable LUTs FI = 5, the soft logic block sees 6 pins instead of 5 pins for the dual LUT mode messing up the pin counter.  The packer still produces correct results but runs slower than its best (experiment on a modified architecture file that forces correct pin counting shows 40x speedup vs VPR 6.0 as opposed to 3x speedup at the time)
+ c) Modes - A pin class spans every mode of its pb_graph_node, but a pin with no edges into a mode cannot carry a net in that mode.  For fracturable LUTs FI = 5, the soft logic block sees 6 pins in the pin class but only 5 of them reach the dual LUT mode.  
+    load_mode_pin_class_capacities counts, for each mode, the pins of each class that connect to the mode's interconnect, and the packer checks its pin counts against the capacity of the pb's current mode.
 
  Author: Jason Luu
  Date: May 16, 2012
@@ -56,6 +57,11 @@ static void sum_pin_class(INOUTP t_pb_graph_node *pb_graph_node);
 static void discover_all_forced_connections(INOUTP t_pb_graph_node *pb_graph_node);
 static boolean is_forced_connection(INP t_pb_graph_pin *pb_graph_pin);
 
+static void add_pin_to_mode_pin_class_capacities(INP t_pb_graph_pin *pb_graph_pin,
+		INP t_pb_graph_edge **edges, INP int num_edges, INP int num_modes,
+		INP int num_pin_class, INOUTP boolean *is_in_mode,
+		INOUTP int *capacity);
+
 
 /* Identify all pin class information for complex block
  */
@@ -585,6 +591,81 @@ static boolean is_forced_connection(INP t_pb_graph_pin *pb_graph_pin) {
 	return is_forced_connection(pb_graph_pin->output_edges[0]->output_pins[0]);
 }
 
+/**
+ * For each mode of pb_graph_node, count the pins of each pin class that connect to the interconnect of that mode.
+ * A pin of the pb_graph_node carries a net into or out of the children of a mode only through an edge of that mode, so these are 
+ * the pins of the class the packer may use when the pb is in that mode.
+ * input_capacity: [0..num_modes-1][0..num_input_pin_class-1] flattened to [mode * num_input_pin_class + class], clocks included
+ * output_capacity: [0..num_modes-1][0..num_output_pin_class-1] flattened likewise
+ */
+void load_mode_pin_class_capacities(INP t_pb_graph_node *pb_graph_node,
+		OUTP int *input_capacity, OUTP int *output_capacity) {
+	int i, j, num_modes;
+	boolean *is_in_mode;
+	t_pb_graph_pin *pb_graph_pin;
+
+	num_modes = pb_graph_node->pb_type->num_modes;
+	for (i = 0; i < num_modes * pb_graph_node->num_input_pin_class; i++) {
+		input_capacity[i] = 0;
+	}
+	for (i = 0; i < num_modes * pb_graph_node->num_output_pin_class; i++) {
+		output_capacity[i] = 0;
+	}
+	if (num_modes == 0) {
+		return;
+	}
+	is_in_mode = (boolean*) my_malloc(num_modes * sizeof(boolean));
 
+	/* Inputs and clocks feed the mode through their output edges, outputs are driven from it through their input edges */
+	for (i = 0; i < pb_graph_node->num_input_ports; i++) {
+		for (j = 0; j < pb_graph_node->num_input_pins[i]; j++) {
+			pb_graph_pin = &pb_graph_node->input_pins[i][j];
+			add_pin_to_mode_pin_class_capacities(pb_graph_pin,
+					pb_graph_pin->output_edges, pb_graph_pin->num_output_edges,
+					num_modes, pb_graph_node->num_input_pin_class, is_in_mode,
+					input_capacity);
+		}
+	}
+	for (i = 0; i < pb_graph_node->num_clock_ports; i++) {
+		for (j = 0; j < pb_graph_node->num_clock_pins[i]; j++) {
+			pb_graph_pin = &pb_graph_node->clock_pins[i][j];
+			add_pin_to_mode_pin_class_capacities(pb_graph_pin,
+					pb_graph_pin->output_edges, pb_graph_pin->num_output_edges,
+					num_modes, pb_graph_node->num_input_pin_class, is_in_mode,
+					input_capacity);
+		}
+	}
+	for (i = 0; i < pb_graph_node->num_output_ports; i++) {
+		for (j = 0; j < pb_graph_node->num_output_pins[i]; j++) {
+			pb_graph_pin = &pb_graph_node->output_pins[i][j];
+			add_pin_to_mode_pin_class_capacities(pb_graph_pin,
+					pb_graph_pin->input_edges, pb_graph_pin->num_input_edges,
+					num_modes, pb_graph_node->num_output_pin_class, is_in_mode,
+					output_capacity);
+		}
+	}
 
+	free(is_in_mode);
+}
+
+static void add_pin_to_mode_pin_class_capacities(INP t_pb_graph_pin *pb_graph_pin,
+		INP t_pb_graph_edge **edges, INP int num_edges, INP int num_modes,
+		INP int num_pin_class, INOUTP boolean *is_in_mode,
+		INOUTP int *capacity) {
+	int i;
 
+	if (pb_graph_pin->pin_class == OPEN) {
+		return; /* unconnected pin, already reported by sum_pin_class */
+	}
+	for (i = 0; i < num_modes; i++) {
+		is_in_mode[i] = FALSE;
+	}
+	for (i = 0; i < num_edges; i++) {
+		is_in_mode[edges[i]->interconnect->parent_mode_index] = TRUE;
+	}
+	for (i = 0; i < num_modes; i++) {
+		if (is_in_mode[i]) {
+			capacity[i * num_pin_class + pb_graph_pin->pin_class]++;
+		}
+	}
+}
@@ -26,4 +26,7 @@
 
 void load_pin_classes_in_pb_graph_head(INOUTP t_pb_graph_node *pb_graph_node);
 
+void load_mode_pin_class_capacities(INP t_pb_graph_node *pb_graph_node,
+		OUTP int *input_capacity, OUTP int *output_capacity);
+
 #endif
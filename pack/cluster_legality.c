@@ -14,6 +14,10 @@
 
 static t_chunk rr_mem_ch = {NULL, 0, NULL};
 
+/* Negotiation iterations among the changed nets of a cluster before the   *
+ * incremental router gives up and everything is rerouted                   */
+#define CLUSTER_INCREMENTAL_ROUTE_ITERATIONS 3
+
 /*static struct s_linked_vptr *rr_mem_chunk_list_head = NULL;
 static int chunk_bytes_avail = 0;
 static char *chunk_next_avail_mem = NULL;*/
@@ -22,6 +26,11 @@ static struct s_trace **best_routing;
 /* nets_in_cluster: array of all nets contained in the cluster */
 static int *nets_in_cluster; /* [0..num_nets_in_cluster-1] */
 static int num_nets_in_cluster;
+
+/* nets_to_reroute: nets_in_cluster entries whose committed routing can't *
+ * be kept by the incremental router [0..num_nets_to_reroute-1]          */
+static int *nets_to_reroute;
+static int num_nets_to_reroute;
 static int saved_num_nets_in_cluster;
 static int curr_cluster_index;
 
@@ -30,6 +39,63 @@ static int ext_input_rr_node_index, ext_output_rr_node_index,
 static int **saved_net_rr_terminals;
 static float pres_fac;
 
+/* Legalizer arena, used by the packer only.  The local rr graph of a       *
+ * cluster type is the same for every cluster, so it is built once per type *
+ * into rr_graph_templates and each new cluster of that type starts from a  *
+ * copy of its nodes.  The copies share the template's edge and switch      *
+ * arrays; the per-cluster state (occupancy, the capacities that enable     *
+ * modes, net_num, prev_node, prev_edge) lives in the copied nodes.         *
+ * [0..num_types-1], an entry is NULL until a cluster of that type starts.  *
+ * rr_graph_template_num_nodes holds each template's num_rr_nodes, which    *
+ * counts the primitive sinks added while the graph was built.              */
+static t_rr_node **rr_graph_templates = NULL;
+static int *rr_graph_template_num_nodes = NULL; /* [0..num_types-1] */
+
+/* Intra-cluster routing cache, used by the packer only.  Before running the *
+ * router, try_breadth_first_route_cluster looks up the routing problem it   *
+ * was given: the cluster type, the mode of every instantiated pb, and the   *
+ * rr_node terminals of every net.  A problem already found unroutable       *
+ * fails at once; for a routable one the stored routing is copied into       *
+ * trace_head.  Clusters built from repeated structures pose the same        *
+ * problems over and over, so most checks become lookups.                    */
+#define ROUTE_CACHE_NUM_BUCKETS 4093
+#define ROUTE_CACHE_MAX_ENTRIES 16384 /* Stop adding entries past this many, bounds memory */
+
+/* key: signature built by load_route_cache_key [0..key_len-1].           *
+ * routing: for each net in key order, the number of trace elements      *
+ * followed by the index and iswitch of each [0..routing_len-1].  NULL    *
+ * if unroutable.                                                          */
+typedef struct s_route_cache_entry {
+	int *key;
+	int key_len;
+	unsigned int hash;
+	boolean routable;
+	int *routing;
+	int routing_len;
+	struct s_route_cache_entry *next;
+} t_route_cache_entry;
+
+static t_route_cache_entry **route_cache = NULL; /* [0..ROUTE_CACHE_NUM_BUCKETS-1] */
+static int num_route_cache_entries;
+static int num_route_cache_hits, num_route_cache_unroutable_hits,
+		num_route_cache_misses;
+static t_block *curr_cluster;
+
+/* Scratch space for building a key.  route_cache_terminals holds each     *
+ * net's sorted terminals, starting at route_cache_terminal_start[i] for   *
+ * nets_in_cluster[i].  route_cache_net_order lists the positions in       *
+ * nets_in_cluster in key order.                                           */
+static int *route_cache_key, *route_cache_terminals;
+static int route_cache_key_len, max_route_cache_key_len,
+		max_route_cache_terminals;
+static int *route_cache_terminal_start, *route_cache_net_order;
+
+/* Entries added to the cache since record_route_cache_additions, so a     *
+ * speculative packing worker can hand the routings it found back to the   *
+ * packer [0..num_route_cache_added-1].  NULL when not recording.          */
+static t_route_cache_entry **route_cache_added = NULL;
+static int num_route_cache_added, max_route_cache_added;
+
 /********************* Subroutines local to this module *********************/
 static boolean is_net_in_cluster(INP int inet);
 
@@ -53,6 +119,35 @@ static void mark_ends_cluster(int inet);
 
 static float rr_node_intrinsic_cost(int inode);
 
+static boolean route_cluster(void);
+
+static boolean try_incremental_route_cluster(
+		INP struct s_router_opts *router_opts);
+
+static boolean is_net_routing_committed(INP int inet);
+
+static void copy_best_routing(INP int inet);
+
+static void add_to_route_cache_key(int value);
+
+static void load_pb_modes_into_route_cache_key(t_pb *pb);
+
+static int compare_int(const void *a, const void *b);
+
+static int compare_net_terminals(const void *a, const void *b);
+
+static void load_route_cache_key(void);
+
+static t_route_cache_entry *find_route_cache_entry(void);
+
+static void add_route_cache_entry(boolean routable);
+
+static void load_cached_routing(t_route_cache_entry *entry);
+
+static void free_route_cache(void);
+
+static unsigned int get_route_cache_key_hash(void);
+
 /************************ Subroutine definitions ****************************/
 
 static boolean is_net_in_cluster(INP int inet) {
@@ -204,6 +299,8 @@ void alloc_and_load_cluster_legality_checker(void) {
 			sizeof(struct s_trace *));
 	nets_in_cluster = (int *) my_malloc(num_logical_nets * sizeof(int));
 	num_nets_in_cluster = 0;
+	nets_to_reroute = (int *) my_malloc(num_logical_nets * sizeof(int));
+	num_nets_to_reroute = 0;
 	num_nets = num_logical_nets;
 
 	/* inside a cluster, I do not consider rr_indexed_data cost, set to 1 since other costs are multiplied by it */
@@ -218,6 +315,11 @@ void alloc_and_load_cluster_legality_checker(void) {
 
 void free_cluster_legality_checker(void) {
 	int inet;
+
+	if (route_cache != NULL) {
+		free_route_cache();
+	}
+
 	free(best_routing);
 	free(rr_indexed_data);
 	free_rr_node_route_structs();
@@ -231,6 +333,7 @@ void free_cluster_legality_checker(void) {
 	}
 	free(net_rr_terminals);
 	free(nets_in_cluster);
+	free(nets_to_reroute);
 	free(saved_net_rr_terminals);
 }
 
@@ -444,15 +547,9 @@ void alloc_and_load_legalizer_for_cluster(INP t_block* clb, INP int clb_index,
 	num_rr_nodes = pb_graph_node->total_pb_pins + pb_type->num_input_pins
 			+ pb_type->num_output_pins + pb_type->num_clock_pins;
 
-	/* allocate memory for rr_node resources + additional memory for any additional sources/sinks, 2x is an overallocation but guarantees that there will be enough sources/sinks available */
-	rr_node = (t_rr_node *) my_calloc(num_rr_nodes * 2, sizeof(t_rr_node));
-	clb->pb->rr_graph = rr_node;
-
-	alloc_and_load_rr_graph_for_pb_graph_node(pb_graph_node, arch, 0);
-
 	curr_cluster_index = clb_index;
+	curr_cluster = clb;
 
-	/*   Alloc and load rr_graph external sources and sinks */
 	ext_input_rr_node_index = pb_graph_node->total_pb_pins;
 	ext_output_rr_node_index = pb_type->num_input_pins
 			+ pb_graph_node->total_pb_pins;
@@ -461,6 +558,28 @@ void alloc_and_load_legalizer_for_cluster(INP t_block* clb, INP int clb_index,
 	max_ext_index = pb_type->num_input_pins + pb_type->num_output_pins
 			+ pb_type->num_clock_pins + pb_graph_node->total_pb_pins;
 
+	if (rr_graph_templates != NULL
+			&& rr_graph_templates[clb->type->index] != NULL) {
+		/* Arena on and this type already built: copy the nodes only */
+		num_rr_nodes = rr_graph_template_num_nodes[clb->type->index];
+		rr_node = (t_rr_node *) my_malloc(num_rr_nodes * sizeof(t_rr_node));
+		memcpy(rr_node, rr_graph_templates[clb->type->index],
+				num_rr_nodes * sizeof(t_rr_node));
+		clb->pb->rr_graph = rr_node;
+
+		alloc_and_load_rr_node_route_structs();
+		num_nets_in_cluster = 0;
+		return;
+	}
+
+	/* allocate memory for rr_node resources + additional memory for any additional sources/sinks, 2x is an overallocation but guarantees that there will be enough sources/sinks available */
+	rr_node = (t_rr_node *) my_calloc(num_rr_nodes * 2, sizeof(t_rr_node));
+	clb->pb->rr_graph = rr_node;
+
+	alloc_and_load_rr_graph_for_pb_graph_node(pb_graph_node, arch, 0);
+
+	/*   Alloc and load rr_graph external sources and sinks */
+
 	for (i = 0; i < pb_type->num_input_pins; i++) {
 		index = i + pb_graph_node->total_pb_pins;
 		rr_node[index].type = SOURCE;
@@ -575,6 +694,17 @@ void alloc_and_load_legalizer_for_cluster(INP t_block* clb, INP int clb_index,
 		}
 	}
 
+	if (rr_graph_templates != NULL) {
+		/* The graph just built becomes the template for this type, and owns *
+		 * the edge and switch arrays; the cluster works on a copy.          */
+		rr_graph_templates[clb->type->index] = rr_node;
+		rr_graph_template_num_nodes[clb->type->index] = num_rr_nodes;
+		rr_node = (t_rr_node *) my_malloc(num_rr_nodes * sizeof(t_rr_node));
+		memcpy(rr_node, rr_graph_templates[clb->type->index],
+				num_rr_nodes * sizeof(t_rr_node));
+		clb->pb->rr_graph = rr_node;
+	}
+
 	alloc_and_load_rr_node_route_structs();
 	num_nets_in_cluster = 0;
 
@@ -584,7 +714,11 @@ void free_legalizer_for_cluster(INP t_block* clb, boolean free_local_rr_graph) {
 	int i;
 
 	free_rr_node_route_structs();
-	if(free_local_rr_graph == TRUE) {
+	if(free_local_rr_graph == TRUE && rr_graph_templates != NULL) {
+		/* Edges and switches belong to the arena template */
+		free(clb->pb->rr_graph);
+		clb->pb->rr_graph = NULL;
+	} else if(free_local_rr_graph == TRUE) {
 		for (i = 0; i < num_rr_nodes; i++) {
 			if (clb->pb->rr_graph[i].edges != NULL) {
 				free(clb->pb->rr_graph[i].edges);
@@ -617,6 +751,37 @@ void reset_legalizer_for_cluster(t_block *clb) {
  */
 boolean try_breadth_first_route_cluster(void) {
 
+	/* Returns TRUE if the nets in the cluster can be routed, FALSE if they  *
+	 * can't.  Answers from the routing cache when it is on and has seen    *
+	 * this routing problem before.                                          */
+
+	boolean success;
+	t_route_cache_entry *entry;
+
+	if (route_cache == NULL) {
+		return route_cluster();
+	}
+
+	load_route_cache_key();
+	entry = find_route_cache_entry();
+	if (entry != NULL) {
+		num_route_cache_hits++;
+		if (!entry->routable) {
+			num_route_cache_unroutable_hits++;
+			return FALSE;
+		}
+		load_cached_routing(entry);
+		return TRUE;
+	}
+
+	num_route_cache_misses++;
+	success = route_cluster();
+	add_route_cache_entry(success);
+	return success;
+}
+
+static boolean route_cluster(void) {
+
 	/* Iterated maze router ala Pathfinder Negotiated Congestion algorithm,  *
 	 * (FPGA 95 p. 111).  Returns TRUE if it can route this FPGA, FALSE if   *
 	 * it can't.                                                             */
@@ -643,6 +808,10 @@ boolean try_breadth_first_route_cluster(void) {
 
 	pres_fac = router_opts.first_iter_pres_fac;
 
+	if (try_incremental_route_cluster(&router_opts)) {
+		return (TRUE);
+	}
+
 	for (itry = 1; itry <= router_opts.max_router_iterations; itry++) {
 		for (inet = 0; inet < num_nets_in_cluster; inet++) {
 			net_index = nets_in_cluster[inet];
@@ -682,6 +851,126 @@ boolean try_breadth_first_route_cluster(void) {
 	return (FALSE);
 }
 
+static boolean try_incremental_route_cluster(
+		INP struct s_router_opts *router_opts) {
+
+	/* Routes only the nets that changed since the cluster routing was last  *
+	 * saved (save_and_reset_routing_cluster).  Nets whose terminals are     *
+	 * unchanged keep their committed routing, and only the other nets       *
+	 * negotiate congestion, for at most CLUSTER_INCREMENTAL_ROUTE_ITERATIONS *
+	 * iterations.  Returns TRUE if that gives a legal routing.  Otherwise   *
+	 * every net is ripped up and history is cleared, so route_cluster goes  *
+	 * on exactly as if this had not been tried.  Only attempted when no net *
+	 * has a working routing yet, since that is the state it restores.        */
+
+	int i, itry, inet;
+	boolean success;
+
+	for (i = 0; i < num_nets_in_cluster; i++) {
+		if (trace_head[nets_in_cluster[i]] != NULL) {
+			return FALSE;
+		}
+	}
+
+	num_nets_to_reroute = 0;
+	for (i = 0; i < num_nets_in_cluster; i++) {
+		inet = nets_in_cluster[i];
+		if (i < saved_num_nets_in_cluster && is_net_routing_committed(inet)) {
+			copy_best_routing(inet);
+			pathfinder_update_one_cost(trace_head[inet], 1, pres_fac);
+		} else {
+			nets_to_reroute[num_nets_to_reroute] = inet;
+			num_nets_to_reroute++;
+		}
+	}
+	if (num_nets_to_reroute == num_nets_in_cluster) {
+		/* Nothing to keep, the full router does the same work */
+		return FALSE;
+	}
+
+	success = FALSE;
+	for (itry = 1; itry <= CLUSTER_INCREMENTAL_ROUTE_ITERATIONS; itry++) {
+		for (i = 0; i < num_nets_to_reroute; i++) {
+			inet = nets_to_reroute[i];
+			pathfinder_update_one_cost(trace_head[inet], -1, pres_fac);
+			if (!breadth_first_route_net_cluster(inet)) {
+				/* Left to the full router, which reports the failure */
+				break;
+			}
+			pathfinder_update_one_cost(trace_head[inet], 1, pres_fac);
+		}
+		if (i < num_nets_to_reroute) {
+			break;
+		}
+
+		success = feasible_routing();
+		if (success) {
+			break;
+		}
+
+		if (itry == 1)
+			pres_fac = router_opts->initial_pres_fac;
+		else
+			pres_fac *= router_opts->pres_fac_mult;
+		pathfinder_update_cost(pres_fac, router_opts->acc_fac);
+	}
+
+	if (success) {
+		return TRUE;
+	}
+
+	for (i = 0; i < num_nets_in_cluster; i++) {
+		inet = nets_in_cluster[i];
+		pathfinder_update_one_cost(trace_head[inet], -1, pres_fac);
+		free_traceback(inet);
+	}
+	reset_rr_node_route_structs();
+	pres_fac = router_opts->first_iter_pres_fac;
+	return FALSE;
+}
+
+static boolean is_net_routing_committed(INP int inet) {
+
+	/* TRUE if net inet has a saved routing and the same terminals it had *
+	 * when that routing was saved.                                        */
+
+	int j;
+
+	if (best_routing[inet] == NULL) {
+		return FALSE;
+	}
+	for (j = 0; j <= vpack_net[inet].num_sinks; j++) {
+		if (net_rr_terminals[inet][j] != saved_net_rr_terminals[inet][j]) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+static void copy_best_routing(INP int inet) {
+
+	/* Makes trace_head[inet] a copy of best_routing[inet].  A copy, since *
+	 * restore_routing_cluster frees trace_head and reinstates            *
+	 * best_routing.                                                       */
+
+	struct s_trace *from, *tptr, *prev;
+
+	prev = NULL;
+	for (from = best_routing[inet]; from != NULL; from = from->next) {
+		tptr = alloc_trace_data();
+		tptr->index = from->index;
+		tptr->iswitch = from->iswitch;
+		tptr->next = NULL;
+		if (prev == NULL) {
+			trace_head[inet] = tptr;
+		} else {
+			prev->next = tptr;
+		}
+		prev = tptr;
+	}
+	trace_tail[inet] = prev;
+}
+
 static boolean breadth_first_route_net_cluster(int inet) {
 
 	/* Uses a maze routing (Dijkstra's) algorithm to route a net.  The net       *
@@ -1134,6 +1423,469 @@ void save_cluster_solution(void) {
 	}
 }
 
+void alloc_cluster_legalizer_arena(void) {
+
+	/* Turns on the legalizer arena.  Clusters started from here on must   *
+	 * give back their rr graph with free_cluster_rr_graph, before         *
+	 * free_cluster_legalizer_arena is called.                              */
+
+	rr_graph_templates = (t_rr_node **) my_calloc(num_types,
+			sizeof(t_rr_node *));
+	rr_graph_template_num_nodes = (int *) my_calloc(num_types, sizeof(int));
+}
+
+void free_cluster_rr_graph(INOUTP t_pb *pb) {
+
+	/* Frees the node copy of a cluster built with the arena on.  The edge *
+	 * and switch arrays are left to the template.                          */
+
+	free(pb->rr_graph);
+	pb->rr_graph = NULL;
+}
+
+void free_cluster_legalizer_arena(void) {
+
+	int itype, i;
+	t_rr_node *rr_graph;
+
+	for (itype = 0; itype < num_types; itype++) {
+		rr_graph = rr_graph_templates[itype];
+		if (rr_graph == NULL) {
+			continue;
+		}
+		for (i = 0; i < rr_graph_template_num_nodes[itype]; i++) {
+			if (rr_graph[i].edges != NULL) {
+				free(rr_graph[i].edges);
+			}
+			if (rr_graph[i].switches != NULL) {
+				free(rr_graph[i].switches);
+			}
+		}
+		free(rr_graph);
+	}
+	free(rr_graph_templates);
+	rr_graph_templates = NULL;
+	free(rr_graph_template_num_nodes);
+	rr_graph_template_num_nodes = NULL;
+}
+
+void alloc_cluster_route_cache(void) {
+
+	/* Turns on the intra-cluster routing cache.  Only valid while the rr    *
+	 * graph of each cluster type is fixed, i.e. during packing; it is freed *
+	 * by free_cluster_legality_checker.                                     */
+
+	route_cache = (t_route_cache_entry **) my_calloc(ROUTE_CACHE_NUM_BUCKETS,
+			sizeof(t_route_cache_entry *));
+	num_route_cache_entries = 0;
+	num_route_cache_hits = 0;
+	num_route_cache_unroutable_hits = 0;
+	num_route_cache_misses = 0;
+
+	route_cache_key = NULL;
+	route_cache_terminals = NULL;
+	route_cache_key_len = 0;
+	max_route_cache_key_len = 0;
+	max_route_cache_terminals = 0;
+	route_cache_terminal_start = (int *) my_malloc(
+			(num_logical_nets + 1) * sizeof(int));
+	route_cache_net_order = (int *) my_malloc(num_logical_nets * sizeof(int));
+}
+
+static void free_route_cache(void) {
+
+	int i;
+	t_route_cache_entry *entry, *next;
+
+	vpr_printf(TIO_MESSAGE_INFO, "Intra-cluster routing cache: %d hits (%d unroutable), %d misses, %d entries.\n",
+			num_route_cache_hits, num_route_cache_unroutable_hits,
+			num_route_cache_misses, num_route_cache_entries);
+
+	for (i = 0; i < ROUTE_CACHE_NUM_BUCKETS; i++) {
+		entry = route_cache[i];
+		while (entry != NULL) {
+			next = entry->next;
+			free(entry->key);
+			free(entry->routing);
+			free(entry);
+			entry = next;
+		}
+	}
+	free(route_cache);
+	route_cache = NULL;
+
+	free(route_cache_key);
+	free(route_cache_terminals);
+	free(route_cache_terminal_start);
+	free(route_cache_net_order);
+	free(route_cache_added);
+	route_cache_added = NULL;
+	num_route_cache_added = 0;
+}
+
+static void add_to_route_cache_key(int value) {
+	if (route_cache_key_len >= max_route_cache_key_len) {
+		max_route_cache_key_len = 2 * max_route_cache_key_len + 64;
+		route_cache_key = (int *) my_realloc(route_cache_key,
+				max_route_cache_key_len * sizeof(int));
+	}
+	route_cache_key[route_cache_key_len] = value;
+	route_cache_key_len++;
+}
+
+static void load_pb_modes_into_route_cache_key(t_pb *pb) {
+
+	/* The modes chosen for the pbs set which rr_nodes have capacity, so   *
+	 * they are part of the routing problem.  Walks the instantiated pbs   *
+	 * in a fixed order, adding each one's mode, or OPEN for a pb without  *
+	 * children.                                                           */
+
+	int i, j;
+	const t_pb_type *pb_type;
+
+	if (pb->child_pbs == NULL) {
+		add_to_route_cache_key(OPEN);
+		return;
+	}
+	add_to_route_cache_key(pb->mode);
+
+	pb_type = pb->pb_graph_node->pb_type;
+	for (i = 0; i < pb_type->modes[pb->mode].num_pb_type_children; i++) {
+		for (j = 0; j < pb_type->modes[pb->mode].pb_type_children[i].num_pb;
+				j++) {
+			load_pb_modes_into_route_cache_key(&pb->child_pbs[i][j]);
+		}
+	}
+}
+
+static int compare_int(const void *a, const void *b) {
+	return (*(const int *) a - *(const int *) b);
+}
+
+static int compare_net_terminals(const void *a, const void *b) {
+
+	/* Orders nets (positions in nets_in_cluster) by their terminal lists: *
+	 * first by length, then element by element.                           */
+
+	int ia, ib, len_a, len_b, i;
+
+	ia = *(const int *) a;
+	ib = *(const int *) b;
+	len_a = route_cache_terminal_start[ia + 1] - route_cache_terminal_start[ia];
+	len_b = route_cache_terminal_start[ib + 1] - route_cache_terminal_start[ib];
+	if (len_a != len_b) {
+		return (len_a - len_b);
+	}
+	for (i = 0; i < len_a; i++) {
+		if (route_cache_terminals[route_cache_terminal_start[ia] + i]
+				!= route_cache_terminals[route_cache_terminal_start[ib] + i]) {
+			return (route_cache_terminals[route_cache_terminal_start[ia] + i]
+					- route_cache_terminals[route_cache_terminal_start[ib] + i]);
+		}
+	}
+	return 0;
+}
+
+static void load_route_cache_key(void) {
+
+	/* Builds the signature of the current routing problem in              *
+	 * route_cache_key: the cluster type, the pb modes, then for each net  *
+	 * its terminal count, SOURCE and sorted SINKs.  Nets are listed in    *
+	 * order of their terminals so the key does not depend on the order    *
+	 * in which they joined the cluster.                                   */
+
+	int i, j, inet, num_terminals, start;
+
+	num_terminals = 0;
+	for (i = 0; i < num_nets_in_cluster; i++) {
+		num_terminals += vpack_net[nets_in_cluster[i]].num_sinks + 1;
+	}
+	if (num_terminals > max_route_cache_terminals) {
+		max_route_cache_terminals = 2 * num_terminals;
+		route_cache_terminals = (int *) my_realloc(route_cache_terminals,
+				max_route_cache_terminals * sizeof(int));
+	}
+
+	start = 0;
+	for (i = 0; i < num_nets_in_cluster; i++) {
+		inet = nets_in_cluster[i];
+		route_cache_terminal_start[i] = start;
+		route_cache_terminals[start] = net_rr_terminals[inet][0];
+		start++;
+		for (j = 1; j <= vpack_net[inet].num_sinks; j++) {
+			if (net_rr_terminals[inet][j] != OPEN) {
+				route_cache_terminals[start] = net_rr_terminals[inet][j];
+				start++;
+			}
+		}
+		qsort(route_cache_terminals + route_cache_terminal_start[i] + 1,
+				start - route_cache_terminal_start[i] - 1, sizeof(int),
+				compare_int);
+		route_cache_net_order[i] = i;
+	}
+	route_cache_terminal_start[num_nets_in_cluster] = start;
+	qsort(route_cache_net_order, num_nets_in_cluster, sizeof(int),
+			compare_net_terminals);
+
+	route_cache_key_len = 0;
+	add_to_route_cache_key(curr_cluster->type->index);
+	load_pb_modes_into_route_cache_key(curr_cluster->pb);
+	for (i = 0; i < num_nets_in_cluster; i++) {
+		start = route_cache_terminal_start[route_cache_net_order[i]];
+		num_terminals = route_cache_terminal_start[route_cache_net_order[i] + 1]
+				- start;
+		add_to_route_cache_key(num_terminals);
+		for (j = 0; j < num_terminals; j++) {
+			add_to_route_cache_key(route_cache_terminals[start + j]);
+		}
+	}
+}
+
+static unsigned int get_route_cache_key_hash(void) {
+	int i;
+	unsigned int hash;
+
+	hash = 2166136261u;
+	for (i = 0; i < route_cache_key_len; i++) {
+		hash = (hash ^ (unsigned int) route_cache_key[i]) * 16777619u;
+	}
+	return hash;
+}
+
+static t_route_cache_entry *find_route_cache_entry(void) {
+
+	/* Returns the entry whose key matches route_cache_key, NULL if none. */
+
+	unsigned int hash;
+	t_route_cache_entry *entry;
+
+	hash = get_route_cache_key_hash();
+	entry = route_cache[hash % ROUTE_CACHE_NUM_BUCKETS];
+	while (entry != NULL) {
+		if (entry->hash == hash && entry->key_len == route_cache_key_len
+				&& memcmp(entry->key, route_cache_key,
+						route_cache_key_len * sizeof(int)) == 0) {
+			return entry;
+		}
+		entry = entry->next;
+	}
+	return NULL;
+}
+
+static void add_route_cache_entry(boolean routable) {
+
+	/* Records the result of routing the problem in route_cache_key, and  *
+	 * for a routable problem the routing found, taken from trace_head.   */
+
+	int i, inet, len, count_pos;
+	unsigned int hash;
+	struct s_trace *tptr;
+	t_route_cache_entry *entry;
+
+	if (num_route_cache_entries >= ROUTE_CACHE_MAX_ENTRIES) {
+		return;
+	}
+
+	hash = get_route_cache_key_hash();
+	entry = (t_route_cache_entry *) my_malloc(sizeof(t_route_cache_entry));
+	entry->key = (int *) my_malloc(route_cache_key_len * sizeof(int));
+	memcpy(entry->key, route_cache_key, route_cache_key_len * sizeof(int));
+	entry->key_len = route_cache_key_len;
+	entry->hash = hash;
+	entry->routable = routable;
+	entry->routing = NULL;
+	entry->routing_len = 0;
+
+	if (routable) {
+		len = num_nets_in_cluster;
+		for (i = 0; i < num_nets_in_cluster; i++) {
+			for (tptr = trace_head[nets_in_cluster[i]]; tptr != NULL;
+					tptr = tptr->next) {
+				len += 2;
+			}
+		}
+		entry->routing = (int *) my_malloc(len * sizeof(int));
+		entry->routing_len = 0;
+		for (i = 0; i < num_nets_in_cluster; i++) {
+			inet = nets_in_cluster[route_cache_net_order[i]];
+			count_pos = entry->routing_len;
+			entry->routing[count_pos] = 0;
+			entry->routing_len++;
+			for (tptr = trace_head[inet]; tptr != NULL; tptr = tptr->next) {
+				entry->routing[entry->routing_len] = tptr->index;
+				entry->routing[entry->routing_len + 1] = tptr->iswitch;
+				entry->routing_len += 2;
+				entry->routing[count_pos]++;
+			}
+		}
+		assert(entry->routing_len == len);
+	}
+
+	entry->next = route_cache[hash % ROUTE_CACHE_NUM_BUCKETS];
+	route_cache[hash % ROUTE_CACHE_NUM_BUCKETS] = entry;
+	num_route_cache_entries++;
+
+	if (route_cache_added != NULL) {
+		if (num_route_cache_added >= max_route_cache_added) {
+			max_route_cache_added = 2 * max_route_cache_added + 16;
+			route_cache_added = (t_route_cache_entry **) my_realloc(
+					route_cache_added,
+					max_route_cache_added * sizeof(t_route_cache_entry *));
+		}
+		route_cache_added[num_route_cache_added] = entry;
+		num_route_cache_added++;
+	}
+}
+
+void record_route_cache_additions(void) {
+
+	/* From here on, remembers every routing problem added to the cache so  *
+	 * get_route_cache_additions can pass them on.  Called by a speculative *
+	 * packing worker right after it is forked.                             */
+
+	free(route_cache_added);
+	max_route_cache_added = 16;
+	route_cache_added = (t_route_cache_entry **) my_malloc(
+			max_route_cache_added * sizeof(t_route_cache_entry *));
+	num_route_cache_added = 0;
+}
+
+int *get_route_cache_additions(OUTP int *num_ints) {
+
+	/* Packs the entries added since record_route_cache_additions into one *
+	 * array: for each entry its key_len, key, routable flag, routing_len  *
+	 * and routing.  Returns NULL with *num_ints 0 if there are none; the  *
+	 * caller frees the array.                                             */
+
+	int i, len;
+	int *packed;
+	t_route_cache_entry *entry;
+
+	len = 0;
+	for (i = 0; i < num_route_cache_added; i++) {
+		len += 3 + route_cache_added[i]->key_len
+				+ route_cache_added[i]->routing_len;
+	}
+	*num_ints = len;
+	if (len == 0) {
+		return NULL;
+	}
+
+	packed = (int *) my_malloc(len * sizeof(int));
+	len = 0;
+	for (i = 0; i < num_route_cache_added; i++) {
+		entry = route_cache_added[i];
+		packed[len++] = entry->key_len;
+		memcpy(packed + len, entry->key, entry->key_len * sizeof(int));
+		len += entry->key_len;
+		packed[len++] = entry->routable;
+		packed[len++] = entry->routing_len;
+		if (entry->routing_len > 0) {
+			memcpy(packed + len, entry->routing,
+					entry->routing_len * sizeof(int));
+			len += entry->routing_len;
+		}
+	}
+	assert(len == *num_ints);
+	return packed;
+}
+
+void add_route_cache_entries(INP int *packed, INP int num_ints) {
+
+	/* Adds the entries packed by get_route_cache_additions in a worker,    *
+	 * skipping problems the cache already holds.  Keys and routings are in *
+	 * cluster-local rr node numbers, which every process shares, so a      *
+	 * replayed worker cluster is answered from the cache instead of being  *
+	 * routed again.  These entries are added even past                     *
+	 * ROUTE_CACHE_MAX_ENTRIES, since the packer is about to look them up.  */
+
+	int pos, i, key_len, routing_len;
+	boolean routable;
+	t_route_cache_entry *entry;
+
+	if (route_cache == NULL) {
+		return;
+	}
+
+	pos = 0;
+	while (pos < num_ints) {
+		key_len = packed[pos++];
+		if (key_len <= 0 || pos + key_len + 2 > num_ints) {
+			break;
+		}
+		route_cache_key_len = 0;
+		for (i = 0; i < key_len; i++) {
+			add_to_route_cache_key(packed[pos + i]);
+		}
+		pos += key_len;
+		routable = (boolean) packed[pos++];
+		routing_len = packed[pos++];
+		if (routing_len < 0 || pos + routing_len > num_ints) {
+			break;
+		}
+
+		if (find_route_cache_entry() == NULL) {
+			entry = (t_route_cache_entry *) my_malloc(
+					sizeof(t_route_cache_entry));
+			entry->key = (int *) my_malloc(key_len * sizeof(int));
+			memcpy(entry->key, route_cache_key, key_len * sizeof(int));
+			entry->key_len = key_len;
+			entry->hash = get_route_cache_key_hash();
+			entry->routable = routable;
+			entry->routing = NULL;
+			entry->routing_len = routing_len;
+			if (routing_len > 0) {
+				entry->routing = (int *) my_malloc(routing_len * sizeof(int));
+				memcpy(entry->routing, packed + pos, routing_len * sizeof(int));
+			}
+			entry->next = route_cache[entry->hash % ROUTE_CACHE_NUM_BUCKETS];
+			route_cache[entry->hash % ROUTE_CACHE_NUM_BUCKETS] = entry;
+			num_route_cache_entries++;
+		}
+		pos += routing_len;
+	}
+}
+
+static void load_cached_routing(t_route_cache_entry *entry) {
+
+	/* Replaces the routing of every net in the cluster with the one      *
+	 * stored in entry, updating occupancy as the router would.  Relies   *
+	 * on route_cache_net_order from the load_route_cache_key call that   *
+	 * found entry.                                                        */
+
+	int i, j, inet, pos, num_elements;
+	struct s_trace *tptr, *prev;
+
+	pos = 0;
+	for (i = 0; i < num_nets_in_cluster; i++) {
+		inet = nets_in_cluster[route_cache_net_order[i]];
+
+		pathfinder_update_one_cost(trace_head[inet], -1, pres_fac);
+		free_traceback(inet);
+
+		num_elements = entry->routing[pos];
+		pos++;
+		prev = NULL;
+		for (j = 0; j < num_elements; j++) {
+			tptr = alloc_trace_data();
+			tptr->index = entry->routing[pos];
+			tptr->iswitch = entry->routing[pos + 1];
+			tptr->next = NULL;
+			pos += 2;
+			if (prev == NULL) {
+				trace_head[inet] = tptr;
+			} else {
+				prev->next = tptr;
+			}
+			prev = tptr;
+		}
+		trace_tail[inet] = prev;
+
+		pathfinder_update_one_cost(trace_head[inet], 1, pres_fac);
+	}
+	assert(pos == entry->routing_len);
+}
+
 boolean is_pin_open(int i) {
 	return (boolean) (rr_node[i].occ == 0);
 }
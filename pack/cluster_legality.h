@@ -11,6 +11,20 @@ void free_legalizer_for_cluster(INP t_block* clb, boolean free_local_rr_graph);
 
 void free_cluster_legality_checker(void);
 
+void alloc_cluster_route_cache(void);
+
+void record_route_cache_additions(void);
+
+int *get_route_cache_additions(OUTP int *num_ints);
+
+void add_route_cache_entries(INP int *packed, INP int num_ints);
+
+void alloc_cluster_legalizer_arena(void);
+
+void free_cluster_rr_graph(INOUTP t_pb *pb);
+
+void free_cluster_legalizer_arena(void);
+
 void reset_legalizer_for_cluster(t_block *clb);
 
 /* order of use: 1. save cluster 2. Add blocks.  3. route 4. save if successful, undo if not successful */
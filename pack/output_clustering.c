@@ -7,31 +7,89 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#ifndef _WIN32
+#include <sys/time.h>
+#endif
 #include "util.h"
 #include "vpr_types.h"
 #include "globals.h"
 #include "output_clustering.h"
 #include "read_xml_arch_file.h"
+#include "out_buf.h"
 
 #define LINELENGTH 1024
 #define TAB_LENGTH 4
+#define NET_CLUSTERS_PER_RANGE 256 /* clusters one thread writes per round */
+
+/* Name of an intra-cluster pin as the source of an interconnect, made once *
+ * per pin of each cluster type instead of for every connection printed.   */
+typedef struct s_pin_prefix {
+	char *sibling; /* "<pb_type>[<index>].<port>[<pin>]->": from a sibling or child */
+	char *parent; /* "<pb_type>.<port>[<pin>]->": from the parent */
+} t_pin_prefix;
+
+/* What the print routines need while writing one cluster.  Clusters are *
+ * written on several threads at once, so the rr_node global is not used. */
+typedef struct s_cluster_writer {
+	t_out_buf *out;
+	t_rr_node *rr_graph; /* the cluster's rr graph */
+	t_pin_prefix *pin_prefixes; /* [0..num rr nodes of the cluster type-1] */
+} t_cluster_writer;
+
+/* [0..num_types-1], NULL for types with no cluster. */
+static t_pin_prefix **type_pin_prefixes = NULL;
 
 /****************** Subroutines local to this module ************************/
 
+static void print_tabs(t_out_buf *out, int num_tabs);
+
+static void print_string(const char *str_ptr, int *column, int num_tabs,
+		t_out_buf *out);
+
+static void print_net_name(int inet, int *column, int num_tabs,
+		t_out_buf *out);
+
+static void print_interconnect(int inode, int *column, int num_tabs,
+		t_cluster_writer *writer);
+
+static void print_open_pb_graph_node(t_pb_graph_node * pb_graph_node,
+		int pb_index, boolean is_used, int tab_depth,
+		t_cluster_writer *writer);
+
+static void print_pb(t_cluster_writer *writer, t_pb * pb, int pb_index,
+		int tab_depth);
+
+static int get_num_cluster_rr_nodes(t_type_ptr type);
+
+static void alloc_and_load_pin_prefixes(t_block *clb, int num_clusters);
+
+static void free_pin_prefixes(void);
+
+static void print_cluster_range(t_out_buf **outs, int first, int last,
+		void *context);
+
+static void print_clusters(t_block *clb, int num_clusters, t_out_buf *out);
+
+static void print_stats(t_block *clb, int num_clusters);
+
+static double get_output_wall_seconds(void);
+
 /**************** Subroutine definitions ************************************/
 
-static void print_tabs(FILE *fpout, int num_tabs) {
+static void print_tabs(t_out_buf *out, int num_tabs) {
 	int i;
 	for (i = 0; i < num_tabs; i++) {
-		fprintf(fpout, "\t");
+		out_char(out, '\t');
 	}
 }
 
-static void print_string(const char *str_ptr, int *column, int num_tabs, FILE * fpout) {
+static void print_string(const char *str_ptr, int *column, int num_tabs,
+		t_out_buf *out) {
 
 	/* Prints string without making any lines longer than LINELENGTH.  Column  *
 	 * points to the column in which the next character will go (both used and *
-	 * updated), and fpout points to the output file.                          */
+	 * updated), and out is the output file.                                   */
 
 	int len;
 
@@ -42,23 +100,24 @@ static void print_string(const char *str_ptr, int *column, int num_tabs, FILE *
 	}
 
 	if (*column + len + 2 > LINELENGTH) {
-		fprintf(fpout, "\n");
-		print_tabs(fpout, num_tabs);
+		out_char(out, '\n');
+		print_tabs(out, num_tabs);
 		*column = num_tabs * TAB_LENGTH;
 	}
 
-	fprintf(fpout, "%s ", str_ptr);
+	out_str(out, str_ptr);
+	out_char(out, ' ');
 	*column += len + 1;
 }
 
-static void print_net_name(int inet, int *column, int num_tabs, FILE * fpout) {
+static void print_net_name(int inet, int *column, int num_tabs,
+		t_out_buf *out) {
 
 	/* This routine prints out the vpack_net name (or open) and limits the    *
 	 * length of a line to LINELENGTH characters by using \ to continue *
 	 * lines.  net_num is the index of the vpack_net to be printed, while     *
 	 * column points to the current printing column (column is both     *
-	 * used and updated by this routine).  fpout is the output file     *
-	 * pointer.                                                         */
+	 * used and updated by this routine).  out is the output file.      */
 
 	const char *str_ptr;
 
@@ -67,79 +126,71 @@ static void print_net_name(int inet, int *column, int num_tabs, FILE * fpout) {
 	else
 		str_ptr = vpack_net[inet].name;
 
-	print_string(str_ptr, column, num_tabs, fpout);
+	print_string(str_ptr, column, num_tabs, out);
 }
 
 static void print_interconnect(int inode, int *column, int num_tabs,
-		FILE * fpout) {
+		t_cluster_writer *writer) {
 
 	/* This routine prints out the vpack_net name (or open) and limits the    *
 	 * length of a line to LINELENGTH characters by using \ to continue *
 	 * lines.  net_num is the index of the vpack_net to be printed, while     *
 	 * column points to the current printing column (column is both     *
-	 * used and updated by this routine).  fpout is the output file     *
-	 * pointer.                                                         */
+	 * used and updated by this routine).                               */
 
-	char *str_ptr, *name;
+	t_rr_node *rr_graph;
+	char buf[LINELENGTH], *str_ptr, *name, *prefix;
 	int prev_node, prev_edge;
-	int len;
+	int prefix_len, name_len;
 
-	if (rr_node[inode].net_num == OPEN) {
-		print_string("open", column, num_tabs, fpout);
+	rr_graph = writer->rr_graph;
+	if (rr_graph[inode].net_num == OPEN) {
+		print_string("open", column, num_tabs, writer->out);
 	} else {
-		str_ptr = NULL;
-		prev_node = rr_node[inode].prev_node;
-		prev_edge = rr_node[inode].prev_edge;
+		prev_node = rr_graph[inode].prev_node;
+		prev_edge = rr_graph[inode].prev_edge;
 
 		if (prev_node == OPEN
-				&& rr_node[inode].pb_graph_pin->port->parent_pb_type->num_modes
+				&& rr_graph[inode].pb_graph_pin->port->parent_pb_type->num_modes
 						== 0
-				&& rr_node[inode].pb_graph_pin->port->type == OUT_PORT) { /* This is a primitive output */
-			print_net_name(rr_node[inode].net_num, column, num_tabs, fpout);
+				&& rr_graph[inode].pb_graph_pin->port->type == OUT_PORT) { /* This is a primitive output */
+			print_net_name(rr_graph[inode].net_num, column, num_tabs,
+					writer->out);
 		} else {
 			name =
-					rr_node[prev_node].pb_graph_pin->output_edges[prev_edge]->interconnect->name;
-			if (rr_node[prev_node].pb_graph_pin->port->parent_pb_type->depth
-					>= rr_node[inode].pb_graph_pin->port->parent_pb_type->depth) {
+					rr_graph[prev_node].pb_graph_pin->output_edges[prev_edge]->interconnect->name;
+			if (rr_graph[prev_node].pb_graph_pin->port->parent_pb_type->depth
+					>= rr_graph[inode].pb_graph_pin->port->parent_pb_type->depth) {
 				/* Connections from siblings or children should have an explicit index, connections from parent does not need an explicit index */
-				len =
-						strlen(
-								rr_node[prev_node].pb_graph_pin->parent_node->pb_type->name)
-								+ rr_node[prev_node].pb_graph_pin->parent_node->placement_index
-										/ 10
-								+ strlen(
-										rr_node[prev_node].pb_graph_pin->port->name)
-								+ rr_node[prev_node].pb_graph_pin->pin_number
-										/ 10 + strlen(name) + 11;
-				str_ptr = (char*)my_malloc(len * sizeof(char));
-				sprintf(str_ptr, "%s[%d].%s[%d]->%s ",
-						rr_node[prev_node].pb_graph_pin->parent_node->pb_type->name,
-						rr_node[prev_node].pb_graph_pin->parent_node->placement_index,
-						rr_node[prev_node].pb_graph_pin->port->name,
-						rr_node[prev_node].pb_graph_pin->pin_number, name);
+				prefix = writer->pin_prefixes[prev_node].sibling;
+			} else {
+				prefix = writer->pin_prefixes[prev_node].parent;
+			}
+
+			/* "<prefix><name> ", built on the stack unless it is too long to *
+			 * print anyway, in which case print_string reports it.          */
+			prefix_len = strlen(prefix);
+			name_len = strlen(name);
+			if (prefix_len + name_len + 2 <= LINELENGTH) {
+				str_ptr = buf;
 			} else {
-				len =
-						strlen(
-								rr_node[prev_node].pb_graph_pin->parent_node->pb_type->name)
-								+ strlen(
-										rr_node[prev_node].pb_graph_pin->port->name)
-								+ rr_node[prev_node].pb_graph_pin->pin_number
-										/ 10 + strlen(name) + 8;
-				str_ptr = (char*)my_malloc(len * sizeof(char));
-				sprintf(str_ptr, "%s.%s[%d]->%s ",
-						rr_node[prev_node].pb_graph_pin->parent_node->pb_type->name,
-						rr_node[prev_node].pb_graph_pin->port->name,
-						rr_node[prev_node].pb_graph_pin->pin_number, name);
+				str_ptr = (char *) my_malloc(
+						(prefix_len + name_len + 2) * sizeof(char));
 			}
-			print_string(str_ptr, column, num_tabs, fpout);
+			memcpy(str_ptr, prefix, prefix_len);
+			memcpy(str_ptr + prefix_len, name, name_len);
+			str_ptr[prefix_len + name_len] = ' ';
+			str_ptr[prefix_len + name_len + 1] = '\0';
+			print_string(str_ptr, column, num_tabs, writer->out);
+			if (str_ptr != buf)
+				free(str_ptr);
 		}
-		if (str_ptr)
-			free(str_ptr);
 	}
 }
 
 static void print_open_pb_graph_node(t_pb_graph_node * pb_graph_node,
-		int pb_index, boolean is_used, int tab_depth, FILE * fpout) {
+		int pb_index, boolean is_used, int tab_depth,
+		t_cluster_writer *writer) {
 	int column = 0;
 	int i, j, k, m;
 	const t_pb_type * pb_type, *child_pb_type;
@@ -147,12 +198,16 @@ static void print_open_pb_graph_node(t_pb_graph_node * pb_graph_node,
 	int prev_edge, prev_node;
 	t_pb_graph_pin *pb_graph_pin;
 	int mode_of_edge, port_index, node_index;
+	t_out_buf *out;
+	t_rr_node *rr_graph;
 
 	mode_of_edge = UNDEFINED;
 
 	pb_type = pb_graph_node->pb_type;
+	out = writer->out;
+	rr_graph = writer->rr_graph;
 
-	print_tabs(fpout, tab_depth);
+	print_tabs(out, tab_depth);
 
 	if (is_used) {
 		/* Determine mode if applicable */
@@ -164,10 +219,10 @@ static void print_open_pb_graph_node(t_pb_graph_node * pb_graph_node,
 					node_index =
 							pb_graph_node->output_pins[port_index][j].pin_count_in_cluster;
 					if (pb_type->num_modes > 0
-							&& rr_node[node_index].net_num != OPEN) {
-						prev_edge = rr_node[node_index].prev_edge;
-						prev_node = rr_node[node_index].prev_node;
-						pb_graph_pin = rr_node[prev_node].pb_graph_pin;
+							&& rr_graph[node_index].net_num != OPEN) {
+						prev_edge = rr_graph[node_index].prev_edge;
+						prev_node = rr_graph[node_index].prev_node;
+						pb_graph_pin = rr_graph[prev_node].pb_graph_pin;
 						mode_of_edge =
 								pb_graph_pin->output_edges[prev_edge]->interconnect->parent_mode_index;
 						assert(
@@ -180,77 +235,77 @@ static void print_open_pb_graph_node(t_pb_graph_node * pb_graph_node,
 		}
 
 		assert(mode != NULL && mode_of_edge != UNDEFINED);
-		fprintf(fpout,
+		out_printf(out,
 				"<block name=\"open\" instance=\"%s[%d]\" mode=\"%s\">\n",
 				pb_graph_node->pb_type->name, pb_index, mode->name);
 
-		print_tabs(fpout, tab_depth);
-		fprintf(fpout, "\t<inputs>\n");
+		print_tabs(out, tab_depth);
+		out_str(out, "\t<inputs>\n");
 		port_index = 0;
 		for (i = 0; i < pb_type->num_ports; i++) {
 			if (!pb_type->ports[i].is_clock
 					&& pb_type->ports[i].type == IN_PORT) {
-				print_tabs(fpout, tab_depth);
-				fprintf(fpout, "\t\t<port name=\"%s\">",
+				print_tabs(out, tab_depth);
+				out_printf(out, "\t\t<port name=\"%s\">",
 						pb_graph_node->pb_type->ports[i].name);
 				for (j = 0; j < pb_type->ports[i].num_pins; j++) {
 					node_index =
 							pb_graph_node->input_pins[port_index][j].pin_count_in_cluster;
 					print_interconnect(node_index, &column, tab_depth + 2,
-							fpout);
+							writer);
 				}
-				fprintf(fpout, "</port>\n");
+				out_str(out, "</port>\n");
 				port_index++;
 			}
 		}
-		print_tabs(fpout, tab_depth);
-		fprintf(fpout, "\t</inputs>\n");
+		print_tabs(out, tab_depth);
+		out_str(out, "\t</inputs>\n");
 
 		column = tab_depth * TAB_LENGTH + 8; /* Next column I will write to. */
-		print_tabs(fpout, tab_depth);
-		fprintf(fpout, "\t<outputs>\n");
+		print_tabs(out, tab_depth);
+		out_str(out, "\t<outputs>\n");
 		port_index = 0;
 		for (i = 0; i < pb_type->num_ports; i++) {
 			if (pb_type->ports[i].type == OUT_PORT) {
-				print_tabs(fpout, tab_depth);
-				fprintf(fpout, "\t\t<port name=\"%s\">",
+				print_tabs(out, tab_depth);
+				out_printf(out, "\t\t<port name=\"%s\">",
 						pb_graph_node->pb_type->ports[i].name);
 				assert(!pb_type->ports[i].is_clock);
 				for (j = 0; j < pb_type->ports[i].num_pins; j++) {
 					node_index =
 							pb_graph_node->output_pins[port_index][j].pin_count_in_cluster;
 					print_interconnect(node_index, &column, tab_depth + 2,
-							fpout);
+							writer);
 				}
-				fprintf(fpout, "</port>\n");
+				out_str(out, "</port>\n");
 				port_index++;
 			}
 		}
-		print_tabs(fpout, tab_depth);
-		fprintf(fpout, "\t</outputs>\n");
+		print_tabs(out, tab_depth);
+		out_str(out, "\t</outputs>\n");
 
 		column = tab_depth * TAB_LENGTH + 8; /* Next column I will write to. */
-		print_tabs(fpout, tab_depth);
-		fprintf(fpout, "\t<clocks>\n");
+		print_tabs(out, tab_depth);
+		out_str(out, "\t<clocks>\n");
 		port_index = 0;
 		for (i = 0; i < pb_type->num_ports; i++) {
 			if (pb_type->ports[i].is_clock
 					&& pb_type->ports[i].type == IN_PORT) {
-				print_tabs(fpout, tab_depth);
-				fprintf(fpout, "\t\t<port name=\"%s\">",
+				print_tabs(out, tab_depth);
+				out_printf(out, "\t\t<port name=\"%s\">",
 						pb_graph_node->pb_type->ports[i].name);
 				for (j = 0; j < pb_type->ports[i].num_pins; j++) {
 					node_index =
 							pb_graph_node->clock_pins[port_index][j].pin_count_in_cluster;
 					print_interconnect(node_index, &column, tab_depth + 2,
-							fpout);
+							writer);
 				}
-				fprintf(fpout, "</port>\n");
+				out_str(out, "</port>\n");
 				port_index++;
 			}
 		}
-		print_tabs(fpout, tab_depth);
-		fprintf(fpout, "\t</clocks>\n");
+		print_tabs(out, tab_depth);
+		out_str(out, "\t</clocks>\n");
 
 		if (pb_type->num_modes > 0) {
 			for (i = 0; i < mode->num_pb_type_children; i++) {
@@ -264,7 +319,7 @@ static void print_open_pb_graph_node(t_pb_graph_node * pb_graph_node,
 									m++) {
 								node_index =
 										pb_graph_node->child_pb_graph_nodes[mode_of_edge][i][j].output_pins[port_index][m].pin_count_in_cluster;
-								if (rr_node[node_index].net_num != OPEN) {
+								if (rr_graph[node_index].net_num != OPEN) {
 									is_used = TRUE;
 									break;
 								}
@@ -274,20 +329,21 @@ static void print_open_pb_graph_node(t_pb_graph_node * pb_graph_node,
 					}
 					print_open_pb_graph_node(
 							&pb_graph_node->child_pb_graph_nodes[mode_of_edge][i][j],
-							j, is_used, tab_depth + 1, fpout);
+							j, is_used, tab_depth + 1, writer);
 				}
 			}
 		}
 
-		print_tabs(fpout, tab_depth);
-		fprintf(fpout, "</block>\n");
+		print_tabs(out, tab_depth);
+		out_str(out, "</block>\n");
 	} else {
-		fprintf(fpout, "<block name=\"open\" instance=\"%s[%d]\"/>\n",
+		out_printf(out, "<block name=\"open\" instance=\"%s[%d]\"/>\n",
 				pb_graph_node->pb_type->name, pb_index);
 	}
 }
 
-static void print_pb(FILE *fpout, t_pb * pb, int pb_index, int tab_depth) {
+static void print_pb(t_cluster_writer *writer, t_pb * pb, int pb_index,
+		int tab_depth) {
 
 	int column;
 	int i, j, k, m;
@@ -296,94 +352,98 @@ static void print_pb(FILE *fpout, t_pb * pb, int pb_index, int tab_depth) {
 	t_mode *mode;
 	int port_index, node_index;
 	boolean is_used;
+	t_out_buf *out;
+	t_rr_node *rr_graph;
 
 	pb_type = pb->pb_graph_node->pb_type;
 	pb_graph_node = pb->pb_graph_node;
 	mode = &pb_type->modes[pb->mode];
+	out = writer->out;
+	rr_graph = writer->rr_graph;
 	column = tab_depth * TAB_LENGTH + 8; /* Next column I will write to. */
-	print_tabs(fpout, tab_depth);
+	print_tabs(out, tab_depth);
 	if (pb_type->num_modes == 0) {
-		fprintf(fpout, "<block name=\"%s\" instance=\"%s[%d]\">\n", pb->name,
+		out_printf(out, "<block name=\"%s\" instance=\"%s[%d]\">\n", pb->name,
 				pb_type->name, pb_index);
 	} else {
-		fprintf(fpout, "<block name=\"%s\" instance=\"%s[%d]\" mode=\"%s\">\n",
+		out_printf(out, "<block name=\"%s\" instance=\"%s[%d]\" mode=\"%s\">\n",
 				pb->name, pb_type->name, pb_index, mode->name);
 	}
 
-	print_tabs(fpout, tab_depth);
-	fprintf(fpout, "\t<inputs>\n");
+	print_tabs(out, tab_depth);
+	out_str(out, "\t<inputs>\n");
 	port_index = 0;
 	for (i = 0; i < pb_type->num_ports; i++) {
 		if (!pb_type->ports[i].is_clock && pb_type->ports[i].type == IN_PORT) {
-			print_tabs(fpout, tab_depth);
-			fprintf(fpout, "\t\t<port name=\"%s\">",
+			print_tabs(out, tab_depth);
+			out_printf(out, "\t\t<port name=\"%s\">",
 					pb_graph_node->pb_type->ports[i].name);
 			for (j = 0; j < pb_type->ports[i].num_pins; j++) {
 				node_index =
 						pb->pb_graph_node->input_pins[port_index][j].pin_count_in_cluster;
 				if (pb_type->parent_mode == NULL) {
-					print_net_name(rr_node[node_index].net_num, &column,
-							tab_depth, fpout);
+					print_net_name(rr_graph[node_index].net_num, &column,
+							tab_depth, out);
 				} else {
 					print_interconnect(node_index, &column, tab_depth + 2,
-							fpout);
+							writer);
 				}
 			}
-			fprintf(fpout, "</port>\n");
+			out_str(out, "</port>\n");
 			port_index++;
 		}
 	}
-	print_tabs(fpout, tab_depth);
-	fprintf(fpout, "\t</inputs>\n");
+	print_tabs(out, tab_depth);
+	out_str(out, "\t</inputs>\n");
 
 	column = tab_depth * TAB_LENGTH + 8; /* Next column I will write to. */
-	print_tabs(fpout, tab_depth);
-	fprintf(fpout, "\t<outputs>\n");
+	print_tabs(out, tab_depth);
+	out_str(out, "\t<outputs>\n");
 	port_index = 0;
 	for (i = 0; i < pb_type->num_ports; i++) {
 		if (pb_type->ports[i].type == OUT_PORT) {
 			assert(!pb_type->ports[i].is_clock);
-			print_tabs(fpout, tab_depth);
-			fprintf(fpout, "\t\t<port name=\"%s\">",
+			print_tabs(out, tab_depth);
+			out_printf(out, "\t\t<port name=\"%s\">",
 					pb_graph_node->pb_type->ports[i].name);
 			for (j = 0; j < pb_type->ports[i].num_pins; j++) {
 				node_index =
 						pb->pb_graph_node->output_pins[port_index][j].pin_count_in_cluster;
-				print_interconnect(node_index, &column, tab_depth + 2, fpout);
+				print_interconnect(node_index, &column, tab_depth + 2, writer);
 			}
-			fprintf(fpout, "</port>\n");
+			out_str(out, "</port>\n");
 			port_index++;
 		}
 	}
-	print_tabs(fpout, tab_depth);
-	fprintf(fpout, "\t</outputs>\n");
+	print_tabs(out, tab_depth);
+	out_str(out, "\t</outputs>\n");
 
 	column = tab_depth * TAB_LENGTH + 8; /* Next column I will write to. */
-	print_tabs(fpout, tab_depth);
-	fprintf(fpout, "\t<clocks>\n");
+	print_tabs(out, tab_depth);
+	out_str(out, "\t<clocks>\n");
 	port_index = 0;
 	for (i = 0; i < pb_type->num_ports; i++) {
 		if (pb_type->ports[i].is_clock && pb_type->ports[i].type == IN_PORT) {
-			print_tabs(fpout, tab_depth);
-			fprintf(fpout, "\t\t<port name=\"%s\">",
+			print_tabs(out, tab_depth);
+			out_printf(out, "\t\t<port name=\"%s\">",
 					pb_graph_node->pb_type->ports[i].name);
 			for (j = 0; j < pb_type->ports[i].num_pins; j++) {
 				node_index =
 						pb->pb_graph_node->clock_pins[port_index][j].pin_count_in_cluster;
 				if (pb_type->parent_mode == NULL) {
-					print_net_name(rr_node[node_index].net_num, &column,
-							tab_depth, fpout);
+					print_net_name(rr_graph[node_index].net_num, &column,
+							tab_depth, out);
 				} else {
 					print_interconnect(node_index, &column, tab_depth + 2,
-							fpout);
+							writer);
 				}
 			}
-			fprintf(fpout, "</port>\n");
+			out_str(out, "</port>\n");
 			port_index++;
 		}
 	}
-	print_tabs(fpout, tab_depth);
-	fprintf(fpout, "\t</clocks>\n");
+	print_tabs(out, tab_depth);
+	out_str(out, "\t</clocks>\n");
 
 	if (pb_type->num_modes > 0) {
 		for (i = 0; i < mode->num_pb_type_children; i++) {
@@ -391,7 +451,7 @@ static void print_pb(FILE *fpout, t_pb * pb, int pb_index, int tab_depth) {
 				/* If child pb is not used but routing is used, I must print things differently */
 				if ((pb->child_pbs[i] != NULL)
 						&& (pb->child_pbs[i][j].name != NULL)) {
-					print_pb(fpout, &pb->child_pbs[i][j], j, tab_depth + 1);
+					print_pb(writer, &pb->child_pbs[i][j], j, tab_depth + 1);
 				} else {
 					is_used = FALSE;
 					child_pb_type = &mode->pb_type_children[i];
@@ -403,7 +463,7 @@ static void print_pb(FILE *fpout, t_pb * pb, int pb_index, int tab_depth) {
 									m++) {
 								node_index =
 										pb_graph_node->child_pb_graph_nodes[pb->mode][i][j].output_pins[port_index][m].pin_count_in_cluster;
-								if (rr_node[node_index].net_num != OPEN) {
+								if (rr_graph[node_index].net_num != OPEN) {
 									is_used = TRUE;
 									break;
 								}
@@ -413,31 +473,125 @@ static void print_pb(FILE *fpout, t_pb * pb, int pb_index, int tab_depth) {
 					}
 					print_open_pb_graph_node(
 							&pb_graph_node->child_pb_graph_nodes[pb->mode][i][j],
-							j, is_used, tab_depth + 1, fpout);
+							j, is_used, tab_depth + 1, writer);
 				}
 			}
 		}
 	}
-	print_tabs(fpout, tab_depth);
-	fprintf(fpout, "</block>\n");
+	print_tabs(out, tab_depth);
+	out_str(out, "</block>\n");
 }
 
-static void print_clusters(t_block *clb, int num_clusters, FILE * fpout) {
+static int get_num_cluster_rr_nodes(t_type_ptr type) {
 
-	/* Prints out one cluster (clb).  Both the external pins and the *
-	 * internal connections are printed out.                         */
+	/* Size of the rr graph of a cluster of this type, without the spare *
+	 * nodes alloc_and_load_cluster_legality_checker adds.                */
 
-	int icluster;
+	return (type->pb_graph_head->total_pb_pins + type->pb_type->num_input_pins
+			+ type->pb_type->num_output_pins + type->pb_type->num_clock_pins);
+}
+
+static void alloc_and_load_pin_prefixes(t_block *clb, int num_clusters) {
+
+	/* Makes the interconnect source names of every pin of each cluster type *
+	 * in use, from the rr graph of the first cluster of the type.           */
 
+	int icluster, itype, inode, num_nodes, len;
+	t_rr_node *rr_graph;
+	t_pb_graph_pin *pin;
+	t_pin_prefix *prefixes;
+
+	type_pin_prefixes = (t_pin_prefix **) my_calloc(num_types,
+			sizeof(t_pin_prefix *));
 	for (icluster = 0; icluster < num_clusters; icluster++) {
-		rr_node = clb[icluster].pb->rr_graph;
+		itype = clb[icluster].type->index;
+		if (type_pin_prefixes[itype] != NULL)
+			continue;
+
+		rr_graph = clb[icluster].pb->rr_graph;
+		num_nodes = get_num_cluster_rr_nodes(clb[icluster].type);
+		prefixes = (t_pin_prefix *) my_calloc(num_nodes, sizeof(t_pin_prefix));
+		for (inode = 0; inode < num_nodes; inode++) {
+			pin = rr_graph[inode].pb_graph_pin;
+			if (pin == NULL)
+				continue;
+
+			len = snprintf(NULL, 0, "%s[%d].%s[%d]->",
+					pin->parent_node->pb_type->name,
+					pin->parent_node->placement_index, pin->port->name,
+					pin->pin_number);
+			prefixes[inode].sibling = (char *) my_malloc(
+					(len + 1) * sizeof(char));
+			sprintf(prefixes[inode].sibling, "%s[%d].%s[%d]->",
+					pin->parent_node->pb_type->name,
+					pin->parent_node->placement_index, pin->port->name,
+					pin->pin_number);
+
+			len = snprintf(NULL, 0, "%s.%s[%d]->",
+					pin->parent_node->pb_type->name, pin->port->name,
+					pin->pin_number);
+			prefixes[inode].parent = (char *) my_malloc(
+					(len + 1) * sizeof(char));
+			sprintf(prefixes[inode].parent, "%s.%s[%d]->",
+					pin->parent_node->pb_type->name, pin->port->name,
+					pin->pin_number);
+		}
+		type_pin_prefixes[itype] = prefixes;
+	}
+}
+
+static void free_pin_prefixes(void) {
+
+	int itype, inode, num_nodes;
+
+	for (itype = 0; itype < num_types; itype++) {
+		if (type_pin_prefixes[itype] == NULL)
+			continue;
+		num_nodes = get_num_cluster_rr_nodes(&type_descriptors[itype]);
+		for (inode = 0; inode < num_nodes; inode++) {
+			free(type_pin_prefixes[itype][inode].sibling);
+			free(type_pin_prefixes[itype][inode].parent);
+		}
+		free(type_pin_prefixes[itype]);
+	}
+	free(type_pin_prefixes);
+	type_pin_prefixes = NULL;
+}
+
+static void print_cluster_range(t_out_buf **outs, int first, int last,
+		void *context) {
+
+	/* Prints clusters [first..last-1] of the clb array in context into *
+	 * outs[0].  Called on several threads at once by print_clusters.   */
+
+	t_block *clb;
+	t_cluster_writer writer;
+	int icluster;
+
+	clb = (t_block *) context;
+	writer.out = outs[0];
+	for (icluster = first; icluster < last; icluster++) {
+		writer.rr_graph = clb[icluster].pb->rr_graph;
+		writer.pin_prefixes = type_pin_prefixes[clb[icluster].type->index];
 
 		/* TODO: Must do check that total CLB pins match top-level pb pins, perhaps check this earlier? */
 
-		print_pb(fpout, clb[icluster].pb, icluster, 1);
+		print_pb(&writer, clb[icluster].pb, icluster, 1);
 	}
 }
 
+static void print_clusters(t_block *clb, int num_clusters, t_out_buf *out) {
+
+	/* Prints out every cluster (clb).  Both the external pins and the *
+	 * internal connections are printed out.  Clusters are formatted   *
+	 * on several threads and written in order.                        */
+
+	alloc_and_load_pin_prefixes(clb, num_clusters);
+	write_out_bufs_parallel(&out, 1, num_clusters, NET_CLUSTERS_PER_RANGE,
+			print_cluster_range, clb);
+	free_pin_prefixes();
+}
+
 static void print_stats(t_block *clb, int num_clusters) {
 
 	/* Prints out one cluster (clb).  Both the external pins and the *
@@ -535,14 +689,16 @@ void output_clustering(t_block *clb, int num_clusters, boolean global_clocks,
 	 * input to vpr.  This routine also dumps out the internal structure of   *
 	 * the cluster, in essentially a graph based format.                           */
 
-	FILE *fpout;
+	t_out_buf *fpout;
 	int bnum, netnum, column;
+	double begin, write_seconds;
 
-	fpout = fopen(out_fname, "w");
+	begin = get_output_wall_seconds();
+	fpout = open_out_file(out_fname);
 
-	fprintf(fpout, "<block name=\"%s\" instance=\"FPGA_packed_netlist[0]\">\n",
+	out_printf(fpout, "<block name=\"%s\" instance=\"FPGA_packed_netlist[0]\">\n",
 			out_fname);
-	fprintf(fpout, "\t<inputs>\n\t\t");
+	out_printf(fpout, "\t<inputs>\n\t\t");
 
 	column = 2 * TAB_LENGTH; /* Organize whitespace to ident data inside block */
 	for (bnum = 0; bnum < num_logical_blocks; bnum++) {
@@ -550,8 +706,8 @@ void output_clustering(t_block *clb, int num_clusters, boolean global_clocks,
 			print_string(logical_block[bnum].name, &column, 2, fpout);
 		}
 	}
-	fprintf(fpout, "\n\t</inputs>\n");
-	fprintf(fpout, "\n\t<outputs>\n\t\t");
+	out_printf(fpout, "\n\t</inputs>\n");
+	out_printf(fpout, "\n\t<outputs>\n\t\t");
 
 	column = 2 * TAB_LENGTH;
 	for (bnum = 0; bnum < num_logical_blocks; bnum++) {
@@ -559,18 +715,18 @@ void output_clustering(t_block *clb, int num_clusters, boolean global_clocks,
 			print_string(logical_block[bnum].name, &column, 2, fpout);
 		}
 	}
-	fprintf(fpout, "\n\t</outputs>\n");
+	out_printf(fpout, "\n\t</outputs>\n");
 
 	column = 2 * TAB_LENGTH;
 	if (global_clocks) {
-		fprintf(fpout, "\n\t<clocks>\n\t\t");
+		out_printf(fpout, "\n\t<clocks>\n\t\t");
 
 		for (netnum = 0; netnum < num_logical_nets; netnum++) {
 			if (is_clock[netnum]) {
 				print_string(vpack_net[netnum].name, &column, 2, fpout);
 			}
 		}
-		fprintf(fpout, "\n\t</clocks>\n\n");
+		out_printf(fpout, "\n\t</clocks>\n\n");
 	}
 
 	/* Print out all input and output pads. */
@@ -601,9 +757,27 @@ void output_clustering(t_block *clb, int num_clusters, boolean global_clocks,
 	if (skip_clustering == FALSE)
 		print_clusters(clb, num_clusters, fpout);
 
-	fprintf(fpout, "</block>\n\n");
+	out_printf(fpout, "</block>\n\n");
 
-	fclose(fpout);
+	close_out_file(fpout);
+	write_seconds = get_output_wall_seconds() - begin;
 
 	print_stats(clb, num_clusters);
+	vpr_printf(TIO_MESSAGE_INFO, "Writing the packed netlist '%s' took %g seconds.\n",
+			out_fname, write_seconds);
+}
+
+static double get_output_wall_seconds(void) {
+
+	/* Wall-clock time, so the threaded writer is not charged for every *
+	 * thread's CPU time.                                               */
+
+#ifndef _WIN32
+	struct timeval now;
+
+	gettimeofday(&now, NULL);
+	return ((double) now.tv_sec + 1.e-6 * (double) now.tv_usec);
+#else
+	return ((double) clock() / CLOCKS_PER_SEC);
+#endif
 }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <assert.h>
 #include <string.h>
+#include <time.h>
 #include "read_xml_arch_file.h"
 #include "util.h"
 #include "vpr_types.h"
@@ -11,6 +12,7 @@
 #include "cluster.h"
 #include "output_clustering.h"
 #include "ReadOptions.h"
+#include "pack_profile.h"
 
 /* #define DUMP_PB_GRAPH 1 */
 /* #define DUMP_BLIF_INPUT 1 */
@@ -26,6 +28,7 @@ void try_pack(INP struct s_packer_opts *packer_opts, INP const t_arch * arch,
 	int num_packing_patterns;
 	t_pack_molecule *list_of_pack_molecules, * cur_pack_molecule;
 	int num_pack_molecules;
+	clock_t begin, end;
 
 	vpr_printf(TIO_MESSAGE_INFO, "Begin packing '%s'.\n", packer_opts->blif_file_name);
 
@@ -53,10 +56,19 @@ void try_pack(INP struct s_packer_opts *packer_opts, INP const t_arch * arch,
 	vpr_printf(TIO_MESSAGE_INFO, "Begin prepacking.\n");
 	list_of_packing_patterns = alloc_and_load_pack_patterns(
 			&num_packing_patterns);
+	begin = clock();
 	list_of_pack_molecules = alloc_and_load_pack_molecules(
 			list_of_packing_patterns, num_packing_patterns,
 			&num_pack_molecules);
+	end = clock();
 	vpr_printf(TIO_MESSAGE_INFO, "Finish prepacking.\n");
+#ifdef CLOCKS_PER_SEC
+	vpr_printf(TIO_MESSAGE_INFO, "Molecule creation took %g seconds: %d molecules from %d pack patterns.\n",
+			(float)(end - begin) / CLOCKS_PER_SEC, num_pack_molecules, num_packing_patterns);
+#else
+	vpr_printf(TIO_MESSAGE_INFO, "Molecule creation took %g seconds: %d molecules from %d pack patterns.\n",
+			(float)(end - begin) / CLK_PER_SEC, num_pack_molecules, num_packing_patterns);
+#endif
 
 	if(packer_opts->auto_compute_inter_cluster_net_delay) {
 		packer_opts->inter_cluster_net_delay = interc_delay;
@@ -69,6 +81,9 @@ void try_pack(INP struct s_packer_opts *packer_opts, INP const t_arch * arch,
 	 }else; */
 
 	if (packer_opts->skip_clustering == FALSE) {
+		if (packer_opts->profile) {
+			alloc_pack_profile(packer_opts->output_file);
+		}
 		do_clustering(arch, list_of_pack_molecules, num_models,
 				packer_opts->global_clocks, is_clock,
 				packer_opts->hill_climbing_flag, packer_opts->output_file,
@@ -79,7 +94,9 @@ void try_pack(INP struct s_packer_opts *packer_opts, INP const t_arch * arch,
 				packer_opts->inter_cluster_net_delay, packer_opts->aspect,
 				packer_opts->allow_unrelated_clustering,
 				packer_opts->allow_early_exit, packer_opts->connection_driven,
-				packer_opts->packer_algorithm, timing_inf);
+				packer_opts->packer_algorithm, timing_inf,
+				packer_opts->num_workers, packer_opts->deterministic);
+		free_pack_profile();
 	} else {
 		vpr_printf(TIO_MESSAGE_ERROR, "Skip clustering no longer supported.\n");
 		exit(1);
@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <string.h>
+#include "util.h"
+#include "vpr_types.h"
+#include "globals.h"
+#include "place_profile.h"
+#include "pack_profile.h"
+
+#define NUM_PACK_HISTOGRAM_BINS 12 /* bin 0: no candidates, bin i: [2^(i-1)..2^i - 1], last bin open */
+
+/* Counters for one cluster type.  The last entry of type_counts holds the *
+ * time spent while no cluster was open (seed selection, timing).          *
+ * candidates: molecules tried, by e_block_pack_status.                    */
+typedef struct s_pack_profile_counts {
+	double phase_ticks[NUM_PACK_PHASES];
+	int candidates[BLK_STATUS_UNDEFINED];
+	int num_clusters; /* clusters kept */
+	int num_undone; /* clusters undone, usually to repack with detailed routing */
+} t_pack_profile_counts;
+
+/* One opened cluster, in the order they were opened. */
+typedef struct s_pack_profile_cluster {
+	char *name;
+	int type_index;
+	int detailed_routing_stage;
+	boolean is_kept;
+	int candidates[BLK_STATUS_UNDEFINED];
+	double ticks;
+} t_pack_profile_cluster;
+
+boolean pack_profiling = FALSE; /* available externally */
+
+static char *report_file = NULL;
+static t_pack_profile_counts *type_counts = NULL; /* [0..num_types] */
+static int cur_type_index;
+static t_pack_profile_cluster *clusters = NULL;
+static int num_clusters = 0;
+static int max_clusters = 0;
+static int histogram[NUM_PACK_HISTOGRAM_BINS];
+
+static const char *phase_names[NUM_PACK_PHASES] = { "seed", "start_cluster",
+		"get_molecule", "primitive_placement", "feasibility", "route",
+		"update_stats", "commit", "worker_wait", "timing" };
+
+static const char *status_names[BLK_STATUS_UNDEFINED] = { "passed",
+		"failed_feasible", "failed_route" };
+
+/******** prototypes ******************/
+
+static int get_histogram_bin(int num_candidates);
+
+static void print_json_string(FILE *fp, const char *s);
+
+static void write_pack_profile_report(void);
+
+static void print_pack_profile_summary(void);
+
+/**************************************/
+
+static int get_histogram_bin(int num_candidates) {
+
+	int bin;
+
+	bin = 0;
+	while (num_candidates > 0 && bin < NUM_PACK_HISTOGRAM_BINS - 1) {
+		num_candidates >>= 1;
+		bin++;
+	}
+	return (bin);
+}
+
+void alloc_pack_profile(const char *net_file) {
+
+	/* Starts profiling; the report goes next to the .net file. */
+
+	report_file = (char *) my_malloc(
+			(strlen(net_file) + strlen(".profile.json") + 1) * sizeof(char));
+	sprintf(report_file, "%s.profile.json", net_file);
+
+	type_counts = (t_pack_profile_counts *) my_calloc(num_types + 1,
+			sizeof(t_pack_profile_counts));
+	cur_type_index = num_types;
+	clusters = NULL;
+	num_clusters = 0;
+	max_clusters = 0;
+	memset(histogram, 0, sizeof(histogram));
+
+	pack_profiling = TRUE;
+}
+
+void free_pack_profile(void) {
+
+	/* Writes the report, prints the summary and stops profiling. */
+
+	int i;
+
+	if (pack_profiling == FALSE)
+		return;
+
+	write_pack_profile_report();
+	print_pack_profile_summary();
+
+	for (i = 0; i < num_clusters; i++)
+		free(clusters[i].name);
+	free(clusters);
+	free(type_counts);
+	free(report_file);
+	clusters = NULL;
+	type_counts = NULL;
+	report_file = NULL;
+	num_clusters = max_clusters = 0;
+	pack_profiling = FALSE;
+}
+
+double get_pack_profile_ticks(void) {
+
+	return (get_place_profile_ticks());
+}
+
+double add_pack_profile_phase(enum e_pack_phase phase, double start_ticks) {
+
+	/* Charges the time since start_ticks to phase, under the type of the *
+	 * open cluster.  Returns the current time, so consecutive phases can *
+	 * be timed from one timestamp.                                       */
+
+	double now;
+
+	now = get_place_profile_ticks();
+	type_counts[cur_type_index].phase_ticks[phase] += now - start_ticks;
+	if (cur_type_index != num_types)
+		clusters[num_clusters - 1].ticks += now - start_ticks;
+	return (now);
+}
+
+void start_pack_profile_cluster(t_type_ptr type) {
+
+	t_pack_profile_cluster *cluster;
+
+	if (num_clusters == max_clusters) {
+		max_clusters = (max_clusters == 0 ? 64 : 2 * max_clusters);
+		clusters = (t_pack_profile_cluster *) my_realloc(clusters,
+				max_clusters * sizeof(t_pack_profile_cluster));
+	}
+	cluster = &clusters[num_clusters++];
+	memset(cluster, 0, sizeof(t_pack_profile_cluster));
+	cluster->type_index = type->index;
+	cur_type_index = type->index;
+}
+
+void add_pack_profile_candidate(enum e_block_pack_status block_pack_status) {
+
+	if (cur_type_index == num_types || block_pack_status == BLK_STATUS_UNDEFINED)
+		return;
+	type_counts[cur_type_index].candidates[block_pack_status]++;
+	clusters[num_clusters - 1].candidates[block_pack_status]++;
+}
+
+void end_pack_profile_cluster(const char *name, int detailed_routing_stage,
+		boolean is_kept) {
+
+	/* Closes the open cluster.  Only kept clusters enter the histogram. */
+
+	int i, num_tried;
+	t_pack_profile_cluster *cluster;
+
+	if (cur_type_index == num_types)
+		return;
+
+	cluster = &clusters[num_clusters - 1];
+	cluster->name = my_strdup(name);
+	cluster->detailed_routing_stage = detailed_routing_stage;
+	cluster->is_kept = is_kept;
+	if (is_kept) {
+		type_counts[cur_type_index].num_clusters++;
+		num_tried = 0;
+		for (i = 0; i < BLK_STATUS_UNDEFINED; i++)
+			num_tried += cluster->candidates[i];
+		histogram[get_histogram_bin(num_tried)]++;
+	} else {
+		type_counts[cur_type_index].num_undone++;
+	}
+	cur_type_index = num_types;
+}
+
+static void print_json_string(FILE *fp, const char *s) {
+
+	fputc('"', fp);
+	for (; *s != '\0'; s++) {
+		if (*s == '"' || *s == '\\')
+			fputc('\\', fp);
+		fputc(*s, fp);
+	}
+	fputc('"', fp);
+}
+
+static void write_pack_profile_report(void) {
+
+	int i, itype, bin;
+	FILE *fp;
+
+	fp = my_fopen(report_file, "w", 0);
+	fprintf(fp, "{\n\"tick_unit\": \"%s\",\n",
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+			"cycles"
+#else
+			"clock"
+#endif
+			);
+
+	/* Per type; "(none)" is the time spent with no cluster open */
+	fprintf(fp, "\"types\": {");
+	for (itype = 0; itype <= num_types; itype++) {
+		fprintf(fp, "%s\n  ", (itype == 0 ? "" : ","));
+		print_json_string(fp,
+				(itype == num_types ? "(none)" : type_descriptors[itype].name));
+		fprintf(fp, ": {\"clusters\": %d, \"undone\": %d, \"candidates\": {",
+				type_counts[itype].num_clusters, type_counts[itype].num_undone);
+		for (i = 0; i < BLK_STATUS_UNDEFINED; i++) {
+			fprintf(fp, "%s\"%s\": %d", (i == 0 ? "" : ", "), status_names[i],
+					type_counts[itype].candidates[i]);
+		}
+		fprintf(fp, "}, \"phase_ticks\": {");
+		for (i = 0; i < NUM_PACK_PHASES; i++) {
+			fprintf(fp, "%s\"%s\": %.0f", (i == 0 ? "" : ", "), phase_names[i],
+					type_counts[itype].phase_ticks[i]);
+		}
+		fprintf(fp, "}}");
+	}
+	fprintf(fp, "\n},\n");
+
+	fprintf(fp, "\"candidates_per_cluster\": [");
+	for (bin = 0; bin < NUM_PACK_HISTOGRAM_BINS; bin++) {
+		fprintf(fp, "%s\n  {\"min\": %d, ", (bin == 0 ? "" : ","),
+				(bin == 0 ? 0 : 1 << (bin - 1)));
+		if (bin == NUM_PACK_HISTOGRAM_BINS - 1)
+			fprintf(fp, "\"max\": null, ");
+		else
+			fprintf(fp, "\"max\": %d, ", (bin == 0 ? 0 : (1 << bin) - 1));
+		fprintf(fp, "\"clusters\": %d}", histogram[bin]);
+	}
+	fprintf(fp, "\n],\n");
+
+	/* Every cluster opened, kept or not, as [passed, failed_feasible, failed_route] */
+	fprintf(fp, "\"clusters\": [");
+	for (i = 0; i < num_clusters; i++) {
+		fprintf(fp, "%s\n  {\"name\": ", (i == 0 ? "" : ","));
+		print_json_string(fp, (clusters[i].name ? clusters[i].name : ""));
+		fprintf(fp, ", \"type\": ");
+		print_json_string(fp, type_descriptors[clusters[i].type_index].name);
+		fprintf(fp, ", \"detailed_routing_stage\": %d, \"kept\": %s, "
+				"\"candidates\": [%d, %d, %d], \"ticks\": %.0f}",
+				clusters[i].detailed_routing_stage,
+				(clusters[i].is_kept ? "true" : "false"),
+				clusters[i].candidates[BLK_PASSED],
+				clusters[i].candidates[BLK_FAILED_FEASIBLE],
+				clusters[i].candidates[BLK_FAILED_ROUTE], clusters[i].ticks);
+	}
+	fprintf(fp, "\n]\n}\n");
+	fclose(fp);
+}
+
+static void print_pack_profile_summary(void) {
+
+	int i, itype, bin;
+	double phase_ticks[NUM_PACK_PHASES], total_ticks;
+
+	total_ticks = 0.;
+	for (i = 0; i < NUM_PACK_PHASES; i++) {
+		phase_ticks[i] = 0.;
+		for (itype = 0; itype <= num_types; itype++)
+			phase_ticks[i] += type_counts[itype].phase_ticks[i];
+		total_ticks += phase_ticks[i];
+	}
+
+	vpr_printf(TIO_MESSAGE_INFO, "\n");
+	vpr_printf(TIO_MESSAGE_INFO, "Packing profile (written to %s):\n", report_file);
+	vpr_printf(TIO_MESSAGE_INFO, "%20s %14s %7s\n", "Phase", "Ticks", "%");
+	for (i = 0; i < NUM_PACK_PHASES; i++) {
+		vpr_printf(TIO_MESSAGE_INFO, "%20s %14.0f %7.2f\n", phase_names[i],
+				phase_ticks[i],
+				(total_ticks > 0. ? 100. * phase_ticks[i] / total_ticks : 0.));
+	}
+
+	vpr_printf(TIO_MESSAGE_INFO, "%20s %8s %8s %10s %10s %10s\n", "Cluster type",
+			"Kept", "Undone", status_names[BLK_PASSED],
+			status_names[BLK_FAILED_FEASIBLE], status_names[BLK_FAILED_ROUTE]);
+	for (itype = 0; itype < num_types; itype++) {
+		if (type_counts[itype].num_clusters == 0 && type_counts[itype].num_undone == 0)
+			continue;
+		vpr_printf(TIO_MESSAGE_INFO, "%20s %8d %8d %10d %10d %10d\n",
+				type_descriptors[itype].name, type_counts[itype].num_clusters,
+				type_counts[itype].num_undone,
+				type_counts[itype].candidates[BLK_PASSED],
+				type_counts[itype].candidates[BLK_FAILED_FEASIBLE],
+				type_counts[itype].candidates[BLK_FAILED_ROUTE]);
+	}
+
+	vpr_printf(TIO_MESSAGE_INFO, "Candidates tried per cluster:");
+	for (bin = 0; bin < NUM_PACK_HISTOGRAM_BINS; bin++) {
+		if (histogram[bin] == 0)
+			continue;
+		if (bin == 0)
+			vpr_printf(TIO_MESSAGE_INFO, " 0: %d", histogram[bin]);
+		else if (bin == NUM_PACK_HISTOGRAM_BINS - 1)
+			vpr_printf(TIO_MESSAGE_INFO, " %d+: %d", 1 << (bin - 1), histogram[bin]);
+		else
+			vpr_printf(TIO_MESSAGE_INFO, " %d-%d: %d", 1 << (bin - 1),
+					(1 << bin) - 1, histogram[bin]);
+	}
+	vpr_printf(TIO_MESSAGE_INFO, "\n");
+}
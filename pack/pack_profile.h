@@ -0,0 +1,46 @@
+#ifndef PACK_PROFILE_H
+#define PACK_PROFILE_H
+
+/* Packing profiler (--pack_profile on).  Accumulates the time spent in     *
+ * each phase of do_clustering by the type of the cluster being grown,     *
+ * counts the candidate molecules each cluster tried and why they were     *
+ * rejected, and keeps a histogram of candidates tried per cluster.  The   *
+ * report is written as JSON to <.net file>.profile.json when clustering   *
+ * ends, and a summary is printed.  Times are in the ticks of the          *
+ * placement profiler (CPU cycles on x86 with gcc, clock() otherwise).     *
+ * Clusters grown by --pack_workers processes are profiled when they are    *
+ * replayed, not while the workers grow them.                               */
+
+enum e_pack_phase {
+	PACK_PHASE_SEED, /* picking the seed molecule of the next cluster */
+	PACK_PHASE_START_CLUSTER, /* start_new_cluster */
+	PACK_PHASE_GET_MOLECULE, /* get_molecule_for_cluster */
+	PACK_PHASE_PRIMITIVE_PLACEMENT, /* cluster_placement.c and try_place_logical_block_rec */
+	PACK_PHASE_FEASIBILITY, /* pin-class lookahead filter */
+	PACK_PHASE_ROUTE, /* intra-cluster routing */
+	PACK_PHASE_UPDATE_STATS, /* update_cluster_stats */
+	PACK_PHASE_COMMIT, /* saving or undoing a finished cluster */
+	PACK_PHASE_WORKER_WAIT, /* waiting for --pack_workers clusters */
+	PACK_PHASE_TIMING, /* pre-packing timing analysis */
+	NUM_PACK_PHASES
+};
+
+/* TRUE while the profiler is running; checked before every call below. */
+extern boolean pack_profiling;
+
+void alloc_pack_profile(const char *net_file);
+
+void free_pack_profile(void);
+
+double get_pack_profile_ticks(void);
+
+double add_pack_profile_phase(enum e_pack_phase phase, double start_ticks);
+
+void start_pack_profile_cluster(t_type_ptr type);
+
+void add_pack_profile_candidate(enum e_block_pack_status block_pack_status);
+
+void end_pack_profile_cluster(const char *name, int detailed_routing_stage,
+		boolean is_kept);
+
+#endif
@@ -22,18 +22,50 @@
 #include "vpr_utils.h"
 #include "ReadOptions.h"
 
+/* A pack pattern compiled for matching against the netlist.  The           *
+ * connections of each pattern block are flattened into steps that name the *
+ * netlist pin to follow and the pattern block expected at its other end,   *
+ * so matching never walks the pb_graph.  candidates lists, in ascending    *
+ * order, the logical blocks whose model can implement the root of the      *
+ * pattern; no other block can start a match.                               */
+typedef struct s_pattern_match_step {
+	boolean is_output; /* TRUE if this block drives the connection */
+	boolean is_clock;
+	int port; /* model port index on this block */
+	int pin;
+	int other_block_id; /* pattern block at the other end */
+} t_pattern_match_step;
+
+typedef struct s_pattern_match_program {
+	t_pb_type **block_pb_types; /* [0..num_blocks-1] */
+	int *num_steps; /* [0..num_blocks-1] */
+	t_pattern_match_step **steps; /* [0..num_blocks-1][0..num_steps-1] */
+	t_logical_block **match; /* scratch for a match in progress [0..num_blocks-1] */
+	int num_candidates;
+	int *candidates; /* [0..num_candidates-1] */
+	boolean owns_candidates; /* FALSE if candidates is a model's block list */
+} t_pattern_match_program;
+
+/* Logical blocks grouped by model, in ascending order, for the candidate *
+ * lists of the pattern match programs.                                   */
+typedef struct s_model_blocks {
+	t_model *model;
+	int num_blocks;
+	int *blocks;
+} t_model_blocks;
+
 /*****************************************/
 /*Local Function Declaration			 */
 /*****************************************/
-static int add_pattern_name_to_hash(INOUTP struct s_hash **nhash,
+static int add_pattern_name_to_hash(INOUTP struct s_hash_table *nhash,
 		INP char *pattern_name, INOUTP int *ncount);
 static void discover_pattern_names_in_pb_graph_node(
-		INOUTP t_pb_graph_node *pb_graph_node, INOUTP struct s_hash **nhash,
+		INOUTP t_pb_graph_node *pb_graph_node, INOUTP struct s_hash_table *nhash,
 		INOUTP int *ncount);
 static void forward_infer_pattern(INOUTP t_pb_graph_pin *pb_graph_pin);
 static void backward_infer_pattern(INOUTP t_pb_graph_pin *pb_graph_pin);
 static t_pack_patterns *alloc_and_init_pattern_list_from_hash(INP int ncount,
-		INOUTP struct s_hash **nhash);
+		INOUTP struct s_hash_table *nhash);
 static t_pb_graph_edge * find_expansion_edge_of_pattern(INP int pattern_index,
 		INP t_pb_graph_node *pb_graph_node);
 static void forward_expand_pack_pattern_from_edge(
@@ -48,11 +80,29 @@ static void backward_expand_pack_pattern_from_edge(
 static int compare_pack_pattern(const t_pack_patterns *pattern_a, const t_pack_patterns *pattern_b);
 static void free_pack_pattern(INOUTP t_pack_pattern_block *pattern_block, INOUTP t_pack_pattern_block **pattern_block_list);
 static t_pack_molecule *try_create_molecule(
-		INP t_pack_patterns *list_of_pack_patterns, INP int pack_pattern_index,
+		INP t_pack_patterns *list_of_pack_patterns,
+		INOUTP t_pattern_match_program *program, INP int pack_pattern_index,
 		INP int block_index);
 static boolean try_expand_molecule(INOUTP t_pack_molecule *molecule,
-		INP int logical_block_index,
-		INP t_pack_pattern_block *current_pattern_block);
+		INP t_pattern_match_program *program, INP int logical_block_index,
+		INP int pattern_block_id);
+static t_pattern_match_program *alloc_and_load_pattern_match_programs(
+		INP t_pack_patterns *list_of_pack_patterns,
+		INP int num_packing_patterns, OUTP t_model_blocks **model_blocks,
+		OUTP int *num_models);
+static void load_pattern_match_steps(INOUTP t_pattern_match_program *program,
+		INP t_pack_patterns *pack_pattern);
+static t_model_blocks *alloc_and_load_model_blocks(OUTP int *num_models);
+static void load_pattern_match_candidates(
+		INOUTP t_pattern_match_program *program,
+		INP t_pack_patterns *pack_pattern, INP t_model_blocks *model_blocks,
+		INP int num_models);
+static void free_pattern_match_programs(
+		INOUTP t_pattern_match_program *programs,
+		INP t_pack_patterns *list_of_pack_patterns,
+		INP int num_packing_patterns, INOUTP t_model_blocks *model_blocks,
+		INP int num_models);
+static int compare_int(const void *a, const void *b);
 static void print_pack_molecules(INP const char *fname,
 		INP t_pack_patterns *list_of_pack_patterns, INP int num_pack_patterns,
 		INP t_pack_molecule *list_of_molecules);
@@ -75,7 +125,7 @@ static int find_new_root_atom_for_chain(INP int block_index, INP t_pack_patterns
 t_pack_patterns *alloc_and_load_pack_patterns(OUTP int *num_packing_patterns) {
 	int i, j, ncount, k;
 	int L_num_blocks;
-	struct s_hash **nhash;
+	struct s_hash_table *nhash;
 	t_pack_patterns *list_of_packing_patterns;
 	t_pb_graph_edge *expansion_edge;
 
@@ -127,7 +177,7 @@ t_pack_patterns *alloc_and_load_pack_patterns(OUTP int *num_packing_patterns) {
 /**
  * Adds pack pattern name to hashtable of pack pattern names.
  */
-static int add_pattern_name_to_hash(INOUTP struct s_hash **nhash,
+static int add_pattern_name_to_hash(INOUTP struct s_hash_table *nhash,
 		INP char *pattern_name, INOUTP int *ncount) {
 	struct s_hash *hash_value;
 
@@ -145,7 +195,7 @@ static int add_pattern_name_to_hash(INOUTP struct s_hash **nhash,
  *				For cases where a pattern inference is "obvious", mark it as obvious.
  */
 static void discover_pattern_names_in_pb_graph_node(
-		INOUTP t_pb_graph_node *pb_graph_node, INOUTP struct s_hash **nhash,
+		INOUTP t_pb_graph_node *pb_graph_node, INOUTP struct s_hash_table *nhash,
 		INOUTP int *ncount) {
 	int i, j, k, m;
 	int index;
@@ -296,7 +346,7 @@ static void backward_infer_pattern(INOUTP t_pb_graph_pin *pb_graph_pin) {
  * more complete information later
  */
 static t_pack_patterns *alloc_and_init_pattern_list_from_hash(INP int ncount,
-		INOUTP struct s_hash **nhash) {
+		INOUTP struct s_hash_table *nhash) {
 	t_pack_patterns *nlist;
 	struct s_hash_iterator hash_iter;
 	struct s_hash *curr_pattern;
@@ -756,12 +806,17 @@ static void backward_expand_pack_pattern_from_edge(
 t_pack_molecule *alloc_and_load_pack_molecules(
 		INP t_pack_patterns *list_of_pack_patterns,
 		INP int num_packing_patterns, OUTP int *num_pack_molecule) {
-	int i, j, best_pattern;
+	int i, j, best_pattern, icandidate, num_models;
 	t_pack_molecule *list_of_molecules_head;
 	t_pack_molecule *cur_molecule;
 	boolean *is_used;
+	t_pattern_match_program *programs;
+	t_model_blocks *model_blocks;
 
 	is_used = (boolean*)my_calloc(num_packing_patterns, sizeof(boolean));
+	programs = alloc_and_load_pattern_match_programs(list_of_pack_patterns,
+			num_packing_patterns, &model_blocks, &num_models);
+	*num_pack_molecule = 0;
 
 	cur_molecule = list_of_molecules_head = NULL;
 
@@ -779,8 +834,11 @@ t_pack_molecule *alloc_and_load_pack_molecules(
 		}
 		assert(is_used[best_pattern] == FALSE);
 		is_used[best_pattern] = TRUE;
-		for (j = 0; j < num_logical_blocks; j++) {
-			cur_molecule = try_create_molecule(list_of_pack_patterns, best_pattern, j);
+		/* Only blocks that can implement the root of the pattern can start a match */
+		for (icandidate = 0; icandidate < programs[best_pattern].num_candidates; icandidate++) {
+			j = programs[best_pattern].candidates[icandidate];
+			cur_molecule = try_create_molecule(list_of_pack_patterns,
+					&programs[best_pattern], best_pattern, j);
 			if (cur_molecule != NULL) {
 				cur_molecule->next = list_of_molecules_head;
 				/* In the event of multiple molecules with the same logical block pattern, bias to use the molecule with less costly physical resources first */
@@ -788,14 +846,17 @@ t_pack_molecule *alloc_and_load_pack_molecules(
 				cur_molecule->base_gain = cur_molecule->num_blocks
 						- (cur_molecule->pack_pattern->base_cost / 100);
 				list_of_molecules_head = cur_molecule;
+				(*num_pack_molecule)++;
 				if(logical_block[j].packed_molecules == NULL || logical_block[j].packed_molecules->data_vptr != cur_molecule) {
 					/* molecule did not cover current atom (possibly because molecule created is part of a long chain that extends past multiple logic blocks), try again */
-					j--;
+					icandidate--;
 				}
 			}
 		}
 	}
 	free(is_used);
+	free_pattern_match_programs(programs, list_of_pack_patterns,
+			num_packing_patterns, model_blocks, num_models);
 
 	/* List all logical blocks as a molecule for blocks that do not belong to any molecules.
 	 This allows the packer to be consistent as it now packs molecules only instead of atoms and molecules
@@ -821,6 +882,7 @@ t_pack_molecule *alloc_and_load_pack_molecules(
 			cur_molecule->next = list_of_molecules_head;
 			cur_molecule->base_gain = 1;
 			list_of_molecules_head = cur_molecule;
+			(*num_pack_molecule)++;
 
 			logical_block[i].packed_molecules = (struct s_linked_vptr*) my_calloc(1,
 					sizeof(struct s_linked_vptr));
@@ -837,6 +899,256 @@ t_pack_molecule *alloc_and_load_pack_molecules(
 	return list_of_molecules_head;
 }
 
+/**
+ * Compile each pack pattern into a match program (see t_pattern_match_program)
+ * [0..num_packing_patterns-1]
+ * The candidate lists point into model_blocks, which is freed with the programs.
+ */
+static t_pattern_match_program *alloc_and_load_pattern_match_programs(
+		INP t_pack_patterns *list_of_pack_patterns,
+		INP int num_packing_patterns, OUTP t_model_blocks **model_blocks,
+		OUTP int *num_models) {
+	int i;
+	t_pattern_match_program *programs;
+
+	programs = (t_pattern_match_program*) my_calloc(num_packing_patterns,
+			sizeof(t_pattern_match_program));
+	*model_blocks = alloc_and_load_model_blocks(num_models);
+
+	for (i = 0; i < num_packing_patterns; i++) {
+		load_pattern_match_steps(&programs[i], &list_of_pack_patterns[i]);
+		load_pattern_match_candidates(&programs[i], &list_of_pack_patterns[i],
+				*model_blocks, *num_models);
+	}
+
+	return programs;
+}
+
+/**
+ * Flatten the connections of every block of pack_pattern into match steps.  
+ * Steps keep the order of the pattern block's connection list, so a match visits 
+ * the netlist in the same order as a walk of the pattern itself.
+ */
+static void load_pattern_match_steps(INOUTP t_pattern_match_program *program,
+		INP t_pack_patterns *pack_pattern) {
+	int i, num_stack, istep;
+	t_pack_pattern_block **pattern_blocks, **stack, *pattern_block;
+	t_pack_pattern_connections *connection;
+	t_pattern_match_step *step;
+
+	program->block_pb_types = (t_pb_type**) my_calloc(pack_pattern->num_blocks,
+			sizeof(t_pb_type*));
+	program->num_steps = (int*) my_calloc(pack_pattern->num_blocks, sizeof(int));
+	program->steps = (t_pattern_match_step**) my_calloc(
+			pack_pattern->num_blocks, sizeof(t_pattern_match_step*));
+	program->match = (t_logical_block**) my_calloc(pack_pattern->num_blocks,
+			sizeof(t_logical_block*));
+
+	/* Find every block of the pattern by walking its connections from the root */
+	pattern_blocks = (t_pack_pattern_block**) my_calloc(pack_pattern->num_blocks,
+			sizeof(t_pack_pattern_block*));
+	stack = (t_pack_pattern_block**) my_malloc(
+			pack_pattern->num_blocks * sizeof(t_pack_pattern_block*));
+	pattern_blocks[pack_pattern->root_block->block_id] = pack_pattern->root_block;
+	stack[0] = pack_pattern->root_block;
+	num_stack = 1;
+	while (num_stack > 0) {
+		pattern_block = stack[--num_stack];
+		connection = pattern_block->connections;
+		while (connection != NULL) {
+			if (pattern_blocks[connection->from_block->block_id] == NULL) {
+				pattern_blocks[connection->from_block->block_id] = connection->from_block;
+				stack[num_stack++] = connection->from_block;
+			}
+			if (pattern_blocks[connection->to_block->block_id] == NULL) {
+				pattern_blocks[connection->to_block->block_id] = connection->to_block;
+				stack[num_stack++] = connection->to_block;
+			}
+			program->num_steps[pattern_block->block_id]++;
+			connection = connection->next;
+		}
+	}
+
+	for (i = 0; i < pack_pattern->num_blocks; i++) {
+		pattern_block = pattern_blocks[i];
+		if (pattern_block == NULL) {
+			continue;
+		}
+		program->block_pb_types[i] = pattern_block->pb_type;
+		program->steps[i] = (t_pattern_match_step*) my_malloc(
+				program->num_steps[i] * sizeof(t_pattern_match_step));
+		istep = 0;
+		connection = pattern_block->connections;
+		while (connection != NULL) {
+			step = &program->steps[i][istep++];
+			if (connection->from_block == pattern_block) {
+				step->is_output = TRUE;
+				step->is_clock = FALSE;
+				step->port = connection->from_pin->port->model_port->index;
+				step->pin = connection->from_pin->pin_number;
+				step->other_block_id = connection->to_block->block_id;
+			} else {
+				assert(connection->to_block == pattern_block);
+				step->is_output = FALSE;
+				step->is_clock = connection->to_pin->port->model_port->is_clock;
+				step->port = connection->to_pin->port->model_port->index;
+				step->pin = connection->to_pin->pin_number;
+				step->other_block_id = connection->from_block->block_id;
+			}
+			connection = connection->next;
+		}
+	}
+
+	free(pattern_blocks);
+	free(stack);
+}
+
+/**
+ * Group the logical blocks by model [0..num_models-1]
+ */
+static t_model_blocks *alloc_and_load_model_blocks(OUTP int *num_models) {
+	int i, imodel, *block_model;
+	t_model_blocks *model_blocks;
+
+	model_blocks = NULL;
+	*num_models = 0;
+	imodel = OPEN;
+	block_model = (int*) my_malloc(num_logical_blocks * sizeof(int));
+	for (i = 0; i < num_logical_blocks; i++) {
+		/* Netlists list blocks of one model together, so try the last model first */
+		if (imodel == OPEN || model_blocks[imodel].model != logical_block[i].model) {
+			for (imodel = 0; imodel < *num_models; imodel++) {
+				if (model_blocks[imodel].model == logical_block[i].model) {
+					break;
+				}
+			}
+			if (imodel == *num_models) {
+				model_blocks = (t_model_blocks*) my_realloc(model_blocks,
+						(*num_models + 1) * sizeof(t_model_blocks));
+				model_blocks[imodel].model = logical_block[i].model;
+				model_blocks[imodel].num_blocks = 0;
+				model_blocks[imodel].blocks = NULL;
+				(*num_models)++;
+			}
+		}
+		block_model[i] = imodel;
+		model_blocks[imodel].num_blocks++;
+	}
+
+	for (imodel = 0; imodel < *num_models; imodel++) {
+		model_blocks[imodel].blocks = (int*) my_malloc(
+				model_blocks[imodel].num_blocks * sizeof(int));
+		model_blocks[imodel].num_blocks = 0;
+	}
+	for (i = 0; i < num_logical_blocks; i++) {
+		imodel = block_model[i];
+		model_blocks[imodel].blocks[model_blocks[imodel].num_blocks++] = i;
+	}
+	free(block_model);
+
+	return model_blocks;
+}
+
+/**
+ * List the logical blocks that can start a match of pack_pattern.  
+ * A block can only implement a primitive of its own model, except for a model without any ports, 
+ * which primitive_type_feasible accepts anywhere.  If the root of the pattern is optional, any 
+ * block can start a match.
+ */
+static void load_pattern_match_candidates(
+		INOUTP t_pattern_match_program *program,
+		INP t_pack_patterns *pack_pattern, INP t_model_blocks *model_blocks,
+		INP int num_models) {
+	int i, imodel, num_matching_models, last_matching_model;
+	t_pb_type *root_pb_type;
+	boolean *is_matching_model;
+
+	if (pack_pattern->is_chain == TRUE) {
+		root_pb_type = pack_pattern->chain_root_pin->parent_node->pb_type;
+	} else {
+		root_pb_type = pack_pattern->root_block->pb_type;
+	}
+
+	is_matching_model = (boolean*) my_calloc(num_models, sizeof(boolean));
+	num_matching_models = 0;
+	last_matching_model = OPEN;
+	for (imodel = 0; imodel < num_models; imodel++) {
+		if ((pack_pattern->is_chain == FALSE
+				&& pack_pattern->is_block_optional[pack_pattern->root_block->block_id] == TRUE)
+				|| model_blocks[imodel].model == root_pb_type->model
+				|| (model_blocks[imodel].model->inputs == NULL
+						&& model_blocks[imodel].model->outputs == NULL)) {
+			is_matching_model[imodel] = TRUE;
+			num_matching_models++;
+			last_matching_model = imodel;
+		}
+	}
+
+	if (num_matching_models == 0) {
+		program->num_candidates = 0;
+		program->candidates = NULL;
+		program->owns_candidates = TRUE;
+	} else if (num_matching_models == 1) {
+		/* Share the model's list */
+		program->num_candidates = model_blocks[last_matching_model].num_blocks;
+		program->candidates = model_blocks[last_matching_model].blocks;
+		program->owns_candidates = FALSE;
+	} else {
+		program->num_candidates = 0;
+		for (imodel = 0; imodel < num_models; imodel++) {
+			if (is_matching_model[imodel]) {
+				program->num_candidates += model_blocks[imodel].num_blocks;
+			}
+		}
+		program->candidates = (int*) my_malloc(
+				program->num_candidates * sizeof(int));
+		program->num_candidates = 0;
+		for (imodel = 0; imodel < num_models; imodel++) {
+			if (is_matching_model[imodel]) {
+				for (i = 0; i < model_blocks[imodel].num_blocks; i++) {
+					program->candidates[program->num_candidates++] =
+							model_blocks[imodel].blocks[i];
+				}
+			}
+		}
+		qsort(program->candidates, program->num_candidates, sizeof(int),
+				compare_int);
+		program->owns_candidates = TRUE;
+	}
+	free(is_matching_model);
+}
+
+static void free_pattern_match_programs(
+		INOUTP t_pattern_match_program *programs,
+		INP t_pack_patterns *list_of_pack_patterns,
+		INP int num_packing_patterns, INOUTP t_model_blocks *model_blocks,
+		INP int num_models) {
+	int i, j;
+
+	for (i = 0; i < num_packing_patterns; i++) {
+		for (j = 0; j < list_of_pack_patterns[i].num_blocks; j++) {
+			free(programs[i].steps[j]);
+		}
+		free(programs[i].steps);
+		free(programs[i].num_steps);
+		free(programs[i].block_pb_types);
+		free(programs[i].match);
+		if (programs[i].owns_candidates) {
+			free(programs[i].candidates);
+		}
+	}
+	free(programs);
+
+	for (i = 0; i < num_models; i++) {
+		free(model_blocks[i].blocks);
+	}
+	free(model_blocks);
+}
+
+static int compare_int(const void *a, const void *b) {
+	return (*(const int *) a - *(const int *) b);
+}
+
 
 static void free_pack_pattern(INOUTP t_pack_pattern_block *pattern_block, INOUTP t_pack_pattern_block **pattern_block_list) {
 	t_pack_pattern_connections *connection, *next;
@@ -865,48 +1177,59 @@ static void free_pack_pattern(INOUTP t_pack_pattern_block *pattern_block, INOUTP
  * Side Effect: If successful, link atom to molecule
  */
 static t_pack_molecule *try_create_molecule(
-		INP t_pack_patterns *list_of_pack_patterns, INP int pack_pattern_index,
+		INP t_pack_patterns *list_of_pack_patterns,
+		INOUTP t_pattern_match_program *program, INP int pack_pattern_index,
 		INP int block_index) {
 	int i;
-	t_pack_molecule *molecule;
+	t_pack_molecule *molecule, trial;
 	struct s_linked_vptr *molecule_linked_list;
 
+	if(list_of_pack_patterns[pack_pattern_index].is_chain == TRUE) {
+		/* A chain pattern extends beyond a single logic block so we must find the block_index that matches with the portion of a chain for this particular logic block */
+		block_index = find_new_root_atom_for_chain(block_index, &list_of_pack_patterns[pack_pattern_index]);
+	}
+	if (block_index == OPEN) {
+		return NULL;
+	}
+
+	/* Match into the program's scratch list, so that a block that does not match allocates nothing */
+	for (i = 0; i < list_of_pack_patterns[pack_pattern_index].num_blocks; i++) {
+		program->match[i] = NULL;
+	}
+	trial.pack_pattern = &list_of_pack_patterns[pack_pattern_index];
+	trial.logical_block_ptrs = program->match;
+	trial.num_ext_inputs = 0;
+	if (try_expand_molecule(&trial, program, block_index,
+			trial.pack_pattern->root_block->block_id) == FALSE) {
+		/* Does not match pattern */
+		return NULL;
+	}
+
+	/* Success! commit module */
 	molecule = (t_pack_molecule*)my_calloc(1, sizeof(t_pack_molecule));
 	molecule->valid = TRUE;
 	molecule->type = MOLECULE_FORCED_PACK;
-	molecule->pack_pattern = &list_of_pack_patterns[pack_pattern_index];
-	molecule->logical_block_ptrs = (t_logical_block **)my_calloc(molecule->pack_pattern->num_blocks,
+	molecule->pack_pattern = trial.pack_pattern;
+	molecule->logical_block_ptrs = (t_logical_block **)my_malloc(molecule->pack_pattern->num_blocks *
 			sizeof(t_logical_block *));
+	memcpy(molecule->logical_block_ptrs, program->match,
+			molecule->pack_pattern->num_blocks * sizeof(t_logical_block *));
 	molecule->num_blocks = list_of_pack_patterns[pack_pattern_index].num_blocks;
 	molecule->root =
 			list_of_pack_patterns[pack_pattern_index].root_block->block_id;
-	molecule->num_ext_inputs = 0;
-
-	if(list_of_pack_patterns[pack_pattern_index].is_chain == TRUE) {
-		/* A chain pattern extends beyond a single logic block so we must find the block_index that matches with the portion of a chain for this particular logic block */
-		block_index = find_new_root_atom_for_chain(block_index, &list_of_pack_patterns[pack_pattern_index]);
-	}
-
-	if (block_index != OPEN && try_expand_molecule(molecule, block_index,
-			molecule->pack_pattern->root_block) == TRUE) {
-		/* Success! commit module */
-		for (i = 0; i < molecule->pack_pattern->num_blocks; i++) {
-			if(molecule->logical_block_ptrs[i] == NULL) {
-				assert(list_of_pack_patterns[pack_pattern_index].is_block_optional[i] == TRUE);
-				continue;
-			}			
-			molecule_linked_list = (struct s_linked_vptr*) my_calloc(1, sizeof(struct s_linked_vptr));
-			molecule_linked_list->data_vptr = (void *) molecule;
-			molecule_linked_list->next =
-					molecule->logical_block_ptrs[i]->packed_molecules;
-			molecule->logical_block_ptrs[i]->packed_molecules =
-					molecule_linked_list;
-		}
-	} else {
-		/* Does not match pattern, free molecule */
-		free(molecule->logical_block_ptrs);
-		free(molecule);
-		molecule = NULL;
+	molecule->num_ext_inputs = trial.num_ext_inputs;
+
+	for (i = 0; i < molecule->pack_pattern->num_blocks; i++) {
+		if(molecule->logical_block_ptrs[i] == NULL) {
+			assert(list_of_pack_patterns[pack_pattern_index].is_block_optional[i] == TRUE);
+			continue;
+		}			
+		molecule_linked_list = (struct s_linked_vptr*) my_calloc(1, sizeof(struct s_linked_vptr));
+		molecule_linked_list->data_vptr = (void *) molecule;
+		molecule_linked_list->next =
+				molecule->logical_block_ptrs[i]->packed_molecules;
+		molecule->logical_block_ptrs[i]->packed_molecules =
+				molecule_linked_list;
 	}
 
 	return molecule;
@@ -917,19 +1240,19 @@ static t_pack_molecule *try_create_molecule(
  * return TRUE if it matches, return FALSE otherwise
  */
 static boolean try_expand_molecule(INOUTP t_pack_molecule *molecule,
-		INP int logical_block_index,
-		INP t_pack_pattern_block *current_pattern_block) {
-	int iport, ipin, inet;
+		INP t_pattern_match_program *program, INP int logical_block_index,
+		INP int pattern_block_id) {
+	int istep, inet;
 	boolean success;
 	boolean is_optional;
 	boolean *is_block_optional;
-	t_pack_pattern_connections *cur_pack_pattern_connection;
+	t_pattern_match_step *step;
 	is_block_optional = molecule->pack_pattern->is_block_optional;
-	is_optional = is_block_optional[current_pattern_block->block_id];
+	is_optional = is_block_optional[pattern_block_id];
 
 		/* If the block in the pattern has already been visited, then there is no need to revisit it */
-	if (molecule->logical_block_ptrs[current_pattern_block->block_id] != NULL) {
-		if (molecule->logical_block_ptrs[current_pattern_block->block_id]
+	if (molecule->logical_block_ptrs[pattern_block_id] != NULL) {
+		if (molecule->logical_block_ptrs[pattern_block_id]
 				!= &logical_block[logical_block_index]) {
 			/* Mismatch between the visited block and the current block implies that the current netlist structure does not match the expected pattern, return whether or not this matters */
 			return is_optional;
@@ -947,57 +1270,34 @@ static boolean try_expand_molecule(INOUTP t_pack_molecule *molecule,
 	}
 
 	if (primitive_type_feasible(logical_block_index,
-			current_pattern_block->pb_type)) {
+			program->block_pb_types[pattern_block_id])) {
 
 		success = TRUE;
 		/* If the primitive types match, store it, expand it and explore neighbouring nodes */
-		molecule->logical_block_ptrs[current_pattern_block->block_id] =
+		molecule->logical_block_ptrs[pattern_block_id] =
 				&logical_block[logical_block_index]; /* store that this node has been visited */
 		molecule->num_ext_inputs +=
 				logical_block[logical_block_index].used_input_pins;
 		
-		cur_pack_pattern_connection = current_pattern_block->connections;
-		while (cur_pack_pattern_connection != NULL && success == TRUE) {
-			if (cur_pack_pattern_connection->from_block
-					== current_pattern_block) {
-				/* find net corresponding to pattern */
-				iport =
-						cur_pack_pattern_connection->from_pin->port->model_port->index;
-				ipin = cur_pack_pattern_connection->from_pin->pin_number;
-				inet =
-						logical_block[logical_block_index].output_nets[iport][ipin];
-
-				/* Check if net is valid */
-				if (inet == OPEN || vpack_net[inet].num_sinks != 1) { /* One fanout assumption */
-					success = is_block_optional[cur_pack_pattern_connection->to_block->block_id];
-				} else {
-					success = try_expand_molecule(molecule,
-							vpack_net[inet].node_block[1],
-							cur_pack_pattern_connection->to_block);
-				}
+		for (istep = 0; istep < program->num_steps[pattern_block_id] && success == TRUE; istep++) {
+			step = &program->steps[pattern_block_id][istep];
+			/* find net corresponding to pattern */
+			if (step->is_output) {
+				inet = logical_block[logical_block_index].output_nets[step->port][step->pin];
+			} else if (step->is_clock) {
+				inet = logical_block[logical_block_index].clock_net;
 			} else {
-				assert(
-						cur_pack_pattern_connection->to_block == current_pattern_block);
-				/* find net corresponding to pattern */
-				iport =
-						cur_pack_pattern_connection->to_pin->port->model_port->index;
-				ipin = cur_pack_pattern_connection->to_pin->pin_number;
-				if (cur_pack_pattern_connection->to_pin->port->model_port->is_clock) {
-					inet = logical_block[logical_block_index].clock_net;
-				} else {
-					inet =
-							logical_block[logical_block_index].input_nets[iport][ipin];
-				}
-				/* Check if net is valid */
-				if (inet == OPEN || vpack_net[inet].num_sinks != 1) { /* One fanout assumption */
-					success = is_block_optional[cur_pack_pattern_connection->from_block->block_id];
-				} else {
-					success = try_expand_molecule(molecule,
-							vpack_net[inet].node_block[0],
-							cur_pack_pattern_connection->from_block);
-				}
+				inet = logical_block[logical_block_index].input_nets[step->port][step->pin];
+			}
+
+			/* Check if net is valid */
+			if (inet == OPEN || vpack_net[inet].num_sinks != 1) { /* One fanout assumption */
+				success = is_block_optional[step->other_block_id];
+			} else {
+				success = try_expand_molecule(molecule, program,
+						vpack_net[inet].node_block[step->is_output ? 1 : 0],
+						step->other_block_id);
 			}
-			cur_pack_pattern_connection = cur_pack_pattern_connection->next;
 		}
 	} else {
 		success = is_optional;
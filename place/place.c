@@ -2,6 +2,13 @@
 #include <stdio.h>
 #include <math.h>
 #include <assert.h>
+#include <time.h>
+#include <string.h>
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#endif
 #include "util.h"
 #include "vpr_types.h"
 #include "globals.h"
@@ -18,6 +25,7 @@
 #include "ReadOptions.h"
 #include "vpr_utils.h"
 #include "place_macro.h"
+#include "place_profile.h"
 
 /************** Types and defines local to place.c ***************************/
 
@@ -100,6 +108,64 @@ typedef struct s_pl_blocks_to_be_moved {
 	t_pl_moved_block * moved_blocks;
 }t_pl_blocks_to_be_moved;
 
+/* Convergence tracking for the ADAPTIVE_SCHED annealing schedule.        *
+ * num_temps: number of temperatures recorded so far.                     *
+ * bb_cost, delay_cost: costs at the end of the last exit_window + 1      *
+ *                      temperatures, indexed by num_temps modulo         *
+ *                      exit_window + 1.  The delay cost is used rather   *
+ *                      than the timing cost since the latter changes     *
+ *                      scale whenever the criticalities are recomputed.  *
+ * success_rat: acceptance rate of the last temperature; it sets the      *
+ *              number of moves tried at the next one.                    */
+typedef struct s_anneal_history {
+	int num_temps;
+	float bb_cost[MAX_ANNEAL_EXIT_WINDOW + 1];
+	float delay_cost[MAX_ANNEAL_EXIT_WINDOW + 1];
+	float success_rat;
+}t_anneal_history;
+
+/* Annealing state saved in a placement checkpoint, taken at the top of  *
+ * a temperature.  Together with the block locations (and criticalities  *
+ * for the timing-driven placers) this is everything try_place needs to  *
+ * continue the anneal exactly as the original run did.                  *
+ * num_blocks .. place_algorithm: identify the netlist and device; a     *
+ *               checkpoint is rejected if any of them differ.           *
+ * rng_seed: the random number generator is reseeded with this value     *
+ *           right after the checkpoint is saved or restored.            *
+ * num_temps: number of temperatures completed so far.                   *
+ * anneal_history: convergence state of the adaptive schedule.           *
+ * has_block_die: TRUE if a die partition (block_die) follows the blocks.*/
+typedef struct s_place_checkpoint {
+	int num_blocks;
+	int num_nets;
+	int nx;
+	int ny;
+	int place_algorithm;
+	int rng_seed;
+	float t;
+	float rlim;
+	float crit_exponent;
+	float cost;
+	float bb_cost;
+	float timing_cost;
+	float delay_cost;
+	float place_delay_value;
+	float inverse_prev_bb_cost;
+	float inverse_prev_timing_cost;
+	int tot_iter;
+	int num_temps;
+	int moves_since_cost_recompute;
+	int outer_crit_iter_count;
+	int num_swap_rejected;
+	int num_swap_accepted;
+	int num_swap_aborted;
+	int num_ts_called;
+	t_anneal_history anneal_history;
+	int has_block_die;
+}t_place_checkpoint;
+
+#define PLACE_CHECKPOINT_MAGIC "VPRPLCK2" /* first 8 bytes of a checkpoint file */
+
 
 /********************** Variables local to place.c ***************************/
 
@@ -184,6 +250,21 @@ static int num_pl_macros;
 /* These file-scoped variables keep track of the number of swaps       *
  * rejected, accepted or aborted. The total number of swap attempts    *
  * is the sum of the three number.                                     */
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+/* Die (region between two interposer cuts, counted from the bottom) that *
+ * each block is confined to during two-phase placement.  OPEN means the  *
+ * block may go anywhere (fixed blocks and placement macro members).      *
+ * NULL when the whole chip is annealed as one problem.                   */
+static int *block_die = NULL; /* [0..num_blocks-1] */
+
+/* Number of improvement passes the die partitioner makes over the blocks */
+#define MAX_DIE_PARTITION_PASSES 10
+
+/* Number of times the die partitioner reweights over-budget cuts and     *
+ * reruns its improvement passes before giving up on the wire budget      */
+#define MAX_DIE_BUDGET_ROUNDS 10
+#endif
+
 static int num_swap_rejected = 0;
 static int num_swap_accepted = 0;
 static int num_swap_aborted = 0;
@@ -270,6 +351,18 @@ static void update_rlim(float *rlim, float success_rat);
 static int exit_crit(float t, float cost,
 		struct s_annealing_sched annealing_sched);
 
+static int get_adaptive_move_lim(int move_lim, float success_rat);
+
+static void record_anneal_history(t_anneal_history *anneal_history,
+		float bb_cost, float delay_cost, float success_rat,
+		struct s_annealing_sched annealing_sched);
+
+static boolean anneal_converged(t_anneal_history *anneal_history,
+		struct s_annealing_sched annealing_sched);
+
+static int estimate_remaining_temps(float t, float cost, float success_rat,
+		struct s_annealing_sched annealing_sched);
+
 static int count_connections(void);
 
 static double get_std_dev(int n, double sum_x_squared, double av_x);
@@ -304,6 +397,54 @@ static double get_net_wirelength_estimate(int inet, struct s_bb *bbptr);
 
 static void free_try_swap_arrays(void);
 
+static void set_checkpoint_state(t_place_checkpoint *state,
+		enum e_place_algorithm place_algorithm, int rng_seed, float t,
+		float rlim, float crit_exponent, float cost, float bb_cost,
+		float timing_cost, float delay_cost, float place_delay_value,
+		float inverse_prev_bb_cost, float inverse_prev_timing_cost,
+		int tot_iter, int num_temps, int moves_since_cost_recompute,
+		int outer_crit_iter_count, t_anneal_history *anneal_history);
+
+static void save_place_checkpoint(const char *fname, t_place_checkpoint *state);
+
+static void load_place_checkpoint(const char *fname, t_place_checkpoint *state,
+		enum e_place_algorithm place_algorithm, float **saved_crit);
+
+static void restore_checkpoint_criticalities(float *saved_crit);
+
+static int fork_continuations(int num_forks, int *child_pids);
+
+static void wait_for_continuations(int num_forks, int *child_pids);
+
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+static int get_die_of_row(int y);
+
+static void get_die_row_range(int die, int *y_min, int *y_max);
+
+static int count_interposer_crossings(int *nets_crossing_cut);
+
+static int get_interposer_wire_budget(int width_fac);
+
+static void print_interposer_crossings(const char *stage, int width_fac);
+
+static int count_die_partition_crossings(int *nets_crossing_cut);
+
+static int get_die_move_gain(int iblk, int to_die, int *die_cost,
+		int *net_visited, int visit_stamp);
+
+static int improve_die_partition(int *order, boolean *locked,
+		int **die_capacity, int **die_usage, int *die_cost, int *net_visited,
+		int *visit_stamp);
+
+static void order_blocks_by_connectivity(int *order);
+
+static void partition_blocks_into_dies(int width_fac);
+
+static void place_blocks_in_dies(void);
+
+static boolean moved_blocks_leave_die(void);
+#endif
+
 
 /*****************************************************************************/
 /* RESEARCH TODO: Bounding Box and rlim need to be redone for heterogeneous to prevent a QoR penalty */
@@ -333,6 +474,17 @@ void try_place(struct s_placer_opts placer_opts,
 	float abort_rate;
 	char msg[BUFSIZE];
 	t_slack * slacks = NULL;
+	int num_temps, fork_index, *child_pids;
+	boolean checkpoint_saved, just_resumed;
+	t_place_checkpoint checkpoint_state;
+	float *saved_crit;
+	char fork_checkpoint_name[BUFSIZE];
+	char *checkpoint_file;
+	int temp_move_lim, skipped_temps;
+	boolean converged;
+	t_anneal_history anneal_history;
+	double profile_ticks;
+	char profile_name[BUFSIZE];
 
 	/* Allocated here because it goes into timing critical code where each memory allocation is expensive */
 
@@ -349,7 +501,8 @@ void try_place(struct s_placer_opts placer_opts,
 			|| placer_opts.enable_timing_computations) {
 		/*do this before the initial placement to avoid messing up the initial placement */
 		slacks = alloc_lookups_and_criticalities(chan_width_dist, router_opts,
-				det_routing_arch, segment_inf, timing_inf, &net_delay, directs, num_directs);
+				det_routing_arch, segment_inf, timing_inf, &net_delay, directs, num_directs,
+				placer_opts.delay_cache_file);
 
 		remember_net_delay_original_ptr = net_delay;
 
@@ -403,7 +556,20 @@ void try_place(struct s_placer_opts placer_opts,
 			&old_region_occ_x, &old_region_occ_y, placer_opts,
 			directs, num_directs);
 
-	initial_placement(placer_opts.pad_loc_type, placer_opts.pad_loc_file);
+	saved_crit = NULL;
+	if (placer_opts.resume_file != NULL) {
+		load_place_checkpoint(placer_opts.resume_file, &checkpoint_state,
+				placer_opts.place_algorithm, &saved_crit);
+	} else {
+		initial_placement(placer_opts.pad_loc_type, placer_opts.pad_loc_file);
+
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+		if (placer_opts.die_partition && num_cuts > 0) {
+			partition_blocks_into_dies(width_fac);
+		}
+#endif
+	}
+
 	init_draw_coords((float) width_fac);
 
 	/* Storing the number of pins on each type of block makes the swap routine *
@@ -479,6 +645,24 @@ void try_place(struct s_placer_opts placer_opts,
 		inverse_prev_bb_cost = 0;
 	}
 
+	if (placer_opts.resume_file != NULL) {
+		/* Carry on with the criticalities and the accumulated costs of the *
+		 * checkpointed run, not ones freshly computed from the placement.  */
+		if (saved_crit != NULL) {
+			restore_checkpoint_criticalities(saved_crit);
+			comp_td_costs(&timing_cost, &delay_cost); /* reloads point_to_point_*_cost */
+		}
+		cost = checkpoint_state.cost;
+		bb_cost = checkpoint_state.bb_cost;
+		timing_cost = checkpoint_state.timing_cost;
+		delay_cost = checkpoint_state.delay_cost;
+		place_delay_value = checkpoint_state.place_delay_value;
+		crit_exponent = checkpoint_state.crit_exponent;
+		inverse_prev_bb_cost = checkpoint_state.inverse_prev_bb_cost;
+		inverse_prev_timing_cost = checkpoint_state.inverse_prev_timing_cost;
+		outer_crit_iter_count = checkpoint_state.outer_crit_iter_count;
+	}
+
 	move_lim = (int) (annealing_sched.inner_num * pow(num_blocks, 1.3333));
 
 	if (placer_opts.inner_loop_recompute_divider != 0)
@@ -503,13 +687,67 @@ void try_place(struct s_placer_opts placer_opts,
 	final_rlim = 1;
 	inverse_delta_rlim = 1 / (first_rlim - final_rlim);
 
-	t = starting_t(&cost, &bb_cost, &timing_cost,
-			old_region_occ_x, old_region_occ_y,
-			annealing_sched, move_lim, rlim,
-			placer_opts.place_algorithm, placer_opts.timing_tradeoff,
-			inverse_prev_bb_cost, inverse_prev_timing_cost, &delay_cost);
-	tot_iter = 0;
-	moves_since_cost_recompute = 0;
+	fork_index = 0;
+	child_pids = NULL;
+	checkpoint_file = placer_opts.checkpoint_file;
+	if (placer_opts.resume_file != NULL) {
+		t = checkpoint_state.t;
+		rlim = checkpoint_state.rlim;
+		tot_iter = checkpoint_state.tot_iter;
+		num_temps = checkpoint_state.num_temps;
+		moves_since_cost_recompute = checkpoint_state.moves_since_cost_recompute;
+		anneal_history = checkpoint_state.anneal_history;
+
+		if (placer_opts.num_forks > 1) {
+			child_pids = (int *) my_malloc(placer_opts.num_forks * sizeof(int));
+			fork_index = fork_continuations(placer_opts.num_forks, child_pids);
+		}
+		/* Each forked continuation checkpoints to its own file, named    *
+		 * after the checkpoint file if there is one and after the resume  *
+		 * file otherwise; its end-of-anneal state goes to the same file.  */
+		if (fork_index > 0) {
+			sprintf(fork_checkpoint_name, "%s.fork%d",
+					(checkpoint_file != NULL ? checkpoint_file : placer_opts.resume_file),
+					fork_index);
+			if (checkpoint_file != NULL) {
+				checkpoint_file = fork_checkpoint_name;
+			}
+		}
+		/* Same reseed as the run that saved the checkpoint; each forked  *
+		 * continuation gets its own sequence. */
+		my_srandom(checkpoint_state.rng_seed + fork_index);
+
+		/* Don't save the state we just restored straight back out, in    *
+		 * periodic mode either: that would also reseed without the fork  *
+		 * index and make every continuation draw the same moves.          */
+		checkpoint_saved = (boolean) (t <= placer_opts.checkpoint_t);
+		just_resumed = TRUE;
+	} else {
+		t = starting_t(&cost, &bb_cost, &timing_cost,
+				old_region_occ_x, old_region_occ_y,
+				annealing_sched, move_lim, rlim,
+				placer_opts.place_algorithm, placer_opts.timing_tradeoff,
+				inverse_prev_bb_cost, inverse_prev_timing_cost, &delay_cost);
+		tot_iter = 0;
+		num_temps = 0;
+		moves_since_cost_recompute = 0;
+		checkpoint_saved = FALSE;
+		just_resumed = FALSE;
+		memset(&anneal_history, 0, sizeof(t_anneal_history));
+	}
+	converged = FALSE;
+	skipped_temps = 0;
+
+	/* Profile the anneal proper; each forked continuation gets its own trace. */
+	profile_ticks = 0.;
+	if (placer_opts.profile_file != NULL) {
+		if (fork_index > 0) {
+			sprintf(profile_name, "%s.fork%d", placer_opts.profile_file, fork_index);
+			alloc_place_profile(profile_name);
+		} else {
+			alloc_place_profile(placer_opts.profile_file);
+		}
+	}
 	vpr_printf(TIO_MESSAGE_INFO, "Initial placement cost: %g bb_cost: %g td_cost: %g delay_cost: %g\n",
 				cost, bb_cost, timing_cost, delay_cost);
 	vpr_printf(TIO_MESSAGE_INFO, "\n");
@@ -531,7 +769,25 @@ void try_place(struct s_placer_opts placer_opts,
 		cost, bb_cost, timing_cost, delay_cost, width_fac);
 	update_screen(MAJOR, msg, PLACEMENT, FALSE);
 
-	while (exit_crit(t, cost, annealing_sched) == 0) {
+	while (converged == FALSE && exit_crit(t, cost, annealing_sched) == 0) {
+
+		/* Checkpoints are taken at the top of a temperature, and the random *
+		 * number generator is reseeded so a resumed run draws the same moves.*
+		 * The seed includes the fork index so continuations stay apart.     */
+		if (checkpoint_file != NULL && just_resumed == FALSE
+				&& (placer_opts.checkpoint_t < 0
+						|| (checkpoint_saved == FALSE && t <= placer_opts.checkpoint_t))) {
+			set_checkpoint_state(&checkpoint_state, placer_opts.place_algorithm,
+					placer_opts.seed + num_temps + fork_index, t, rlim, crit_exponent, cost,
+					bb_cost, timing_cost, delay_cost, place_delay_value,
+					inverse_prev_bb_cost, inverse_prev_timing_cost, tot_iter,
+					num_temps, moves_since_cost_recompute, outer_crit_iter_count,
+					&anneal_history);
+			save_place_checkpoint(checkpoint_file, &checkpoint_state);
+			my_srandom(checkpoint_state.rng_seed);
+			checkpoint_saved = TRUE;
+		}
+		just_resumed = FALSE;
 
 		if (placer_opts.place_algorithm == NET_TIMING_DRIVEN_PLACE
 				|| placer_opts.place_algorithm == PATH_TIMING_DRIVEN_PLACE) {
@@ -545,6 +801,11 @@ void try_place(struct s_placer_opts placer_opts,
 		sum_of_squares = 0.;
 		success_sum = 0;
 
+		temp_move_lim = move_lim;
+		if (annealing_sched.type == ADAPTIVE_SCHED && anneal_history.num_temps > 0) {
+			temp_move_lim = get_adaptive_move_lim(move_lim, anneal_history.success_rat);
+		}
+
 		if (placer_opts.place_algorithm == NET_TIMING_DRIVEN_PLACE
 				|| placer_opts.place_algorithm == PATH_TIMING_DRIVEN_PLACE) {
 
@@ -553,6 +814,8 @@ void try_place(struct s_placer_opts placer_opts,
 #ifdef VERBOSE
 				vpr_printf(TIO_MESSAGE_INFO, "Outer loop recompute criticalities\n");
 #endif
+				if (place_profiling)
+					profile_ticks = get_place_profile_ticks();
 				place_delay_value = delay_cost / num_connections;
 
 				if (placer_opts.place_algorithm == NET_TIMING_DRIVEN_PLACE)
@@ -567,6 +830,8 @@ void try_place(struct s_placer_opts placer_opts,
 				/*recompute costs from scratch, based on new criticalities */
 				comp_td_costs(&timing_cost, &delay_cost);
 				outer_crit_iter_count = 0;
+				if (place_profiling)
+					add_place_profile_phase(PLACE_PHASE_OUTER_TIMING, profile_ticks);
 			}
 			outer_crit_iter_count++;
 
@@ -579,7 +844,7 @@ void try_place(struct s_placer_opts placer_opts,
 
 		inner_crit_iter_count = 1;
 
-		for (inner_iter = 0; inner_iter < move_lim; inner_iter++) {
+		for (inner_iter = 0; inner_iter < temp_move_lim; inner_iter++) {
 			swap_result = try_swap(t, &cost, &bb_cost, &timing_cost, rlim,
 					old_region_occ_x,
 					old_region_occ_y, 
@@ -610,12 +875,14 @@ void try_place(struct s_placer_opts placer_opts,
 				 * We do this only once in a while, since it is expensive.
 				 */
 				if (inner_crit_iter_count >= inner_recompute_limit
-						&& inner_iter != move_lim - 1) { /*on last iteration don't recompute */
+						&& inner_iter != temp_move_lim - 1) { /*on last iteration don't recompute */
 
 					inner_crit_iter_count = 0;
 #ifdef VERBOSE
 					vpr_printf(TIO_MESSAGE_TRACE, "Inner loop recompute criticalities\n");
 #endif
+					if (place_profiling)
+						profile_ticks = get_place_profile_ticks();
 					if (placer_opts.place_algorithm
 							== NET_TIMING_DRIVEN_PLACE) {
 					    /* Use a constant delay per connection as the delay estimate, rather than
@@ -634,6 +901,8 @@ void try_place(struct s_placer_opts placer_opts,
 					do_timing_analysis(slacks, FALSE, FALSE, FALSE);
 					load_criticalities(slacks, crit_exponent);
 					comp_td_costs(&timing_cost, &delay_cost);
+					if (place_profiling)
+						add_place_profile_phase(PLACE_PHASE_INNER_TIMING, profile_ticks);
 				}
 				inner_crit_iter_count++;
 			}
@@ -650,7 +919,7 @@ void try_place(struct s_placer_opts placer_opts,
 		 * error checks failing because the cost is different from what   *
 		 * you get when you recompute from scratch.                       */
 
-		moves_since_cost_recompute += move_lim;
+		moves_since_cost_recompute += temp_move_lim;
 		if (moves_since_cost_recompute > MAX_MOVES_BEFORE_RECOMPUTE) {
 			new_bb_cost = recompute_bb_cost();
 			if (fabs(new_bb_cost - bb_cost) > bb_cost * ERROR_TOL) {
@@ -683,8 +952,8 @@ void try_place(struct s_placer_opts placer_opts,
 			moves_since_cost_recompute = 0;
 		}
 
-		tot_iter += move_lim;
-		success_rat = ((float) success_sum) / move_lim;
+		tot_iter += temp_move_lim;
+		success_rat = ((float) success_sum) / temp_move_lim;
 		if (success_sum == 0) {
 			av_cost = cost;
 			av_bb_cost = bb_cost;
@@ -708,6 +977,11 @@ void try_place(struct s_placer_opts placer_opts,
 				critical_path_delay, success_rat, std_dev, rlim, crit_exponent, tot_iter, t / oldt);
 #endif
 
+		if (place_profiling) {
+			end_place_profile_temperature(num_temps, oldt, av_cost, av_bb_cost,
+					av_timing_cost, success_rat, rlim);
+		}
+
 		sprintf(msg, "Cost: %g  BB Cost %g  TD Cost %g  Temperature: %g",
 				cost, bb_cost, timing_cost, t);
 		update_screen(MINOR, msg, PLACEMENT, FALSE);
@@ -720,11 +994,56 @@ void try_place(struct s_placer_opts placer_opts,
 							- placer_opts.td_place_exp_first)
 					+ placer_opts.td_place_exp_first;
 		}
+
+		if (annealing_sched.type == ADAPTIVE_SCHED) {
+			record_anneal_history(&anneal_history, bb_cost, delay_cost,
+					success_rat, annealing_sched);
+			/* A flat cost only means convergence once the range limit has *
+			 * shrunk all the way; before that it is still the hot phase.  */
+			if (rlim <= final_rlim
+					&& anneal_converged(&anneal_history, annealing_sched)) {
+				converged = TRUE;
+				skipped_temps = estimate_remaining_temps(t, cost, success_rat,
+						annealing_sched);
+			}
+		}
 #ifdef VERBOSE
 		if (getEchoEnabled()) {
 			print_clb_placement("first_iteration_clb_placement.echo");
 		}
 #endif
+		num_temps++;
+	}
+
+	if (converged) {
+		vpr_printf(TIO_MESSAGE_INFO, "\n");
+		vpr_printf(TIO_MESSAGE_INFO, "Adaptive annealing converged after %d temperatures (%d moves): bb_cost and delay_cost improved by less than %g%% over the last %d temperatures.\n",
+				num_temps, tot_iter, 100. * annealing_sched.exit_improvement,
+				annealing_sched.exit_window);
+		vpr_printf(TIO_MESSAGE_INFO, "The automatic schedule would have run about %d more temperatures (%g moves).\n",
+				skipped_temps, (double) skipped_temps * move_lim);
+	}
+
+	if (child_pids != NULL) {
+		/* Each continuation reports where its anneal ended.  Forked ones   *
+		 * save that state for a later --place_resume and stop here; the    *
+		 * original process waits for them and carries on with the flow.    */
+		vpr_printf(TIO_MESSAGE_INFO, "Placement continuation %d finished annealing: cost %g, bb_cost %g, td_cost %g.\n",
+				fork_index, cost, bb_cost, timing_cost);
+		if (fork_index > 0) {
+			set_checkpoint_state(&checkpoint_state, placer_opts.place_algorithm,
+					placer_opts.seed + num_temps + fork_index, t, rlim, crit_exponent, cost,
+					bb_cost, timing_cost, delay_cost, place_delay_value,
+					inverse_prev_bb_cost, inverse_prev_timing_cost, tot_iter,
+					num_temps, moves_since_cost_recompute, outer_crit_iter_count,
+					&anneal_history);
+			save_place_checkpoint(fork_checkpoint_name, &checkpoint_state);
+			free_place_profile();
+			fflush(NULL);
+			exit(0);
+		}
+		wait_for_continuations(placer_opts.num_forks, child_pids);
+		free(child_pids);
 	}
 
 	t = 0; /* freeze out */
@@ -745,6 +1064,8 @@ void try_place(struct s_placer_opts placer_opts,
 #ifdef VERBOSE
 			vpr_printf(TIO_MESSAGE_INFO, "Outer loop recompute criticalities\n");
 #endif
+			if (place_profiling)
+				profile_ticks = get_place_profile_ticks();
 			place_delay_value = delay_cost / num_connections;
 
 			if (placer_opts.place_algorithm == NET_TIMING_DRIVEN_PLACE)
@@ -757,6 +1078,8 @@ void try_place(struct s_placer_opts placer_opts,
 			/*recompute criticaliies */
 			comp_td_costs(&timing_cost, &delay_cost);
 			outer_crit_iter_count = 0;
+			if (place_profiling)
+				add_place_profile_phase(PLACE_PHASE_OUTER_TIMING, profile_ticks);
 		}
 		outer_crit_iter_count++;
 
@@ -792,6 +1115,8 @@ void try_place(struct s_placer_opts placer_opts,
 #ifdef VERBOSE
 					vpr_printf(TIO_MESSAGE_TRACE, "Inner loop recompute criticalities\n");
 #endif
+					if (place_profiling)
+						profile_ticks = get_place_profile_ticks();
 					if (placer_opts.place_algorithm
 							== NET_TIMING_DRIVEN_PLACE) {
 						place_delay_value = delay_cost / num_connections;
@@ -803,6 +1128,8 @@ void try_place(struct s_placer_opts placer_opts,
 					do_timing_analysis(slacks, FALSE, FALSE, FALSE);
 					load_criticalities(slacks, crit_exponent);
 					comp_td_costs(&timing_cost, &delay_cost);
+					if (place_profiling)
+						add_place_profile_phase(PLACE_PHASE_INNER_TIMING, profile_ticks);
 				}
 				inner_crit_iter_count++;
 			}
@@ -839,6 +1166,12 @@ void try_place(struct s_placer_opts placer_opts,
 			" ", success_rat, std_dev, rlim, crit_exponent, tot_iter);
 #endif
 
+	if (place_profiling) {
+		end_place_profile_temperature(num_temps, t, av_cost, av_bb_cost,
+				av_timing_cost, success_rat, rlim);
+		free_place_profile();
+	}
+
 	// TODO:  
 	// 1. print a message about number of aborted moves.
 	// 2. add some subroutine hierarchy!  Too big!
@@ -898,6 +1231,10 @@ void try_place(struct s_placer_opts placer_opts,
 			cost, bb_cost, timing_cost, delay_cost);
 	update_screen(MAJOR, msg, PLACEMENT, FALSE);
 	 
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+	print_interposer_crossings("Final placement", width_fac);
+#endif
+
 	// Print out swap statistics
 	total_swap_attempts = num_swap_rejected + num_swap_accepted + num_swap_aborted;
 	reject_rate = num_swap_rejected / total_swap_attempts;
@@ -925,6 +1262,13 @@ void try_place(struct s_placer_opts placer_opts,
 	}
 
 	free_try_swap_arrays();
+
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+	if (block_die != NULL) {
+		free(block_die);
+		block_die = NULL;
+	}
+#endif
 }
 
 static int count_connections() {
@@ -1042,6 +1386,93 @@ static int exit_crit(float t, float cost,
 	}
 }
 
+static int get_adaptive_move_lim(int move_lim, float success_rat) {
+
+	/* Returns the number of moves the adaptive schedule tries at the next *
+	 * temperature, given the acceptance rate of the last one.  The anneal *
+	 * makes most of its progress while a moderate fraction of moves is    *
+	 * accepted.  When nearly every move is accepted the placement is still *
+	 * essentially random (and the temperature halves anyway), and when    *
+	 * almost none are, most moves are wasted, so fewer are tried there.   */
+
+	int adaptive_move_lim;
+
+	if (success_rat > 0.96) {
+		adaptive_move_lim = move_lim / 4;
+	} else if (success_rat > 0.8 || success_rat < 0.05) {
+		adaptive_move_lim = move_lim / 2;
+	} else {
+		adaptive_move_lim = move_lim;
+	}
+	return std::max(adaptive_move_lim, 1);
+}
+
+static void record_anneal_history(t_anneal_history *anneal_history,
+		float bb_cost, float delay_cost, float success_rat,
+		struct s_annealing_sched annealing_sched) {
+
+	/* Records the costs at the end of a temperature. */
+
+	int islot;
+
+	islot = anneal_history->num_temps % (annealing_sched.exit_window + 1);
+	anneal_history->bb_cost[islot] = bb_cost;
+	anneal_history->delay_cost[islot] = delay_cost;
+	anneal_history->success_rat = success_rat;
+	anneal_history->num_temps++;
+}
+
+static boolean anneal_converged(t_anneal_history *anneal_history,
+		struct s_annealing_sched annealing_sched) {
+
+	/* Returns TRUE if neither the bb cost nor the delay cost improved by   *
+	 * more than exit_improvement (relative) over the last exit_window      *
+	 * temperatures.  A zero cost (e.g. the delay cost of a bounding box    *
+	 * placement) can't improve, and counts as converged.                   */
+
+	int inew, iold;
+	float bb_gain, delay_gain;
+
+	if (anneal_history->num_temps <= annealing_sched.exit_window) {
+		return (FALSE);
+	}
+
+	inew = (anneal_history->num_temps - 1) % (annealing_sched.exit_window + 1);
+	iold = anneal_history->num_temps % (annealing_sched.exit_window + 1);
+
+	bb_gain = 0;
+	if (anneal_history->bb_cost[iold] > 0) {
+		bb_gain = (anneal_history->bb_cost[iold] - anneal_history->bb_cost[inew])
+				/ anneal_history->bb_cost[iold];
+	}
+	delay_gain = 0;
+	if (anneal_history->delay_cost[iold] > 0) {
+		delay_gain = (anneal_history->delay_cost[iold]
+				- anneal_history->delay_cost[inew])
+				/ anneal_history->delay_cost[iold];
+	}
+
+	return (boolean) (bb_gain <= annealing_sched.exit_improvement
+			&& delay_gain <= annealing_sched.exit_improvement);
+}
+
+static int estimate_remaining_temps(float t, float cost, float success_rat,
+		struct s_annealing_sched annealing_sched) {
+
+	/* Estimates how many more temperatures the automatic schedule would   *
+	 * have run, by cooling at the last acceptance rate until its exit     *
+	 * criterion is met.  Only used to report the runtime saved.           */
+
+	int num_remaining;
+
+	num_remaining = 0;
+	while (exit_crit(t, cost, annealing_sched) == 0 && num_remaining < 10000) {
+		update_t(&t, 0., 1., success_rat, annealing_sched);
+		num_remaining++;
+	}
+	return (num_remaining);
+}
+
 static float starting_t(float *cost_ptr, float *bb_cost_ptr,
 		float *timing_cost_ptr, float **old_region_occ_x,
 		float **old_region_occ_y, 
@@ -1147,6 +1578,8 @@ static int setup_blocks_affected(int b_from, int x_to, int y_to, int z_to) {
 		// Does not allow a swap with a macro yet
 		get_imacro_from_iblk(&imacro, b_to, pl_macros, num_pl_macros);
 		if (imacro != -1) {
+			if (place_profiling)
+				add_place_profile_abort(PLACE_ABORT_SWAP_WITH_MACRO);
 			abort_swap = TRUE;
 			return (abort_swap);
 		}
@@ -1230,6 +1663,8 @@ static int find_affected_blocks(int b_from, int x_to, int y_to, int z_to) {
 			
 			// Make sure that the swap_to location is still on the chip
 			if (curr_x_to < 1 || curr_x_to > nx || curr_y_to < 1 || curr_y_to > ny || curr_z_to < 0) {
+				if (place_profiling)
+					add_place_profile_abort(PLACE_ABORT_MACRO_OFF_CHIP);
 				abort_swap = TRUE;
 			} else {
 				curr_b_to = grid[curr_x_to][curr_y_to].blocks[curr_z_to];
@@ -1268,9 +1703,19 @@ static enum swap_result try_swap(float t, float *cost, float *bb_cost, float *ti
 	float delta_c, bb_delta_c, timing_delta_c, delay_delta_c;
 	int inet, iblk, bnum, iblk_pin, inet_affected;
 	int abort_swap = FALSE;
+	int imacro;
+	double profile_ticks;
+	t_type_ptr from_type;
 
 	num_ts_called ++;
 
+	/* With --place_profile, the time spent in each phase of the move is  *
+	 * charged as it completes, and the outcome counted by block type.    */
+	imacro = -1;
+	profile_ticks = 0.;
+	if (place_profiling)
+		profile_ticks = get_place_profile_ticks();
+
 	/* I'm using negative values of temp_net_cost as a flag, so DO NOT   *
 	 * use cost functions that can go negative.                          */
 
@@ -1295,15 +1740,26 @@ static enum swap_result try_swap(float t, float *cost, float *bb_cost, float *ti
 	x_from = block[b_from].x;
 	y_from = block[b_from].y;
 	z_from = block[b_from].z;
+	from_type = block[b_from].type;
+	if (place_profiling)
+		get_imacro_from_iblk(&imacro, b_from, pl_macros, num_pl_macros);
 
 	if (!find_to(x_from, y_from, block[b_from].type, rlim, &x_to,
-			&y_to))
+			&y_to)) {
+		if (place_profiling) {
+			add_place_profile_phase(PLACE_PHASE_FIND_TO, profile_ticks);
+			add_place_profile_move(from_type, (boolean) (imacro != -1),
+					PLACE_MOVE_NO_TARGET);
+		}
 		return REJECTED;
+	}
 
 	z_to = 0;
 	if (grid[x_to][y_to].type->capacity > 1) {
 		z_to = my_irand(grid[x_to][y_to].type->capacity - 1);
 	}
+	if (place_profiling)
+		profile_ticks = add_place_profile_phase(PLACE_PHASE_FIND_TO, profile_ticks);
 
 	/* Make the switch in order to make computing the new bounding *
 	 * box simpler.  If the cost increase is too high, switch them *
@@ -1321,6 +1777,17 @@ static enum swap_result try_swap(float t, float *cost, float *bb_cost, float *ti
 	
 	abort_swap = find_affected_blocks(b_from, x_to, y_to, z_to);
 
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+	/* In two-phase placement no block may leave the die it was assigned. */
+	if (abort_swap == FALSE && block_die != NULL) {
+		abort_swap = moved_blocks_leave_die();
+		if (abort_swap && place_profiling)
+			add_place_profile_abort(PLACE_ABORT_DIE_BOUNDARY);
+	}
+#endif
+	if (place_profiling)
+		profile_ticks = add_place_profile_phase(PLACE_PHASE_AFFECTED_BLOCKS, profile_ticks);
+
 	if (abort_swap == FALSE) {
 
 		// Find all the nets affected by this swap
@@ -1365,6 +1832,8 @@ static enum swap_result try_swap(float t, float *cost, float *bb_cost, float *ti
 			temp_net_cost[inet] = get_net_cost(inet, &ts_bb_coord_new[inet]);
 			bb_delta_c += temp_net_cost[inet] - net_cost[inet];
 		}
+		if (place_profiling)
+			profile_ticks = add_place_profile_phase(PLACE_PHASE_BB_UPDATE, profile_ticks);
 
 		if (place_algorithm == NET_TIMING_DRIVEN_PLACE
 				|| place_algorithm == PATH_TIMING_DRIVEN_PLACE) {
@@ -1373,6 +1842,8 @@ static enum swap_result try_swap(float t, float *cost, float *bb_cost, float *ti
 			 *relation to 1*/
 
 			comp_delta_td_cost(&timing_delta_c, &delay_delta_c);
+			if (place_profiling)
+				profile_ticks = add_place_profile_phase(PLACE_PHASE_TD_DELTA, profile_ticks);
 
 			delta_c = (1 - timing_tradeoff) * bb_delta_c * inverse_prev_bb_cost
 					+ timing_tradeoff * timing_delta_c * inverse_prev_timing_cost;
@@ -1382,6 +1853,8 @@ static enum swap_result try_swap(float t, float *cost, float *bb_cost, float *ti
 
 		/* 1 -> move accepted, 0 -> rejected. */
 		keep_switch = assess_swap(delta_c, t);
+		if (place_profiling)
+			profile_ticks = add_place_profile_phase(PLACE_PHASE_ASSESS, profile_ticks);
 		
 		if (keep_switch == ACCEPTED) {
 			*cost = *cost + delta_c;
@@ -1394,7 +1867,11 @@ static enum swap_result try_swap(float t, float *cost, float *bb_cost, float *ti
 				*timing_cost = *timing_cost + timing_delta_c;
 				*delay_cost = *delay_cost + delay_delta_c;
 
+				if (place_profiling)
+					profile_ticks = add_place_profile_phase(PLACE_PHASE_COMMIT, profile_ticks);
 				update_td_cost();
+				if (place_profiling)
+					profile_ticks = add_place_profile_phase(PLACE_PHASE_UPDATE_TD_COST, profile_ticks);
 			}
 
 			/* update net cost functions and reset flags. */
@@ -1436,6 +1913,12 @@ static enum swap_result try_swap(float t, float *cost, float *bb_cost, float *ti
 			
 			} // Finish updating clb for all blocks
 
+			if (place_profiling) {
+				add_place_profile_phase(PLACE_PHASE_COMMIT, profile_ticks);
+				add_place_profile_move(from_type, (boolean) (imacro != -1),
+						PLACE_MOVE_ACCEPTED);
+			}
+
 		} else { /* Move was rejected.  */
 
 			/* Reset the net cost function flags first. */
@@ -1453,6 +1936,12 @@ static enum swap_result try_swap(float t, float *cost, float *bb_cost, float *ti
 				block[b_from].y = blocks_affected.moved_blocks[iblk].yold;
 				block[b_from].z = blocks_affected.moved_blocks[iblk].zold;
 			}
+
+			if (place_profiling) {
+				add_place_profile_phase(PLACE_PHASE_REVERT, profile_ticks);
+				add_place_profile_move(from_type, (boolean) (imacro != -1),
+						PLACE_MOVE_REJECTED);
+			}
 		}
 
 		/* Resets the num_moved_blocks, but do not free blocks_moved array. Defensive Coding */
@@ -1474,6 +1963,12 @@ static enum swap_result try_swap(float t, float *cost, float *bb_cost, float *ti
 
 		/* Resets the num_moved_blocks, but do not free blocks_moved array. Defensive Coding */
 		blocks_affected.num_moved_blocks = 0;
+
+		if (place_profiling) {
+			add_place_profile_phase(PLACE_PHASE_REVERT, profile_ticks);
+			add_place_profile_move(from_type, (boolean) (imacro != -1),
+					PLACE_MOVE_ABORTED);
+		}
 		
 		return ABORTED;
 	}
@@ -1541,6 +2036,17 @@ static boolean find_to(int x_from, int y_from, t_type_ptr type, float rlim, int
 	min_y = std::max(0, y_from - rly);
 	max_y = std::min(ny + 1, y_from + rly);
 
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+	/* Keep the search window inside the die of the from location, so the  *
+	 * blocks of each die are annealed on their own. */
+	if (block_die != NULL) {
+		int die_min_y, die_max_y;
+		get_die_row_range(get_die_of_row(y_from), &die_min_y, &die_max_y);
+		min_y = std::max(min_y, die_min_y);
+		max_y = std::min(max_y, die_max_y);
+	}
+#endif
+
 #ifdef DEBUG
 	if (rlx < 1 || rlx > nx + 1) {
 		vpr_printf(TIO_MESSAGE_ERROR, "in find_to: rlx = %d\n", rlx);
@@ -3178,6 +3684,258 @@ static void check_place(float bb_cost, float timing_cost,
 
 }
 
+static void set_checkpoint_state(t_place_checkpoint *state,
+		enum e_place_algorithm place_algorithm, int rng_seed, float t,
+		float rlim, float crit_exponent, float cost, float bb_cost,
+		float timing_cost, float delay_cost, float place_delay_value,
+		float inverse_prev_bb_cost, float inverse_prev_timing_cost,
+		int tot_iter, int num_temps, int moves_since_cost_recompute,
+		int outer_crit_iter_count, t_anneal_history *anneal_history) {
+
+	/* Gathers try_place's annealing variables and the swap counters into *
+	 * state, ready to be written by save_place_checkpoint.                */
+
+	memset(state, 0, sizeof(t_place_checkpoint));
+	state->num_blocks = num_blocks;
+	state->num_nets = num_nets;
+	state->nx = nx;
+	state->ny = ny;
+	state->place_algorithm = (int) place_algorithm;
+	state->rng_seed = rng_seed;
+	state->t = t;
+	state->rlim = rlim;
+	state->crit_exponent = crit_exponent;
+	state->cost = cost;
+	state->bb_cost = bb_cost;
+	state->timing_cost = timing_cost;
+	state->delay_cost = delay_cost;
+	state->place_delay_value = place_delay_value;
+	state->inverse_prev_bb_cost = inverse_prev_bb_cost;
+	state->inverse_prev_timing_cost = inverse_prev_timing_cost;
+	state->tot_iter = tot_iter;
+	state->num_temps = num_temps;
+	state->moves_since_cost_recompute = moves_since_cost_recompute;
+	state->outer_crit_iter_count = outer_crit_iter_count;
+	state->num_swap_rejected = num_swap_rejected;
+	state->num_swap_accepted = num_swap_accepted;
+	state->num_swap_aborted = num_swap_aborted;
+	state->num_ts_called = num_ts_called;
+	state->anneal_history = *anneal_history;
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+	state->has_block_die = (block_die != NULL);
+#endif
+}
+
+static void save_place_checkpoint(const char *fname, t_place_checkpoint *state) {
+
+	/* Writes a binary checkpoint: the magic string, state, then x, y, z   *
+	 * and type index of every block, the die partition if there is one,  *
+	 * and for the timing-driven placers the criticality of every sink.    */
+
+	FILE *fp;
+	int iblk, inet, loc[4];
+
+	fp = my_fopen(fname, "wb", 0);
+
+	fwrite(PLACE_CHECKPOINT_MAGIC, sizeof(char), strlen(PLACE_CHECKPOINT_MAGIC), fp);
+	fwrite(state, sizeof(t_place_checkpoint), 1, fp);
+
+	for (iblk = 0; iblk < num_blocks; iblk++) {
+		loc[0] = block[iblk].x;
+		loc[1] = block[iblk].y;
+		loc[2] = block[iblk].z;
+		loc[3] = block[iblk].type->index;
+		fwrite(loc, sizeof(int), 4, fp);
+	}
+
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+	if (state->has_block_die) {
+		fwrite(block_die, sizeof(int), num_blocks, fp);
+	}
+#endif
+
+	if (state->place_algorithm == NET_TIMING_DRIVEN_PLACE
+			|| state->place_algorithm == PATH_TIMING_DRIVEN_PLACE) {
+		for (inet = 0; inet < num_nets; inet++) {
+			fwrite(&timing_place_crit[inet][1], sizeof(float),
+					clb_net[inet].num_sinks, fp);
+		}
+	}
+
+	fclose(fp);
+	vpr_printf(TIO_MESSAGE_INFO, "Saved placement checkpoint '%s' at temperature %g.\n",
+			fname, state->t);
+}
+
+static void load_place_checkpoint(const char *fname, t_place_checkpoint *state,
+		enum e_place_algorithm place_algorithm, float **saved_crit) {
+
+	/* Reads a checkpoint written by save_place_checkpoint and puts every  *
+	 * block back at its saved location; replaces initial_placement.  The *
+	 * saved criticalities are returned in *saved_crit (NULL if none),     *
+	 * since they can only be applied after the timing graph is set up.    *
+	 * Exits if the file is unreadable or was made for another netlist,   *
+	 * device or placement algorithm.                                      */
+
+	FILE *fp;
+	char magic[sizeof(PLACE_CHECKPOINT_MAGIC)];
+	int i, j, k, iblk, inet, num_crit, loc[4];
+	boolean ok;
+
+	fp = my_fopen(fname, "rb", 0);
+
+	ok = (boolean) (fread(magic, sizeof(char), strlen(PLACE_CHECKPOINT_MAGIC), fp)
+			== strlen(PLACE_CHECKPOINT_MAGIC)
+			&& strncmp(magic, PLACE_CHECKPOINT_MAGIC, strlen(PLACE_CHECKPOINT_MAGIC)) == 0
+			&& fread(state, sizeof(t_place_checkpoint), 1, fp) == 1);
+	if (!ok) {
+		vpr_printf(TIO_MESSAGE_ERROR, "'%s' is not a placement checkpoint.\n", fname);
+		exit(1);
+	}
+	if (state->num_blocks != num_blocks || state->num_nets != num_nets
+			|| state->nx != nx || state->ny != ny) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Placement checkpoint '%s' is for %d blocks and %d nets on a %d x %d grid, "
+				"but this run has %d blocks and %d nets on a %d x %d grid.\n",
+				fname, state->num_blocks, state->num_nets, state->nx, state->ny,
+				num_blocks, num_nets, nx, ny);
+		exit(1);
+	}
+	if (state->place_algorithm != (int) place_algorithm) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Placement checkpoint '%s' was made with a different placement algorithm.\n",
+				fname);
+		exit(1);
+	}
+
+	for (i = 0; i <= nx + 1; i++) {
+		for (j = 0; j <= ny + 1; j++) {
+			grid[i][j].usage = 0;
+			for (k = 0; k < grid[i][j].type->capacity; k++) {
+				grid[i][j].blocks[k] = EMPTY;
+			}
+		}
+	}
+
+	for (iblk = 0; iblk < num_blocks; iblk++) {
+		if (fread(loc, sizeof(int), 4, fp) != 4) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Placement checkpoint '%s' is truncated.\n", fname);
+			exit(1);
+		}
+		if (loc[3] != block[iblk].type->index || loc[0] < 0 || loc[0] > nx + 1
+				|| loc[1] < 0 || loc[1] > ny + 1
+				|| grid[loc[0]][loc[1]].type != block[iblk].type
+				|| loc[2] < 0 || loc[2] >= grid[loc[0]][loc[1]].type->capacity
+				|| grid[loc[0]][loc[1]].blocks[loc[2]] != EMPTY) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Placement checkpoint '%s' has an illegal location for block %s (#%d).\n",
+					fname, block[iblk].name, iblk);
+			exit(1);
+		}
+		block[iblk].x = loc[0];
+		block[iblk].y = loc[1];
+		block[iblk].z = loc[2];
+		grid[loc[0]][loc[1]].blocks[loc[2]] = iblk;
+		grid[loc[0]][loc[1]].usage++;
+	}
+
+	if (state->has_block_die) {
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+		block_die = (int *) my_malloc(num_blocks * sizeof(int));
+		ok = (boolean) (fread(block_die, sizeof(int), num_blocks, fp) == (size_t) num_blocks);
+#else
+		ok = (boolean) (fseek(fp, num_blocks * sizeof(int), SEEK_CUR) == 0);
+#endif
+		if (!ok) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Placement checkpoint '%s' is truncated.\n", fname);
+			exit(1);
+		}
+	}
+
+	*saved_crit = NULL;
+	if (place_algorithm == NET_TIMING_DRIVEN_PLACE
+			|| place_algorithm == PATH_TIMING_DRIVEN_PLACE) {
+		num_crit = 0;
+		for (inet = 0; inet < num_nets; inet++)
+			num_crit += clb_net[inet].num_sinks;
+		*saved_crit = (float *) my_malloc(std::max(num_crit, 1) * sizeof(float));
+		if (fread(*saved_crit, sizeof(float), num_crit, fp) != (size_t) num_crit) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Placement checkpoint '%s' is truncated.\n", fname);
+			exit(1);
+		}
+	}
+
+	fclose(fp);
+
+	num_swap_rejected = state->num_swap_rejected;
+	num_swap_accepted = state->num_swap_accepted;
+	num_swap_aborted = state->num_swap_aborted;
+	num_ts_called = state->num_ts_called;
+
+	vpr_printf(TIO_MESSAGE_INFO, "Resuming placement from checkpoint '%s' at temperature %g after %d moves.\n",
+			fname, state->t, state->tot_iter);
+}
+
+static void restore_checkpoint_criticalities(float *saved_crit) {
+
+	/* Copies criticalities read by load_place_checkpoint into            *
+	 * timing_place_crit and frees them.                                  */
+
+	int inet, ipin, icrit;
+
+	icrit = 0;
+	for (inet = 0; inet < num_nets; inet++) {
+		for (ipin = 1; ipin <= clb_net[inet].num_sinks; ipin++) {
+			timing_place_crit[inet][ipin] = saved_crit[icrit++];
+		}
+	}
+	free(saved_crit);
+}
+
+static int fork_continuations(int num_forks, int *child_pids) {
+
+	/* Splits the run into num_forks processes that continue the anneal   *
+	 * from the same checkpoint.  Returns 0 in the original process and   *
+	 * 1..num_forks-1 in the children; child_pids is loaded in the parent.*/
+
+	int ifork;
+
+	child_pids[0] = 0;
+#ifndef _WIN32
+	fflush(NULL); /* so the children do not repeat buffered output */
+	for (ifork = 1; ifork < num_forks; ifork++) {
+		child_pids[ifork] = (int) fork();
+		if (child_pids[ifork] == 0) {
+			return ifork;
+		}
+		if (child_pids[ifork] < 0) {
+			vpr_printf(TIO_MESSAGE_WARNING, "Could only start %d of %d placement continuations.\n",
+					ifork, num_forks);
+			break;
+		}
+	}
+	for (; ifork < num_forks; ifork++)
+		child_pids[ifork] = -1;
+#else
+	vpr_printf(TIO_MESSAGE_WARNING, "--place_fork is not supported on this platform; running one continuation.\n");
+	for (ifork = 1; ifork < num_forks; ifork++)
+		child_pids[ifork] = -1;
+#endif
+	return 0;
+}
+
+static void wait_for_continuations(int num_forks, int *child_pids) {
+
+	int ifork;
+
+#ifndef _WIN32
+	for (ifork = 1; ifork < num_forks; ifork++) {
+		if (child_pids[ifork] > 0) {
+			waitpid((pid_t) child_pids[ifork], NULL, 0);
+		}
+	}
+#else
+	(void) ifork;
+#endif
+}
+
 #ifdef VERBOSE
 static void print_clb_placement(const char *fname) {
 
@@ -3215,3 +3973,551 @@ static void free_try_swap_arrays(void) {
 	}
 }
 
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+static int get_die_of_row(int y) {
+
+	/* Returns the die that row y belongs to.  Uses the same cut positions  *
+	 * as get_net_cost and comp_td_point_to_point_delay: cut i lies between *
+	 * rows i*cut_step and i*cut_step + 1.  The bottom IO row is in die 0   *
+	 * and the top IO row is in the last die.                               */
+
+	int cut_step, die;
+
+	cut_step = ny / (num_cuts + 1);
+	if (y <= 0 || cut_step <= 0)
+		return 0;
+
+	die = (y - 1) / cut_step;
+	return std::min(die, num_cuts);
+}
+
+static void get_die_row_range(int die, int *y_min, int *y_max) {
+
+	/* Rows [*y_min..*y_max] that make up die, IO rows included. */
+
+	int cut_step;
+
+	cut_step = ny / (num_cuts + 1);
+	*y_min = (die == 0) ? 0 : die * cut_step + 1;
+	*y_max = (die == num_cuts) ? ny + 1 : (die + 1) * cut_step;
+}
+
+static int count_interposer_crossings(int *nets_crossing_cut) {
+
+	/* Counts, for the current placement, how many nets span each cut and  *
+	 * returns the total number of (net, cut) crossings.                    *
+	 * nets_crossing_cut: [0..num_cuts-1], loaded if not NULL.               */
+
+	int inet, ipin, bnum, ymin, ymax, die_min, die_max, icut, total;
+
+	if (nets_crossing_cut != NULL) {
+		for (icut = 0; icut < num_cuts; icut++)
+			nets_crossing_cut[icut] = 0;
+	}
+
+	total = 0;
+	for (inet = 0; inet < num_nets; inet++) {
+		if (clb_net[inet].is_global)
+			continue;
+
+		bnum = clb_net[inet].node_block[0];
+		ymin = ymax = block[bnum].y;
+		for (ipin = 1; ipin <= clb_net[inet].num_sinks; ipin++) {
+			bnum = clb_net[inet].node_block[ipin];
+			ymin = std::min(ymin, block[bnum].y);
+			ymax = std::max(ymax, block[bnum].y);
+		}
+
+		die_min = get_die_of_row(ymin);
+		die_max = get_die_of_row(ymax);
+		total += die_max - die_min;
+		if (nets_crossing_cut != NULL) {
+			for (icut = die_min; icut < die_max; icut++)
+				nets_crossing_cut[icut]++;
+		}
+	}
+	return total;
+}
+
+static int get_interposer_wire_budget(int width_fac) {
+
+	/* Vertical wires left at each cut once percent_wires_cut of them have *
+	 * been removed, at channel width width_fac.                           */
+
+	return (int) ((nx + 1) * width_fac * (100 - percent_wires_cut) / 100.);
+}
+
+static void print_interposer_crossings(const char *stage, int width_fac) {
+
+	/* Reports the nets crossing each cut against the vertical wires left   *
+	 * at that cut once percent_wires_cut of them have been removed.        */
+
+	int *nets_crossing_cut;
+	int icut, total, wire_budget, cut_step;
+
+	if (num_cuts <= 0)
+		return;
+
+	nets_crossing_cut = (int *) my_malloc(num_cuts * sizeof(int));
+	total = count_interposer_crossings(nets_crossing_cut);
+
+	cut_step = ny / (num_cuts + 1);
+	wire_budget = get_interposer_wire_budget(width_fac);
+
+	vpr_printf(TIO_MESSAGE_INFO, "%s: %d net crossings of %d interposer cuts.\n",
+			stage, total, num_cuts);
+	for (icut = 0; icut < num_cuts; icut++) {
+		vpr_printf(TIO_MESSAGE_INFO, "\tCut %d (above row %d): %d nets, %d wires available.\n",
+				icut, (icut + 1) * cut_step, nets_crossing_cut[icut], wire_budget);
+		if (nets_crossing_cut[icut] > wire_budget) {
+			vpr_printf(TIO_MESSAGE_WARNING, "Cut %d is crossed by more nets (%d) than it has wires (%d).\n",
+					icut, nets_crossing_cut[icut], wire_budget);
+		}
+	}
+	free(nets_crossing_cut);
+}
+
+static int count_die_partition_crossings(int *nets_crossing_cut) {
+
+	/* Same as count_interposer_crossings, but for the die assignment in   *
+	 * block_die rather than the current placement.                       */
+
+	int inet, ipin, bnum, die_min, die_max, icut, total;
+
+	if (nets_crossing_cut != NULL) {
+		for (icut = 0; icut < num_cuts; icut++)
+			nets_crossing_cut[icut] = 0;
+	}
+
+	total = 0;
+	for (inet = 0; inet < num_nets; inet++) {
+		if (clb_net[inet].is_global)
+			continue;
+
+		die_min = num_cuts + 1;
+		die_max = -1;
+		for (ipin = 0; ipin <= clb_net[inet].num_sinks; ipin++) {
+			bnum = clb_net[inet].node_block[ipin];
+			die_min = std::min(die_min, block_die[bnum]);
+			die_max = std::max(die_max, block_die[bnum]);
+		}
+		total += die_max - die_min;
+		if (nets_crossing_cut != NULL) {
+			for (icut = die_min; icut < die_max; icut++)
+				nets_crossing_cut[icut]++;
+		}
+	}
+	return total;
+}
+
+static int get_die_move_gain(int iblk, int to_die, int *die_cost,
+		int *net_visited, int visit_stamp) {
+
+	/* Returns by how much the cut crossing cost of the nets of iblk        *
+	 * shrinks if iblk is moved from its current die to to_die, using       *
+	 * block_die for every other block.  A net spanning dies [lo..hi] costs *
+	 * die_cost[hi] - die_cost[lo], the summed weight of the cuts it        *
+	 * crosses.  A net attached to several pins of iblk is counted once     *
+	 * via net_visited[inet] == visit_stamp.                                */
+
+	int ipin, inet, isink, bnum, from_die, die_min, die_max, gain;
+
+	from_die = block_die[iblk];
+	gain = 0;
+
+	for (ipin = 0; ipin < block[iblk].type->num_pins; ipin++) {
+		inet = block[iblk].nets[ipin];
+		if (inet == OPEN || clb_net[inet].is_global)
+			continue;
+		if (net_visited[inet] == visit_stamp)
+			continue;
+		net_visited[inet] = visit_stamp;
+
+		die_min = num_cuts + 1;
+		die_max = -1;
+		for (isink = 0; isink <= clb_net[inet].num_sinks; isink++) {
+			bnum = clb_net[inet].node_block[isink];
+			if (bnum == iblk)
+				continue;
+			die_min = std::min(die_min, block_die[bnum]);
+			die_max = std::max(die_max, block_die[bnum]);
+		}
+		if (die_max == -1)
+			continue; /* every pin of the net is on iblk */
+
+		gain += (die_cost[std::max(die_max, from_die)]
+				- die_cost[std::min(die_min, from_die)])
+				- (die_cost[std::max(die_max, to_die)]
+						- die_cost[std::min(die_min, to_die)]);
+	}
+	return gain;
+}
+
+static void order_blocks_by_connectivity(int *order) {
+
+	/* Loads order[0..num_blocks-1] with a breadth-first traversal of the   *
+	 * clustered netlist, so that connected blocks end up next to each     *
+	 * other.  Each disconnected component is started from its lowest     *
+	 * numbered block.                                                     */
+
+	int head, tail, iseed, iblk, ipin, inet, isink, bnum;
+	boolean *queued;
+
+	queued = (boolean *) my_calloc(num_blocks, sizeof(boolean));
+	head = tail = 0;
+
+	for (iseed = 0; iseed < num_blocks; iseed++) {
+		if (queued[iseed])
+			continue;
+		queued[iseed] = TRUE;
+		order[tail++] = iseed;
+
+		while (head < tail) {
+			iblk = order[head++];
+			for (ipin = 0; ipin < block[iblk].type->num_pins; ipin++) {
+				inet = block[iblk].nets[ipin];
+				if (inet == OPEN || clb_net[inet].is_global)
+					continue;
+				for (isink = 0; isink <= clb_net[inet].num_sinks; isink++) {
+					bnum = clb_net[inet].node_block[isink];
+					if (!queued[bnum]) {
+						queued[bnum] = TRUE;
+						order[tail++] = bnum;
+					}
+				}
+			}
+		}
+	}
+	assert(tail == num_blocks);
+	free(queued);
+}
+
+static int improve_die_partition(int *order, boolean *locked,
+		int **die_capacity, int **die_usage, int *die_cost, int *net_visited,
+		int *visit_stamp) {
+
+	/* Greedy improvement of block_die: moves single unlocked blocks, in    *
+	 * order, to the die that lowers the cut crossing cost (see             *
+	 * get_die_move_gain) the most, while that die has a free location of   *
+	 * the block's type.  Stops after a pass without moves or after         *
+	 * MAX_DIE_PARTITION_PASSES passes, and returns the passes made.        */
+
+	int ipass, iorder, iblk, itype, to_die, best_die, best_gain, gain,
+		num_moves;
+
+	for (ipass = 0; ipass < MAX_DIE_PARTITION_PASSES; ipass++) {
+		num_moves = 0;
+		for (iorder = 0; iorder < num_blocks; iorder++) {
+			iblk = order[iorder];
+			if (locked[iblk])
+				continue;
+			itype = block[iblk].type->index;
+
+			best_die = block_die[iblk];
+			best_gain = 0;
+			for (to_die = 0; to_die <= num_cuts; to_die++) {
+				if (to_die == block_die[iblk]
+						|| die_usage[to_die][itype] >= die_capacity[to_die][itype])
+					continue;
+				gain = get_die_move_gain(iblk, to_die, die_cost, net_visited,
+						++(*visit_stamp));
+				if (gain > best_gain) {
+					best_gain = gain;
+					best_die = to_die;
+				}
+			}
+
+			if (best_die != block_die[iblk]) {
+				die_usage[block_die[iblk]][itype]--;
+				die_usage[best_die][itype]++;
+				block_die[iblk] = best_die;
+				num_moves++;
+			}
+		}
+		if (num_moves == 0)
+			break;
+	}
+	return ipass;
+}
+
+static void partition_blocks_into_dies(int width_fac) {
+
+	/* First phase of two-phase placement.  Assigns every movable block to *
+	 * a die so that few nets cross the interposer cuts, without putting   *
+	 * more blocks of a type in a die than the die has locations for.      *
+	 * Blocks are first dealt out to the dies in netlist breadth-first      *
+	 * order, in proportion to each die's free capacity, then moved one at *
+	 * a time to whichever die removes the most crossings until a pass     *
+	 * makes no improvement.  Cuts still crossed by more nets than they    *
+	 * have wires are then weighted up and the passes rerun; if that does  *
+	 * not bring every cut within budget, placement stops with an error.   *
+	 * Fixed blocks and macro members keep the die of their initial        *
+	 * placement and act as terminals.  Finally the blocks are moved into  *
+	 * their dies so annealing starts legal.                               */
+
+	int num_dies, idie, itype, ipos, iblk, iorder, imacro, ipass, visit_stamp,
+		cum_free, prev_target, target, wire_budget, icut, iround,
+		num_over_budget;
+	int **die_capacity, **die_usage, **die_quota, *num_movable, *total_free,
+		*die_cursor, *order, *net_visited, *die_cost, *nets_crossing_cut,
+		*cut_weight;
+	boolean *locked;
+	clock_t begin, end;
+
+	begin = clock();
+	num_dies = num_cuts + 1;
+
+	die_capacity = (int **) alloc_matrix(0, num_dies - 1, 0, num_types - 1, sizeof(int));
+	die_usage = (int **) alloc_matrix(0, num_dies - 1, 0, num_types - 1, sizeof(int));
+	die_quota = (int **) alloc_matrix(0, num_dies - 1, 0, num_types - 1, sizeof(int));
+	for (idie = 0; idie < num_dies; idie++) {
+		for (itype = 0; itype < num_types; itype++) {
+			die_capacity[idie][itype] = 0;
+			die_usage[idie][itype] = 0;
+		}
+	}
+	for (itype = 0; itype < num_types; itype++) {
+		for (ipos = 0; ipos < num_legal_pos[itype]; ipos++) {
+			die_capacity[get_die_of_row(legal_pos[itype][ipos].y)][itype]++;
+		}
+	}
+
+	block_die = (int *) my_malloc(num_blocks * sizeof(int));
+	locked = (boolean *) my_malloc(num_blocks * sizeof(boolean));
+	num_movable = (int *) my_calloc(num_types, sizeof(int));
+
+	for (iblk = 0; iblk < num_blocks; iblk++) {
+		get_imacro_from_iblk(&imacro, iblk, pl_macros, num_pl_macros);
+		locked[iblk] = (boolean) (block[iblk].isFixed || imacro != -1);
+		itype = block[iblk].type->index;
+		if (locked[iblk]) {
+			block_die[iblk] = get_die_of_row(block[iblk].y);
+			die_usage[block_die[iblk]][itype]++;
+		} else {
+			block_die[iblk] = OPEN;
+			num_movable[itype]++;
+		}
+	}
+
+	/* Share of the movable blocks of each type that each die receives.     *
+	 * The first idie+1 dies together get floor(movable * (their free       *
+	 * locations) / (all free locations)), which never overfills a die.     */
+	total_free = (int *) my_calloc(num_types, sizeof(int));
+	for (itype = 0; itype < num_types; itype++) {
+		for (idie = 0; idie < num_dies; idie++)
+			total_free[itype] += die_capacity[idie][itype] - die_usage[idie][itype];
+
+		cum_free = 0;
+		prev_target = 0;
+		for (idie = 0; idie < num_dies; idie++) {
+			cum_free += die_capacity[idie][itype] - die_usage[idie][itype];
+			if (idie == num_dies - 1 || total_free[itype] == 0)
+				target = num_movable[itype];
+			else
+				target = (int) ((double) num_movable[itype] * cum_free / total_free[itype]);
+			die_quota[idie][itype] = target - prev_target;
+			prev_target = target;
+		}
+	}
+
+	/* Deal the blocks out bottom to top in connectivity order. */
+	order = (int *) my_malloc(num_blocks * sizeof(int));
+	order_blocks_by_connectivity(order);
+
+	die_cursor = (int *) my_calloc(num_types, sizeof(int));
+	for (iorder = 0; iorder < num_blocks; iorder++) {
+		iblk = order[iorder];
+		if (locked[iblk])
+			continue;
+		itype = block[iblk].type->index;
+		while (die_quota[die_cursor[itype]][itype] == 0)
+			die_cursor[itype]++;
+
+		block_die[iblk] = die_cursor[itype];
+		die_quota[die_cursor[itype]][itype]--;
+		die_usage[die_cursor[itype]][itype]++;
+	}
+
+	vpr_printf(TIO_MESSAGE_INFO, "Die partitioning: %d crossings after initial assignment.\n",
+			count_die_partition_crossings(NULL));
+
+	/* Greedy improvement: move single blocks to the die that removes the  *
+	 * most crossings, while the destination has a free location.          */
+	net_visited = (int *) my_malloc(num_nets * sizeof(int));
+	for (iorder = 0; iorder < num_nets; iorder++)
+		net_visited[iorder] = 0;
+	visit_stamp = 0;
+
+	die_cost = (int *) my_malloc(num_dies * sizeof(int));
+	for (idie = 0; idie < num_dies; idie++)
+		die_cost[idie] = idie;
+	ipass = improve_die_partition(order, locked, die_capacity, die_usage,
+			die_cost, net_visited, &visit_stamp);
+
+	vpr_printf(TIO_MESSAGE_INFO, "Die partitioning: %d crossings after %d improvement passes.\n",
+			count_die_partition_crossings(NULL), ipass);
+
+	/* Enforce the wire budget of each cut.  A cut crossed by more nets     *
+	 * than it has wires is made costlier to cross than every other cut     *
+	 * together, and the improvement passes are rerun, until no cut is over *
+	 * budget or MAX_DIE_BUDGET_ROUNDS rounds have been tried.              */
+	wire_budget = get_interposer_wire_budget(width_fac);
+	nets_crossing_cut = (int *) my_malloc(num_cuts * sizeof(int));
+	cut_weight = (int *) my_malloc(num_cuts * sizeof(int));
+	for (icut = 0; icut < num_cuts; icut++)
+		cut_weight[icut] = 1;
+
+	for (iround = 0;; iround++) {
+		count_die_partition_crossings(nets_crossing_cut);
+		num_over_budget = 0;
+		for (icut = 0; icut < num_cuts; icut++) {
+			if (nets_crossing_cut[icut] > wire_budget) {
+				num_over_budget++;
+				cut_weight[icut] = num_nets + 1;
+			}
+		}
+		if (num_over_budget == 0 || iround == MAX_DIE_BUDGET_ROUNDS)
+			break;
+
+		die_cost[0] = 0;
+		for (idie = 1; idie < num_dies; idie++)
+			die_cost[idie] = die_cost[idie - 1] + cut_weight[idie - 1];
+		ipass = improve_die_partition(order, locked, die_capacity, die_usage,
+				die_cost, net_visited, &visit_stamp);
+		vpr_printf(TIO_MESSAGE_INFO, "Die partitioning: %d cuts over their wire budget of %d, %d crossings after %d more passes.\n",
+				num_over_budget, wire_budget, count_die_partition_crossings(NULL), ipass);
+	}
+
+	if (num_over_budget > 0) {
+		for (icut = 0; icut < num_cuts; icut++) {
+			if (nets_crossing_cut[icut] > wire_budget) {
+				vpr_printf(TIO_MESSAGE_ERROR, "Die partitioning could not bring cut %d within its wire budget: %d nets cross it, %d wires are left at channel width %d.\n",
+						icut, nets_crossing_cut[icut], wire_budget, width_fac);
+			}
+		}
+		exit(1);
+	}
+
+	/* Fixed blocks and macros are not confined once annealing starts. */
+	for (iblk = 0; iblk < num_blocks; iblk++) {
+		if (locked[iblk])
+			block_die[iblk] = OPEN;
+	}
+
+	place_blocks_in_dies();
+
+	end = clock();
+#ifdef CLOCKS_PER_SEC
+	vpr_printf(TIO_MESSAGE_INFO, "Die partitioning took %g seconds.\n", (float)(end - begin) / CLOCKS_PER_SEC);
+#else
+	vpr_printf(TIO_MESSAGE_INFO, "Die partitioning took %g seconds.\n", (float)(end - begin) / CLK_PER_SEC);
+#endif
+	print_interposer_crossings("Placement after die partitioning", width_fac);
+
+	free_matrix(die_capacity, 0, num_dies - 1, 0, sizeof(int));
+	free_matrix(die_usage, 0, num_dies - 1, 0, sizeof(int));
+	free_matrix(die_quota, 0, num_dies - 1, 0, sizeof(int));
+	free(locked);
+	free(num_movable);
+	free(total_free);
+	free(die_cursor);
+	free(order);
+	free(net_visited);
+	free(die_cost);
+	free(nets_crossing_cut);
+	free(cut_weight);
+}
+
+static void place_blocks_in_dies(void) {
+
+	/* Moves every confined block that is not already in its die to a     *
+	 * random free location of its type inside the die.  All such blocks  *
+	 * are lifted off the grid first, so a die that is full of blocks     *
+	 * bound elsewhere has room by the time its own blocks are dropped in. */
+
+	int num_dies, idie, itype, ipos, iblk, ichoice, x, y, z;
+	int **num_free;
+	t_legal_pos ***free_pos;
+
+	num_dies = num_cuts + 1;
+
+	for (iblk = 0; iblk < num_blocks; iblk++) {
+		if (block_die[iblk] == OPEN || get_die_of_row(block[iblk].y) == block_die[iblk])
+			continue;
+		x = block[iblk].x;
+		y = block[iblk].y;
+		z = block[iblk].z;
+		grid[x][y].blocks[z] = EMPTY;
+		grid[x][y].usage--;
+		block[iblk].x = -1;
+	}
+
+	/* Free locations of each type in each die */
+	num_free = (int **) alloc_matrix(0, num_dies - 1, 0, num_types - 1, sizeof(int));
+	free_pos = (t_legal_pos ***) alloc_matrix(0, num_dies - 1, 0, num_types - 1, sizeof(t_legal_pos *));
+	for (idie = 0; idie < num_dies; idie++) {
+		for (itype = 0; itype < num_types; itype++) {
+			num_free[idie][itype] = 0;
+			free_pos[idie][itype] = (t_legal_pos *) my_malloc(
+					std::max(num_legal_pos[itype], 1) * sizeof(t_legal_pos));
+		}
+	}
+	for (itype = 0; itype < num_types; itype++) {
+		for (ipos = 0; ipos < num_legal_pos[itype]; ipos++) {
+			x = legal_pos[itype][ipos].x;
+			y = legal_pos[itype][ipos].y;
+			z = legal_pos[itype][ipos].z;
+			if (grid[x][y].blocks[z] == EMPTY) {
+				idie = get_die_of_row(y);
+				free_pos[idie][itype][num_free[idie][itype]++] = legal_pos[itype][ipos];
+			}
+		}
+	}
+
+	for (iblk = 0; iblk < num_blocks; iblk++) {
+		if (block_die[iblk] == OPEN || block[iblk].x != -1)
+			continue;
+		idie = block_die[iblk];
+		itype = block[iblk].type->index;
+		assert(num_free[idie][itype] > 0);
+
+		ichoice = my_irand(num_free[idie][itype] - 1);
+		x = free_pos[idie][itype][ichoice].x;
+		y = free_pos[idie][itype][ichoice].y;
+		z = free_pos[idie][itype][ichoice].z;
+
+		grid[x][y].blocks[z] = iblk;
+		grid[x][y].usage++;
+		block[iblk].x = x;
+		block[iblk].y = y;
+		block[iblk].z = z;
+
+		free_pos[idie][itype][ichoice] = free_pos[idie][itype][num_free[idie][itype] - 1];
+		num_free[idie][itype]--;
+	}
+
+	for (idie = 0; idie < num_dies; idie++) {
+		for (itype = 0; itype < num_types; itype++) {
+			free(free_pos[idie][itype]);
+		}
+	}
+	free_matrix(free_pos, 0, num_dies - 1, 0, sizeof(t_legal_pos *));
+	free_matrix(num_free, 0, num_dies - 1, 0, sizeof(int));
+}
+
+static boolean moved_blocks_leave_die(void) {
+
+	/* Returns TRUE if the swap held in blocks_affected would take a block *
+	 * confined by the die partition out of its die.                      */
+
+	int imoved, bnum;
+
+	for (imoved = 0; imoved < blocks_affected.num_moved_blocks; imoved++) {
+		bnum = blocks_affected.moved_blocks[imoved].block_num;
+		if (block_die[bnum] != OPEN
+				&& get_die_of_row(blocks_affected.moved_blocks[imoved].ynew) != block_die[bnum])
+			return TRUE;
+	}
+	return FALSE;
+}
+#endif
@@ -0,0 +1,275 @@
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "util.h"
+#include "vpr_types.h"
+#include "globals.h"
+#include "place_profile.h"
+
+/* Counters for one temperature, or for the whole anneal.                  *
+ * phase_ticks: time spent in each phase [0..NUM_PLACE_PHASES-1].          *
+ * moves: move outcomes, indexed by get_move_index [0..num_types*2*        *
+ *        NUM_PLACE_MOVE_OUTCOMES-1].                                      *
+ * aborts: aborted swaps by reason [0..NUM_PLACE_ABORT_REASONS-1].         */
+typedef struct s_place_profile_counts {
+	double phase_ticks[NUM_PLACE_PHASES];
+	int *moves;
+	int aborts[NUM_PLACE_ABORT_REASONS];
+} t_place_profile_counts;
+
+boolean place_profiling = FALSE; /* available externally */
+
+static FILE *trace_fp = NULL;
+static t_place_profile_counts temp_counts;
+static t_place_profile_counts total_counts;
+
+static const char *phase_names[NUM_PLACE_PHASES] = { "find_to",
+		"affected_blocks", "bb_update", "td_delta", "assess", "commit",
+		"revert", "update_td_cost", "inner_timing", "outer_timing" };
+
+static const char *outcome_names[NUM_PLACE_MOVE_OUTCOMES] = { "accepted",
+		"rejected", "aborted", "no_target" };
+
+static const char *abort_names[NUM_PLACE_ABORT_REASONS] = { "macro_off_chip",
+		"swap_with_macro", "die_boundary" };
+
+/******** prototypes ******************/
+
+static int get_move_index(int itype, int is_macro, int outcome);
+
+static void reset_place_profile_counts(t_place_profile_counts *counts);
+
+static void print_trace_counts(t_place_profile_counts *counts);
+
+static void print_place_profile_summary(void);
+
+/**************************************/
+
+static int get_move_index(int itype, int is_macro, int outcome) {
+	return ((itype * 2 + is_macro) * NUM_PLACE_MOVE_OUTCOMES + outcome);
+}
+
+static void reset_place_profile_counts(t_place_profile_counts *counts) {
+
+	int i;
+
+	for (i = 0; i < NUM_PLACE_PHASES; i++)
+		counts->phase_ticks[i] = 0.;
+	for (i = 0; i < num_types * 2 * NUM_PLACE_MOVE_OUTCOMES; i++)
+		counts->moves[i] = 0;
+	for (i = 0; i < NUM_PLACE_ABORT_REASONS; i++)
+		counts->aborts[i] = 0;
+}
+
+void alloc_place_profile(const char *trace_file) {
+
+	/* Starts profiling, and writes the first line of the trace: the tick *
+	 * unit and the block type names the move counts are listed by.       */
+
+	int itype;
+
+	temp_counts.moves = (int *) my_malloc(
+			num_types * 2 * NUM_PLACE_MOVE_OUTCOMES * sizeof(int));
+	total_counts.moves = (int *) my_malloc(
+			num_types * 2 * NUM_PLACE_MOVE_OUTCOMES * sizeof(int));
+	reset_place_profile_counts(&temp_counts);
+	reset_place_profile_counts(&total_counts);
+
+	trace_fp = my_fopen(trace_file, "w", 0);
+	fprintf(trace_fp, "{\"tick_unit\": \"%s\", \"types\": [",
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+			"cycles"
+#else
+			"clock"
+#endif
+			);
+	for (itype = 0; itype < num_types; itype++) {
+		fprintf(trace_fp, "%s\"%s\"", (itype == 0 ? "" : ", "),
+				type_descriptors[itype].name);
+	}
+	fprintf(trace_fp, "]}\n");
+
+	place_profiling = TRUE;
+}
+
+void free_place_profile(void) {
+
+	/* Prints the totals for the whole anneal and stops profiling. */
+
+	if (place_profiling == FALSE)
+		return;
+
+	print_place_profile_summary();
+
+	fclose(trace_fp);
+	trace_fp = NULL;
+	free(temp_counts.moves);
+	free(total_counts.moves);
+	temp_counts.moves = NULL;
+	total_counts.moves = NULL;
+	place_profiling = FALSE;
+}
+
+double get_place_profile_ticks(void) {
+
+	/* Returns the current time in profiler ticks. */
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+	unsigned int lo, hi;
+
+	__asm__ __volatile__ ("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((double) hi * 4294967296. + (double) lo);
+#else
+	return ((double) clock());
+#endif
+}
+
+double add_place_profile_phase(enum e_place_phase phase, double start_ticks) {
+
+	/* Charges the time since start_ticks to phase.  Returns the current  *
+	 * time, so consecutive phases can be timed from one timestamp.       */
+
+	double now;
+
+	now = get_place_profile_ticks();
+	temp_counts.phase_ticks[phase] += now - start_ticks;
+	return (now);
+}
+
+void add_place_profile_move(t_type_ptr type, boolean is_macro,
+		enum e_place_move_outcome outcome) {
+
+	temp_counts.moves[get_move_index(type->index, (is_macro ? 1 : 0), outcome)]++;
+}
+
+void add_place_profile_abort(enum e_place_abort_reason reason) {
+
+	temp_counts.aborts[reason]++;
+}
+
+static void print_trace_counts(t_place_profile_counts *counts) {
+
+	/* Writes the phase, move and abort fields of a trace line. */
+
+	int i, itype, is_macro, outcome;
+	boolean first;
+
+	fprintf(trace_fp, "\"phase_ticks\": {");
+	for (i = 0; i < NUM_PLACE_PHASES; i++) {
+		fprintf(trace_fp, "%s\"%s\": %.0f", (i == 0 ? "" : ", "),
+				phase_names[i], counts->phase_ticks[i]);
+	}
+	fprintf(trace_fp, "}, \"aborts\": {");
+	for (i = 0; i < NUM_PLACE_ABORT_REASONS; i++) {
+		fprintf(trace_fp, "%s\"%s\": %d", (i == 0 ? "" : ", "), abort_names[i],
+				counts->aborts[i]);
+	}
+
+	/* Moves are listed as [accepted, rejected, aborted, no_target] per *
+	 * type, for single blocks and for macros.  Unused types are left   *
+	 * out.                                                              */
+	fprintf(trace_fp, "}, \"moves\": {");
+	first = TRUE;
+	for (itype = 0; itype < num_types; itype++) {
+		for (i = 0; i < 2 * NUM_PLACE_MOVE_OUTCOMES; i++) {
+			if (counts->moves[itype * 2 * NUM_PLACE_MOVE_OUTCOMES + i] != 0)
+				break;
+		}
+		if (i == 2 * NUM_PLACE_MOVE_OUTCOMES)
+			continue;
+
+		fprintf(trace_fp, "%s\"%s\": {", (first ? "" : ", "),
+				type_descriptors[itype].name);
+		first = FALSE;
+		for (is_macro = 0; is_macro < 2; is_macro++) {
+			fprintf(trace_fp, "%s\"%s\": [", (is_macro == 0 ? "" : ", "),
+					(is_macro == 0 ? "single" : "macro"));
+			for (outcome = 0; outcome < NUM_PLACE_MOVE_OUTCOMES; outcome++) {
+				fprintf(trace_fp, "%s%d", (outcome == 0 ? "" : ", "),
+						counts->moves[get_move_index(itype, is_macro, outcome)]);
+			}
+			fprintf(trace_fp, "]");
+		}
+		fprintf(trace_fp, "}");
+	}
+	fprintf(trace_fp, "}");
+}
+
+void end_place_profile_temperature(int num_temps, float t, float cost,
+		float bb_cost, float timing_cost, float success_rat, float rlim) {
+
+	/* Appends the counters of the temperature just finished to the trace *
+	 * and adds them to the totals.                                       */
+
+	int i;
+
+	fprintf(trace_fp, "{\"temp\": %d, \"t\": %g, \"cost\": %g, \"bb_cost\": %g, "
+			"\"td_cost\": %g, \"ac_rate\": %g, \"rlim\": %g, ",
+			num_temps, t, cost, bb_cost, timing_cost, success_rat, rlim);
+	print_trace_counts(&temp_counts);
+	fprintf(trace_fp, "}\n");
+
+	for (i = 0; i < NUM_PLACE_PHASES; i++)
+		total_counts.phase_ticks[i] += temp_counts.phase_ticks[i];
+	for (i = 0; i < num_types * 2 * NUM_PLACE_MOVE_OUTCOMES; i++)
+		total_counts.moves[i] += temp_counts.moves[i];
+	for (i = 0; i < NUM_PLACE_ABORT_REASONS; i++)
+		total_counts.aborts[i] += temp_counts.aborts[i];
+	reset_place_profile_counts(&temp_counts);
+}
+
+static void print_place_profile_summary(void) {
+
+	int i, itype, is_macro, outcome, num_moves;
+	double total_ticks;
+
+	/* Anything counted since the last temperature was written */
+	for (i = 0; i < NUM_PLACE_PHASES; i++)
+		total_counts.phase_ticks[i] += temp_counts.phase_ticks[i];
+	for (i = 0; i < num_types * 2 * NUM_PLACE_MOVE_OUTCOMES; i++)
+		total_counts.moves[i] += temp_counts.moves[i];
+	for (i = 0; i < NUM_PLACE_ABORT_REASONS; i++)
+		total_counts.aborts[i] += temp_counts.aborts[i];
+
+	fprintf(trace_fp, "{\"total\": true, ");
+	print_trace_counts(&total_counts);
+	fprintf(trace_fp, "}\n");
+
+	total_ticks = 0.;
+	for (i = 0; i < NUM_PLACE_PHASES; i++)
+		total_ticks += total_counts.phase_ticks[i];
+
+	vpr_printf(TIO_MESSAGE_INFO, "\n");
+	vpr_printf(TIO_MESSAGE_INFO, "Placement profile:\n");
+	vpr_printf(TIO_MESSAGE_INFO, "%16s %14s %7s\n", "Phase", "Ticks", "%");
+	for (i = 0; i < NUM_PLACE_PHASES; i++) {
+		vpr_printf(TIO_MESSAGE_INFO, "%16s %14.0f %7.2f\n", phase_names[i],
+				total_counts.phase_ticks[i],
+				(total_ticks > 0. ? 100. * total_counts.phase_ticks[i] / total_ticks : 0.));
+	}
+
+	vpr_printf(TIO_MESSAGE_INFO, "%16s %6s %10s %10s %10s %10s\n", "Block type",
+			"Kind", outcome_names[0], outcome_names[1], outcome_names[2],
+			outcome_names[3]);
+	for (itype = 0; itype < num_types; itype++) {
+		for (is_macro = 0; is_macro < 2; is_macro++) {
+			num_moves = 0;
+			for (outcome = 0; outcome < NUM_PLACE_MOVE_OUTCOMES; outcome++)
+				num_moves += total_counts.moves[get_move_index(itype, is_macro, outcome)];
+			if (num_moves == 0)
+				continue;
+			vpr_printf(TIO_MESSAGE_INFO, "%16s %6s %10d %10d %10d %10d\n",
+					type_descriptors[itype].name, (is_macro ? "macro" : "single"),
+					total_counts.moves[get_move_index(itype, is_macro, PLACE_MOVE_ACCEPTED)],
+					total_counts.moves[get_move_index(itype, is_macro, PLACE_MOVE_REJECTED)],
+					total_counts.moves[get_move_index(itype, is_macro, PLACE_MOVE_ABORTED)],
+					total_counts.moves[get_move_index(itype, is_macro, PLACE_MOVE_NO_TARGET)]);
+		}
+	}
+
+	vpr_printf(TIO_MESSAGE_INFO, "Aborted swaps:");
+	for (i = 0; i < NUM_PLACE_ABORT_REASONS; i++) {
+		vpr_printf(TIO_MESSAGE_INFO, " %s %d", abort_names[i], total_counts.aborts[i]);
+	}
+	vpr_printf(TIO_MESSAGE_INFO, "\n");
+}
@@ -0,0 +1,59 @@
+#ifndef PLACE_PROFILE_H
+#define PLACE_PROFILE_H
+
+/* Placement profiler (--place_profile <file>).  Accumulates the time spent *
+ * in each phase of try_swap and in the placer's timing updates, counts    *
+ * move outcomes by block type and by single block vs. placement macro,    *
+ * and counts why swaps were aborted.  One JSON object per temperature is  *
+ * appended to the trace file, and the totals are printed when placement   *
+ * ends.  Times are in CPU cycles where the cycle counter can be read      *
+ * (x86 with gcc), and in clock() ticks otherwise.                          */
+
+enum e_place_phase {
+	PLACE_PHASE_FIND_TO, /* picking the block and its destination */
+	PLACE_PHASE_AFFECTED_BLOCKS, /* find_affected_blocks */
+	PLACE_PHASE_BB_UPDATE, /* net bounding boxes and bb cost */
+	PLACE_PHASE_TD_DELTA, /* comp_delta_td_cost */
+	PLACE_PHASE_ASSESS, /* assess_swap */
+	PLACE_PHASE_COMMIT, /* keeping an accepted move */
+	PLACE_PHASE_REVERT, /* undoing a rejected or aborted move */
+	PLACE_PHASE_UPDATE_TD_COST, /* update_td_cost */
+	PLACE_PHASE_INNER_TIMING, /* criticality updates inside a temperature */
+	PLACE_PHASE_OUTER_TIMING, /* criticality updates between temperatures */
+	NUM_PLACE_PHASES
+};
+
+enum e_place_move_outcome {
+	PLACE_MOVE_ACCEPTED, PLACE_MOVE_REJECTED, PLACE_MOVE_ABORTED,
+	PLACE_MOVE_NO_TARGET, /* find_to found no legal destination */
+	NUM_PLACE_MOVE_OUTCOMES
+};
+
+enum e_place_abort_reason {
+	PLACE_ABORT_MACRO_OFF_CHIP, /* a macro member would leave the device */
+	PLACE_ABORT_SWAP_WITH_MACRO, /* the destination block is in a macro */
+	PLACE_ABORT_DIE_BOUNDARY, /* a block would leave its die (interposer) */
+	NUM_PLACE_ABORT_REASONS
+};
+
+/* TRUE while the profiler is running; checked before every call below so *
+ * that an unprofiled run pays no more than a test per hook.               */
+extern boolean place_profiling;
+
+void alloc_place_profile(const char *trace_file);
+
+void free_place_profile(void);
+
+double get_place_profile_ticks(void);
+
+double add_place_profile_phase(enum e_place_phase phase, double start_ticks);
+
+void add_place_profile_move(t_type_ptr type, boolean is_macro,
+		enum e_place_move_outcome outcome);
+
+void add_place_profile_abort(enum e_place_abort_reason reason);
+
+void end_place_profile_temperature(int num_temps, float t, float cost,
+		float bb_cost, float timing_cost, float success_rat, float rlim);
+
+#endif
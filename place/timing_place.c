@@ -122,7 +122,7 @@ t_slack * alloc_lookups_and_criticalities(t_chan_width_dist chan_width_dist,
 		struct s_router_opts router_opts,
 		struct s_det_routing_arch det_routing_arch, t_segment_inf * segment_inf,
 		t_timing_inf timing_inf, float ***net_delay, INP t_direct_inf *directs, 
-		INP int num_directs) {
+		INP int num_directs, INP char *delay_cache_file) {
 
 	t_slack * slacks = alloc_and_load_timing_graph(timing_inf);
 
@@ -130,7 +130,7 @@ t_slack * alloc_lookups_and_criticalities(t_chan_width_dist chan_width_dist,
 			num_nets);
 
 	compute_delay_lookup_tables(router_opts, det_routing_arch, segment_inf,
-			timing_inf, chan_width_dist, directs, num_directs);
+			timing_inf, chan_width_dist, directs, num_directs, delay_cache_file);
 	
 	timing_place_crit = alloc_crit(&timing_place_crit_ch);
 
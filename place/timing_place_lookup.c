@@ -55,6 +55,9 @@
 #define DEBUG_TIMING_PLACE_LOOKUP	/*initialize arrays to known state */
 
 #define DUMPFILE "lookup_dump.echo"
+
+#define DELAY_CACHE_MAGIC "VPR_PLACE_DELAY_LOOKUP" /* first token of a delay lookup cache file */
+#define DELAY_CACHE_VERSION 1	/* bump whenever the cache layout changes */
 /* #define PRINT_ARRAYS *//*only used during debugging, calls routine to  */
 /*print out the various lookup arrays           */
 
@@ -167,6 +170,22 @@ static int get_longest_segment_length(
 		struct s_det_routing_arch det_routing_arch, t_segment_inf * segment_inf);
 static void reset_placement(void);
 
+static unsigned int hash_delay_cache_bytes(unsigned int hash, const void *data,
+		size_t num_bytes);
+static unsigned int compute_delay_cache_key(struct s_router_opts router_opts,
+		struct s_det_routing_arch det_routing_arch, t_segment_inf * segment_inf,
+		t_timing_inf timing_inf, t_chan_width_dist chan_width_dist,
+		INP t_direct_inf *directs, INP int num_directs);
+static unsigned int hash_delay_cache_chan(unsigned int key, t_chan chan);
+static void format_delay_cache_header(char *header, unsigned int arch_key);
+static boolean read_delay_cache_matrix(FILE * fp, float **matrix, int max_x,
+		int max_y);
+static void write_delay_cache_matrix(FILE * fp, float **matrix, int max_x,
+		int max_y);
+static boolean load_delay_lookup_cache(INP char *cache_file,
+		unsigned int arch_key);
+static void save_delay_lookup_cache(INP char *cache_file, unsigned int arch_key);
+
 #ifdef PRINT_ARRAYS
 static void print_array(float **array_to_print,
 		int x1,
@@ -972,13 +991,278 @@ static void compute_delta_arrays(struct s_router_opts router_opts,
 
 }
 
+/**************************************/
+static unsigned int hash_delay_cache_bytes(unsigned int hash, const void *data,
+		size_t num_bytes) {
+
+	/* 32-bit FNV-1a, folds num_bytes of data into hash */
+	const unsigned char *bytes = (const unsigned char *) data;
+	size_t i;
+
+	for (i = 0; i < num_bytes; i++) {
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**************************************/
+static unsigned int compute_delay_cache_key(struct s_router_opts router_opts,
+		struct s_det_routing_arch det_routing_arch, t_segment_inf * segment_inf,
+		t_timing_inf timing_inf, t_chan_width_dist chan_width_dist,
+		INP t_direct_inf *directs, INP int num_directs) {
+
+	/* Summarizes every input of compute_delay_lookup_tables that the delta *
+	 * arrays depend on: the block types with their pins and Fc, the wire   *
+	 * segments and switches, the router and timing settings, the channel  *
+	 * width distribution and the direct connections.  Must be called      *
+	 * before load_simplified_device swaps out the real types.              */
+
+	unsigned int key;
+	int i, ipin, iheight, iside;
+	t_type_descriptor *type;
+
+	key = 2166136261u;
+
+	key = hash_delay_cache_bytes(key, &num_types, sizeof(int));
+	for (i = 0; i < num_types; i++) {
+		type = &type_descriptors[i];
+		if (type->name != NULL) {
+			key = hash_delay_cache_bytes(key, type->name, strlen(type->name));
+		}
+		key = hash_delay_cache_bytes(key, &type->num_pins, sizeof(int));
+		key = hash_delay_cache_bytes(key, &type->capacity, sizeof(int));
+		key = hash_delay_cache_bytes(key, &type->height, sizeof(int));
+		key = hash_delay_cache_bytes(key, &type->is_Fc_frac, sizeof(boolean));
+		key = hash_delay_cache_bytes(key, &type->is_Fc_full_flex,
+				sizeof(boolean));
+		for (ipin = 0; ipin < type->num_pins; ipin++) {
+			key = hash_delay_cache_bytes(key, &type->Fc[ipin], sizeof(float));
+			key = hash_delay_cache_bytes(key, &type->pin_class[ipin],
+					sizeof(int));
+			key = hash_delay_cache_bytes(key, &type->is_global_pin[ipin],
+					sizeof(boolean));
+			key = hash_delay_cache_bytes(key, &type->pin_height[ipin],
+					sizeof(int));
+			for (iheight = 0; iheight < type->height; iheight++) {
+				for (iside = 0; iside < 4; iside++) {
+					key = hash_delay_cache_bytes(key,
+							&type->pinloc[iheight][iside][ipin], sizeof(int));
+				}
+			}
+		}
+	}
+
+	key = hash_delay_cache_bytes(key, &det_routing_arch.directionality,
+			sizeof(enum e_directionality));
+	key = hash_delay_cache_bytes(key, &det_routing_arch.Fs, sizeof(int));
+	key = hash_delay_cache_bytes(key, &det_routing_arch.switch_block_type,
+			sizeof(enum e_switch_block_type));
+	key = hash_delay_cache_bytes(key, &det_routing_arch.global_route_switch,
+			sizeof(short));
+	key = hash_delay_cache_bytes(key, &det_routing_arch.wire_to_ipin_switch,
+			sizeof(short));
+	key = hash_delay_cache_bytes(key, &det_routing_arch.delayless_switch,
+			sizeof(short));
+
+	key = hash_delay_cache_bytes(key, &det_routing_arch.num_segment,
+			sizeof(int));
+	for (i = 0; i < det_routing_arch.num_segment; i++) {
+		key = hash_delay_cache_bytes(key, &segment_inf[i].frequency,
+				sizeof(int));
+		key = hash_delay_cache_bytes(key, &segment_inf[i].length, sizeof(int));
+		key = hash_delay_cache_bytes(key, &segment_inf[i].wire_switch,
+				sizeof(short));
+		key = hash_delay_cache_bytes(key, &segment_inf[i].opin_switch,
+				sizeof(short));
+		key = hash_delay_cache_bytes(key, &segment_inf[i].Rmetal,
+				sizeof(float));
+		key = hash_delay_cache_bytes(key, &segment_inf[i].Cmetal,
+				sizeof(float));
+	}
+
+	key = hash_delay_cache_bytes(key, &det_routing_arch.num_switch,
+			sizeof(short));
+	for (i = 0; i < det_routing_arch.num_switch; i++) {
+		key = hash_delay_cache_bytes(key, &switch_inf[i].buffered,
+				sizeof(boolean));
+		key = hash_delay_cache_bytes(key, &switch_inf[i].R, sizeof(float));
+		key = hash_delay_cache_bytes(key, &switch_inf[i].Cin, sizeof(float));
+		key = hash_delay_cache_bytes(key, &switch_inf[i].Cout, sizeof(float));
+		key = hash_delay_cache_bytes(key, &switch_inf[i].Tdel, sizeof(float));
+	}
+
+	key = hash_delay_cache_bytes(key, &router_opts.route_type,
+			sizeof(enum e_route_type));
+	key = hash_delay_cache_bytes(key, &router_opts.fixed_channel_width,
+			sizeof(int));
+	key = hash_delay_cache_bytes(key, &router_opts.base_cost_type,
+			sizeof(enum e_base_cost_type));
+	key = hash_delay_cache_bytes(key, &router_opts.astar_fac, sizeof(float));
+	key = hash_delay_cache_bytes(key, &router_opts.bend_cost, sizeof(float));
+	key = hash_delay_cache_bytes(key, &router_opts.max_criticality,
+			sizeof(float));
+	key = hash_delay_cache_bytes(key, &router_opts.criticality_exp,
+			sizeof(float));
+
+	key = hash_delay_cache_bytes(key, &timing_inf.timing_analysis_enabled,
+			sizeof(boolean));
+	key = hash_delay_cache_bytes(key, &timing_inf.C_ipin_cblock,
+			sizeof(float));
+	key = hash_delay_cache_bytes(key, &timing_inf.T_ipin_cblock,
+			sizeof(float));
+
+	key = hash_delay_cache_bytes(key, &chan_width_dist.chan_width_io,
+			sizeof(float));
+	key = hash_delay_cache_chan(key, chan_width_dist.chan_x_dist);
+	key = hash_delay_cache_chan(key, chan_width_dist.chan_y_dist);
+
+	key = hash_delay_cache_bytes(key, &num_directs, sizeof(int));
+	for (i = 0; i < num_directs; i++) {
+		if (directs[i].from_pin != NULL) {
+			key = hash_delay_cache_bytes(key, directs[i].from_pin,
+					strlen(directs[i].from_pin) + 1);
+		}
+		if (directs[i].to_pin != NULL) {
+			key = hash_delay_cache_bytes(key, directs[i].to_pin,
+					strlen(directs[i].to_pin) + 1);
+		}
+		key = hash_delay_cache_bytes(key, &directs[i].x_offset, sizeof(int));
+		key = hash_delay_cache_bytes(key, &directs[i].y_offset, sizeof(int));
+		key = hash_delay_cache_bytes(key, &directs[i].z_offset, sizeof(int));
+		key = hash_delay_cache_bytes(key, &directs[i].Tdel, sizeof(float));
+	}
+
+	return key;
+}
+
+/**************************************/
+static unsigned int hash_delay_cache_chan(unsigned int key, t_chan chan) {
+
+	/* Folds one channel width distribution into key, field by field so *
+	 * that structure padding never reaches the hash.                   */
+
+	key = hash_delay_cache_bytes(key, &chan.type, sizeof(enum e_stat));
+	key = hash_delay_cache_bytes(key, &chan.peak, sizeof(float));
+	key = hash_delay_cache_bytes(key, &chan.width, sizeof(float));
+	key = hash_delay_cache_bytes(key, &chan.xpeak, sizeof(float));
+	key = hash_delay_cache_bytes(key, &chan.dc, sizeof(float));
+	return key;
+}
+
+/**************************************/
+static void format_delay_cache_header(char *header, unsigned int arch_key) {
+
+	/* The header line identifies what the cached arrays were computed for: *
+	 * the architecture key, the grid size, the channel width used by       *
+	 * setup_chan_width and, for interposer architectures, the cut settings.*/
+
+#ifdef INTERPOSER_BASED_ARCHITECTURE
+	sprintf(header, "%s %d %08x %d %d %d %d %d %d\n", DELAY_CACHE_MAGIC,
+			DELAY_CACHE_VERSION, arch_key, nx, ny, chan_width_x[0], num_cuts,
+			percent_wires_cut, delay_increase);
+#else
+	sprintf(header, "%s %d %08x %d %d %d\n", DELAY_CACHE_MAGIC,
+			DELAY_CACHE_VERSION, arch_key, nx, ny, chan_width_x[0]);
+#endif
+}
+
+/**************************************/
+static boolean read_delay_cache_matrix(FILE * fp, float **matrix, int max_x,
+		int max_y) {
+
+	int id_x;
+
+	for (id_x = 0; id_x <= max_x; id_x++) {
+		if (fread(matrix[id_x], sizeof(float), max_y + 1, fp)
+				!= (size_t) (max_y + 1)) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/**************************************/
+static void write_delay_cache_matrix(FILE * fp, float **matrix, int max_x,
+		int max_y) {
+
+	int id_x;
+
+	for (id_x = 0; id_x <= max_x; id_x++) {
+		fwrite(matrix[id_x], sizeof(float), max_y + 1, fp);
+	}
+}
+
+/**************************************/
+static boolean load_delay_lookup_cache(INP char *cache_file,
+		unsigned int arch_key) {
+
+	/* Fills the (already allocated) delta arrays from cache_file.  Returns  *
+	 * FALSE if the file is missing, was computed for a different device or *
+	 * is truncated; the caller then recomputes the arrays by routing.      */
+
+	FILE *fp;
+	char expected[BUFSIZE], found[BUFSIZE];
+	boolean success;
+
+	fp = fopen(cache_file, "rb");
+	if (fp == NULL) {
+		return FALSE;
+	}
+
+	format_delay_cache_header(expected, arch_key);
+	if (fgets(found, BUFSIZE, fp) == NULL || strcmp(expected, found) != 0) {
+		vpr_printf(TIO_MESSAGE_INFO, "Delay lookup cache '%s' does not match this architecture, grid or channel width; recomputing.\n",
+				cache_file);
+		fclose(fp);
+		return FALSE;
+	}
+
+	success = (boolean) (read_delay_cache_matrix(fp, delta_io_to_io, nx + 1, ny + 1)
+			&& read_delay_cache_matrix(fp, delta_io_to_clb, nx, ny)
+			&& read_delay_cache_matrix(fp, delta_clb_to_io, nx, ny)
+			&& read_delay_cache_matrix(fp, delta_clb_to_clb, nx - 1, ny - 1));
+	fclose(fp);
+
+	if (!success) {
+		vpr_printf(TIO_MESSAGE_WARNING, "Delay lookup cache '%s' is truncated; recomputing.\n",
+				cache_file);
+	}
+	return success;
+}
+
+/**************************************/
+static void save_delay_lookup_cache(INP char *cache_file, unsigned int arch_key) {
+
+	FILE *fp;
+	char header[BUFSIZE];
+
+	fp = fopen(cache_file, "wb");
+	if (fp == NULL) {
+		vpr_printf(TIO_MESSAGE_WARNING, "Could not open delay lookup cache '%s' for writing.\n",
+				cache_file);
+		return;
+	}
+
+	format_delay_cache_header(header, arch_key);
+	fputs(header, fp);
+	write_delay_cache_matrix(fp, delta_io_to_io, nx + 1, ny + 1);
+	write_delay_cache_matrix(fp, delta_io_to_clb, nx, ny);
+	write_delay_cache_matrix(fp, delta_clb_to_io, nx, ny);
+	write_delay_cache_matrix(fp, delta_clb_to_clb, nx - 1, ny - 1);
+	fclose(fp);
+
+	vpr_printf(TIO_MESSAGE_INFO, "Saved placement delay lookup tables to '%s'.\n",
+			cache_file);
+}
+
 /******* Globally Accessable Functions **********/
 
 /**************************************/
 void compute_delay_lookup_tables(struct s_router_opts router_opts,
 		struct s_det_routing_arch det_routing_arch, t_segment_inf * segment_inf,
 		t_timing_inf timing_inf, t_chan_width_dist chan_width_dist, INP t_direct_inf *directs, 
-		INP int num_directs) {
+		INP int num_directs, INP char *delay_cache_file) {
 
 	static struct s_net *original_net; /*this will be used as a pointer to remember what */
 
@@ -990,6 +1274,11 @@ void compute_delay_lookup_tables(struct s_router_opts router_opts,
 	static int original_num_nets;
 	static int original_num_blocks;
 	static int longest_length;
+	unsigned int arch_key;
+
+	/* The key must see the real block types, not the simplified device */
+	arch_key = compute_delay_cache_key(router_opts, det_routing_arch,
+			segment_inf, timing_inf, chan_width_dist, directs, num_directs);
 
 	load_simplified_device();
 
@@ -997,6 +1286,19 @@ void compute_delay_lookup_tables(struct s_router_opts router_opts,
 			&original_num_nets, &original_num_blocks);
 	setup_chan_width(router_opts, chan_width_dist);
 
+	alloc_delta_arrays();
+	if (delay_cache_file != NULL
+			&& load_delay_lookup_cache(delay_cache_file, arch_key)) {
+		vpr_printf(TIO_MESSAGE_INFO, "Loaded placement delay lookup tables from '%s'.\n",
+				delay_cache_file);
+
+		restore_original_device();
+
+		free_and_reset_internal_structures(original_net, original_block,
+				original_num_nets, original_num_blocks);
+		return;
+	}
+
 #ifdef INTERPOSER_BASED_ARCHITECTURE
 	/* Change the number of cuts to zero to avoid running the cut routine
 	 * at build_rr_graph. This is because placement uses only deltas to estimate
@@ -1015,11 +1317,14 @@ void compute_delay_lookup_tables(struct s_router_opts router_opts,
 
 	longest_length = get_longest_segment_length(det_routing_arch, segment_inf);
 
-	/*now setup and compute the actual arrays */
-	alloc_delta_arrays();
+	/*now compute the actual arrays */
 	compute_delta_arrays(router_opts, det_routing_arch, segment_inf, timing_inf,
 			longest_length);
 
+	if (delay_cache_file != NULL) {
+		save_delay_lookup_cache(delay_cache_file, arch_key);
+	}
+
 	/*free all data structures that are no longer needed */
 	free_routing_structs(router_opts, det_routing_arch, segment_inf,
 			timing_inf);
@@ -4,7 +4,7 @@
 void compute_delay_lookup_tables(struct s_router_opts router_opts,
 		struct s_det_routing_arch det_routing_arch, t_segment_inf * segment_inf,
 		t_timing_inf timing_inf, t_chan_width_dist chan_width_dist, INP t_direct_inf *directs, 
-		INP int num_directs);
+		INP int num_directs, INP char *delay_cache_file);
 void free_place_lookup_structs(void);
 
 extern float **delta_io_to_clb;
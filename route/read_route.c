@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <string.h>
+#include "util.h"
+#include "vpr_types.h"
+#include "globals.h"
+#include "hash.h"
+#include "ReadLine.h"
+#include "route_common.h"
+#include "read_route.h"
+
+/* Names print_route gives each t_rr_type. */
+static const char *rr_type_names[] = { "SOURCE", "SINK", "IPIN", "OPIN",
+		"CHANX", "CHANY", "INTRA_CLUSTER_EDGE" };
+
+/* The routing of the net being read, in file order.  route_switches[i] is *
+ * the switch from route_nodes[i] to route_nodes[i + 1], OPEN after a SINK. */
+static int *route_nodes = NULL; /* [0..max_route_nodes-1] */
+static short *route_switches = NULL; /* [0..max_route_nodes-1] */
+static int num_route_nodes = 0;
+static int max_route_nodes = 0;
+
+/******************** Subroutines local to this module **********************/
+
+static int get_route_net(char **tokens, struct s_hash_table *net_hash);
+
+static boolean add_route_node(char **tokens);
+
+static short get_edge_switch(int from_node, int to_node);
+
+static boolean load_net_route(int inet, int *node_mark, int *sink_count,
+		float pres_fac);
+
+/************************ Subroutine definitions ****************************/
+
+boolean *read_route(INP const char *route_file, INP float pres_fac) {
+
+	FILE *infile;
+	char **tokens;
+	int line, inet, cur_net, num_imported, num_missing, num_broken,
+			num_congested;
+	int *node_mark; /* [0..num_rr_nodes-1]: 1 + the last net that used the node */
+	int *sink_count; /* [0..num_rr_nodes-1]: scratch, all 0 between nets */
+	boolean *reroute_nets, *is_listed, *is_imported, is_broken;
+	struct s_hash_table *net_hash;
+
+	infile = fopen(route_file, "r");
+	if (infile == NULL) {
+		vpr_printf(TIO_MESSAGE_ERROR, "'%s' - Cannot open routing file.\n",
+				route_file);
+		exit(1);
+	}
+
+	/* Check array size in first line matches */
+	tokens = ReadLineTokens(infile, &line);
+	if (NULL == tokens || CountTokens(tokens) < 5
+			|| 0 != strcmp(tokens[0], "Array")
+			|| 0 != strcmp(tokens[1], "size:")
+			|| 0 != strcmp(tokens[3], "x")) {
+		vpr_printf(TIO_MESSAGE_ERROR, "'%s' - Bad FPGA size specification line in routing file.\n",
+				route_file);
+		exit(1);
+	}
+	if ((my_atoi(tokens[2]) != nx) || (my_atoi(tokens[4]) != ny)) {
+		vpr_printf(TIO_MESSAGE_ERROR, "'%s' - Current FPGA size (%d x %d) is different from size when routing generated (%d x %d).\n",
+				route_file, nx, ny, my_atoi(tokens[2]), my_atoi(tokens[4]));
+		exit(1);
+	}
+	FreeTokens(&tokens);
+
+	net_hash = alloc_hash_table();
+	for (inet = 0; inet < num_nets; inet++) {
+		insert_in_hash_table(net_hash, clb_net[inet].name, inet);
+	}
+
+	reroute_nets = (boolean *) my_calloc(num_nets, sizeof(boolean));
+	is_listed = (boolean *) my_calloc(num_nets, sizeof(boolean));
+	is_imported = (boolean *) my_calloc(num_nets, sizeof(boolean));
+	node_mark = (int *) my_calloc(num_rr_nodes, sizeof(int));
+	sink_count = (int *) my_calloc(num_rr_nodes, sizeof(int));
+
+	/* Each "Net" line starts a net; its "Node:" lines follow.  Global nets, *
+	 * nets no longer in the netlist and repeated nets are skipped.          */
+	cur_net = OPEN;
+	is_broken = FALSE;
+	tokens = ReadLineTokens(infile, &line);
+	for (;;) {
+		if (NULL == tokens || (0 == strcmp(tokens[0], "Net") && NULL != tokens[1])) {
+			if (cur_net != OPEN && !is_broken) {
+				is_imported[cur_net] = load_net_route(cur_net, node_mark,
+						sink_count, pres_fac);
+			}
+			if (NULL == tokens)
+				break;
+
+			cur_net = get_route_net(tokens, net_hash);
+			if (cur_net != OPEN) {
+				if (is_listed[cur_net]) {
+					cur_net = OPEN;
+				} else {
+					is_listed[cur_net] = TRUE;
+				}
+			}
+			is_broken = FALSE;
+			num_route_nodes = 0;
+		} else if (0 == strcmp(tokens[0], "Node:") && cur_net != OPEN
+				&& !is_broken) {
+			is_broken = (boolean) !add_route_node(tokens);
+		}
+		FreeTokens(&tokens);
+		tokens = ReadLineTokens(infile, &line);
+	}
+	fclose(infile);
+
+	num_imported = num_missing = num_broken = 0;
+	for (inet = 0; inet < num_nets; inet++) {
+		if (clb_net[inet].is_global || clb_net[inet].num_sinks == 0) {
+			continue;
+		}
+		if (is_imported[inet]) {
+			num_imported++;
+		} else {
+			reroute_nets[inet] = TRUE;
+			if (is_listed[inet]) {
+				num_broken++;
+			} else {
+				num_missing++;
+			}
+		}
+	}
+	num_congested = mark_congested_nets(reroute_nets);
+
+	vpr_printf(TIO_MESSAGE_INFO, "Imported the routing of %d nets from '%s'.\n",
+			num_imported, route_file);
+	vpr_printf(TIO_MESSAGE_INFO, "Rerouting %d nets: %d not in the file, %d no longer legal, %d congested.\n",
+			num_missing + num_broken + num_congested, num_missing, num_broken,
+			num_congested);
+
+	free_hash_table(net_hash);
+	free(is_listed);
+	free(is_imported);
+	free(node_mark);
+	free(sink_count);
+	free(route_nodes);
+	free(route_switches);
+	route_nodes = NULL;
+	route_switches = NULL;
+	num_route_nodes = max_route_nodes = 0;
+
+	return (reroute_nets);
+}
+
+static int get_route_net(char **tokens, struct s_hash_table *net_hash) {
+
+	/* Returns the net named on a "Net <index> (<name>)" line, or OPEN if it  *
+	 * is a global net or is not in the netlist.  The index is tried first;  *
+	 * it is only a hint, since the netlist may have changed.                */
+
+	char *name;
+	int inet, len;
+	struct s_hash *h_ptr;
+
+	if (NULL == tokens[2] || NULL != tokens[3]) /* ": global net connecting:" */
+		return (OPEN);
+
+	name = tokens[2];
+	len = strlen(name);
+	if (len < 2 || name[0] != '(' || name[len - 1] != ')')
+		return (OPEN);
+	name[len - 1] = '\0';
+	name++;
+
+	inet = my_atoi(tokens[1]);
+	if (inet < 0 || inet >= num_nets || 0 != strcmp(clb_net[inet].name, name)) {
+		h_ptr = get_hash_entry(net_hash, name);
+		if (h_ptr == NULL)
+			return (OPEN);
+		inet = h_ptr->index;
+	}
+
+	if (clb_net[inet].is_global)
+		return (OPEN);
+	return (inet);
+}
+
+static boolean add_route_node(char **tokens) {
+
+	/* Appends the node on a "Node:" line to route_nodes.  Returns FALSE if  *
+	 * it is not the same rr_node (type, location and ptc) in the current    *
+	 * rr graph.                                                             */
+
+	int inode, x, y, itoken, num_tokens;
+
+	num_tokens = CountTokens(tokens);
+	if (num_tokens < 6)
+		return (FALSE);
+
+	inode = my_atoi(tokens[1]);
+	if (inode < 0 || inode >= num_rr_nodes)
+		return (FALSE);
+	if (0 != strcmp(tokens[2], rr_type_names[rr_node[inode].type]))
+		return (FALSE);
+	if (sscanf(tokens[3], "(%d,%d)", &x, &y) != 2 || x != rr_node[inode].xlow
+			|| y != rr_node[inode].ylow)
+		return (FALSE);
+
+	/* Skip "to (xhigh,yhigh)" and the "Pin:", "Pad:", "Track:" or "Class:" label */
+	itoken = (0 == strcmp(tokens[4], "to") ? 7 : 5);
+	if (itoken >= num_tokens || my_atoi(tokens[itoken]) != rr_node[inode].ptc_num)
+		return (FALSE);
+
+	if (num_route_nodes == max_route_nodes) {
+		max_route_nodes = (max_route_nodes == 0 ? 64 : 2 * max_route_nodes);
+		route_nodes = (int *) my_realloc(route_nodes,
+				max_route_nodes * sizeof(int));
+		route_switches = (short *) my_realloc(route_switches,
+				max_route_nodes * sizeof(short));
+	}
+	route_nodes[num_route_nodes++] = inode;
+	return (TRUE);
+}
+
+static short get_edge_switch(int from_node, int to_node) {
+
+	/* Returns the switch of the edge from_node -> to_node, OPEN if none. */
+
+	int iedge;
+
+	for (iedge = 0; iedge < rr_node[from_node].num_edges; iedge++) {
+		if (rr_node[from_node].edges[iedge] == to_node)
+			return (rr_node[from_node].switches[iedge]);
+	}
+	return (OPEN);
+}
+
+static boolean load_net_route(int inet, int *node_mark, int *sink_count,
+		float pres_fac) {
+
+	/* Checks the routing in route_nodes the way check_route would: it starts *
+	 * at the net SOURCE, each node is reached over an rr edge from the one   *
+	 * before it, each branch after a SINK restarts from a node already in    *
+	 * the routing, no node is used twice, and the SINKs reached are exactly  *
+	 * the net's SINKs.  If it passes, it becomes the net's traceback and     *
+	 * its nodes' occupancies are updated.                                    */
+
+	int i, ipin, inode, mark;
+	boolean is_valid;
+	struct s_trace *tptr;
+
+	if (num_route_nodes == 0 || route_nodes[0] != net_rr_terminals[inet][0])
+		return (FALSE);
+
+	mark = inet + 1;
+	node_mark[route_nodes[0]] = mark;
+	is_valid = TRUE;
+	for (i = 1; i < num_route_nodes && is_valid; i++) {
+		inode = route_nodes[i];
+		if (rr_node[route_nodes[i - 1]].type == SINK) {
+			route_switches[i - 1] = OPEN;
+			if (node_mark[inode] != mark || rr_node[inode].type == SINK)
+				is_valid = FALSE;
+			continue;
+		}
+		route_switches[i - 1] = get_edge_switch(route_nodes[i - 1], inode);
+		if (route_switches[i - 1] == OPEN)
+			is_valid = FALSE;
+		if (rr_node[inode].type == SINK) {
+			sink_count[inode]++;
+		} else if (node_mark[inode] == mark) {
+			is_valid = FALSE;
+		}
+		node_mark[inode] = mark;
+	}
+	if (rr_node[route_nodes[num_route_nodes - 1]].type != SINK)
+		is_valid = FALSE;
+	route_switches[num_route_nodes - 1] = OPEN;
+
+	for (ipin = 1; ipin <= clb_net[inet].num_sinks; ipin++) {
+		sink_count[net_rr_terminals[inet][ipin]]--;
+	}
+	for (ipin = 1; ipin <= clb_net[inet].num_sinks; ipin++) {
+		inode = net_rr_terminals[inet][ipin];
+		if (sink_count[inode] != 0)
+			is_valid = FALSE;
+		sink_count[inode] = 0;
+	}
+	for (i = 0; i < num_route_nodes; i++) {
+		inode = route_nodes[i];
+		if (sink_count[inode] != 0) /* a SINK of another net */
+			is_valid = FALSE;
+		sink_count[inode] = 0;
+	}
+
+	if (!is_valid)
+		return (FALSE);
+
+	for (i = 0; i < num_route_nodes; i++) {
+		tptr = alloc_trace_data();
+		tptr->index = route_nodes[i];
+		tptr->iswitch = route_switches[i];
+		tptr->next = NULL;
+		if (i == 0) {
+			trace_head[inet] = tptr;
+		} else {
+			trace_tail[inet]->next = tptr;
+		}
+		trace_tail[inet] = tptr;
+	}
+	pathfinder_update_one_cost(trace_head[inet], 1, pres_fac);
+
+	return (TRUE);
+}
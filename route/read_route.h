@@ -0,0 +1,14 @@
+#ifndef READ_ROUTE_H
+#define READ_ROUTE_H
+
+/* Reads a .route file written by print_route back into trace_head and the *
+ * rr_node occupancies (--import_route).  The rr graph and the routing      *
+ * structures must already be built for the channel width the file was     *
+ * routed at.  Returns [0..num_nets-1], TRUE for each net the router still  *
+ * has to route: nets missing from the file, nets whose routing no longer  *
+ * connects their terminals in the current rr graph, and nets using an     *
+ * overused rr_node.  The caller frees it.                                  */
+
+boolean *read_route(INP const char *route_file, INP float pres_fac);
+
+#endif
@@ -21,11 +21,14 @@ static void breadth_first_add_source_to_heap(int inet);
 /************************ Subroutine definitions ****************************/
 
 boolean try_breadth_first_route(struct s_router_opts router_opts,
-		t_ivec ** clb_opins_used_locally, int width_fac) {
+		t_ivec ** clb_opins_used_locally, int width_fac,
+		boolean *reroute_nets) {
 
 	/* Iterated maze router ala Pathfinder Negotiated Congestion algorithm,  *
 	 * (FPGA 95 p. 111).  Returns TRUE if it can route this FPGA, FALSE if   *
-	 * it can't.                                                             */
+	 * it can't.  If reroute_nets is not NULL, only the nets marked in it    *
+	 * are rerouted; the rest keep their imported routing until they become  *
+	 * congested.                                                            */
 
 	float pres_fac;
 	boolean success, is_routable, rip_up_local_opins;
@@ -40,6 +43,8 @@ boolean try_breadth_first_route(struct s_router_opts router_opts,
 	for (itry = 1; itry <= router_opts.max_router_iterations; itry++) {
 
 		for (inet = 0; inet < num_nets; inet++) {
+			if (reroute_nets != NULL && !reroute_nets[inet])
+				continue; /* Keeps its imported routing. */
 			if (clb_net[inet].is_global == FALSE) { /* Skip global nets. */
 
 				pathfinder_update_one_cost(trace_head[inet], -1, pres_fac);
@@ -84,6 +89,9 @@ boolean try_breadth_first_route(struct s_router_opts router_opts,
 		pres_fac = std::min(pres_fac, static_cast<float>(HUGE_POSITIVE_FLOAT / 1e5));
 
 		pathfinder_update_cost(pres_fac, router_opts.acc_fac);
+
+		if (reroute_nets != NULL)
+			mark_congested_nets(reroute_nets);
 	}
 
 	vpr_printf(TIO_MESSAGE_INFO, "Routing failed.\n");
@@ -15,6 +15,8 @@
 #include "rr_graph.h"
 #include "read_xml_arch_file.h"
 #include "ReadOptions.h"
+#include "read_route.h"
+#include "out_buf.h"
 
 /***************** Variables shared only by route modules *******************/
 
@@ -83,9 +85,10 @@ static t_chunk linked_f_pointer_ch = {NULL, 0, NULL};
 /******************** Subroutines local to route_common.c *******************/
 
 static void free_trace_data(struct s_trace *tptr);
+static void print_route_nets(t_out_buf *out, int first, int last,
+		void *context);
 static void load_route_bb(int bb_factor);
 
-static struct s_trace *alloc_trace_data(void);
 static void add_to_heap(struct s_heap *hptr);
 static struct s_heap *alloc_heap_data(void);
 static struct s_linked_f_pointer *alloc_linked_f_pointer(void);
@@ -221,18 +224,21 @@ boolean try_route(int width_fac, struct s_router_opts router_opts,
 		struct s_det_routing_arch det_routing_arch, t_segment_inf * segment_inf,
 		t_timing_inf timing_inf, float **net_delay, t_slack * slacks,
 		t_chan_width_dist chan_width_dist, t_ivec ** clb_opins_used_locally,
-		boolean * Fc_clipped, t_direct_inf *directs, int num_directs) {
+		boolean * Fc_clipped, t_direct_inf *directs, int num_directs,
+		char *import_route_file) {
 
 	/* Attempts a routing via an iterated maze router algorithm.  Width_fac *
 	 * specifies the relative width of the channels, while the members of   *
 	 * router_opts determine the value of the costs assigned to routing     *
 	 * resource node, etc.  det_routing_arch describes the detailed routing *
 	 * architecture (connection and switch boxes) of the FPGA; it is used   *
-	 * only if a DETAILED routing has been selected.                        */
+	 * only if a DETAILED routing has been selected.  If import_route_file  *
+	 * is not NULL, the routing in it is loaded first and only the nets it  *
+	 * leaves unrouted, illegal or congested are rerouted.                  */
 
 	int tmp;
 	clock_t begin, end;
-	boolean success;
+	boolean success, *reroute_nets;
 	t_graph_type graph_type;
 
 	if (router_opts.route_type == GLOBAL) {
@@ -279,17 +285,25 @@ boolean try_route(int width_fac, struct s_router_opts router_opts,
 
 	init_route_structs(router_opts.bb_factor);
 
+	reroute_nets = NULL;
+	if (import_route_file != NULL) {
+		reroute_nets = read_route(import_route_file,
+				router_opts.first_iter_pres_fac);
+	}
+
 	if (router_opts.router_algorithm == BREADTH_FIRST) {
 		vpr_printf(TIO_MESSAGE_INFO, "Confirming Router Algorithm: BREADTH_FIRST.\n");
 		success = try_breadth_first_route(router_opts, clb_opins_used_locally,
-				width_fac);
+				width_fac, reroute_nets);
 	} else { /* TIMING_DRIVEN route */
 		vpr_printf(TIO_MESSAGE_INFO, "Confirming Router Algorithm: TIMING_DRIVEN.\n");
 		assert(router_opts.route_type != GLOBAL);
 		success = try_timing_driven_route(router_opts, net_delay, slacks,
-			clb_opins_used_locally,timing_inf.timing_analysis_enabled);
+			clb_opins_used_locally,timing_inf.timing_analysis_enabled,
+			reroute_nets);
 	}
 
+	free(reroute_nets);
 	free_rr_node_route_structs();
 
 	return (success);
@@ -391,6 +405,30 @@ void pathfinder_update_cost(float pres_fac, float acc_fac) {
 	}
 }
 
+int mark_congested_nets(boolean *reroute_nets) {
+
+	/* Marks every net whose routing uses an overused rr_node for rerouting. *
+	 * Returns the number of nets newly marked.                              */
+
+	int inet, num_marked;
+	struct s_trace *tptr;
+
+	num_marked = 0;
+	for (inet = 0; inet < num_nets; inet++) {
+		if (reroute_nets[inet])
+			continue;
+		for (tptr = trace_head[inet]; tptr != NULL; tptr = tptr->next) {
+			if (rr_node[tptr->index].occ > rr_node[tptr->index].capacity) {
+				reroute_nets[inet] = TRUE;
+				num_marked++;
+				break;
+			}
+		}
+	}
+
+	return (num_marked);
+}
+
 void init_route_structs(int bb_factor) {
 
 	/* Call this before you route any nets.  It frees any old traceback and   *
@@ -1039,7 +1077,7 @@ void invalidate_heap_entries(int sink_node, int ipin_node) {
 	}
 }
 
-static struct s_trace *
+struct s_trace *
 alloc_trace_data(void) {
 
 	struct s_trace *temp_ptr;
@@ -1092,28 +1130,27 @@ alloc_linked_f_pointer(void) {
 	return (temp_ptr);
 }
 
-void print_route(char *route_file) {
+static void print_route_nets(t_out_buf *out, int first, int last,
+		void *context) {
 
-	/* Prints out the routing to file route_file.  */
+	/* Prints the routing of nets [first..last-1] the way print_route lays *
+	 * out the file.  Runs on several threads; only reads the routing.     */
 
 	int inet, inode, ipin, bnum, ilow, jlow, node_block_pin, iclass;
 	t_rr_type rr_type;
 	struct s_trace *tptr;
 	const char *name_type[] = { "SOURCE", "SINK", "IPIN", "OPIN", "CHANX", "CHANY",
 			"INTRA_CLUSTER_EDGE" };
-	FILE *fp;
-
-	fp = fopen(route_file, "w");
+	const char *padded_name_type[] = { "SOURCE", "  SINK", "  IPIN", "  OPIN",
+			" CHANX", " CHANY", "INTRA_CLUSTER_EDGE" }; /* "%6s" */
 
-	fprintf(fp, "Array size: %d x %d logic blocks.\n", nx, ny);
-	fprintf(fp, "\nRouting:");
-	for (inet = 0; inet < num_nets; inet++) {
+	for (inet = first; inet < last; inet++) {
 		if (clb_net[inet].is_global == FALSE) {
 			if (clb_net[inet].num_sinks == FALSE) {
-				fprintf(fp, "\n\nNet %d (%s)\n\n", inet, clb_net[inet].name);
-				fprintf(fp, "\n\nUsed in local cluster only, reserved one CLB pin\n\n");
+				out_printf(out, "\n\nNet %d (%s)\n\n", inet, clb_net[inet].name);
+				out_str(out, "\n\nUsed in local cluster only, reserved one CLB pin\n\n");
 			} else {
-				fprintf(fp, "\n\nNet %d (%s)\n\n", inet, clb_net[inet].name);
+				out_printf(out, "\n\nNet %d (%s)\n\n", inet, clb_net[inet].name);
 				tptr = trace_head[inet];
 
 				while (tptr != NULL) {
@@ -1122,35 +1159,47 @@ void print_route(char *route_file) {
 					ilow = rr_node[inode].xlow;
 					jlow = rr_node[inode].ylow;
 
-					fprintf(fp, "Node:\t%d\t%6s (%d,%d) ", inode, name_type[rr_type], ilow, jlow);
+					out_str(out, "Node:\t");
+					out_int(out, inode);
+					out_char(out, '\t');
+					out_str(out, padded_name_type[rr_type]);
+					out_str(out, " (");
+					out_int(out, ilow);
+					out_char(out, ',');
+					out_int(out, jlow);
+					out_str(out, ") ");
 
 					if ((ilow != rr_node[inode].xhigh)
-							|| (jlow != rr_node[inode].yhigh))
-						fprintf(fp, "to (%d,%d) ", rr_node[inode].xhigh,
-								rr_node[inode].yhigh);
+							|| (jlow != rr_node[inode].yhigh)) {
+						out_str(out, "to (");
+						out_int(out, rr_node[inode].xhigh);
+						out_char(out, ',');
+						out_int(out, rr_node[inode].yhigh);
+						out_str(out, ") ");
+					}
 
 					switch (rr_type) {
 
 					case IPIN:
 					case OPIN:
 						if (grid[ilow][jlow].type == IO_TYPE) {
-							fprintf(fp, " Pad: ");
+							out_str(out, " Pad: ");
 						} else { /* IO Pad. */
-							fprintf(fp, " Pin: ");
+							out_str(out, " Pin: ");
 						}
 						break;
 
 					case CHANX:
 					case CHANY:
-						fprintf(fp, " Track: ");
+						out_str(out, " Track: ");
 						break;
 
 					case SOURCE:
 					case SINK:
 						if (grid[ilow][jlow].type == IO_TYPE) {
-							fprintf(fp, " Pad: ");
+							out_str(out, " Pad: ");
 						} else { /* IO Pad. */
-							fprintf(fp, " Class: ");
+							out_str(out, " Class: ");
 						}
 						break;
 
@@ -1161,14 +1210,16 @@ void print_route(char *route_file) {
 						break;
 					}
 
-					fprintf(fp, "%d  ", rr_node[inode].ptc_num);
+					out_int(out, rr_node[inode].ptc_num);
+					out_str(out, "  ");
 
 					/* Uncomment line below if you're debugging and want to see the switch types *
 					 * used in the routing.                                                      */
-					fprintf (fp, "Switch: %d", tptr->iswitch);
-					fprintf (fp, "\t\t Switch_Delay: %g", switch_inf[tptr->iswitch].Tdel);
+					out_str(out, "Switch: ");
+					out_int(out, tptr->iswitch);
+					out_printf(out, "\t\t Switch_Delay: %g", switch_inf[tptr->iswitch].Tdel);
 
-					fprintf(fp, "\n");
+					out_char(out, '\n');
 
 					tptr = tptr->next;
 				}
@@ -1176,7 +1227,7 @@ void print_route(char *route_file) {
 		}
 
 		else { /* Global net.  Never routed. */
-			fprintf(fp, "\n\nNet %d (%s): global net connecting:\n\n", inet,
+			out_printf(out, "\n\nNet %d (%s): global net connecting:\n\n", inet,
 					clb_net[inet].name);
 
 			for (ipin = 0; ipin <= clb_net[inet].num_sinks; ipin++) {
@@ -1185,14 +1236,29 @@ void print_route(char *route_file) {
 				node_block_pin = clb_net[inet].node_block_pin[ipin];
 				iclass = block[bnum].type->pin_class[node_block_pin];
 
-				fprintf(fp, "Block %s (#%d) at (%d, %d), Pin class %d.\n",
+				out_printf(out, "Block %s (#%d) at (%d, %d), Pin class %d.\n",
 						block[bnum].name, bnum, block[bnum].x, block[bnum].y,
 						iclass);
 			}
 		}
 	}
+}
+
+void print_route(char *route_file) {
+
+	/* Prints out the routing to file route_file.  The nets are formatted in *
+	 * parallel and written in net order.                                    */
+
+	t_out_buf *out;
+	FILE *fp;
+
+	out = open_out_file(route_file);
+
+	out_printf(out, "Array size: %d x %d logic blocks.\n", nx, ny);
+	out_str(out, "\nRouting:");
+	write_out_buf_parallel(out, num_nets, print_route_nets, NULL);
 
-	fclose(fp);
+	close_out_file(out);
 
 	if (getEchoEnabled() && isEchoFileEnabled(E_ECHO_MEM)) {
 		fp = my_fopen(getEchoFileName(E_ECHO_MEM), "w", 0);
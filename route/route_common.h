@@ -72,6 +72,8 @@ void pathfinder_update_one_cost(struct s_trace *route_segment_start,
 
 void pathfinder_update_cost(float pres_fac, float acc_fac);
 
+int mark_congested_nets(boolean *reroute_nets);
+
 struct s_trace *update_traceback(struct s_heap *hptr, int inet);
 
 void reset_path_costs(void);
@@ -87,6 +89,8 @@ boolean is_empty_heap(void);
 
 void free_traceback(int inet);
 
+struct s_trace *alloc_trace_data(void);
+
 void add_to_mod_list(float *fptr);
 
 struct s_heap *get_heap_head(void);
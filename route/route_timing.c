@@ -47,11 +47,15 @@ static int mark_node_expansion_by_bin(int inet, int target_node,
 /************************ Subroutine definitions *****************************/
 
 boolean try_timing_driven_route(struct s_router_opts router_opts,
-		float **net_delay, t_slack * slacks, t_ivec ** clb_opins_used_locally, boolean timing_analysis_enabled) {
+		float **net_delay, t_slack * slacks, t_ivec ** clb_opins_used_locally, boolean timing_analysis_enabled,
+		boolean *reroute_nets) {
 
 	/* Timing-driven routing algorithm.  The timing graph (includes slack)   *
 	 * must have already been allocated, and net_delay must have been allocated. *
-	 * Returns TRUE if the routing succeeds, FALSE otherwise.                    */
+	 * Returns TRUE if the routing succeeds, FALSE otherwise.                    *
+	 * If reroute_nets is not NULL, the other nets keep their imported routing  *
+	 * and only nets marked in it (and nets that later become congested) are    *
+	 * ripped up and rerouted.                                                  */
 
 	int itry, inet, ipin, i, bends, wirelength, total_wirelength, available_wirelength, 
 		segments, *net_index, *sink_order /* [1..max_pins_per_net-1] */;
@@ -110,6 +114,8 @@ boolean try_timing_driven_route(struct s_router_opts router_opts,
 
 		for (i = 0; i < num_nets; i++) {
 			inet = net_index[i];
+			if (reroute_nets != NULL && !reroute_nets[inet])
+				continue; /* Keeps its imported routing. */
 			if (clb_net[inet].is_global == FALSE) { /* Skip global nets. */
 
 				is_routable = timing_driven_route_net(inet, pres_fac,
@@ -131,6 +137,11 @@ boolean try_timing_driven_route(struct s_router_opts router_opts,
 			}
 		}
 
+		if (itry == 1 && reroute_nets != NULL) {
+			/* Only now is every net routed; the imported nets need delays too. */
+			load_net_delay_from_routing(net_delay, clb_net, num_nets);
+		}
+
 		if (itry == 1) {
 			/* Early exit code for cases where it is obvious that a successful route will not be found 
 			 Heuristic: If total wirelength used in first routing iteration is X% of total available wirelength, exit
@@ -270,6 +281,10 @@ boolean try_timing_driven_route(struct s_router_opts router_opts,
 			pathfinder_update_cost(pres_fac, router_opts.acc_fac);
 		}
 
+		if (reroute_nets != NULL) {
+			mark_congested_nets(reroute_nets);
+		}
+
 		if (timing_analysis_enabled) {		
 			/* Update slack values by doing another timing analysis.                 *
 			 * Timing_driven_route_net updated the net delay values.                 */
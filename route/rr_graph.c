@@ -16,6 +16,7 @@
 #include "read_xml_arch_file.h"
 #include "ReadOptions.h"
 #include "rr_graph_multi.h"
+#include "out_buf.h"
 
 /* #define ENABLE_DUMP */
 /* #define MUX_SIZE_DIST_DISPLAY */
@@ -173,6 +174,11 @@ static void print_distribution(FILE * fptr,
 		t_mux_size_distribution * distr_struct);
 #endif
 
+static void out_rr_node(t_out_buf *out, t_rr_node *L_rr_node, int inode);
+
+static void dump_rr_nodes(t_out_buf *out, int first, int last,
+		void *context);
+
 static void free_type_pin_to_track_map(int***** ipin_to_track_map,
 		t_type_ptr types);
 
@@ -1796,15 +1802,11 @@ alloc_and_load_track_to_pin_lookup(INP int ****pin_to_track_map, INP int *Fc,
  * only for debugging.                                                    */
 void dump_rr_graph(INP const char *file_name) {
 
-	int inode;
-	FILE *fp;
+	t_out_buf *out;
 
-	fp = my_fopen(file_name, "w", 0);
+	out = open_out_file(file_name);
 
-	for (inode = 0; inode < num_rr_nodes; inode++) {
-		print_rr_node(fp, rr_node, inode);
-		fprintf(fp, "\n");
-	}
+	write_out_buf_parallel(out, num_rr_nodes, dump_rr_nodes, NULL);
 
 #if 0
 	fprintf(fp, "\n\n%d rr_indexed_data entries.\n\n", num_rr_indexed_data);
@@ -1816,12 +1818,34 @@ void dump_rr_graph(INP const char *file_name) {
 	}
 #endif
 
-	fclose(fp);
+	close_out_file(out);
+}
+
+static void dump_rr_nodes(t_out_buf *out, int first, int last,
+		void *context) {
+
+	int inode;
+
+	for (inode = first; inode < last; inode++) {
+		out_rr_node(out, rr_node, inode);
+		out_char(out, '\n');
+	}
 }
 
 /* Prints all the data about node inode to file fp.                    */
 void print_rr_node(FILE * fp, t_rr_node * L_rr_node, int inode) {
 
+	t_out_buf out;
+
+	init_out_buf(&out);
+	out_rr_node(&out, L_rr_node, inode);
+	fwrite(out.text, 1, out.size, fp);
+	free_out_buf(&out);
+}
+
+/* Appends all the data about node inode to out.                       */
+static void out_rr_node(t_out_buf *out, t_rr_node *L_rr_node, int inode) {
+
 	static const char *name_type[] = { "SOURCE", "SINK", "IPIN", "OPIN",
 			"CHANX", "CHANY", "INTRA_CLUSTER_EDGE" };
 	static const char *direction_name[] = { "OPEN", "INC_DIRECTION",
@@ -1840,37 +1864,57 @@ void print_rr_node(FILE * fp, t_rr_node * L_rr_node, int inode) {
 	assert(
 			(L_rr_node[inode].drivers + 1) < (int)(sizeof(drivers_name) / sizeof(char *)));
 
-	fprintf(fp, "Node: %d %s ", inode, name_type[rr_type]);
-	if ((L_rr_node[inode].xlow == L_rr_node[inode].xhigh)
-			&& (L_rr_node[inode].ylow == L_rr_node[inode].yhigh)) {
-		fprintf(fp, "(%d, %d) ", L_rr_node[inode].xlow, L_rr_node[inode].ylow);
-	} else {
-		fprintf(fp, "(%d, %d) to (%d, %d) ", L_rr_node[inode].xlow,
-				L_rr_node[inode].ylow, L_rr_node[inode].xhigh,
-				L_rr_node[inode].yhigh);
-	}
-	fprintf(fp, "Ptc_num: %d ", L_rr_node[inode].ptc_num);
-	fprintf(fp, "Direction: %s ",
-			direction_name[L_rr_node[inode].direction + 1]);
-	fprintf(fp, "Drivers: %s ", drivers_name[L_rr_node[inode].drivers + 1]);
-	fprintf(fp, "\n");
-
-	fprintf(fp, "%d edge(s):", L_rr_node[inode].num_edges);
-	for (iconn = 0; iconn < L_rr_node[inode].num_edges; iconn++)
-		fprintf(fp, " %d", L_rr_node[inode].edges[iconn]);
-	fprintf(fp, "\n");
-
-	fprintf(fp, "Switch types:");
-	for (iconn = 0; iconn < L_rr_node[inode].num_edges; iconn++)
-		fprintf(fp, " %d", L_rr_node[inode].switches[iconn]);
-	fprintf(fp, "\n");
-
-	fprintf(fp, "Occ: %d  Capacity: %d\n", L_rr_node[inode].occ,
-			L_rr_node[inode].capacity);
+	out_str(out, "Node: ");
+	out_int(out, inode);
+	out_char(out, ' ');
+	out_str(out, name_type[rr_type]);
+	out_str(out, " (");
+	out_int(out, L_rr_node[inode].xlow);
+	out_str(out, ", ");
+	out_int(out, L_rr_node[inode].ylow);
+	out_str(out, ") ");
+	if ((L_rr_node[inode].xlow != L_rr_node[inode].xhigh)
+			|| (L_rr_node[inode].ylow != L_rr_node[inode].yhigh)) {
+		out_str(out, "to (");
+		out_int(out, L_rr_node[inode].xhigh);
+		out_str(out, ", ");
+		out_int(out, L_rr_node[inode].yhigh);
+		out_str(out, ") ");
+	}
+	out_str(out, "Ptc_num: ");
+	out_int(out, L_rr_node[inode].ptc_num);
+	out_str(out, " Direction: ");
+	out_str(out, direction_name[L_rr_node[inode].direction + 1]);
+	out_str(out, " Drivers: ");
+	out_str(out, drivers_name[L_rr_node[inode].drivers + 1]);
+	out_str(out, " \n");
+
+	out_int(out, L_rr_node[inode].num_edges);
+	out_str(out, " edge(s):");
+	for (iconn = 0; iconn < L_rr_node[inode].num_edges; iconn++) {
+		out_char(out, ' ');
+		out_int(out, L_rr_node[inode].edges[iconn]);
+	}
+	out_char(out, '\n');
+
+	out_str(out, "Switch types:");
+	for (iconn = 0; iconn < L_rr_node[inode].num_edges; iconn++) {
+		out_char(out, ' ');
+		out_int(out, L_rr_node[inode].switches[iconn]);
+	}
+	out_char(out, '\n');
+
+	out_str(out, "Occ: ");
+	out_int(out, L_rr_node[inode].occ);
+	out_str(out, "  Capacity: ");
+	out_int(out, L_rr_node[inode].capacity);
+	out_char(out, '\n');
 	if (rr_type != INTRA_CLUSTER_EDGE) {
-		fprintf(fp, "R: %g  C: %g\n", L_rr_node[inode].R, L_rr_node[inode].C);
+		out_printf(out, "R: %g  C: %g\n", L_rr_node[inode].R, L_rr_node[inode].C);
 	}
-	fprintf(fp, "Cost_index: %d\n", L_rr_node[inode].cost_index);
+	out_str(out, "Cost_index: ");
+	out_int(out, L_rr_node[inode].cost_index);
+	out_char(out, '\n');
 }
 
 /* Prints all the rr_indexed_data of index to file fp.   */
@@ -14,6 +14,7 @@
 #include "ReadOptions.h"
 #include "read_sdc.h"
 #include "stats.h"
+#include "out_buf.h"
 
 /**************************** Top-level summary ******************************
 
@@ -228,7 +229,15 @@ static void propagate_clock_domain_and_skew(int inode);
 
 static void process_constraints(void);
 
-static void print_global_criticality_stats(FILE * fp, float ** criticality, const char * singular_name, const char * capitalized_plural_name);
+static void print_global_criticality_stats(t_out_buf * out, float ** criticality, const char * singular_name, const char * capitalized_plural_name);
+
+static void print_slack_nets(t_out_buf * out, int first, int last, void * context);
+
+static void print_criticality_nets(t_out_buf * out, int first, int last, void * context);
+
+static void print_net_delay_nets(t_out_buf * out, int first, int last, void * context);
+
+static void print_timing_graph_tnodes(t_out_buf * out, int first, int last, void * context);
 
 static void print_timing_constraint_info(const char *fname);
 
@@ -387,6 +396,53 @@ void load_timing_graph_net_delays(float **net_delay) {
 	}
 }
 
+int load_pre_packing_intra_cluster_net_delays(int iblk,
+		float intra_cluster_net_delay) {
+
+	/* Used by the clusterer on the pre-packed timing graph once logical block  *
+	 * iblk is committed to a cluster.  Every connection from an output of iblk *
+	 * to a sink in the same cluster now has the intra-cluster net delay rather *
+	 * than the inter-cluster delay it was created with.  Connections into iblk *
+	 * are updated when their driver is.  Returns the number of edges changed,  *
+	 * so the caller knows whether another timing analysis can change anything. */
+
+	int iport, ipin, inet, inode, isink, num_changed;
+	t_model_ports *model_port;
+	t_tedge *tedge;
+
+	num_changed = 0;
+	if (logical_block[iblk].type == VPACK_OUTPAD) {
+		return num_changed;
+	}
+
+	iport = 0;
+	model_port = logical_block[iblk].model->outputs;
+	while (model_port) {
+		for (ipin = 0; ipin < model_port->size; ipin++) {
+			inet = logical_block[iblk].output_nets[iport][ipin];
+			if (inet == OPEN || vpack_net[inet].is_const_gen
+					|| vpack_net[inet].is_global) {
+				continue;
+			}
+			inode = f_net_to_driver_tnode[inet];
+			tedge = tnode[inode].out_edges;
+
+			/* Edges are in the same order as the sinks of the net, see alloc_and_load_tnodes_from_prepacked_netlist */
+			for (isink = 1; isink <= vpack_net[inet].num_sinks; isink++) {
+				if (logical_block[vpack_net[inet].node_block[isink]].clb_index
+						== logical_block[iblk].clb_index
+						&& tedge[isink - 1].Tdel != intra_cluster_net_delay) {
+					tedge[isink - 1].Tdel = intra_cluster_net_delay;
+					num_changed++;
+				}
+			}
+		}
+		iport++;
+		model_port = model_port->next;
+	}
+	return num_changed;
+}
+
 void free_timing_graph(t_slack * slacks) {
 
 	int inode;
@@ -442,17 +498,16 @@ void print_slack(float ** slack, boolean slack_is_normalized, const char *fname)
 
 	/* Prints slacks into a file. */
 
-	int inet, iedge, ibucket, driver_tnode, num_edges, num_unused_slacks = 0;
-	t_tedge * tedge;
-	FILE *fp;
+	int inet, iedge, ibucket, num_edges, num_unused_slacks = 0;
+	t_out_buf *out;
 	float max_slack = HUGE_NEGATIVE_FLOAT, min_slack = HUGE_POSITIVE_FLOAT, 
 		total_slack = 0, total_negative_slack = 0, bucket_size, slk;
 	int slacks_in_bucket[NUM_BUCKETS]; 
 
-	fp = my_fopen(fname, "w", 0);
+	out = open_out_file(fname);
 
 	if (slack_is_normalized) {
-		fprintf(fp, "The following slacks have been normalized to be non-negative by "
+		out_printf(out, "The following slacks have been normalized to be non-negative by "
 					"relaxing the required times to the maximum arrival time.\n\n");
 	}
 
@@ -476,19 +531,19 @@ void print_slack(float ** slack, boolean slack_is_normalized, const char *fname)
 	}
 
 	if (max_slack > HUGE_NEGATIVE_FLOAT + 1) {
-		fprintf(fp, "Largest slack in design: %g\n", max_slack);
+		out_printf(out, "Largest slack in design: %g\n", max_slack);
 	} else {
-		fprintf(fp, "Largest slack in design: --\n");
+		out_printf(out, "Largest slack in design: --\n");
 	}
 	
 	if (min_slack < HUGE_POSITIVE_FLOAT - 1) {
-		fprintf(fp, "Smallest slack in design: %g\n", min_slack);
+		out_printf(out, "Smallest slack in design: %g\n", min_slack);
 	} else {
-		fprintf(fp, "Smallest slack in design: --\n");
+		out_printf(out, "Smallest slack in design: --\n");
 	}
 
-	fprintf(fp, "Total slack in design: %g\n", total_slack);
-	fprintf(fp, "Total negative slack: %g\n", total_negative_slack);
+	out_printf(out, "Total slack in design: %g\n", total_slack);
+	out_printf(out, "Total negative slack: %g\n", total_negative_slack);
 
 	if (max_slack - min_slack > EPSILON) { /* Only sort the slacks into buckets if not all slacks are the same (if they are identical, no need to sort). */
 		/* Initialize slacks_in_bucket, an array counting how many slacks are within certain linearly-spaced ranges (buckets). */
@@ -516,96 +571,126 @@ void print_slack(float ** slack, boolean slack_is_normalized, const char *fname)
 		}
 
 		/* Now print how many slacks are in each bucket. */
-		fprintf(fp, "\n\nRange\t\t");
+		out_printf(out, "\n\nRange\t\t");
 		for (ibucket = 0; ibucket < NUM_BUCKETS; ibucket++) {
-			fprintf(fp, "%.1e to ", min_slack);
+			out_printf(out, "%.1e to ", min_slack);
 			min_slack += bucket_size;
-			fprintf(fp, "%.1e\t", min_slack);
+			out_printf(out, "%.1e\t", min_slack);
 		}
-		fprintf(fp, "Not analysed");
-		fprintf(fp, "\nSlacks in range\t\t");
+		out_printf(out, "Not analysed");
+		out_printf(out, "\nSlacks in range\t\t");
 		for (ibucket = 0; ibucket < NUM_BUCKETS; ibucket++) {
-			fprintf(fp, "%d\t\t\t", slacks_in_bucket[ibucket]);
+			out_printf(out, "%d\t\t\t", slacks_in_bucket[ibucket]);
 		}
-		fprintf(fp, "%d", num_unused_slacks);
+		out_printf(out, "%d", num_unused_slacks);
 	}
 
 	/* Finally, print all the slacks, organized by net. */
-	fprintf(fp, "\n\nNet #\tDriver_tnode\tto_node\tSlack\n\n");
+	out_printf(out, "\n\nNet #\tDriver_tnode\tto_node\tSlack\n\n");
 
-	for (inet = 0; inet < num_timing_nets; inet++) {
+	write_out_buf_parallel(out, num_timing_nets, print_slack_nets, slack);
+
+	close_out_file(out);
+}
+
+static void print_slack_nets(t_out_buf * out, int first, int last, void * context) {
+
+	/* Prints the slacks of nets [first..last-1] for print_slack, one row per edge. */
+
+	int inet, iedge, driver_tnode, num_edges;
+	t_tedge * tedge;
+	float ** slack, slk;
+
+	slack = (float **) context;
+	for (inet = first; inet < last; inet++) {
 		driver_tnode = f_net_to_driver_tnode[inet];
 		num_edges = tnode[driver_tnode].num_edges;
 		tedge = tnode[driver_tnode].out_edges;
-		slk = slack[inet][1];
-		if (slk < HUGE_POSITIVE_FLOAT - 1) {
-			fprintf(fp, "%5d\t%5d\t\t%5d\t%g\n", inet, driver_tnode, tedge[0].to_node, slk);
-		} else { /* Slack is meaningless, so replace with --. */
-			fprintf(fp, "%5d\t%5d\t\t%5d\t--\n", inet, driver_tnode, tedge[0].to_node);
-		}
-		for (iedge = 1; iedge < num_edges; iedge++) { /* newline and indent subsequent edges after the first */
-			slk = slack[inet][iedge+1];
+		for (iedge = 0; iedge < num_edges; iedge++) {
+			if (iedge == 0) { /* "%5d\t%5d\t\t%5d\t" */
+				out_int_width(out, inet, 5);
+				out_char(out, '\t');
+				out_int_width(out, driver_tnode, 5);
+				out_str(out, "\t\t");
+			} else { /* indent subsequent edges after the first */
+				out_str(out, "\t\t\t");
+			}
+			out_int_width(out, tedge[iedge].to_node, 5);
+			slk = slack[inet][iedge + 1];
 			if (slk < HUGE_POSITIVE_FLOAT - 1) {
-				fprintf(fp, "\t\t\t%5d\t%g\n", tedge[iedge].to_node, slk);
+				out_printf(out, "\t%g\n", slk);
 			} else { /* Slack is meaningless, so replace with --. */
-				fprintf(fp, "\t\t\t%5d\t--\n", tedge[iedge].to_node);
+				out_str(out, "\t--\n");
 			}
 		}
 	}
-
-	fclose(fp);
 }
 
 void print_criticality(t_slack * slacks, boolean criticality_is_normalized, const char *fname) {
 
 	/* Prints timing criticalities (and path criticalities if enabled) into a file. */
 
-	int inet, iedge, driver_tnode, num_edges;
-	t_tedge * tedge;
-	FILE *fp;
+	t_out_buf *out;
 
-	fp = my_fopen(fname, "w", 0);
+	out = open_out_file(fname);
 
 	if (criticality_is_normalized) {
-		fprintf(fp, "Timing criticalities have been normalized to be non-negative by "
+		out_printf(out, "Timing criticalities have been normalized to be non-negative by "
 					"relaxing the required times to the maximum arrival time.\n\n");
 	}
 
-	print_global_criticality_stats(fp, slacks->timing_criticality, "timing criticality", "Timing criticalities");
+	print_global_criticality_stats(out, slacks->timing_criticality, "timing criticality", "Timing criticalities");
 #ifdef PATH_COUNTING
-	print_global_criticality_stats(fp, slacks->path_criticality, "path criticality", "Path criticalities");
+	print_global_criticality_stats(out, slacks->path_criticality, "path criticality", "Path criticalities");
 #endif
 
 	/* Finally, print all the criticalities, organized by net. */
-	fprintf(fp, "\n\nNet #\tDriver_tnode\t to_node\tTiming criticality"
+	out_printf(out, "\n\nNet #\tDriver_tnode\t to_node\tTiming criticality"
 #ifdef PATH_COUNTING
 		"\tPath criticality"
 #endif
 		"\n");
 
-	for (inet = 0; inet < num_timing_nets; inet++) {
+	write_out_buf_parallel(out, num_timing_nets, print_criticality_nets, slacks);
+
+	close_out_file(out);
+}
+
+static void print_criticality_nets(t_out_buf * out, int first, int last, void * context) {
+
+	/* Prints the criticalities of nets [first..last-1] for print_criticality. */
+
+	int inet, iedge, driver_tnode, num_edges;
+	t_tedge * tedge;
+	t_slack * slacks;
+
+	slacks = (t_slack *) context;
+	for (inet = first; inet < last; inet++) {
 		driver_tnode = f_net_to_driver_tnode[inet];
 		num_edges = tnode[driver_tnode].num_edges;
 		tedge = tnode[driver_tnode].out_edges;
-
-		fprintf(fp, "\n%5d\t%5d\t\t%5d\t\t%.6f", inet, driver_tnode, tedge[0].to_node, slacks->timing_criticality[inet][1]);
-#ifdef PATH_COUNTING
-		fprintf(fp, "\t\t%g", slacks->path_criticality[inet][1]);
-#endif
-		for (iedge = 1; iedge < num_edges; iedge++) { /* newline and indent subsequent edges after the first */
-			fprintf(fp, "\n\t\t\t%5d\t\t%.6f", tedge[iedge].to_node, slacks->timing_criticality[inet][iedge+1]);
+		for (iedge = 0; iedge < num_edges; iedge++) {
+			if (iedge == 0) { /* "\n%5d\t%5d\t\t%5d\t\t" */
+				out_char(out, '\n');
+				out_int_width(out, inet, 5);
+				out_char(out, '\t');
+				out_int_width(out, driver_tnode, 5);
+				out_str(out, "\t\t");
+			} else { /* newline and indent subsequent edges after the first */
+				out_str(out, "\n\t\t\t");
+			}
+			out_int_width(out, tedge[iedge].to_node, 5);
+			out_printf(out, "\t\t%.6f", slacks->timing_criticality[inet][iedge + 1]);
 #ifdef PATH_COUNTING
-			fprintf(fp, "\t\t%g", slacks->path_criticality[inet][iedge+1]);
+			out_printf(out, "\t\t%g", slacks->path_criticality[inet][iedge + 1]);
 #endif
 		}
 	}
-
-	fclose(fp);
 }
 
-static void print_global_criticality_stats(FILE * fp, float ** criticality, const char * singular_name, const char * capitalized_plural_name) {
+static void print_global_criticality_stats(t_out_buf * out, float ** criticality, const char * singular_name, const char * capitalized_plural_name) {
 	
-	/* Prints global stats for timing or path criticality to the file pointed to by	fp,
+	/* Prints global stats for timing or path criticality to out,
 	including maximum criticality, minimum criticality, total criticality in the design,
 	and the number of criticalities within various ranges, or buckets. */
 
@@ -625,9 +710,9 @@ static void print_global_criticality_stats(FILE * fp, float ** criticality, cons
 		}
 	}
 
-	fprintf(fp, "Largest %s in design: %g\n", singular_name, max_criticality);
-	fprintf(fp, "Smallest %s in design: %g\n", singular_name, min_criticality);
-	fprintf(fp, "Total %s in design: %g\n", singular_name, total_criticality);
+	out_printf(out, "Largest %s in design: %g\n", singular_name, max_criticality);
+	out_printf(out, "Smallest %s in design: %g\n", singular_name, min_criticality);
+	out_printf(out, "Total %s in design: %g\n", singular_name, total_criticality);
 
 	if (max_criticality - min_criticality > EPSILON) { /* Only sort the criticalities into buckets if not all criticalities are the same (if they are identical, no need to sort). */
 		/* Initialize criticalities_in_bucket, an array counting how many criticalities are within certain linearly-spaced ranges (buckets). */
@@ -653,43 +738,61 @@ static void print_global_criticality_stats(FILE * fp, float ** criticality, cons
 		}
 
 		/* Now print how many criticalities are in each bucket. */
-		fprintf(fp, "\nRange\t\t");
+		out_printf(out, "\nRange\t\t");
 		for (ibucket = 0; ibucket < NUM_BUCKETS; ibucket++) {
-			fprintf(fp, "%.1e to ", min_criticality);
+			out_printf(out, "%.1e to ", min_criticality);
 			min_criticality += bucket_size;
-			fprintf(fp, "%.1e\t", min_criticality);
+			out_printf(out, "%.1e\t", min_criticality);
 		}
-		fprintf(fp, "\n%s in range\t\t", capitalized_plural_name);
+		out_printf(out, "\n%s in range\t\t", capitalized_plural_name);
 		for (ibucket = 0; ibucket < NUM_BUCKETS; ibucket++) {
-			fprintf(fp, "%d\t\t\t", criticalities_in_bucket[ibucket]);
+			out_printf(out, "%d\t\t\t", criticalities_in_bucket[ibucket]);
 		}
 	}
-	fprintf(fp, "\n\n");
+	out_printf(out, "\n\n");
 }
 
 void print_net_delay(float **net_delay, const char *fname) {
 
 	/* Prints the net delays into a file. */
 
-	int inet, iedge, driver_tnode, num_edges;
-	t_tedge * tedge;
-	FILE *fp;
+	t_out_buf *out;
 
-	fp = my_fopen(fname, "w", 0);
+	out = open_out_file(fname);
 
-	fprintf(fp, "Net #\tDriver_tnode\tto_node\tDelay\n\n");
+	out_printf(out, "Net #\tDriver_tnode\tto_node\tDelay\n\n");
 
-	for (inet = 0; inet < num_timing_nets; inet++) {
+	write_out_buf_parallel(out, num_timing_nets, print_net_delay_nets, net_delay);
+
+	close_out_file(out);
+}
+
+static void print_net_delay_nets(t_out_buf * out, int first, int last, void * context) {
+
+	/* Prints the delays of nets [first..last-1] for print_net_delay. */
+
+	int inet, iedge, driver_tnode, num_edges;
+	t_tedge * tedge;
+	float ** net_delay;
+
+	net_delay = (float **) context;
+	for (inet = first; inet < last; inet++) {
 		driver_tnode = f_net_to_driver_tnode[inet];
 		num_edges = tnode[driver_tnode].num_edges;
 		tedge = tnode[driver_tnode].out_edges;
-		fprintf(fp, "%5d\t%5d\t\t%5d\t%g\n", inet, driver_tnode, tedge[0].to_node, net_delay[inet][1]);
-		for (iedge = 1; iedge < num_edges; iedge++) { /* newline and indent subsequent edges after the first */
-			fprintf(fp, "\t\t\t%5d\t%g\n", tedge[iedge].to_node, net_delay[inet][iedge+1]);
+		for (iedge = 0; iedge < num_edges; iedge++) {
+			if (iedge == 0) { /* "%5d\t%5d\t\t%5d\t" */
+				out_int_width(out, inet, 5);
+				out_char(out, '\t');
+				out_int_width(out, driver_tnode, 5);
+				out_str(out, "\t\t");
+			} else { /* indent subsequent edges after the first */
+				out_str(out, "\t\t\t");
+			}
+			out_int_width(out, tedge[iedge].to_node, 5);
+			out_printf(out, "\t%g\n", net_delay[inet][iedge + 1]);
 		}
 	}
-
-	fclose(fp);
 }
 
 #ifndef PATH_COUNTING
@@ -1389,79 +1492,42 @@ void print_timing_graph(const char *fname) {
 
 	/* Prints the timing graph into a file. */
 
-	FILE *fp;
-	int inode, iedge, ilevel, i;
-	t_tedge *tedge;
-	e_tnode_type itype;
-	const char *tnode_type_names[] = {  "TN_INPAD_SOURCE", "TN_INPAD_OPIN", "TN_OUTPAD_IPIN",
+	t_out_buf *out;
+	int inode, ilevel, i;
 
-			"TN_OUTPAD_SINK", "TN_CB_IPIN", "TN_CB_OPIN", "TN_INTERMEDIATE_NODE",
-			"TN_PRIMITIVE_IPIN", "TN_PRIMITIVE_OPIN", "TN_FF_IPIN", "TN_FF_OPIN", "TN_FF_SINK",
-			"TN_FF_SOURCE", "TN_FF_CLOCK", "TN_CONSTANT_GEN_SOURCE" };
-
-	fp = my_fopen(fname, "w", 0);
+	out = open_out_file(fname);
 
-	fprintf(fp, "num_tnodes: %d\n", num_tnodes);
-	fprintf(fp, "Node #\tType\t\tipin\tiblk\tDomain\tSkew\tI/O Delay\t# edges\t"
+	out_printf(out, "num_tnodes: %d\n", num_tnodes);
+	out_printf(out, "Node #\tType\t\tipin\tiblk\tDomain\tSkew\tI/O Delay\t# edges\t"
 			"to_node     Tdel\n\n");
 
-	for (inode = 0; inode < num_tnodes; inode++) {
-		fprintf(fp, "%d\t", inode);
-
-		itype = tnode[inode].type;
-		fprintf(fp, "%-15.15s\t", tnode_type_names[itype]);
-
-		if (tnode[inode].pb_graph_pin != NULL) {
-			fprintf(fp, "%d\t%d\t",
-					tnode[inode].pb_graph_pin->pin_count_in_cluster,
-					tnode[inode].block);
-		} else {
-			fprintf(fp, "\t%d\t", tnode[inode].block);
-		}
-
-		if (itype == TN_FF_CLOCK || itype == TN_FF_SOURCE || itype == TN_FF_SINK) {
-			fprintf(fp, "%d\t%.3e\t\t", tnode[inode].clock_domain, tnode[inode].clock_delay);
-		} else if (itype == TN_INPAD_SOURCE) {
-			fprintf(fp, "%d\t\t%.3e\t", tnode[inode].clock_domain, tnode[inode].out_edges[0].Tdel);
-		} else if (itype == TN_OUTPAD_SINK) {
-			assert(tnode[inode-1].type == TN_OUTPAD_IPIN); /* Outpad ipins should be one prior in the tnode array */
-			fprintf(fp, "%d\t\t%.3e\t", tnode[inode].clock_domain, tnode[inode-1].out_edges[0].Tdel);
-		} else {
-			fprintf(fp, "\t\t\t\t");
-		}
-
-		fprintf(fp, "%d", tnode[inode].num_edges);
-
-		/* Print all edges after edge 0 on separate lines */
-		tedge = tnode[inode].out_edges;
-		if (tnode[inode].num_edges > 0) {
-			fprintf(fp, "\t%4d\t%7.3g", tedge[0].to_node, tedge[0].Tdel);
-			for (iedge = 1; iedge < tnode[inode].num_edges; iedge++) {
-				fprintf(fp, "\n\t\t\t\t\t\t\t\t\t\t%4d\t%7.3g", tedge[iedge].to_node, tedge[iedge].Tdel);
-			}
-		}
-		fprintf(fp, "\n");
-	}
+	write_out_buf_parallel(out, num_tnodes, print_timing_graph_tnodes, NULL);
 
-	fprintf(fp, "\n\nnum_tnode_levels: %d\n", num_tnode_levels);
+	out_printf(out, "\n\nnum_tnode_levels: %d\n", num_tnode_levels);
 
 	for (ilevel = 0; ilevel < num_tnode_levels; ilevel++) {
-		fprintf(fp, "\n\nLevel: %d  Num_nodes: %d\nNodes:", ilevel,
+		out_printf(out, "\n\nLevel: %d  Num_nodes: %d\nNodes:", ilevel,
 				tnodes_at_level[ilevel].nelem);
-		for (i = 0; i < tnodes_at_level[ilevel].nelem; i++)
-			fprintf(fp, "\t%d", tnodes_at_level[ilevel].list[i]);
+		for (i = 0; i < tnodes_at_level[ilevel].nelem; i++) {
+			out_char(out, '\t');
+			out_int(out, tnodes_at_level[ilevel].list[i]);
+		}
 	}
 
-	fprintf(fp, "\n");
-	fprintf(fp, "\n\nNet #\tNet_to_driver_tnode\n");
+	out_printf(out, "\n");
+	out_printf(out, "\n\nNet #\tNet_to_driver_tnode\n");
 
-	for (i = 0; i < num_nets; i++)
-		fprintf(fp, "%4d\t%6d\n", i, f_net_to_driver_tnode[i]);
+	for (i = 0; i < num_nets; i++) {
+		out_int_width(out, i, 4);
+		out_char(out, '\t');
+		out_int_width(out, f_net_to_driver_tnode[i], 6);
+		out_char(out, '\n');
+	}
 
 	if (g_sdc->num_constrained_clocks == 1) {
 		/* Arrival and required times, and forward and backward weights, will be meaningless for multiclock
 		designs, since the values currently on the graph will only correspond to the most recent traversal. */
-		fprintf(fp, "\n\nNode #\t\tT_arr\t\tT_req"
+		out_printf(out, "\n\nNode #\t\tT_arr\t\tT_req"
 #ifdef PATH_COUNTING
 			"\tForward weight\tBackward weight"
 #endif
@@ -1469,23 +1535,82 @@ void print_timing_graph(const char *fname) {
 
 		for (inode = 0; inode < num_tnodes; inode++) {
 			if (tnode[inode].T_arr > HUGE_NEGATIVE_FLOAT + 1) {
-				fprintf(fp, "%d\t%12g", inode, tnode[inode].T_arr);
+				out_printf(out, "%d\t%12g", inode, tnode[inode].T_arr);
 			} else {
-				fprintf(fp, "%d\t\t   -", inode);
+				out_printf(out, "%d\t\t   -", inode);
 			}
 			if (tnode[inode].T_req < HUGE_POSITIVE_FLOAT - 1) {
-				fprintf(fp, "\t%12g", tnode[inode].T_req);
+				out_printf(out, "\t%12g", tnode[inode].T_req);
 			} else {
-				fprintf(fp, "\t\t   -");
+				out_printf(out, "\t\t   -");
 			}
 #ifdef PATH_COUNTING
-			fprintf(fp, "\t%12g\t%12g\n", tnode[inode].forward_weight, tnode[inode].backward_weight);
+			out_printf(out, "\t%12g\t%12g\n", tnode[inode].forward_weight, tnode[inode].backward_weight);
 #endif
 		}
 	}
 
-	fclose(fp);
+	close_out_file(out);
+}
+
+static void print_timing_graph_tnodes(t_out_buf * out, int first, int last, void * context) {
+
+	/* Prints tnodes [first..last-1] and their out edges for print_timing_graph. */
+
+	int inode, iedge;
+	t_tedge *tedge;
+	e_tnode_type itype;
+	const char *tnode_type_names[] = {  "TN_INPAD_SOURCE", "TN_INPAD_OPIN", "TN_OUTPAD_IPIN",
+
+			"TN_OUTPAD_SINK", "TN_CB_IPIN", "TN_CB_OPIN", "TN_INTERMEDIATE_NODE",
+			"TN_PRIMITIVE_IPIN", "TN_PRIMITIVE_OPIN", "TN_FF_IPIN", "TN_FF_OPIN", "TN_FF_SINK",
+			"TN_FF_SOURCE", "TN_FF_CLOCK", "TN_CONSTANT_GEN_SOURCE" };
+
+	for (inode = first; inode < last; inode++) {
+		out_int(out, inode);
+		out_char(out, '\t');
+
+		itype = tnode[inode].type;
+		out_printf(out, "%-15.15s\t", tnode_type_names[itype]);
+
+		if (tnode[inode].pb_graph_pin != NULL) {
+			out_int(out, tnode[inode].pb_graph_pin->pin_count_in_cluster);
+			out_char(out, '\t');
+		} else {
+			out_char(out, '\t');
+		}
+		out_int(out, tnode[inode].block);
+		out_char(out, '\t');
+
+		if (itype == TN_FF_CLOCK || itype == TN_FF_SOURCE || itype == TN_FF_SINK) {
+			out_printf(out, "%d\t%.3e\t\t", tnode[inode].clock_domain, tnode[inode].clock_delay);
+		} else if (itype == TN_INPAD_SOURCE) {
+			out_printf(out, "%d\t\t%.3e\t", tnode[inode].clock_domain, tnode[inode].out_edges[0].Tdel);
+		} else if (itype == TN_OUTPAD_SINK) {
+			assert(tnode[inode-1].type == TN_OUTPAD_IPIN); /* Outpad ipins should be one prior in the tnode array */
+			out_printf(out, "%d\t\t%.3e\t", tnode[inode].clock_domain, tnode[inode-1].out_edges[0].Tdel);
+		} else {
+			out_str(out, "\t\t\t\t");
+		}
+
+		out_int(out, tnode[inode].num_edges);
+
+		/* Print all edges after edge 0 on separate lines */
+		tedge = tnode[inode].out_edges;
+		if (tnode[inode].num_edges > 0) {
+			out_char(out, '\t');
+			out_int_width(out, tedge[0].to_node, 4);
+			out_printf(out, "\t%7.3g", tedge[0].Tdel);
+			for (iedge = 1; iedge < tnode[inode].num_edges; iedge++) {
+				out_str(out, "\n\t\t\t\t\t\t\t\t\t\t");
+				out_int_width(out, tedge[iedge].to_node, 4);
+				out_printf(out, "\t%7.3g", tedge[iedge].Tdel);
+			}
+		}
+		out_char(out, '\n');
+	}
 }
+
 static void process_constraints(void) {
 	/* Removes all constraints between domains which never intersect. We need to do this 
 	so that criticality_denom in do_timing_analysis is not affected	by unused constraints. 
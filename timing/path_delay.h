@@ -51,6 +51,9 @@ t_linked_int *allocate_and_load_critical_path(void);
 
 void load_timing_graph_net_delays(float **net_delay);
 
+int load_pre_packing_intra_cluster_net_delays(int iblk,
+		float intra_cluster_net_delay);
+
 void do_timing_analysis(t_slack * slacks, boolean is_prepacked, boolean do_lut_input_balancing, boolean is_final_analysis);
 
 void free_timing_graph(t_slack * slack);
@@ -2,6 +2,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <time.h>
 #include "assert.h"
 #include "util.h"
 #include "vpr_types.h"
@@ -11,6 +12,7 @@
 #include "path_delay.h"
 #include "path_delay2.h"
 #include "ReadOptions.h"
+#include "hash.h"
 #include "slre.h"
 
 /***************************** Summary **********************************/
@@ -81,6 +83,24 @@ typedef struct s_sdc_exclusive_group {
 /* Used to temporarily separate clock names into exclusive groups when parsing the 
 command set_clock_groups -exclusive. */
 
+typedef enum e_sdc_pattern_type {
+	SDC_PATTERN_ALL, SDC_PATTERN_LITERAL, SDC_PATTERN_SUBSTRING, SDC_PATTERN_REGEX
+} t_sdc_pattern_type;
+
+typedef struct s_sdc_pattern {
+	t_sdc_pattern_type type;
+	char * pattern;
+	char * substring;
+	struct slre * regex;
+} t_sdc_pattern;
+/* A clock or I/O name pattern from the SDC file, classified and compiled once
+before it is tried against the netlist names. "*" matches every name and a 
+pattern with no regex metacharacters only the name equal to it. Since the 
+regex library matches anywhere in a name, a literal followed by "*", "+" or 
+".*" is the same as a search for the literal substring (without the last 
+character for "*"), which is kept in substring. Anything else is compiled into 
+regex. */
+
 /****************** Variables local to this module **************************/
 
 static FILE *sdc;
@@ -92,6 +112,9 @@ char ** netlist_clocks; /* [0..num_netlist_clocks - 1] array of names of clocks
 int num_netlist_ios = 0; /* number of clocks in netlist */
 char ** netlist_ios; /* [0..num_netlist_clocks - 1] array of names of ios in netlist */
 
+static struct s_hash_table * netlist_clock_hash = NULL; /* netlist_clocks by name; index is the position in netlist_clocks */
+static struct s_hash_table * netlist_io_hash = NULL; /* netlist_ios by name; count is how many times the name is in netlist_ios */
+
 /***************** Subroutines local to this module *************************/
 
 static void alloc_and_load_netlist_clocks_and_ios(void);
@@ -105,7 +128,10 @@ static void add_override_constraint(char ** from_list, int num_from, char ** to_
 	float constraint, int num_multicycles, boolean domain_level_from, boolean domain_level_to,
 	boolean make_copies);
 static int find_cc_constraint(char * source_clock_domain, char * sink_clock_domain);
-static boolean regex_match (char *string, char *pattern);
+static void compile_sdc_pattern(char * pattern, t_sdc_pattern * compiled);
+static boolean sdc_pattern_matches(t_sdc_pattern * compiled, char * name);
+static int match_sdc_pattern(char * pattern, char ** names, int num_names, 
+	struct s_hash_table * name_hash, int ** matches);
 static void count_netlist_ios_as_constrained_ios(char * clock_name, float io_delay);
 static void free_io_constraint(t_io *& io_array, int num_ios);
 static void free_clock_constraint(t_clock *& clock_array, int num_clocks);
@@ -117,6 +143,7 @@ void read_sdc(t_timing_inf timing_inf) {
 	char buf[BUFSIZE];
 	int source_clock_domain, sink_clock_domain, iinput, ioutput, icc, isource, isink;
 	boolean found; 
+	clock_t begin;
 	
 	/* Make sure we haven't called this subroutine before. */
 	assert(!g_sdc);
@@ -145,6 +172,7 @@ void read_sdc(t_timing_inf timing_inf) {
 	}
 	
 	/* Now we have an SDC file. */
+	begin = clock();
 
 	/* Count how many clocks and I/Os are in the netlist. 
 	Store the names of each clock and each I/O in netlist_clocks and netlist_ios. 
@@ -165,6 +193,8 @@ void read_sdc(t_timing_inf timing_inf) {
 		use_default_timing_constraints();
 		free(netlist_clocks);
 		free(netlist_ios);
+		free_hash_table(netlist_clock_hash);
+		free_hash_table(netlist_io_hash);
 		return;
 	}
 	
@@ -244,6 +274,11 @@ void read_sdc(t_timing_inf timing_inf) {
 				 timing_inf.SDCFile ); 
 	vpr_printf(TIO_MESSAGE_INFO, "%d clocks (including virtual clocks), %d inputs and %d outputs were constrained.\n", 
 				 g_sdc->num_constrained_clocks, g_sdc->num_constrained_inputs, g_sdc->num_constrained_outputs);
+#ifdef CLOCKS_PER_SEC
+	vpr_printf(TIO_MESSAGE_INFO, "Reading the SDC file took %g seconds.\n", (float) (clock() - begin) / CLOCKS_PER_SEC);
+#else
+	vpr_printf(TIO_MESSAGE_INFO, "Reading the SDC file took %g seconds.\n", (float) (clock() - begin) / CLK_PER_SEC);
+#endif
 	vpr_printf(TIO_MESSAGE_INFO, "\n");
 	
 	/* Since all the information we need is stored in g_sdc->domain_constraint, g_sdc->constrained_clocks, 
@@ -251,6 +286,8 @@ void read_sdc(t_timing_inf timing_inf) {
 	free(sdc_clocks);
 	free(netlist_clocks);
 	free(netlist_ios);
+	free_hash_table(netlist_clock_hash);
+	free_hash_table(netlist_io_hash);
 	return;
 }
 
@@ -325,11 +362,14 @@ static void use_default_timing_constraints(void) {
 static void alloc_and_load_netlist_clocks_and_ios(void) {
 
 	/* Count how many clocks and I/Os are in the netlist. 
-	Store the names of each clock and each I/O in netlist_clocks and netlist_ios. */
+	Store the names of each clock and each I/O in netlist_clocks and netlist_ios, 
+	and index them by name in netlist_clock_hash and netlist_io_hash. */
 
-	int iblock, i, clock_net;
+	int iblock, clock_net;
 	char * name;
-	boolean found;
+
+	netlist_clock_hash = alloc_hash_table();
+	netlist_io_hash = alloc_hash_table();
 
 	for (iblock = 0; iblock < num_logical_blocks; iblock++) {
 		if (logical_block[iblock].clock_net != OPEN) {
@@ -337,31 +377,23 @@ static void alloc_and_load_netlist_clocks_and_ios(void) {
 			assert(clock_net != OPEN);
 			name = logical_block[clock_net].name;
 			/* Now that we've found a clock, let's see if we've counted it already */
-			found = FALSE;
-			for (i = 0; !found && i < num_netlist_clocks; i++) {
-				if (strcmp(netlist_clocks[i], name) == 0) {
-					found = TRUE;
-				}
-			}
-			if (!found) {
+			if (get_hash_entry(netlist_clock_hash, name) == NULL) {
 				/* If we get here, the clock is new and so we dynamically grow the array netlist_clocks by one. */
 				netlist_clocks = (char **) my_realloc (netlist_clocks, ++num_netlist_clocks * sizeof(char *));
 				netlist_clocks[num_netlist_clocks - 1] = name;
+				insert_in_hash_table(netlist_clock_hash, name, num_netlist_clocks - 1);
 			}
 		} else if (logical_block[iblock].type == VPACK_INPAD || logical_block[iblock].type == VPACK_OUTPAD) {
 			name = logical_block[iblock].name;
-			/* Now that we've found an I/O, let's see if we've counted it already */
-			found = FALSE;
-			for (i = 0; !found && i < num_netlist_ios; i++) {
-				if (strcmp(netlist_ios[i], name) == 0) {
-					found = TRUE;
-				}
-			}
-			if (!found) {
+			/* Now that we've found an I/O, let's see if we've counted it already. 
+			The check is on the full block name, as it has always been, so an output 
+			whose name without "out:" is also an input's name is listed twice. */
+			if (get_hash_entry(netlist_io_hash, name) == NULL) {
 				/* If we get here, the I/O is new and so we dynamically grow the array netlist_ios by one. */
 				netlist_ios = (char **) my_realloc (netlist_ios, ++num_netlist_ios * sizeof(char *));
 				netlist_ios[num_netlist_ios - 1] = logical_block[iblock].type == VPACK_OUTPAD ? name + 4 : name; 
 				/* the + 4 removes the prefix "out:" automatically prepended to outputs */
+				insert_in_hash_table(netlist_io_hash, netlist_ios[num_netlist_ios - 1], num_netlist_ios - 1);
 			}
 		}
 	}
@@ -455,6 +487,7 @@ static boolean get_sdc_tok(char * buf) {
 	float clock_period, rising_edge, falling_edge, max_delay;
 	int iclock, iio, num_exclusive_groups = 0,  
 		num_from = 0, num_to = 0, num_multicycles, i, j;
+	int * matches, num_matches, imatch;
 	t_sdc_exclusive_group * exclusive_groups = NULL;
 	boolean found, domain_level_from = FALSE, domain_level_to = FALSE;
 
@@ -565,28 +598,29 @@ static boolean get_sdc_tok(char * buf) {
 
 			do {
 				/* See if the regular expression stored in ptr is legal and matches at least one clock net. 
-				If it is not legal, it will fail during regex_match.  We check for a match using boolean found. */
+				If it is not legal, match_sdc_pattern will fail.  We check for a match using boolean found. */
 				found = FALSE;
-				for (iclock = 0; iclock < num_netlist_clocks; iclock++) {
-					if (regex_match(netlist_clocks[iclock], ptr)) {
-						/* We've found a new clock!  (Note that we can't store ptr as the clock's 
-						name since it could be a regex, unlike the virtual clock case).*/
-						found = TRUE;
-
-						/* Store the clock's name, period and edges in the local array sdc_clocks. */
-						sdc_clocks = (t_sdc_clock *) my_realloc(sdc_clocks, ++g_sdc->num_constrained_clocks * sizeof(t_sdc_clock));
-						sdc_clocks[g_sdc->num_constrained_clocks - 1].name = netlist_clocks[iclock];
-						sdc_clocks[g_sdc->num_constrained_clocks - 1].period = clock_period;
-						sdc_clocks[g_sdc->num_constrained_clocks - 1].rising_edge = rising_edge; 
-						sdc_clocks[g_sdc->num_constrained_clocks - 1].falling_edge = falling_edge;
-
-						/* Also store the clock's name, and the fact that it is a netlist clock, in g_sdc->constrained_clocks. */
-						g_sdc->constrained_clocks = (t_clock *) my_realloc (g_sdc->constrained_clocks, g_sdc->num_constrained_clocks * sizeof(t_clock));
-						g_sdc->constrained_clocks[g_sdc->num_constrained_clocks - 1].name = my_strdup(netlist_clocks[iclock]);
-						g_sdc->constrained_clocks[g_sdc->num_constrained_clocks - 1].is_netlist_clock = TRUE;
-						/* Fanout will be filled out once the timing graph has been constructed. */
-					}
+				num_matches = match_sdc_pattern(ptr, netlist_clocks, num_netlist_clocks, netlist_clock_hash, &matches);
+				for (imatch = 0; imatch < num_matches; imatch++) {
+					iclock = matches[imatch];
+					/* We've found a new clock!  (Note that we can't store ptr as the clock's 
+					name since it could be a regex, unlike the virtual clock case).*/
+					found = TRUE;
+
+					/* Store the clock's name, period and edges in the local array sdc_clocks. */
+					sdc_clocks = (t_sdc_clock *) my_realloc(sdc_clocks, ++g_sdc->num_constrained_clocks * sizeof(t_sdc_clock));
+					sdc_clocks[g_sdc->num_constrained_clocks - 1].name = netlist_clocks[iclock];
+					sdc_clocks[g_sdc->num_constrained_clocks - 1].period = clock_period;
+					sdc_clocks[g_sdc->num_constrained_clocks - 1].rising_edge = rising_edge; 
+					sdc_clocks[g_sdc->num_constrained_clocks - 1].falling_edge = falling_edge;
+
+					/* Also store the clock's name, and the fact that it is a netlist clock, in g_sdc->constrained_clocks. */
+					g_sdc->constrained_clocks = (t_clock *) my_realloc (g_sdc->constrained_clocks, g_sdc->num_constrained_clocks * sizeof(t_clock));
+					g_sdc->constrained_clocks[g_sdc->num_constrained_clocks - 1].name = my_strdup(netlist_clocks[iclock]);
+					g_sdc->constrained_clocks[g_sdc->num_constrained_clocks - 1].is_netlist_clock = TRUE;
+					/* Fanout will be filled out once the timing graph has been constructed. */
 				}
+				free(matches);
 
 				if (!found) {
 					vpr_printf(TIO_MESSAGE_ERROR, "[SDC line %d] Clock name or regular expression does not correspond to any nets.\n", 
@@ -635,16 +669,17 @@ static boolean get_sdc_tok(char * buf) {
 			do {
 				/* Check the regex ptr against each netlist clock and add it to the clock_names list if it matches. */
 				found = FALSE;
-				for (iclock = 0; iclock < num_netlist_clocks; iclock++) {
-					if (regex_match(netlist_clocks[iclock], ptr)) {
-						found = TRUE;
-						exclusive_groups[num_exclusive_groups - 1].clock_names = (char **) my_realloc(
-							exclusive_groups[num_exclusive_groups - 1].clock_names, ++exclusive_groups[num_exclusive_groups - 1].num_clock_names * sizeof(char *));
-						exclusive_groups[num_exclusive_groups - 1].clock_names
-							[exclusive_groups[num_exclusive_groups - 1].num_clock_names - 1] = 
-							my_strdup(netlist_clocks[iclock]);
-					}
+				num_matches = match_sdc_pattern(ptr, netlist_clocks, num_netlist_clocks, netlist_clock_hash, &matches);
+				for (imatch = 0; imatch < num_matches; imatch++) {
+					iclock = matches[imatch];
+					found = TRUE;
+					exclusive_groups[num_exclusive_groups - 1].clock_names = (char **) my_realloc(
+						exclusive_groups[num_exclusive_groups - 1].clock_names, ++exclusive_groups[num_exclusive_groups - 1].num_clock_names * sizeof(char *));
+					exclusive_groups[num_exclusive_groups - 1].clock_names
+						[exclusive_groups[num_exclusive_groups - 1].num_clock_names - 1] = 
+						my_strdup(netlist_clocks[iclock]);
 				}
+				free(matches);
 				if (!found) {
 					/* If no clocks matched, assume ptr is the name of a virtual clock and add it to the list.
 					(If it's not a virtual clock, we'll catch it later when we check all override constraints.) */
@@ -955,22 +990,23 @@ static boolean get_sdc_tok(char * buf) {
 
 			found = FALSE;
 
-			for (iio = 0; iio < num_netlist_ios; iio++) {
-				/* See if the regular expression stored in ptr is legal and matches at least one input port. 
-				If it is not legal, it will fail during regex_match.  We check for a match using boolean found. */
-				if (regex_match(netlist_ios[iio], ptr)) {
-					/* We've found a new input! */
-					g_sdc->num_constrained_inputs++;
-					found = TRUE;
-
-					/* Fill in input information in the permanent array g_sdc->constrained_inputs. */
-					g_sdc->constrained_inputs = (t_io *) my_realloc (g_sdc->constrained_inputs, g_sdc->num_constrained_inputs * sizeof(t_io));
-					g_sdc->constrained_inputs[g_sdc->num_constrained_inputs - 1].name = my_strdup(netlist_ios[iio]);
-					g_sdc->constrained_inputs[g_sdc->num_constrained_inputs - 1].clock_name = my_strdup(clock_name);
-					g_sdc->constrained_inputs[g_sdc->num_constrained_inputs - 1].delay = max_delay;
-					g_sdc->constrained_inputs[g_sdc->num_constrained_inputs - 1].file_line_number = file_line_number; /* global var */
-				}
+			/* See if the regular expression stored in ptr is legal and matches at least one input port. 
+			If it is not legal, match_sdc_pattern will fail.  We check for a match using boolean found. */
+			num_matches = match_sdc_pattern(ptr, netlist_ios, num_netlist_ios, netlist_io_hash, &matches);
+			for (imatch = 0; imatch < num_matches; imatch++) {
+				iio = matches[imatch];
+				/* We've found a new input! */
+				g_sdc->num_constrained_inputs++;
+				found = TRUE;
+
+				/* Fill in input information in the permanent array g_sdc->constrained_inputs. */
+				g_sdc->constrained_inputs = (t_io *) my_realloc (g_sdc->constrained_inputs, g_sdc->num_constrained_inputs * sizeof(t_io));
+				g_sdc->constrained_inputs[g_sdc->num_constrained_inputs - 1].name = my_strdup(netlist_ios[iio]);
+				g_sdc->constrained_inputs[g_sdc->num_constrained_inputs - 1].clock_name = my_strdup(clock_name);
+				g_sdc->constrained_inputs[g_sdc->num_constrained_inputs - 1].delay = max_delay;
+				g_sdc->constrained_inputs[g_sdc->num_constrained_inputs - 1].file_line_number = file_line_number; /* global var */
 			}
+			free(matches);
 
 			if (!found) {
 				vpr_printf(TIO_MESSAGE_ERROR, "[SDC line %d] Output name or regular expression \"%s\" does not correspond to any nets.\n", 
@@ -1030,22 +1066,23 @@ static boolean get_sdc_tok(char * buf) {
 
 			found = FALSE;
 
-			for (iio = 0; iio < num_netlist_ios; iio++) {
-				/* See if the regular expression stored in ptr is legal and matches at least one output port. 
-				If it is not legal, it will fail during regex_match.  We check for a match using boolean found. */
-				if (regex_match(netlist_ios[iio], ptr)) {
-					/* We've found a new output! */
-					g_sdc->num_constrained_outputs++;
-					found = TRUE;
-
-					/* Fill in output information in the permanent array g_sdc->constrained_outputs. */
-					g_sdc->constrained_outputs = (t_io *) my_realloc (g_sdc->constrained_outputs, g_sdc->num_constrained_outputs * sizeof(t_io));
-					g_sdc->constrained_outputs[g_sdc->num_constrained_outputs - 1].name = my_strdup(netlist_ios[iio]);
-					g_sdc->constrained_outputs[g_sdc->num_constrained_outputs - 1].clock_name = my_strdup(clock_name);
-					g_sdc->constrained_outputs[g_sdc->num_constrained_outputs - 1].delay = max_delay;
-					g_sdc->constrained_outputs[g_sdc->num_constrained_outputs - 1].file_line_number = file_line_number; /* global var */
-				}
+			/* See if the regular expression stored in ptr is legal and matches at least one output port. 
+			If it is not legal, match_sdc_pattern will fail.  We check for a match using boolean found. */
+			num_matches = match_sdc_pattern(ptr, netlist_ios, num_netlist_ios, netlist_io_hash, &matches);
+			for (imatch = 0; imatch < num_matches; imatch++) {
+				iio = matches[imatch];
+				/* We've found a new output! */
+				g_sdc->num_constrained_outputs++;
+				found = TRUE;
+
+				/* Fill in output information in the permanent array g_sdc->constrained_outputs. */
+				g_sdc->constrained_outputs = (t_io *) my_realloc (g_sdc->constrained_outputs, g_sdc->num_constrained_outputs * sizeof(t_io));
+				g_sdc->constrained_outputs[g_sdc->num_constrained_outputs - 1].name = my_strdup(netlist_ios[iio]);
+				g_sdc->constrained_outputs[g_sdc->num_constrained_outputs - 1].clock_name = my_strdup(clock_name);
+				g_sdc->constrained_outputs[g_sdc->num_constrained_outputs - 1].delay = max_delay;
+				g_sdc->constrained_outputs[g_sdc->num_constrained_outputs - 1].file_line_number = file_line_number; /* global var */
 			}
+			free(matches);
 
 			if (!found) {
 				vpr_printf(TIO_MESSAGE_ERROR, "[SDC line %d] Output name or regular expression \"%s\" does not correspond to any nets.\n", 
@@ -1246,35 +1283,123 @@ static float calculate_constraint(t_sdc_clock source_domain, t_sdc_clock sink_do
 	return constraint;
 }
 
-static boolean regex_match (char * string, char * regular_expression) {
-	/* Given a string and a regular expression, return TRUE if there's a match, 
-	FALSE if not. Print an error and exit if regular_expression is invalid. */
+static void compile_sdc_pattern(char * pattern, t_sdc_pattern * compiled) {
+	/* Classifies pattern (see t_sdc_pattern) and compiles it if it needs the regex 
+	library. Prints an error and exits if pattern is not a valid regular expression. */
+
+	const char * error;
+	int len, literal_len;
+
+	compiled->pattern = pattern;
+	compiled->substring = NULL;
+	compiled->regex = NULL;
+
+	/* Length of the leading run of characters the regex library takes literally */
+	len = strlen(pattern);
+	literal_len = strcspn(pattern, "|.*+?()[\\");
+
+	if (strcmp(pattern, "*") == 0) {
+		compiled->type = SDC_PATTERN_ALL;
+	} else if (literal_len == len) {
+		compiled->type = SDC_PATTERN_LITERAL;
+	} else if (literal_len > 0 && literal_len == len - 1 && (pattern[literal_len] == '*' || pattern[literal_len] == '+')) {
+		/* "abc*" finds "ab" followed by any number of 'c's; "abc+" finds "abc". */
+		compiled->type = SDC_PATTERN_SUBSTRING;
+		compiled->substring = my_strdup(pattern);
+		compiled->substring[pattern[literal_len] == '*' ? literal_len - 1 : literal_len] = '\0';
+	} else if (literal_len == len - 2 && strcmp(pattern + literal_len, ".*") == 0) {
+		compiled->type = SDC_PATTERN_SUBSTRING;
+		compiled->substring = my_strdup(pattern);
+		compiled->substring[literal_len] = '\0';
+	} else {
+		compiled->type = SDC_PATTERN_REGEX;
+		compiled->regex = slre_compile((enum slre_option) 0, pattern, &error);
+		if (compiled->regex == NULL) {
+			vpr_printf(TIO_MESSAGE_ERROR, "[SDC line %d] Error matching regular expression \"%s\".\n", 
+					file_line_number, pattern);
+			exit(1);
+		}
+	}
+}
+
+static boolean sdc_pattern_matches(t_sdc_pattern * compiled, char * name) {
+	/* Given a name and a compiled pattern, return TRUE if there's a match, 
+	FALSE if not. Print an error and exit if the regex library fails. */
 
 	const char * error;
-	
-	assert(string && regular_expression);
 
-	/* The regex library reports a match if regular_expression is a substring of string
-	AND not equal to string. This is not appropriate for our purposes. For example, 
+	if (compiled->type == SDC_PATTERN_LITERAL) 
+		return (boolean) (strcmp(name, compiled->pattern) == 0);
+
+	/* The regex library reports a match if the pattern is a substring of name
+	AND not equal to name. This is not appropriate for our purposes. For example, 
 	we'd get both "clock" and "clock2" matching the regular expression "clock".  
 	We have to manually return that there's no match in this special case. */
-	if (strstr(string, regular_expression) && strcmp(string, regular_expression) != 0)
+	if (strstr(name, compiled->pattern) && strcmp(name, compiled->pattern) != 0)
 		return FALSE;
 
-	if (strcmp(regular_expression, "*") == 0)
+	switch (compiled->type) {
+	case SDC_PATTERN_ALL:
 		return TRUE; /* The regex library hangs if it is fed "*" as a regular expression. */
+	case SDC_PATTERN_SUBSTRING:
+		/* The regex library never matches an empty name. */
+		return (boolean) (name[0] != '\0' && strstr(name, compiled->substring) != NULL);
+	default:
+		error = slre_match_compiled(compiled->regex, name, strlen(name));
+		if (!error) 
+			return TRUE;
+		else if (strcmp(error, "No match") == 0) 
+			return FALSE;
+		else {
+			vpr_printf(TIO_MESSAGE_ERROR, "[SDC line %d] Error matching regular expression \"%s\".\n", 
+					file_line_number, compiled->pattern);
+			exit(1);
+		}
+	}
+}
 
-	error = slre_match((enum slre_option) 0, regular_expression, string, strlen(string));
+static int match_sdc_pattern(char * pattern, char ** names, int num_names, 
+	struct s_hash_table * name_hash, int ** matches) {
+	/* Finds the names in names[0..num_names-1] matched by pattern, a clock or I/O 
+	name or regular expression from the SDC file. Returns how many there are and 
+	sets *matches to their indices in increasing order; the caller frees it. 
+	pattern is compiled once. A literal name is looked up in name_hash, 
+	whose count says how many times the name is in names; other patterns are 
+	tried against every name. */
+
+	t_sdc_pattern compiled;
+	struct s_hash * h_ptr;
+	int i, num_matches, max_matches;
+
+	compile_sdc_pattern(pattern, &compiled);
+
+	*matches = NULL;
+	num_matches = max_matches = 0;
+	if (compiled.type == SDC_PATTERN_LITERAL) {
+		h_ptr = get_hash_entry(name_hash, pattern);
+		if (h_ptr == NULL) {
+			return 0;
+		}
+		if (h_ptr->count == 1) {
+			*matches = (int *) my_malloc(sizeof(int));
+			(*matches)[0] = h_ptr->index;
+			return 1;
+		}
+	}
 
-	if (!error) 
-		return TRUE;
-	else if (strcmp(error, "No match") == 0) 
-		return FALSE;
-	else {
-		vpr_printf(TIO_MESSAGE_ERROR, "[SDC line %d] Error matching regular expression \"%s\".\n", 
-				file_line_number, regular_expression);
-		exit(1);
+	for (i = 0; i < num_names; i++) {
+		if (sdc_pattern_matches(&compiled, names[i])) {
+			if (num_matches == max_matches) {
+				max_matches = (max_matches == 0 ? 16 : 2 * max_matches);
+				*matches = (int *) my_realloc(*matches, max_matches * sizeof(int));
+			}
+			(*matches)[num_matches++] = i;
+		}
 	}
+
+	free(compiled.substring);
+	free(compiled.regex);
+	return num_matches;
 }
 
 void free_sdc_related_structs(void) {
@@ -660,3 +660,26 @@ const char *slre_match(enum slre_option options, const char *re,
 
   return error_string;
 }
+
+struct slre *slre_compile(enum slre_option options, const char *re,
+                          const char **error) {
+  struct slre *slre;
+
+  if ((slre = (struct slre *) malloc(sizeof(*slre))) == NULL) {
+    *error = "Out of memory";
+    return NULL;
+  }
+  slre->options = options;
+  if ((*error = compile2(slre, re)) != NULL) {
+    free(slre);
+    return NULL;
+  }
+  return slre;
+}
+
+const char *slre_match_compiled(const struct slre *slre, const char *buf,
+                                int buf_len) {
+  struct cap caps[20];
+
+  return match2(slre, buf, buf_len, caps);
+}
@@ -82,4 +82,14 @@ enum slre_capture {SLRE_STRING, SLRE_INT, SLRE_FLOAT};
 const char *slre_match(enum slre_option options, const char *regexp,
                        const char *buf, int buf_len, ...);
 
+// Compile once, match many times. slre_compile returns a regexp to pass to
+// slre_match_compiled and release with free(), or NULL with *error set.
+// slre_match_compiled returns NULL on a match, an error string otherwise;
+// captures are not reported.
+struct slre;
+struct slre *slre_compile(enum slre_option options, const char *regexp,
+                          const char **error);
+const char *slre_match_compiled(const struct slre *compiled, const char *buf,
+                                int buf_len);
+
 #endif /* SLRE_H */
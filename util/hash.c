@@ -1,37 +1,47 @@
 #include <stdlib.h>
 #include <string.h>
-#include "hash.h"
 #include "util.h"
+#include "hash.h"
+
+#define HASH_INITIAL_SLOTS 64 /* Must be a power of two */
+#define HASH_EMPTY_SLOT -1
 
-struct s_hash **
+static int find_hash_slot(struct s_hash_table *hash_table, char *name,
+		unsigned int hash);
+static void grow_hash_table(struct s_hash_table *hash_table);
+
+struct s_hash_table *
 alloc_hash_table(void) {
 
-	/* Creates a hash table with HASHSIZE different locations (hash values).   */
+	/* Creates an empty hash table.  It starts small and doubles as entries are *
+	 * added, so small tables cost next to nothing.                             */
 
-	struct s_hash **hash_table;
+	struct s_hash_table *hash_table;
+	int i;
 
-	hash_table = (struct s_hash **) my_calloc(sizeof(struct s_hash *),
-			HASHSIZE);
+	hash_table = (struct s_hash_table *) my_malloc(sizeof(struct s_hash_table));
+	hash_table->num_slots = HASH_INITIAL_SLOTS;
+	hash_table->slots = (int *) my_malloc(HASH_INITIAL_SLOTS * sizeof(int));
+	for (i = 0; i < HASH_INITIAL_SLOTS; i++)
+		hash_table->slots[i] = HASH_EMPTY_SLOT;
+	hash_table->num_entries = 0;
+	hash_table->max_entries = HASH_INITIAL_SLOTS / 2;
+	hash_table->entries = (struct s_hash **) my_malloc(
+			hash_table->max_entries * sizeof(struct s_hash *));
+	hash_table->storage.chunk_ptr_head = NULL;
+	hash_table->storage.mem_avail = 0;
+	hash_table->storage.next_mem_loc_ptr = NULL;
 	return (hash_table);
 }
 
-void free_hash_table(struct s_hash **hash_table) {
+void free_hash_table(struct s_hash_table *hash_table) {
 
-	/* Frees all the storage associated with a hash table. */
-
-	int i;
-	struct s_hash *h_ptr, *temp_ptr;
-
-	for (i = 0; i < HASHSIZE; i++) {
-		h_ptr = hash_table[i];
-		while (h_ptr != NULL) {
-			free(h_ptr->name);
-			temp_ptr = h_ptr->next;
-			free(h_ptr);
-			h_ptr = temp_ptr;
-		}
-	}
+	/* Frees all the storage associated with a hash table, including the names *
+	 * of its entries.                                                          */
 
+	free_chunk_memory(&hash_table->storage);
+	free(hash_table->slots);
+	free(hash_table->entries);
 	free(hash_table);
 }
 
@@ -43,158 +53,173 @@ struct s_hash_iterator start_hash_table_iterator(void) {
 	struct s_hash_iterator hash_iterator;
 
 	hash_iterator.i = -1;
-	hash_iterator.h_ptr = NULL;
 	return (hash_iterator);
 }
 
 struct s_hash *
-get_next_hash(struct s_hash **hash_table, struct s_hash_iterator *hash_iterator) {
+get_next_hash(struct s_hash_table *hash_table,
+		struct s_hash_iterator *hash_iterator) {
 
-	/* Returns the next occupied hash entry, and moves the iterator structure    *
-	 * forward so the next call gets the next entry.                             */
+	/* Returns the next entry, and moves the iterator structure forward so the *
+	 * next call gets the next entry.                                          */
 
-	int i;
+	if (hash_iterator->i + 1 >= hash_table->num_entries)
+		return (NULL); /* End of table */
+
+	hash_iterator->i++;
+	return (hash_table->entries[hash_iterator->i]);
+}
+
+static int find_hash_slot(struct s_hash_table *hash_table, char *name,
+		unsigned int hash) {
+
+	/* Returns the slot holding name, or the empty slot where it would go.  The *
+	 * stored hashes are compared first, so strcmp runs about once per lookup.  */
+
+	int islot, mask;
 	struct s_hash *h_ptr;
 
-	i = hash_iterator->i;
-	h_ptr = hash_iterator->h_ptr;
+	mask = hash_table->num_slots - 1;
+	islot = (int) (hash & (unsigned int) mask);
+	while (hash_table->slots[islot] != HASH_EMPTY_SLOT) {
+		h_ptr = hash_table->entries[hash_table->slots[islot]];
+		if (h_ptr->hash == hash && strcmp(h_ptr->name, name) == 0)
+			return (islot);
+		islot = (islot + 1) & mask;
+	}
+	return (islot);
+}
+
+static void grow_hash_table(struct s_hash_table *hash_table) {
+
+	/* Doubles the number of slots and re-inserts every entry by its stored *
+	 * hash.  The entries themselves do not move.                           */
 
-	while (h_ptr == NULL) {
-		i++;
-		if (i >= HASHSIZE)
-			return (NULL); /* End of table */
+	int i, islot, mask;
 
-		h_ptr = hash_table[i];
+	free(hash_table->slots);
+	hash_table->num_slots *= 2;
+	hash_table->slots = (int *) my_malloc(hash_table->num_slots * sizeof(int));
+	for (i = 0; i < hash_table->num_slots; i++)
+		hash_table->slots[i] = HASH_EMPTY_SLOT;
+
+	mask = hash_table->num_slots - 1;
+	for (i = 0; i < hash_table->num_entries; i++) {
+		islot = (int) (hash_table->entries[i]->hash & (unsigned int) mask);
+		while (hash_table->slots[islot] != HASH_EMPTY_SLOT)
+			islot = (islot + 1) & mask;
+		hash_table->slots[islot] = i;
 	}
 
-	hash_iterator->h_ptr = h_ptr->next;
-	hash_iterator->i = i;
-	return (h_ptr);
+	hash_table->max_entries = hash_table->num_slots / 2;
+	hash_table->entries = (struct s_hash **) my_realloc(hash_table->entries,
+			hash_table->max_entries * sizeof(struct s_hash *));
 }
 
 struct s_hash *
-insert_in_hash_table(struct s_hash **hash_table, char *name,
+insert_in_hash_table(struct s_hash_table *hash_table, char *name,
 		int next_free_index) {
 
 	/* Adds the string pointed to by name to the hash table, and returns the    *
 	 * hash structure created or updated.  If name is already in the hash table *
 	 * the count member of that hash element is incremented.  Otherwise a new   *
-	 * hash entry with a count of zero and an index of next_free_index is       *
+	 * hash entry with a count of one and an index of next_free_index is        *
 	 * created.                                                                 */
 
-	int i;
-	struct s_hash *h_ptr, *prev_ptr;
-
-	i = hash_value(name);
-	prev_ptr = NULL;
-	h_ptr = hash_table[i];
-
-	while (h_ptr != NULL) {
-		if (strcmp(h_ptr->name, name) == 0) {
-			h_ptr->count++;
-			return (h_ptr);
-		}
+	int islot;
+	unsigned int hash;
+	size_t len;
+	struct s_hash *h_ptr;
 
-		prev_ptr = h_ptr;
-		h_ptr = h_ptr->next;
+	hash = hash_value(name);
+	islot = find_hash_slot(hash_table, name, hash);
+	if (hash_table->slots[islot] != HASH_EMPTY_SLOT) {
+		h_ptr = hash_table->entries[hash_table->slots[islot]];
+		h_ptr->count++;
+		return (h_ptr);
 	}
 
-	/* Name string wasn't in the hash table.  Add it. */
+	/* Name string wasn't in the hash table.  Add it, growing the table first *
+	 * if it would become more than half full.                                */
 
-	h_ptr = (struct s_hash *) my_malloc(sizeof(struct s_hash));
-	if (prev_ptr == NULL) {
-		hash_table[i] = h_ptr;
-	} else {
-		prev_ptr->next = h_ptr;
+	if (hash_table->num_entries == hash_table->max_entries) {
+		grow_hash_table(hash_table);
+		islot = find_hash_slot(hash_table, name, hash);
 	}
-	h_ptr->next = NULL;
+
+	len = strlen(name);
+	h_ptr = (struct s_hash *) my_chunk_malloc(sizeof(struct s_hash),
+			&hash_table->storage);
+	h_ptr->name = (char *) my_chunk_malloc((len + 1) * sizeof(char),
+			&hash_table->storage);
+	memcpy(h_ptr->name, name, len + 1);
 	h_ptr->index = next_free_index;
 	h_ptr->count = 1;
-	h_ptr->name = (char *) my_malloc((strlen(name) + 1) * sizeof(char));
-	strcpy(h_ptr->name, name);
+	h_ptr->hash = hash;
+
+	hash_table->slots[islot] = hash_table->num_entries;
+	hash_table->entries[hash_table->num_entries++] = h_ptr;
 	return (h_ptr);
 }
 
 struct s_hash *
-get_hash_entry(struct s_hash **hash_table, char *name) {
+get_hash_entry(struct s_hash_table *hash_table, char *name) {
 
 	/* Returns the hash entry with this name, or NULL if there is no            *
 	 * corresponding entry.                                                     */
 
-	int i;
-	struct s_hash *h_ptr;
-
-	i = hash_value(name);
-	h_ptr = hash_table[i];
-
-	while (h_ptr != NULL) {
-		if (strcmp(h_ptr->name, name) == 0)
-			return (h_ptr);
+	int islot;
 
-		h_ptr = h_ptr->next;
-	}
-
-	return (NULL);
+	islot = find_hash_slot(hash_table, name, hash_value(name));
+	if (hash_table->slots[islot] == HASH_EMPTY_SLOT)
+		return (NULL);
+	return (hash_table->entries[hash_table->slots[islot]]);
 }
 
-int hash_value(char *name) {
-	/* Creates a hash key from a character string.  The absolute value is taken  *
-	 * for the final val to compensate for long strlen that cause val to 	     *
-	 * overflow.								     */
+unsigned int hash_value(char *name) {
 
-	int i;
-	int val = 0, mult = 1;
+	/* Creates a hash key from a character string (32-bit FNV-1a).  Every bit *
+	 * of the key depends on every character, so the low bits can be used     *
+	 * directly to pick a slot in a power-of-two table.                       */
 
-	i = strlen(name);
-	for (i = strlen(name) - 1; i >= 0; i--) {
-		val += mult * ((int) name[i]);
-		mult *= 7;
+	unsigned int val;
+	const unsigned char *c;
+
+	val = 2166136261u;
+	for (c = (const unsigned char *) name; *c != '\0'; c++) {
+		val ^= (unsigned int) *c;
+		val *= 16777619u;
 	}
-	val += (int) name[0];
-	val %= HASHSIZE;
-	
-	val = abs(val);
 	return (val);
 }
 
-void get_hash_stats(struct s_hash **hash_table, char *hash_table_name){
+void get_hash_stats(struct s_hash_table *hash_table, char *hash_table_name){
 
 	/* Checks to see how well elements are distributed within the hash table.     *
-	 * Will traverse through the hash_table and count the length of the linked    *
-	 * list. Will output the hash number, the number of array elements that are   *
-	 * NULL, the average number of linked lists and the maximum length of linked  * 
-	 * lists.								      */
-
-	int num_NULL = 0, total_elements = 0,  max_num = 0, curr_num;
-	double avg_num = 0;
-	int i;
-	struct s_hash *h_ptr;
-
-	for (i = 0; i<HASHSIZE; i++){
-	h_ptr = hash_table[i];
-	curr_num = 0;
-	
-	if (h_ptr == NULL)
-		num_NULL++;		
-	else{
-		while (h_ptr != NULL){
-			curr_num ++;		
-			h_ptr = h_ptr->next;
-		}
-	}
-
-	if (curr_num > max_num)
-		max_num = curr_num;
-	
-	total_elements = total_elements + curr_num;
+	 * Counts how many slots each entry is from the slot its hash maps to, and    *
+	 * outputs the table size, the number of entries, and the average and the     *
+	 * maximum number of probes needed to find an entry.                          */
+
+	int i, islot, mask, curr_num, max_num = 0;
+	double total_num = 0.;
+
+	mask = hash_table->num_slots - 1;
+	for (islot = 0; islot < hash_table->num_slots; islot++) {
+		i = hash_table->slots[islot];
+		if (i == HASH_EMPTY_SLOT)
+			continue;
+		curr_num = ((islot - (int) (hash_table->entries[i]->hash & (unsigned int) mask)) & mask) + 1;
+		total_num += curr_num;
+		if (curr_num > max_num)
+			max_num = curr_num;
 	}
 
-	avg_num = (float) total_elements / ((float)HASHSIZE - (float)num_NULL);
-	
 	vpr_printf(TIO_MESSAGE_INFO, "\n");
-	vpr_printf(TIO_MESSAGE_INFO, "The hash table '%s' is of size %d.\n",
-		hash_table_name, HASHSIZE);
-	vpr_printf(TIO_MESSAGE_INFO, "It has: %d keys that are never used; total of %d elements; an average linked-list length of %.1f; and a maximum linked-list length of %d.\n", 
-		num_NULL, total_elements, avg_num, max_num); 
+	vpr_printf(TIO_MESSAGE_INFO, "The hash table '%s' has %d slots.\n",
+		hash_table_name, hash_table->num_slots);
+	vpr_printf(TIO_MESSAGE_INFO, "It has: %d elements; an average of %.2f probes to find an element; and a maximum of %d probes.\n", 
+		hash_table->num_entries,
+		(hash_table->num_entries > 0 ? total_num / hash_table->num_entries : 0.),
+		max_num); 
 	vpr_printf(TIO_MESSAGE_INFO, "\n");
 }
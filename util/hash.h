@@ -1,38 +1,54 @@
-#define HASHSIZE 5000001
-
 struct s_hash {
 	char *name;
 	int index;
 	int count;
-	struct s_hash *next;
+	unsigned int hash;
 };
 
-/* name:  The string referred to by this hash entry.                        *
+/* name:  The string referred to by this hash entry.  It is interned in the  *
+ *        table's own storage and lives until the table is freed.           *
  * index: The integer identifier for this entry.                            *
  * count: Number of times an element with this name has been inserted into  *
  *        the table. EXCEPTION: For the structure for blif parsing/reading, *
  * 	  blif_hash, value of count is the number of pins on this vpack_net *
  * 	  so far.	                                                    *
- * next:  A pointer to the next (string,index) entry that mapped to the     *
- *        same hash value, or NULL if there are no more entries.            */
+ * hash:  hash_value(name), kept so probes and resizes never rehash names.  */
+
+struct s_hash_table {
+	int num_slots;
+	int *slots;
+	int num_entries;
+	int max_entries;
+	struct s_hash **entries;
+	t_chunk storage;
+};
+
+/* An open-addressing (linear probing) hash table that grows as entries are *
+ * added.                                                                   *
+ * num_slots: Size of slots; always a power of two, at least twice the      *
+ *            number of entries.                                            *
+ * slots:     [0..num_slots-1].  Index into entries of the entry stored in  *
+ *            this slot, or HASH_EMPTY_SLOT.                                *
+ * entries:   [0..num_entries-1].  The entries in the order they were       *
+ *            first inserted.  Entries never move, so pointers to them stay *
+ *            valid as the table grows.                                     *
+ * storage:   Chunk memory holding the entries and their names, so freeing  *
+ *            the table is a handful of frees whatever its size.            */
 
 struct s_hash_iterator {
 	int i;
-	struct s_hash *h_ptr;
 };
 
-/* i:  current "line" of the hash table.  That is, hash_table[i] is the     *
- *     start of the hash linked list for this hash value.                   *
- * h_ptr:  Pointer to the next hash structure to be examined in the         *
- *         iteration.                                                       */
+/* i:  index in entries of the last entry returned.  Entries are visited in *
+ *     the order they were first inserted.                                  */
 
-struct s_hash **alloc_hash_table(void);
-void free_hash_table(struct s_hash **hash_table);
+struct s_hash_table *alloc_hash_table(void);
+void free_hash_table(struct s_hash_table *hash_table);
 struct s_hash_iterator start_hash_table_iterator(void);
-struct s_hash *get_next_hash(struct s_hash **hash_table,
+struct s_hash *get_next_hash(struct s_hash_table *hash_table,
 		struct s_hash_iterator *hash_iterator);
-struct s_hash *insert_in_hash_table(struct s_hash **hash_table, char *name,
+struct s_hash *insert_in_hash_table(struct s_hash_table *hash_table, char *name,
 		int next_free_index);
-struct s_hash *get_hash_entry(struct s_hash **hash_table, char *name);
-int hash_value(char *name);
-void get_hash_stats(struct s_hash **hash_table, char *hash_table_name);
+struct s_hash *get_hash_entry(struct s_hash_table *hash_table, char *name);
+unsigned int hash_value(char *name);
+void get_hash_stats(struct s_hash_table *hash_table, char *hash_table_name);
@@ -0,0 +1,397 @@
+#include <stdio.h>
+#include <stdarg.h>
+#include <string.h>
+#ifndef _WIN32
+#include <pthread.h>
+#include <unistd.h>
+#endif
+#include "util.h"
+#include "out_buf.h"
+
+#define OUT_BUF_FILE_SIZE (1 << 20) /* bytes buffered before a file write */
+#define OUT_BUF_MAX_THREADS 8
+#define OUT_BUF_ITEMS_PER_RANGE 4096 /* items one thread formats per round */
+
+/* One thread's share of a write_out_bufs_parallel round. */
+typedef struct s_out_range {
+	t_out_buf *bufs; /* [0..num_outs-1] */
+	t_out_buf **buf_ptrs; /* [0..num_outs-1]: &bufs[i], as format takes them */
+	int num_outs;
+	int first;
+	int last;
+	t_out_format_ranges format;
+	void *context;
+} t_out_range;
+
+/* write_out_buf_parallel's format, called through format_single_range. */
+typedef struct s_out_single_format {
+	t_out_format_range format;
+	void *context;
+} t_out_single_format;
+
+/******************** Subroutines local to this module **********************/
+
+static void reserve_out_buf(t_out_buf *out, size_t num_bytes);
+
+static void flush_out_buf(t_out_buf *out);
+
+static void out_bytes(t_out_buf *out, const char *bytes, size_t num_bytes);
+
+static FILE *open_compressor(const char *file_name);
+
+static void *format_out_range(void *arg);
+
+static void format_single_range(t_out_buf **outs, int first, int last,
+		void *context);
+
+/************************ Subroutine definitions ****************************/
+
+t_out_buf *open_out_file(INP const char *file_name) {
+
+	t_out_buf *out;
+
+	out = (t_out_buf *) my_calloc(1, sizeof(t_out_buf));
+	out->file_name = my_strdup(file_name);
+	out->fp = open_compressor(file_name);
+	if (out->fp != NULL) {
+		out->is_pipe = TRUE;
+	} else {
+		out->fp = my_fopen(file_name, "w", 0);
+	}
+	out->capacity = OUT_BUF_FILE_SIZE;
+	out->text = (char *) my_malloc(out->capacity);
+	return (out);
+}
+
+void close_out_file(INOUTP t_out_buf *out) {
+
+	flush_out_buf(out);
+	if (out->is_pipe) {
+#ifndef _WIN32
+		if (pclose(out->fp) != 0) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Compressing '%s' failed.\n",
+					out->file_name);
+			exit(1);
+		}
+#endif
+	} else if (ferror(out->fp) || fclose(out->fp) != 0) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Writing '%s' failed.\n", out->file_name);
+		exit(1);
+	}
+	free(out->text);
+	free(out->file_name);
+	free(out);
+}
+
+void init_out_buf(OUTP t_out_buf *out) {
+
+	memset(out, 0, sizeof(t_out_buf));
+}
+
+void free_out_buf(INOUTP t_out_buf *out) {
+
+	free(out->text);
+	init_out_buf(out);
+}
+
+static void reserve_out_buf(t_out_buf *out, size_t num_bytes) {
+
+	/* Makes room for num_bytes more bytes: a file is written out first, a *
+	 * memory buffer (or a file buffer too small for one piece) grows.     */
+
+	if (out->capacity - out->size >= num_bytes)
+		return;
+
+	if (out->fp != NULL) {
+		flush_out_buf(out);
+		if (out->capacity >= num_bytes)
+			return;
+	}
+	while (out->capacity - out->size < num_bytes)
+		out->capacity = (out->capacity == 0 ? 4096 : 2 * out->capacity);
+	out->text = (char *) my_realloc(out->text, out->capacity);
+}
+
+static void flush_out_buf(t_out_buf *out) {
+
+	if (out->fp != NULL && out->size > 0) {
+		if (fwrite(out->text, 1, out->size, out->fp) != out->size) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Writing '%s' failed.\n",
+					out->file_name);
+			exit(1);
+		}
+		out->size = 0;
+	}
+}
+
+static void out_bytes(t_out_buf *out, const char *bytes, size_t num_bytes) {
+
+	if (num_bytes == 0)
+		return;
+	if (out->fp != NULL && num_bytes >= OUT_BUF_FILE_SIZE) {
+		/* Large pieces skip the buffer */
+		flush_out_buf(out);
+		if (fwrite(bytes, 1, num_bytes, out->fp) != num_bytes) {
+			vpr_printf(TIO_MESSAGE_ERROR, "Writing '%s' failed.\n",
+					out->file_name);
+			exit(1);
+		}
+		return;
+	}
+	reserve_out_buf(out, num_bytes);
+	memcpy(out->text + out->size, bytes, num_bytes);
+	out->size += num_bytes;
+}
+
+void out_str(INOUTP t_out_buf *out, INP const char *s) {
+
+	out_bytes(out, s, strlen(s));
+}
+
+void out_char(INOUTP t_out_buf *out, INP char c) {
+
+	if (out->size == out->capacity)
+		reserve_out_buf(out, 1);
+	out->text[out->size++] = c;
+}
+
+void out_int(INOUTP t_out_buf *out, INP int value) {
+
+	out_int_width(out, value, 0);
+}
+
+void out_int_width(INOUTP t_out_buf *out, INP int value, INP int width) {
+
+	/* Same as "%<width>d": right-justified, padded with blanks. */
+
+	char digits[16], *p;
+	unsigned int magnitude;
+	int len;
+
+	p = digits + sizeof(digits);
+	magnitude = (value < 0 ? 0u - (unsigned int) value : (unsigned int) value);
+	do {
+		*--p = (char) ('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0);
+	if (value < 0)
+		*--p = '-';
+	len = (int) (digits + sizeof(digits) - p);
+
+	reserve_out_buf(out, (size_t) (len > width ? len : width));
+	for (; width > len; width--)
+		out->text[out->size++] = ' ';
+	memcpy(out->text + out->size, p, len);
+	out->size += len;
+}
+
+void out_printf(INOUTP t_out_buf *out, INP const char *format, ...) {
+
+	va_list args;
+	int len;
+
+	va_start(args, format);
+	len = vsnprintf(out->text + out->size, out->capacity - out->size, format,
+			args);
+	va_end(args);
+
+	if (len < 0) {
+		vpr_printf(TIO_MESSAGE_ERROR, "in out_printf: bad format '%s'.\n", format);
+		exit(1);
+	}
+	if ((size_t) len >= out->capacity - out->size) {
+		/* Did not fit; make room and format again */
+		reserve_out_buf(out, (size_t) len + 1);
+		va_start(args, format);
+		vsnprintf(out->text + out->size, out->capacity - out->size, format,
+				args);
+		va_end(args);
+	}
+	out->size += len;
+}
+
+static FILE *open_compressor(const char *file_name) {
+
+	/* Returns a pipe into gzip or zstd writing file_name if its suffix asks *
+	 * for compression, NULL otherwise.                                      */
+
+	FILE *fp;
+	const char *command;
+	char *cmd_line, *p;
+	size_t len;
+
+	len = strlen(file_name);
+	if (len > 3 && strcmp(file_name + len - 3, ".gz") == 0) {
+		command = "gzip -c > '";
+	} else if (len > 4 && strcmp(file_name + len - 4, ".zst") == 0) {
+		command = "zstd -q -c > '";
+	} else {
+		return (NULL);
+	}
+
+#ifdef _WIN32
+	vpr_printf(TIO_MESSAGE_WARNING, "Compressed output is not supported on this platform; '%s' is written as text.\n",
+			file_name);
+	return (NULL);
+#else
+	/* Quote the name for the shell: ' becomes '\'' */
+	cmd_line = (char *) my_malloc(strlen(command) + 4 * len + 2);
+	strcpy(cmd_line, command);
+	p = cmd_line + strlen(command);
+	for (; *file_name != '\0'; file_name++) {
+		if (*file_name == '\'') {
+			strcpy(p, "'\\''");
+			p += 4;
+		} else {
+			*p++ = *file_name;
+		}
+	}
+	*p++ = '\'';
+	*p = '\0';
+
+	fflush(NULL);
+	fp = popen(cmd_line, "w");
+	if (fp == NULL) {
+		vpr_printf(TIO_MESSAGE_ERROR, "Cannot start '%s'.\n", cmd_line);
+		exit(1);
+	}
+	free(cmd_line);
+	return (fp);
+#endif
+}
+
+static void *format_out_range(void *arg) {
+
+	t_out_range *range;
+	int iout;
+
+	range = (t_out_range *) arg;
+	for (iout = 0; iout < range->num_outs; iout++)
+		range->bufs[iout].size = 0;
+	range->format(range->buf_ptrs, range->first, range->last, range->context);
+	return (NULL);
+}
+
+static void format_single_range(t_out_buf **outs, int first, int last,
+		void *context) {
+
+	t_out_single_format *single;
+
+	single = (t_out_single_format *) context;
+	single->format(outs[0], first, last, single->context);
+}
+
+void write_out_buf_parallel(INOUTP t_out_buf *out, INP int num_items,
+		INP t_out_format_range format, INP void *context) {
+
+	/* Appends items [0..num_items-1] to out as format writes them; see *
+	 * write_out_bufs_parallel.                                         */
+
+	t_out_single_format single;
+
+	single.format = format;
+	single.context = (void *) context;
+	write_out_bufs_parallel(&out, 1, num_items, OUT_BUF_ITEMS_PER_RANGE,
+			format_single_range, &single);
+}
+
+void write_out_bufs_parallel(INOUTP t_out_buf **outs, INP int num_outs,
+		INP int num_items, INP int items_per_range,
+		INP t_out_format_ranges format, INP void *context) {
+
+	/* Appends items [0..num_items-1] to outs[0..num_outs-1] as format      *
+	 * writes them.  Each round, up to one range of items_per_range items   *
+	 * per thread is formatted into that thread's memory buffers, then the  *
+	 * buffers are appended to each output in item order, so the output    *
+	 * does not depend on the number of threads and memory stays bounded on *
+	 * very large files.  items_per_range should be smaller when each item  *
+	 * writes a lot of text.                                                */
+
+	t_out_range *ranges;
+	int num_threads, irange, num_ranges, first, iout;
+#ifndef _WIN32
+	pthread_t *threads;
+	boolean *is_threaded;
+	long num_cpus;
+#endif
+
+	num_threads = 1;
+#ifndef _WIN32
+	num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (num_cpus > OUT_BUF_MAX_THREADS)
+		num_threads = OUT_BUF_MAX_THREADS;
+	else if (num_cpus > 1)
+		num_threads = (int) num_cpus;
+#endif
+	if (num_threads == 1 || num_items <= items_per_range) {
+		format(outs, 0, num_items, (void *) context);
+		return;
+	}
+
+	ranges = (t_out_range *) my_calloc(num_threads, sizeof(t_out_range));
+	for (irange = 0; irange < num_threads; irange++) {
+		ranges[irange].bufs = (t_out_buf *) my_calloc(num_outs,
+				sizeof(t_out_buf));
+		ranges[irange].buf_ptrs = (t_out_buf **) my_malloc(
+				num_outs * sizeof(t_out_buf *));
+		for (iout = 0; iout < num_outs; iout++)
+			ranges[irange].buf_ptrs[iout] = &ranges[irange].bufs[iout];
+		ranges[irange].num_outs = num_outs;
+		ranges[irange].format = format;
+		ranges[irange].context = (void *) context;
+	}
+#ifndef _WIN32
+	threads = (pthread_t *) my_malloc(num_threads * sizeof(pthread_t));
+	is_threaded = (boolean *) my_calloc(num_threads, sizeof(boolean));
+#endif
+
+	for (first = 0; first < num_items;) {
+		num_ranges = 0;
+		while (num_ranges < num_threads && first < num_items) {
+			ranges[num_ranges].first = first;
+			first += items_per_range;
+			if (first > num_items)
+				first = num_items;
+			ranges[num_ranges].last = first;
+			num_ranges++;
+		}
+
+#ifndef _WIN32
+		/* Range 0 is formatted on this thread; any thread that cannot be *
+		 * started just leaves its range to be done here too.             */
+		for (irange = 1; irange < num_ranges; irange++) {
+			is_threaded[irange] = (boolean) (pthread_create(&threads[irange],
+					NULL, format_out_range, &ranges[irange]) == 0);
+		}
+		format_out_range(&ranges[0]);
+		for (irange = 1; irange < num_ranges; irange++) {
+			if (is_threaded[irange])
+				pthread_join(threads[irange], NULL);
+			else
+				format_out_range(&ranges[irange]);
+		}
+#else
+		for (irange = 0; irange < num_ranges; irange++)
+			format_out_range(&ranges[irange]);
+#endif
+
+		for (iout = 0; iout < num_outs; iout++) {
+			for (irange = 0; irange < num_ranges; irange++) {
+				out_bytes(outs[iout], ranges[irange].bufs[iout].text,
+						ranges[irange].bufs[iout].size);
+			}
+		}
+	}
+
+	for (irange = 0; irange < num_threads; irange++) {
+		for (iout = 0; iout < num_outs; iout++)
+			free_out_buf(&ranges[irange].bufs[iout]);
+		free(ranges[irange].bufs);
+		free(ranges[irange].buf_ptrs);
+	}
+	free(ranges);
+#ifndef _WIN32
+	free(threads);
+	free(is_threaded);
+#endif
+}
@@ -0,0 +1,62 @@
+#ifndef OUT_BUF_H
+#define OUT_BUF_H
+
+/* Buffered text output for the large output files and echo dumps.  A     *
+ * t_out_buf is either an open file, written out in OUT_BUF_FILE_SIZE     *
+ * pieces, or a growable memory buffer.  Text is appended with out_str,   *
+ * out_int and friends, which format integers without going through      *
+ * printf; out_printf handles everything else with the C library's        *
+ * formatting, so the bytes are exactly what fprintf would write.         *
+ * A file whose name ends in ".gz" or ".zst" is streamed through gzip or  *
+ * zstd (found on the PATH) instead of being written as text.             */
+
+typedef struct s_out_buf {
+	char *text;
+	size_t size;
+	size_t capacity;
+	FILE *fp;
+	boolean is_pipe;
+	char *file_name;
+} t_out_buf;
+
+/* text:      [0..capacity-1].  The first size bytes are not written yet.  *
+ * fp:        The file the text goes to, NULL for a memory buffer.        *
+ * is_pipe:   fp is a compressor opened with popen.                       *
+ * file_name: For error messages; NULL for a memory buffer.               */
+
+/* Formats items [first..last-1] into out.  Called on several threads at  *
+ * once by write_out_buf_parallel, so it may only read shared data.       */
+typedef void (*t_out_format_range)(t_out_buf *out, int first, int last,
+		void *context);
+
+/* Same for write_out_bufs_parallel: formats items [first..last-1] into   *
+ * outs[0..num_outs-1], one buffer per output file.                       */
+typedef void (*t_out_format_ranges)(t_out_buf **outs, int first, int last,
+		void *context);
+
+t_out_buf *open_out_file(INP const char *file_name);
+
+void close_out_file(INOUTP t_out_buf *out);
+
+void init_out_buf(OUTP t_out_buf *out);
+
+void free_out_buf(INOUTP t_out_buf *out);
+
+void out_str(INOUTP t_out_buf *out, INP const char *s);
+
+void out_char(INOUTP t_out_buf *out, INP char c);
+
+void out_int(INOUTP t_out_buf *out, INP int value);
+
+void out_int_width(INOUTP t_out_buf *out, INP int value, INP int width);
+
+void out_printf(INOUTP t_out_buf *out, INP const char *format, ...);
+
+void write_out_buf_parallel(INOUTP t_out_buf *out, INP int num_items,
+		INP t_out_format_range format, INP void *context);
+
+void write_out_bufs_parallel(INOUTP t_out_buf **outs, INP int num_outs,
+		INP int num_items, INP int items_per_range,
+		INP t_out_format_ranges format, INP void *context);
+
+#endif
@@ -40,6 +40,21 @@ static int ** f_port_pin_from_blk_pin = NULL;
  * [0...num_types-1][0...num_ports-1][0...num_port_pins-1]               */
 static int *** f_blk_pin_from_port_pin = NULL;
 
+/* Pool of cleared pb_stats gain arrays, so that opening a cluster doesn't *
+ * cost an allocation and a clear of netlist-sized arrays.  Each entry is   *
+ * one block-indexed chunk (the six float gain arrays back to back) and one *
+ * net-indexed chunk (num_pins_of_net_in_pb).  Only the top-level pb of an  *
+ * open cluster holds a set, so the pool keeps at most                      *
+ * MAX_FREE_PB_GAINS sets and frees the rest.                               *
+ * [0...f_num_free_pb_gains-1]                                              */
+#define MAX_FREE_PB_GAINS 2
+static float ** f_free_pb_block_gains = NULL;
+static int ** f_free_pb_net_pins = NULL;
+static int f_num_free_pb_gains = 0;
+static int f_max_free_pb_gains = 0;
+
+#define NUM_PB_BLOCK_GAIN_ARRAYS 6
+
 
 /******************** Subroutine declarations ********************************/
 
@@ -68,6 +83,10 @@ static void mark_direct_of_pins(int start_pin_index, int end_pin_index, int ityp
 		int iport, int ** idirect_from_blk_pin, int idirect, 
 		int ** direct_type_from_blk_pin, int direct_type, int line, char * src_string);
 
+/* Clears the gain entries touched while the pb was open and returns the   *
+ * arrays to the pool.                                                     */
+static void release_pb_stats_gains(t_pb_stats *pb_stats);
+
 /******************** Subroutine definitions *********************************/
 
 /**
@@ -514,15 +533,18 @@ void free_cb(t_pb *pb) {
 	total_nodes = pb->pb_graph_node->total_pb_pins + pb_type->num_input_pins
 			+ pb_type->num_output_pins + pb_type->num_clock_pins;
 
-	for (i = 0; i < total_nodes; i++) {
-		if (pb->rr_graph[i].edges != NULL) {
-			free(pb->rr_graph[i].edges);
-		}
-		if (pb->rr_graph[i].switches != NULL) {
-			free(pb->rr_graph[i].switches);
+	/* NULL if the packer's legalizer arena already took the rr graph back */
+	if (pb->rr_graph != NULL) {
+		for (i = 0; i < total_nodes; i++) {
+			if (pb->rr_graph[i].edges != NULL) {
+				free(pb->rr_graph[i].edges);
+			}
+			if (pb->rr_graph[i].switches != NULL) {
+				free(pb->rr_graph[i].switches);
+			}
 		}
+		free(pb->rr_graph);
 	}
-	free(pb->rr_graph);
 	free_pb(pb);
 }
 
@@ -619,14 +641,8 @@ void free_pb_stats(t_pb *pb) {
 		return;
 	}
 
-	pb->pb_stats->gain.clear();
-	pb->pb_stats->timinggain.clear();
-	pb->pb_stats->sharinggain.clear();
-	pb->pb_stats->hillgain.clear();
-	pb->pb_stats->connectiongain.clear();
-	pb->pb_stats->num_pins_of_net_in_pb.clear();
-	
-	if(pb->pb_stats->marked_blocks != NULL) {
+	if(pb->pb_stats->feasible_blocks != NULL) {
+		release_pb_stats_gains(pb->pb_stats);
 		for (i = 0; i < pb_graph_node->num_input_pin_class; i++) {
 			free(pb->pb_stats->input_pins_used[i]);
 			free(pb->pb_stats->lookahead_input_pins_used[i]);
@@ -639,7 +655,14 @@ void free_pb_stats(t_pb *pb) {
 		}
 		free(pb->pb_stats->output_pins_used);
 		free(pb->pb_stats->lookahead_output_pins_used);
+		free(pb->pb_stats->lookahead_input_pins_count);
+		free(pb->pb_stats->lookahead_output_pins_count);
+		free(pb->pb_stats->input_pin_class_capacity);
+		free(pb->pb_stats->output_pin_class_capacity);
+		free(pb->pb_stats->lookahead_overused_classes);
 		free(pb->pb_stats->feasible_blocks);
+		free(pb->pb_stats->candidates);
+		free(pb->pb_stats->parked_candidates);
 		free(pb->pb_stats->marked_nets);
 		free(pb->pb_stats->marked_blocks);
 	}
@@ -648,6 +671,107 @@ void free_pb_stats(t_pb *pb) {
 	pb->pb_stats = NULL;
 }
 
+void alloc_pb_stats_gains(t_pb_stats *pb_stats) {
+
+	/* Gives pb_stats a set of all-zero gain arrays, from the pool if one is *
+	 * free.                                                                 */
+
+	float *block_gains;
+	int *net_pins;
+
+	if (f_num_free_pb_gains > 0) {
+		f_num_free_pb_gains--;
+		block_gains = f_free_pb_block_gains[f_num_free_pb_gains];
+		net_pins = f_free_pb_net_pins[f_num_free_pb_gains];
+	} else {
+		block_gains = (float *) my_calloc(
+				NUM_PB_BLOCK_GAIN_ARRAYS * num_logical_blocks, sizeof(float));
+		net_pins = (int *) my_calloc(num_logical_nets, sizeof(int));
+	}
+
+	pb_stats->gain = block_gains;
+	pb_stats->timinggain = block_gains + num_logical_blocks;
+	pb_stats->connectiongain = block_gains + 2 * num_logical_blocks;
+	pb_stats->prevconnectiongainincr = block_gains + 3 * num_logical_blocks;
+	pb_stats->sharinggain = block_gains + 4 * num_logical_blocks;
+	pb_stats->hillgain = block_gains + 5 * num_logical_blocks;
+	pb_stats->num_pins_of_net_in_pb = net_pins;
+}
+
+static void release_pb_stats_gains(t_pb_stats *pb_stats) {
+
+	/* Only marked blocks get a sharing, hill or total gain, but the      *
+	 * connection and timing gains are updated for any unclustered block  *
+	 * on a marked net, so every block on those nets is cleared.          */
+
+	int i, ipin, iblk, inet;
+
+	if (pb_stats->gain == NULL) {
+		return;
+	}
+
+	for (i = 0; i < pb_stats->num_marked_blocks; i++) {
+		iblk = pb_stats->marked_blocks[i];
+		pb_stats->gain[iblk] = 0;
+		pb_stats->sharinggain[iblk] = 0;
+		pb_stats->hillgain[iblk] = 0;
+		pb_stats->connectiongain[iblk] = 0;
+		pb_stats->timinggain[iblk] = 0;
+		pb_stats->prevconnectiongainincr[iblk] = 0;
+	}
+	for (i = 0; i < pb_stats->num_marked_nets; i++) {
+		inet = pb_stats->marked_nets[i];
+		for (ipin = 0; ipin <= vpack_net[inet].num_sinks; ipin++) {
+			iblk = vpack_net[inet].node_block[ipin];
+			pb_stats->connectiongain[iblk] = 0;
+			pb_stats->timinggain[iblk] = 0;
+		}
+		pb_stats->num_pins_of_net_in_pb[inet] = 0;
+	}
+
+	if (f_max_free_pb_gains == 0) {
+		f_max_free_pb_gains = MAX_FREE_PB_GAINS;
+		f_free_pb_block_gains = (float **) my_malloc(
+				f_max_free_pb_gains * sizeof(float *));
+		f_free_pb_net_pins = (int **) my_malloc(
+				f_max_free_pb_gains * sizeof(int *));
+	}
+	if (f_num_free_pb_gains < f_max_free_pb_gains) {
+		f_free_pb_block_gains[f_num_free_pb_gains] = pb_stats->gain;
+		f_free_pb_net_pins[f_num_free_pb_gains] = pb_stats->num_pins_of_net_in_pb;
+		f_num_free_pb_gains++;
+	} else {
+		free(pb_stats->gain);
+		free(pb_stats->num_pins_of_net_in_pb);
+	}
+
+	pb_stats->gain = NULL;
+	pb_stats->timinggain = NULL;
+	pb_stats->connectiongain = NULL;
+	pb_stats->prevconnectiongainincr = NULL;
+	pb_stats->sharinggain = NULL;
+	pb_stats->hillgain = NULL;
+	pb_stats->num_pins_of_net_in_pb = NULL;
+}
+
+void free_pb_stats_gain_pool(void) {
+
+	/* Frees the pooled gain arrays once packing is done. */
+
+	int i;
+
+	for (i = 0; i < f_num_free_pb_gains; i++) {
+		free(f_free_pb_block_gains[i]);
+		free(f_free_pb_net_pins[i]);
+	}
+	free(f_free_pb_block_gains);
+	free(f_free_pb_net_pins);
+	f_free_pb_block_gains = NULL;
+	f_free_pb_net_pins = NULL;
+	f_num_free_pb_gains = 0;
+	f_max_free_pb_gains = 0;
+}
+
 int ** alloc_and_load_net_pin_index() {
 
 	/* Allocates and loads net_pin_index array, this array allows us to quickly   *
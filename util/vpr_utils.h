@@ -44,6 +44,8 @@ void parse_direct_pin_name(char * src_string, int line, int * start_pin_index,
 
 void free_cb(t_pb *pb);
 void free_pb_stats(t_pb *pb);
+void alloc_pb_stats_gains(t_pb_stats *pb_stats);
+void free_pb_stats_gain_pool(void);
 void free_pb(t_pb *pb);
 
 